@@ -39,7 +39,8 @@ NS_LOG_COMPONENT_DEFINE ("AodvNeighbors");
 namespace aodv
 {
 Neighbors::Neighbors (Time delay) : 
-  m_ntimer (Timer::CANCEL_ON_DESTROY)
+  m_ntimer (Timer::CANCEL_ON_DESTROY),
+  m_timerWheelClient (0)
 {
   m_ntimer.SetDelay (delay);
   m_ntimer.SetFunction (&Neighbors::Purge, this);
@@ -118,15 +119,50 @@ Neighbors::Purge ()
         }
     }
   m_nb.erase (std::remove_if (m_nb.begin (), m_nb.end (), pred), m_nb.end ());
-  m_ntimer.Cancel ();
-  m_ntimer.Schedule ();
+  ScheduleTimer ();
 }
 
 void
 Neighbors::ScheduleTimer ()
+{
+  if (m_timerWheel == 0)
+    {
+      m_ntimer.Cancel ();
+      m_ntimer.Schedule ();
+      return;
+    }
+  // Purge is called on every lookup: move the time of the purge, and
+  // leave the pending job check it rather than scheduling a new one
+  m_purgeTime = Simulator::Now () + m_ntimer.GetDelay ();
+  if (m_purgeJob == 0)
+    {
+      m_purgeJob = m_timerWheel->Schedule (m_timerWheelClient, m_ntimer.GetDelay (),
+                                           &Neighbors::PurgeJob, this);
+    }
+}
+
+void
+Neighbors::SetTimerWheel (Ptr<TimerWheel> wheel, uint32_t client)
 {
   m_ntimer.Cancel ();
-  m_ntimer.Schedule ();
+  m_timerWheel = wheel;
+  m_timerWheelClient = client;
+  m_purgeJob = 0;
+}
+
+void
+Neighbors::PurgeJob ()
+{
+  m_purgeJob = 0;
+  if (Simulator::Now () >= m_purgeTime)
+    {
+      Purge ();
+    }
+  else
+    {
+      m_purgeJob = m_timerWheel->Schedule (m_timerWheelClient, m_purgeTime - Simulator::Now (),
+                                           &Neighbors::PurgeJob, this);
+    }
 }
 
 void
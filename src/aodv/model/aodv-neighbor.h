@@ -31,6 +31,7 @@
 
 #include "ns3/simulator.h"
 #include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/callback.h"
 #include "ns3/wifi-mac-header.h"
@@ -75,6 +76,12 @@ public:
   void Purge ();
   /// Schedule m_ntimer.
   void ScheduleTimer ();
+  /**
+   * Schedule the purges in a timer wheel instead of m_ntimer.
+   * \param wheel the timer wheel
+   * \param client the identifier of the owner of the neighbors in the wheel
+   */
+  void SetTimerWheel (Ptr<TimerWheel> wheel, uint32_t client);
   /// Remove all entries
   void Clear () { m_nb.clear (); }
 
@@ -97,6 +104,14 @@ private:
   Callback<void, WifiMacHeader const &> m_txErrorCallback;
   /// Timer for neighbor's list. Schedule Purge().
   Timer m_ntimer;
+  /// Timer wheel used instead of m_ntimer, if any
+  Ptr<TimerWheel> m_timerWheel;
+  /// Identifier of the owner of the neighbors in m_timerWheel
+  uint32_t m_timerWheelClient;
+  /// Pending purge job in m_timerWheel
+  Ptr<EventImpl> m_purgeJob;
+  /// Time of the next purge, when m_timerWheel is used
+  Time m_purgeTime;
   /// vector of entries
   std::vector<Neighbor> m_nb;
   /// list of ARP cached to be used for layer 2 notifications processing
@@ -106,6 +121,8 @@ private:
   Mac48Address LookupMacAddress (Ipv4Address);
   /// Process layer 2 TX error notification
   void ProcessTxError (WifiMacHeader const &);
+  /// Purge if the time of the purge has come, or schedule the job again
+  void PurgeJob ();
 };
 
 }
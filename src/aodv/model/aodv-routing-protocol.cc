@@ -152,6 +152,9 @@ RoutingProtocol::RoutingProtocol () :
   m_nb (m_helloInterval),
   m_rreqCount (0),
   m_rerrCount (0),
+  m_rateLimitStart (Seconds (0)),
+  m_timerTick (Seconds (0)),
+  m_timerWheelClient (0),
   m_htimer (Timer::CANCEL_ON_DESTROY),
   m_rreqRateLimitTimer (Timer::CANCEL_ON_DESTROY),
   m_rerrRateLimitTimer (Timer::CANCEL_ON_DESTROY),
@@ -277,6 +280,15 @@ RoutingProtocol::GetTypeId (void)
                    StringValue ("ns3::UniformRandomVariable"),
                    MakePointerAccessor (&RoutingProtocol::m_uniformRandomVariable),
                    MakePointerChecker<UniformRandomVariable> ())
+    .AddAttribute ("TimerTick",
+                   "Duration of the ticks of a timer wheel shared by all the instances of "
+                   "the protocol, which runs the hello and neighbor purge timers in batches; "
+                   "these timers are delayed by less than a tick, and the RREQ and RERR rate "
+                   "limit counts are reset when they are used instead of by timers. "
+                   "Zero disables the wheel.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&RoutingProtocol::m_timerTick),
+                   MakeTimeChecker (Seconds (0)))
   ;
   return tid;
 }
@@ -314,6 +326,12 @@ RoutingProtocol::DoDispose ()
       iter->first->Close ();
     }
   m_socketSubnetBroadcastAddresses.clear ();
+  if (m_timerWheel != 0)
+    {
+      m_timerWheel->RemoveClient (m_timerWheelClient);
+      m_timerWheel = 0;
+      m_helloJob = 0;
+    }
   Ipv4RoutingProtocol::DoDispose ();
 }
 
@@ -341,10 +359,21 @@ void
 RoutingProtocol::Start ()
 {
   NS_LOG_FUNCTION (this);
+  SetupTimerWheel ();
   if (m_enableHello)
     {
       m_nb.ScheduleTimer ();
     }
+  if (m_timerWheel != 0)
+    {
+      // the RREQ and RERR counts are reset every second from now on, when
+      // they are used, rather than by timers which would mostly find them
+      // unused
+      m_rateLimitStart = Simulator::Now ();
+      m_rreqCount = 0;
+      m_rerrCount = 0;
+      return;
+    }
   m_rreqRateLimitTimer.SetFunction (&RoutingProtocol::RreqRateLimitTimerExpire,
                                     this);
   m_rreqRateLimitTimer.Schedule (Seconds (1));
@@ -352,7 +381,45 @@ RoutingProtocol::Start ()
   m_rerrRateLimitTimer.SetFunction (&RoutingProtocol::RerrRateLimitTimerExpire,
                                     this);
   m_rerrRateLimitTimer.Schedule (Seconds (1));
+}
+
+void
+RoutingProtocol::SetupTimerWheel ()
+{
+  if (m_timerWheel != 0 || m_timerTick.IsZero ())
+    {
+      return;
+    }
+  m_timerWheel = TimerWheel::GetShared ("ns3::aodv::RoutingProtocol", m_timerTick);
+  m_timerWheelClient = m_timerWheel->AddClient ();
+  m_nb.SetTimerWheel (m_timerWheel, m_timerWheelClient);
+}
+
+void
+RoutingProtocol::UpdateRateLimits ()
+{
+  if (m_timerWheel == 0)
+    {
+      return;
+    }
+  Time elapsed = Simulator::Now () - m_rateLimitStart;
+  if (elapsed >= Seconds (1))
+    {
+      int64_t seconds = elapsed.GetTimeStep () / Seconds (1).GetTimeStep ();
+      m_rateLimitStart += TimeStep (seconds * Seconds (1).GetTimeStep ());
+      m_rreqCount = 0;
+      m_rerrCount = 0;
+    }
+}
 
+Time
+RoutingProtocol::GetRateLimitDelayLeft (const Timer &timer) const
+{
+  if (m_timerWheel == 0)
+    {
+      return timer.GetDelayLeft ();
+    }
+  return m_rateLimitStart + Seconds (1) - Simulator::Now ();
 }
 
 Ptr<Ipv4Route>
@@ -735,7 +802,7 @@ RoutingProtocol::NotifyInterfaceDown (uint32_t i)
   if (m_socketAddresses.empty ())
     {
       NS_LOG_LOGIC ("No aodv interfaces");
-      m_htimer.Cancel ();
+      CancelHello ();
       m_nb.Clear ();
       m_routingTable.Clear ();
       return;
@@ -848,7 +915,7 @@ RoutingProtocol::NotifyRemoveAddress (uint32_t i, Ipv4InterfaceAddress address)
       if (m_socketAddresses.empty ())
         {
           NS_LOG_LOGIC ("No aodv interfaces");
-          m_htimer.Cancel ();
+          CancelHello ();
           m_nb.Clear ();
           m_routingTable.Clear ();
           return;
@@ -929,9 +996,10 @@ RoutingProtocol::SendRequest (Ipv4Address dst)
 {
   NS_LOG_FUNCTION ( this << dst);
   // A node SHOULD NOT originate more than RREQ_RATELIMIT RREQ messages per second.
+  UpdateRateLimits ();
   if (m_rreqCount == m_rreqRateLimit)
     {
-      Simulator::Schedule (m_rreqRateLimitTimer.GetDelayLeft () + MicroSeconds (100),
+      Simulator::Schedule (GetRateLimitDelayLeft (m_rreqRateLimitTimer) + MicroSeconds (100),
                            &RoutingProtocol::SendRequest, this, dst);
       return;
     }
@@ -1746,12 +1814,37 @@ RoutingProtocol::HelloTimerExpire ()
     {
       SendHello ();
     }
-  m_htimer.Cancel ();
   Time diff = m_helloInterval - offset;
-  m_htimer.Schedule (std::max (Time (Seconds (0)), diff));
+  ScheduleHello (std::max (Time (Seconds (0)), diff));
   m_lastBcastTime = Time (Seconds (0));
 }
 
+void
+RoutingProtocol::ScheduleHello (Time delay)
+{
+  CancelHello ();
+  if (m_timerWheel != 0)
+    {
+      m_helloJob = m_timerWheel->Schedule (m_timerWheelClient, delay,
+                                           &RoutingProtocol::HelloTimerExpire, this);
+    }
+  else
+    {
+      m_htimer.Schedule (delay);
+    }
+}
+
+void
+RoutingProtocol::CancelHello ()
+{
+  m_htimer.Cancel ();
+  if (m_helloJob != 0)
+    {
+      m_helloJob->Cancel ();
+      m_helloJob = 0;
+    }
+}
+
 void
 RoutingProtocol::RreqRateLimitTimerExpire ()
 {
@@ -1896,13 +1989,14 @@ RoutingProtocol::SendRerrWhenNoRouteToForward (Ipv4Address dst,
 {
   NS_LOG_FUNCTION (this);
   // A node SHOULD NOT originate more than RERR_RATELIMIT RERR messages per second.
+  UpdateRateLimits ();
   if (m_rerrCount == m_rerrRateLimit)
     {
       // Just make sure that the RerrRateLimit timer is running and will expire
-      NS_ASSERT (m_rerrRateLimitTimer.IsRunning ());
+      NS_ASSERT (m_timerWheel != 0 || m_rerrRateLimitTimer.IsRunning ());
       // discard the packet and return
       NS_LOG_LOGIC ("RerrRateLimit reached at " << Simulator::Now ().GetSeconds () << " with timer delay left " 
-                                                << m_rerrRateLimitTimer.GetDelayLeft ().GetSeconds ()
+                                                << GetRateLimitDelayLeft (m_rerrRateLimitTimer).GetSeconds ()
                                                 << "; suppressing RERR");
       return;
     }
@@ -1958,13 +2052,14 @@ RoutingProtocol::SendRerrMessage (Ptr<Packet> packet, std::vector<Ipv4Address> p
       return;
     }
   // A node SHOULD NOT originate more than RERR_RATELIMIT RERR messages per second.
+  UpdateRateLimits ();
   if (m_rerrCount == m_rerrRateLimit)
     {
       // Just make sure that the RerrRateLimit timer is running and will expire
-      NS_ASSERT (m_rerrRateLimitTimer.IsRunning ());
+      NS_ASSERT (m_timerWheel != 0 || m_rerrRateLimitTimer.IsRunning ());
       // discard the packet and return
       NS_LOG_LOGIC ("RerrRateLimit reached at " << Simulator::Now ().GetSeconds () << " with timer delay left " 
-                                                << m_rerrRateLimitTimer.GetDelayLeft ().GetSeconds ()
+                                                << GetRateLimitDelayLeft (m_rerrRateLimitTimer).GetSeconds ()
                                                 << "; suppressing RERR");
       return;
     }
@@ -2058,7 +2153,8 @@ RoutingProtocol::DoInitialize (void)
       m_htimer.SetFunction (&RoutingProtocol::HelloTimerExpire, this);
       startTime = m_uniformRandomVariable->GetInteger (0, 100);
       NS_LOG_DEBUG ("Starting at time " << startTime << "ms");
-      m_htimer.Schedule (MilliSeconds (startTime));
+      SetupTimerWheel ();
+      ScheduleHello (MilliSeconds (startTime));
     }
   Ipv4RoutingProtocol::DoInitialize ();
 }
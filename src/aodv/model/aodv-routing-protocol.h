@@ -39,6 +39,7 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-interface.h"
 #include "ns3/ipv4-l3-protocol.h"
+#include "ns3/timer-wheel.h"
 #include <map>
 
 namespace ns3
@@ -167,6 +168,14 @@ private:
   uint16_t m_rreqCount;
   /// Number of RERRs used for RERR rate control
   uint16_t m_rerrCount;
+  /// Start of the current second of RREQ and RERR rate control, when the timer wheel is used
+  Time m_rateLimitStart;
+  /// Duration of a tick of the timer wheel, or zero not to use one
+  Time m_timerTick;
+  /// Timer wheel shared by the instances of the protocol
+  Ptr<TimerWheel> m_timerWheel;
+  /// Identifier of this instance as a client of m_timerWheel
+  uint32_t m_timerWheelClient;
 
 private:
   /// Start protocol operation
@@ -253,16 +262,38 @@ private:
 
   /// Hello timer
   Timer m_htimer;
+  /// Hello job, when the timer wheel is used instead of m_htimer
+  Ptr<EventImpl> m_helloJob;
   /// Schedule next send of hello message
   void HelloTimerExpire ();
-  /// RREQ rate limit timer
+  /// RREQ rate limit timer, when the timer wheel is not used
   Timer m_rreqRateLimitTimer;
   /// Reset RREQ count and schedule RREQ rate limit timer with delay 1 sec.
   void RreqRateLimitTimerExpire ();
-  /// RERR rate limit timer
+  /// RERR rate limit timer, when the timer wheel is not used
   Timer m_rerrRateLimitTimer;
   /// Reset RERR count and schedule RERR rate limit timer with delay 1 sec.
   void RerrRateLimitTimerExpire ();
+  /**
+   * Schedule the hello timer, or the hello job if the timer wheel is used.
+   * \param delay the delay before the timer expires
+   */
+  void ScheduleHello (Time delay);
+  /// Cancel the hello timer or job.
+  void CancelHello ();
+  /// Get the timer wheel of the TimerTick attribute, if it is not zero.
+  void SetupTimerWheel ();
+  /**
+   * Reset the RREQ and RERR counts if one second has elapsed since the last
+   * reset, when the timer wheel is used; otherwise the rate limit timers
+   * reset them.
+   */
+  void UpdateRateLimits ();
+  /**
+   * \param timer the rate limit timer of the count
+   * \returns the delay left before the count is reset.
+   */
+  Time GetRateLimitDelayLeft (const Timer &timer) const;
   /// Map IP address + RREQ timer.
   std::map<Ipv4Address, Timer> m_addressReqTimer;
   /// Handle route discovery process
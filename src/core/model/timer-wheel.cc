@@ -0,0 +1,196 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "timer-wheel.h"
+#include "simulator.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimerWheel");
+
+TimerWheel::TimerWheel (Time tick)
+  : m_tick (tick.GetTimeStep ()),
+    m_nJobs (0),
+    m_destroyScheduled (false)
+{
+  NS_LOG_FUNCTION (this << tick);
+  NS_ASSERT_MSG (m_tick > 0, "The tick of a timer wheel must be positive");
+}
+
+TimerWheel::~TimerWheel ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TimerWheel::SharedWheels &
+TimerWheel::GetSharedWheels (void)
+{
+  static SharedWheels wheels;
+  return wheels;
+}
+
+void
+TimerWheel::ClearShared (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  GetSharedWheels ().clear ();
+}
+
+Ptr<TimerWheel>
+TimerWheel::GetShared (std::string service, Time tick)
+{
+  NS_LOG_FUNCTION (service << tick);
+  SharedWheels &wheels = GetSharedWheels ();
+  if (wheels.empty ())
+    {
+      // the next simulation must not inherit the wheels of this one, with
+      // the clients of its disposed objects
+      Simulator::ScheduleDestroy (&TimerWheel::ClearShared);
+    }
+  Ptr<TimerWheel> &wheel = wheels[std::make_pair (service, tick.GetTimeStep ())];
+  if (wheel == 0)
+    {
+      wheel = Create<TimerWheel> (tick);
+    }
+  return wheel;
+}
+
+Time
+TimerWheel::GetTick (void) const
+{
+  return TimeStep (m_tick);
+}
+
+uint32_t
+TimerWheel::AddClient (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_clients.push_back (true);
+  return m_clients.size () - 1;
+}
+
+void
+TimerWheel::RemoveClient (uint32_t client)
+{
+  NS_LOG_FUNCTION (this << client);
+  NS_ASSERT (client < m_clients.size ());
+  m_clients[client] = false;
+}
+
+uint32_t
+TimerWheel::GetNJobs (void) const
+{
+  return m_nJobs;
+}
+
+Ptr<EventImpl>
+TimerWheel::Schedule (uint32_t client, const Time &delay, const Ptr<EventImpl> &event)
+{
+  NS_LOG_FUNCTION (this << client << delay << event);
+  NS_ASSERT (client < m_clients.size () && m_clients[client]);
+  NS_ASSERT (!delay.IsStrictlyNegative ());
+  int64_t expire = Simulator::Now ().GetTimeStep () + delay.GetTimeStep ();
+  int64_t slot = (expire + m_tick - 1) / m_tick;
+  Job job;
+  job.client = client;
+  job.event = event;
+  uint32_t context = Simulator::GetContext ();
+  std::map<uint32_t, ContextJobs>::iterator i = m_contexts.find (context);
+  if (i == m_contexts.end ())
+    {
+      ContextJobs jobs;
+      jobs.running = false;
+      i = m_contexts.insert (std::make_pair (context, jobs)).first;
+    }
+  i->second.slots[slot].push_back (job);
+  m_nJobs++;
+  if (!i->second.running)
+    {
+      ScheduleTick (context, i->second);
+    }
+  return event;
+}
+
+void
+TimerWheel::ScheduleTick (uint32_t context, ContextJobs &jobs)
+{
+  NS_LOG_FUNCTION (this << context);
+  if (jobs.slots.empty ())
+    {
+      return;
+    }
+  int64_t slot = jobs.slots.begin ()->first;
+  // events scheduled with a context cannot be cancelled: the event of a
+  // later slot is left pending, and runs that slot when its time comes
+  if (!jobs.events.empty () && *jobs.events.begin () <= slot)
+    {
+      return;
+    }
+  if (!m_destroyScheduled)
+    {
+      // the simulator drops its events when it is destroyed: do the same,
+      // and keep this wheel alive until then
+      Simulator::ScheduleDestroy (&TimerWheel::Clear, Ptr<TimerWheel> (this));
+      m_destroyScheduled = true;
+    }
+  jobs.events.insert (slot);
+  Simulator::ScheduleWithContext (context, TimeStep (slot * m_tick) - Simulator::Now (),
+                                  &TimerWheel::Tick, this, context, slot);
+}
+
+void
+TimerWheel::Tick (uint32_t context, int64_t slot)
+{
+  NS_LOG_FUNCTION (this << context << slot);
+  ContextJobs &contextJobs = m_contexts[context];
+  contextJobs.events.erase (slot);
+  NS_ASSERT (!contextJobs.slots.empty () && contextJobs.slots.begin ()->first == slot);
+  std::vector<Job> jobs;
+  jobs.swap (contextJobs.slots.begin ()->second);
+  contextJobs.slots.erase (contextJobs.slots.begin ());
+  m_nJobs -= jobs.size ();
+  NS_LOG_LOGIC ("running " << jobs.size () << " jobs");
+  contextJobs.running = true;
+  for (std::vector<Job>::iterator i = jobs.begin (); i != jobs.end (); i++)
+    {
+      if (m_clients[i->client])
+        {
+          i->event->Invoke ();
+        }
+    }
+  contextJobs.running = false;
+  ScheduleTick (context, contextJobs);
+}
+
+void
+TimerWheel::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_contexts.clear ();
+  m_nJobs = 0;
+  // keep the identifiers of the clients, which may be removed later
+  m_clients.assign (m_clients.size (), false);
+  m_destroyScheduled = false;
+}
+
+} // namespace ns3
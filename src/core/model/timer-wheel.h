@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include "nstime.h"
+#include "event-impl.h"
+#include "make-event.h"
+#include "ptr.h"
+#include "simple-ref-count.h"
+
+/**
+ * \file
+ * \ingroup timer
+ * ns3::TimerWheel declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup timer
+ * \brief Run the timer jobs of many objects in batched ticks.
+ *
+ * The jobs are sorted into slots, one per tick: a job is run at the
+ * end of the first tick which is not earlier than its expiration time,
+ * so that it is delayed by less than a tick but never run early.  The
+ * jobs are kept apart by the simulation context, usually the node, in
+ * which they were scheduled, and run in that context: a simulator event
+ * is scheduled in each context for its earliest non-empty slot, and
+ * runs all the jobs of that slot in the order they were scheduled.
+ *
+ * Jobs are therefore only batched within a node: the objects of a node
+ * scheduling periodic jobs or expiration checks at nearby times share
+ * one event per tick instead of one event per job, but the jobs of
+ * different nodes due in the same tick still take one event per node.
+ *
+ * The objects scheduling jobs register as clients of the wheel, and
+ * remove themselves when they are disposed: the pending jobs of a
+ * removed client are dropped.  Each job can also be cancelled with
+ * EventImpl::Cancel.
+ */
+class TimerWheel : public SimpleRefCount<TimerWheel>
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] tick The duration of a tick, which must be positive
+   */
+  TimerWheel (Time tick);
+  /** Destructor. */
+  ~TimerWheel ();
+
+  /**
+   * Get the wheel shared by all the users of a service with the same
+   * tick, such as all the instances of a routing protocol.  The shared
+   * wheels are released when the simulator is destroyed, so that each
+   * simulation gets new ones.
+   *
+   * \param [in] service The name of the service
+   * \param [in] tick The duration of a tick
+   * \returns The wheel
+   */
+  static Ptr<TimerWheel> GetShared (std::string service, Time tick);
+
+  /** \returns The duration of a tick. */
+  Time GetTick (void) const;
+
+  /**
+   * Register a new client.
+   *
+   * \returns The identifier of the client
+   */
+  uint32_t AddClient (void);
+  /**
+   * Remove a client, and drop its pending jobs.
+   *
+   * \param [in] client The identifier of the client
+   */
+  void RemoveClient (uint32_t client);
+
+  /** \returns The number of pending jobs, including dropped ones. */
+  uint32_t GetNJobs (void) const;
+
+  /**
+   * Schedule a job.
+   *
+   * \param [in] client The client scheduling the job
+   * \param [in] delay The minimum delay before the job runs
+   * \param [in] event The job
+   * \returns The job, which can be cancelled
+   */
+  Ptr<EventImpl> Schedule (uint32_t client, const Time &delay, const Ptr<EventImpl> &event);
+
+  /**
+   * \copybrief Schedule(uint32_t,const Time&,const Ptr<EventImpl>&)
+   *
+   * \tparam MEM \deduced Class method function signature type.
+   * \tparam OBJ \deduced Class type of the object.
+   * \param [in] client The client scheduling the job
+   * \param [in] delay The minimum delay before the job runs
+   * \param [in] mem_ptr Member method pointer to invoke
+   * \param [in] obj The object on which to invoke the member method
+   * \returns The job, which can be cancelled
+   */
+  template <typename MEM, typename OBJ>
+  Ptr<EventImpl> Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj);
+
+  /**
+   * \copybrief Schedule(uint32_t,const Time&,MEM,OBJ)
+   *
+   * \tparam MEM \deduced Class method function signature type.
+   * \tparam OBJ \deduced Class type of the object.
+   * \tparam T1 \deduced Type of first argument.
+   * \param [in] client The client scheduling the job
+   * \param [in] delay The minimum delay before the job runs
+   * \param [in] mem_ptr Member method pointer to invoke
+   * \param [in] obj The object on which to invoke the member method
+   * \param [in] a1 The first argument to pass to the method
+   * \returns The job, which can be cancelled
+   */
+  template <typename MEM, typename OBJ, typename T1>
+  Ptr<EventImpl> Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj, T1 a1);
+
+  /**
+   * \copybrief Schedule(uint32_t,const Time&,MEM,OBJ)
+   *
+   * \tparam MEM \deduced Class method function signature type.
+   * \tparam OBJ \deduced Class type of the object.
+   * \tparam T1 \deduced Type of first argument.
+   * \tparam T2 \deduced Type of second argument.
+   * \param [in] client The client scheduling the job
+   * \param [in] delay The minimum delay before the job runs
+   * \param [in] mem_ptr Member method pointer to invoke
+   * \param [in] obj The object on which to invoke the member method
+   * \param [in] a1 The first argument to pass to the method
+   * \param [in] a2 The second argument to pass to the method
+   * \returns The job, which can be cancelled
+   */
+  template <typename MEM, typename OBJ, typename T1, typename T2>
+  Ptr<EventImpl> Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj, T1 a1, T2 a2);
+
+  /**
+   * \copybrief Schedule(uint32_t,const Time&,MEM,OBJ)
+   *
+   * \tparam MEM \deduced Class method function signature type.
+   * \tparam OBJ \deduced Class type of the object.
+   * \tparam T1 \deduced Type of first argument.
+   * \tparam T2 \deduced Type of second argument.
+   * \tparam T3 \deduced Type of third argument.
+   * \param [in] client The client scheduling the job
+   * \param [in] delay The minimum delay before the job runs
+   * \param [in] mem_ptr Member method pointer to invoke
+   * \param [in] obj The object on which to invoke the member method
+   * \param [in] a1 The first argument to pass to the method
+   * \param [in] a2 The second argument to pass to the method
+   * \param [in] a3 The third argument to pass to the method
+   * \returns The job, which can be cancelled
+   */
+  template <typename MEM, typename OBJ, typename T1, typename T2, typename T3>
+  Ptr<EventImpl> Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj,
+                           T1 a1, T2 a2, T3 a3);
+
+private:
+  /** A pending job. */
+  struct Job
+  {
+    uint32_t client;        //!< The client which scheduled the job
+    Ptr<EventImpl> event;   //!< The job
+  };
+  /** The jobs of the slots, indexed by the number of the tick. */
+  typedef std::map<int64_t, std::vector<Job> > Slots;
+  /** The pending jobs of a simulation context. */
+  struct ContextJobs
+  {
+    Slots slots;            //!< The pending jobs
+    std::set<int64_t> events; //!< The slots with a pending event
+    bool running;           //!< Whether the jobs of a slot are running
+  };
+  /** The wheels shared by the services, indexed by service and tick. */
+  typedef std::map<std::pair<std::string, int64_t>, Ptr<TimerWheel> > SharedWheels;
+
+  /**
+   * Run the jobs of a slot of a context.
+   *
+   * \param [in] context The context
+   * \param [in] slot The slot
+   */
+  void Tick (uint32_t context, int64_t slot);
+  /**
+   * Schedule the event of the earliest slot of a context, if needed.
+   *
+   * \param [in] context The context
+   * \param [in] jobs The jobs of the context
+   */
+  void ScheduleTick (uint32_t context, ContextJobs &jobs);
+  /** Drop all the jobs and clients, when the simulator is destroyed. */
+  void Clear (void);
+  /** \returns The wheels shared by the services. */
+  static SharedWheels &GetSharedWheels (void);
+  /** Release the shared wheels, when the simulator is destroyed. */
+  static void ClearShared (void);
+
+  int64_t m_tick;                 //!< The duration of a tick, in time steps
+  /** The pending jobs, by context. */
+  std::map<uint32_t, ContextJobs> m_contexts;
+  uint32_t m_nJobs;               //!< The number of pending jobs
+  std::vector<bool> m_clients;    //!< Whether each client is registered
+  bool m_destroyScheduled;        //!< Whether Clear is scheduled at simulator destruction
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename MEM, typename OBJ>
+Ptr<EventImpl>
+TimerWheel::Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj)
+{
+  return Schedule (client, delay, Ptr<EventImpl> (MakeEvent (mem_ptr, obj), false));
+}
+
+template <typename MEM, typename OBJ, typename T1>
+Ptr<EventImpl>
+TimerWheel::Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj, T1 a1)
+{
+  return Schedule (client, delay, Ptr<EventImpl> (MakeEvent (mem_ptr, obj, a1), false));
+}
+
+template <typename MEM, typename OBJ, typename T1, typename T2>
+Ptr<EventImpl>
+TimerWheel::Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj, T1 a1, T2 a2)
+{
+  return Schedule (client, delay, Ptr<EventImpl> (MakeEvent (mem_ptr, obj, a1, a2), false));
+}
+
+template <typename MEM, typename OBJ, typename T1, typename T2, typename T3>
+Ptr<EventImpl>
+TimerWheel::Schedule (uint32_t client, const Time &delay, MEM mem_ptr, OBJ obj, T1 a1, T2 a2, T3 a3)
+{
+  return Schedule (client, delay, Ptr<EventImpl> (MakeEvent (mem_ptr, obj, a1, a2, a3), false));
+}
+
+} // namespace ns3
+
+#endif /* TIMER_WHEEL_H */
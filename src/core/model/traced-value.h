@@ -207,7 +207,11 @@ public:
   void Set (const T &v) {
     if (m_v != v)
       {
-        m_cb (m_v, v);
+        // an unobserved value only costs the comparison and the store
+        if (!m_cb.IsEmpty ())
+          {
+            m_cb (m_v, v);
+          }
         m_v = v;
       }
   }
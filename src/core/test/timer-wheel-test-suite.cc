@@ -0,0 +1,154 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/timer-wheel.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+class TimerWheelTestCase : public TestCase
+{
+public:
+  TimerWheelTestCase ();
+  virtual void DoRun (void);
+  void Job (int id);
+  void Reschedule (int id, Time delay);
+  Ptr<TimerWheel> m_wheel;
+  uint32_t m_client;
+  std::vector<std::pair<int, Time> > m_runs;
+};
+
+TimerWheelTestCase::TimerWheelTestCase ()
+  : TestCase ("Check that the jobs of a timer wheel run in batched ticks")
+{
+}
+
+void
+TimerWheelTestCase::Job (int id)
+{
+  m_runs.push_back (std::make_pair (id, Simulator::Now ()));
+}
+
+void
+TimerWheelTestCase::Reschedule (int id, Time delay)
+{
+  Job (id);
+  m_wheel->Schedule (m_client, delay, &TimerWheelTestCase::Job, this, id + 1);
+}
+
+void
+TimerWheelTestCase::DoRun (void)
+{
+  m_wheel = Create<TimerWheel> (MilliSeconds (10));
+  m_client = m_wheel->AddClient ();
+  uint32_t removed = m_wheel->AddClient ();
+  m_wheel->Schedule (m_client, MilliSeconds (25), &TimerWheelTestCase::Job, this, 1);
+  m_wheel->Schedule (m_client, MilliSeconds (21), &TimerWheelTestCase::Job, this, 2);
+  m_wheel->Schedule (m_client, MilliSeconds (30), &TimerWheelTestCase::Job, this, 3);
+  m_wheel->Schedule (m_client, MilliSeconds (3), &TimerWheelTestCase::Job, this, 4);
+  Ptr<EventImpl> cancelled = m_wheel->Schedule (m_client, MilliSeconds (3), &TimerWheelTestCase::Job, this, 5);
+  cancelled->Cancel ();
+  m_wheel->Schedule (removed, MilliSeconds (3), &TimerWheelTestCase::Job, this, 6);
+  m_wheel->RemoveClient (removed);
+  // a job scheduled from a job, with no delay, runs in the same tick
+  m_wheel->Schedule (m_client, MilliSeconds (45), &TimerWheelTestCase::Reschedule, this, 7, Seconds (0));
+  // a job scheduled on a tick boundary is not delayed; this event was
+  // scheduled before the one of the tick, and runs first
+  Simulator::Schedule (MilliSeconds (50), &TimerWheelTestCase::Reschedule, this, 9, MilliSeconds (20));
+  NS_TEST_EXPECT_MSG_EQ (m_wheel->GetNJobs (), 7, "Wrong number of pending jobs");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (m_wheel->GetNJobs (), 0, "Pending jobs left");
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_runs.size (), 8, "Wrong number of jobs run");
+  int ids[] = { 4, 1, 2, 3, 9, 7, 8, 10 };
+  int ms[] = { 10, 30, 30, 30, 50, 50, 50, 70 };
+  for (uint32_t i = 0; i < m_runs.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_runs[i].first, ids[i], "Jobs run out of order");
+      NS_TEST_EXPECT_MSG_EQ (m_runs[i].second, MilliSeconds (ms[i]), "Job run at the wrong time");
+    }
+}
+
+class TimerWheelContextTestCase : public TestCase
+{
+public:
+  TimerWheelContextTestCase ();
+  virtual void DoRun (void);
+  void Schedule (Time delay);
+  void Job (uint32_t context);
+  Ptr<TimerWheel> m_wheel;
+  uint32_t m_client;
+  std::vector<std::pair<uint32_t, Time> > m_runs;
+};
+
+TimerWheelContextTestCase::TimerWheelContextTestCase ()
+  : TestCase ("Check that the jobs of a shared timer wheel run in their own context")
+{
+}
+
+void
+TimerWheelContextTestCase::Schedule (Time delay)
+{
+  m_wheel->Schedule (m_client, delay, &TimerWheelContextTestCase::Job, this, Simulator::GetContext ());
+}
+
+void
+TimerWheelContextTestCase::Job (uint32_t context)
+{
+  NS_TEST_EXPECT_MSG_EQ (Simulator::GetContext (), context, "Job run in the wrong context");
+  m_runs.push_back (std::make_pair (context, Simulator::Now ()));
+}
+
+void
+TimerWheelContextTestCase::DoRun (void)
+{
+  m_wheel = TimerWheel::GetShared ("ns3::TimerWheelContextTestCase", MilliSeconds (10));
+  NS_TEST_EXPECT_MSG_EQ (TimerWheel::GetShared ("ns3::TimerWheelContextTestCase", MilliSeconds (10)),
+                         m_wheel, "Wheel not shared");
+  m_client = m_wheel->AddClient ();
+  Simulator::ScheduleWithContext (1, MilliSeconds (2), &TimerWheelContextTestCase::Schedule, this, MilliSeconds (5));
+  Simulator::ScheduleWithContext (2, MilliSeconds (4), &TimerWheelContextTestCase::Schedule, this, MilliSeconds (3));
+  Simulator::ScheduleWithContext (1, MilliSeconds (6), &TimerWheelContextTestCase::Schedule, this, MilliSeconds (1));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the jobs of each context share the event of their tick
+  NS_TEST_ASSERT_MSG_EQ (m_runs.size (), 3, "Wrong number of jobs run");
+  uint32_t contexts[] = { 1, 1, 2 };
+  for (uint32_t i = 0; i < m_runs.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_runs[i].first, contexts[i], "Jobs run out of order");
+      NS_TEST_EXPECT_MSG_EQ (m_runs[i].second, MilliSeconds (10), "Job run at the wrong time");
+    }
+
+  // the next simulation gets a new wheel
+  NS_TEST_EXPECT_MSG_NE (TimerWheel::GetShared ("ns3::TimerWheelContextTestCase", MilliSeconds (10)),
+                         m_wheel, "Wheel shared with a destroyed simulation");
+  Simulator::Destroy ();
+  m_wheel = 0;
+}
+
+static class TimerWheelTestSuite : public TestSuite
+{
+public:
+  TimerWheelTestSuite ()
+    : TestSuite ("timer-wheel", UNIT)
+  {
+    AddTestCase (new TimerWheelTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerWheelContextTestCase (), TestCase::QUICK);
+  }
+} g_timerWheelTestSuite;
@@ -70,6 +70,7 @@ DsrMaintainBuffer::Enqueue (DsrMaintainBuffEntry & entry)
     }
 
   entry.SetExpireTime (m_maintainBufferTimeout);
+  m_nextExpire = std::min (m_nextExpire, Simulator::Now () + entry.GetExpireTime ());
   if (m_maintainBuffer.size () >= m_maxLen)
     {
       NS_LOG_DEBUG ("Drop the most aged packet");
@@ -223,7 +224,21 @@ void
 DsrMaintainBuffer::Purge ()
 {
   NS_LOG_DEBUG ("Purging Maintenance Buffer");
+  if (Simulator::Now () <= m_nextExpire)
+    {
+      // No entry has expired yet, there is no need to scan the buffer
+      return;
+    }
   IsExpired pred;
+  m_nextExpire = Time::Max ();
+  for (std::vector<DsrMaintainBuffEntry>::const_iterator i = m_maintainBuffer.begin (); i
+       != m_maintainBuffer.end (); ++i)
+    {
+      if (!pred (*i))
+        {
+          m_nextExpire = std::min (m_nextExpire, Simulator::Now () + i->GetExpireTime ());
+        }
+    }
   m_maintainBuffer.erase (std::remove_if (m_maintainBuffer.begin (), m_maintainBuffer.end (), pred),
                           m_maintainBuffer.end ());
 }
@@ -254,6 +254,7 @@ public:
    * Default constructor
    */
   DsrMaintainBuffer ()
+    : m_nextExpire (Time::Max ())
   {
   }
   /// Push entry in queue, if there is no entry with the same packet and destination address in queue.
@@ -299,6 +300,8 @@ private:
   std::vector<NetworkKey> m_allNetworkKey;
   /// Remove all expired entries
   void Purge ();
+  /// Lower bound of the expiration times of the entries, before which Purge has nothing to remove
+  Time m_nextExpire;
   /// The maximum number of packets that we allow a routing protocol to buffer.
   uint32_t m_maxLen;
   /// The maximum period of time that a routing protocol is allowed to buffer a packet for, seconds.
@@ -146,8 +146,10 @@ TypeId DsrRouteCache::GetTypeId ()
 
 DsrRouteCache::DsrRouteCache ()
   : m_vector (0),
+    m_nextExpire (Time::Max ()),
     m_maxEntriesEachDst (3),
     m_isLinkCache (false),
+    m_nextLinkNodeExpire (Time::Max ()),
     m_ntimer (Timer::CANCEL_ON_DESTROY),
     m_delay (MilliSeconds (100))
 {
@@ -190,6 +192,7 @@ DsrRouteCache::UpdateRouteEntry (Ipv4Address dst)
       std::list<DsrRouteCacheEntry> rtVector = i->second;
       DsrRouteCacheEntry successEntry = rtVector.front ();
       successEntry.SetExpireTime (RouteCacheTimeout);
+      UpdateNextExpire (successEntry.GetExpireTime ());
       rtVector.pop_front ();
       rtVector.push_back (successEntry);
       rtVector.sort (CompareRoutesExpire);      // sort the route vector first
@@ -224,10 +227,11 @@ DsrRouteCache::LookupRoute (Ipv4Address id, DsrRouteCacheEntry & rt)
       if (i == m_sortedRoutes.end ())
         {
           NS_LOG_LOGIC ("No Direct Route to " << id << " found");
+          std::list<DsrRouteCacheEntry> newVector;
           for (std::map<Ipv4Address, std::list<DsrRouteCacheEntry> >::const_iterator j =
                  m_sortedRoutes.begin (); j != m_sortedRoutes.end (); ++j)
             {
-              std::list<DsrRouteCacheEntry> rtVector = j->second; // The route cache vector linked with destination address
+              const std::list<DsrRouteCacheEntry> &rtVector = j->second; // The route cache vector linked with destination address
               /*
                * Loop through the possibly multiple routes within the route vector
                */
@@ -260,15 +264,18 @@ DsrRouteCache::LookupRoute (Ipv4Address id, DsrRouteCacheEntry & rt)
                       changeEntry.SetDestination (id);
                       // Use the expire time from original route entry
                       changeEntry.SetExpireTime (k->GetExpireTime ());
-                      // We need to add new route entry here
-                      std::list<DsrRouteCacheEntry> newVector;
+                      // We need to add new route entry here, the last sub route found is kept
+                      newVector.clear ();
                       newVector.push_back (changeEntry);
-                      newVector.sort (CompareRoutesExpire);  // sort the route vector first
-                      m_sortedRoutes[id] = newVector;   // Only get the first sub route and add it in route cache
                       NS_LOG_INFO ("We have a sub-route to " << id << " add it in route cache");
                     }
                 }
             }
+          if (!newVector.empty ())
+            {
+              // Add the sub route once the scan is done, not to modify the cache while iterating on it
+              m_sortedRoutes[id] = newVector;
+            }
         }
       NS_LOG_INFO ("Here we check the route cache again after updated the sub routes");
       std::map<Ipv4Address, std::list<DsrRouteCacheEntry> >::const_iterator m = m_sortedRoutes.find (id);
@@ -280,7 +287,7 @@ DsrRouteCache::LookupRoute (Ipv4Address id, DsrRouteCacheEntry & rt)
       /*
        * We have a direct route to the destination address
        */
-      std::list<DsrRouteCacheEntry> rtVector = m->second;
+      const std::list<DsrRouteCacheEntry> &rtVector = m->second;
       rt = rtVector.front ();  // use the first entry in the route vector
       NS_LOG_LOGIC ("Route to " << id << " with route size " << rtVector.size ());
       return true;
@@ -465,6 +472,12 @@ void
 DsrRouteCache::PurgeLinkNode ()
 {
   NS_LOG_FUNCTION (this);
+  if (Simulator::Now () < m_nextLinkNodeExpire)
+    {
+      NS_LOG_LOGIC ("No link or node has expired yet");
+      return;
+    }
+  m_nextLinkNodeExpire = Time::Max ();
   for (std::map<Link, DsrLinkStab>::iterator i = m_linkCache.begin (); i != m_linkCache.end (); )
     {
       NS_LOG_DEBUG ("The link stability " << i->second.GetLinkStability ().GetSeconds ());
@@ -476,6 +489,7 @@ DsrRouteCache::PurgeLinkNode ()
         }
       else
         {
+          UpdateNextLinkNodeExpire (i->second.GetLinkStability ());
           ++i;
         }
     }
@@ -491,11 +505,18 @@ DsrRouteCache::PurgeLinkNode ()
         }
       else
         {
+          UpdateNextLinkNodeExpire (i->second.GetNodeStability ());
           ++i;
         }
     }
 }
 
+void
+DsrRouteCache::UpdateNextLinkNodeExpire (Time stability)
+{
+  m_nextLinkNodeExpire = std::min (m_nextLinkNodeExpire, Simulator::Now () + stability);
+}
+
 void
 DsrRouteCache::UpdateNetGraph ()
 {
@@ -521,6 +542,7 @@ DsrRouteCache::IncStability (Ipv4Address node)
       NS_LOG_INFO ("The initial stability " << m_initStability.GetSeconds ());
       DsrNodeStab ns (m_initStability);
       m_nodeCache[node] = ns;
+      UpdateNextLinkNodeExpire (m_initStability);
       return false;
     }
   else
@@ -530,6 +552,7 @@ DsrRouteCache::IncStability (Ipv4Address node)
       NS_LOG_INFO ("The stability here " << Time (i->second.GetNodeStability () * m_stabilityIncrFactor).GetSeconds ());
       DsrNodeStab ns (Time (i->second.GetNodeStability () * m_stabilityIncrFactor));
       m_nodeCache[node] = ns;
+      UpdateNextLinkNodeExpire (ns.GetNodeStability ());
       return true;
     }
   return false;
@@ -544,6 +567,7 @@ DsrRouteCache::DecStability (Ipv4Address node)
     {
       DsrNodeStab ns (m_initStability);
       m_nodeCache[node] = ns;
+      UpdateNextLinkNodeExpire (m_initStability);
       return false;
     }
   else
@@ -553,6 +577,7 @@ DsrRouteCache::DecStability (Ipv4Address node)
       NS_LOG_INFO ("The stability here " << Time (i->second.GetNodeStability () / m_stabilityDecrFactor).GetSeconds ());
       DsrNodeStab ns (Time (i->second.GetNodeStability () / m_stabilityDecrFactor));
       m_nodeCache[node] = ns;
+      UpdateNextLinkNodeExpire (ns.GetNodeStability ());
       return true;
     }
   return false;
@@ -569,6 +594,7 @@ DsrRouteCache::AddRoute_Link (DsrRouteCacheEntry::IP_VECTOR nodelist, Ipv4Addres
     {
       DsrNodeStab ns;                /// This is the node stability
       ns.SetNodeStability (m_initStability);
+      UpdateNextLinkNodeExpire (m_initStability);
 
       if (m_nodeCache.find (nodelist[i]) == m_nodeCache.end ())
         {
@@ -597,6 +623,7 @@ DsrRouteCache::AddRoute_Link (DsrRouteCacheEntry::IP_VECTOR nodelist, Ipv4Addres
           stab.SetLinkStability (m_minLifeTime);
         }
       m_linkCache[link] = stab;
+      UpdateNextLinkNodeExpire (stab.GetLinkStability ());
       NS_LOG_DEBUG ("Add a new link");
       link.Print ();
       NS_LOG_DEBUG ("Link Info");
@@ -669,6 +696,7 @@ DsrRouteCache::AddRoute (DsrRouteCacheEntry & rt)
   if (i == m_sortedRoutes.end ())
     {
       rtVector.push_back (rt);
+      UpdateNextExpire (rt.GetExpireTime ());
       m_sortedRoutes.erase (dst);   // Erase the route entries for dst first
       /**
        * Save the new route cache along with the destination address in map
@@ -700,6 +728,7 @@ DsrRouteCache::AddRoute (DsrRouteCacheEntry & rt)
           if (rt.GetExpireTime () > Time (0))
             {
               rtVector.push_back (rt);
+              UpdateNextExpire (rt.GetExpireTime ());
               // This sort function will sort the route cache entries based on the size of route in each of the
               // route entries
               rtVector.sort (CompareRoutesExpire);
@@ -971,6 +1000,12 @@ DsrRouteCache::Purge ()
       NS_LOG_DEBUG ("The route cache is empty");
       return;
     }
+  if (Simulator::Now () < m_nextExpire)
+    {
+      NS_LOG_DEBUG ("No route has expired yet");
+      return;
+    }
+  m_nextExpire = Time::Max ();
   for (std::map<Ipv4Address, std::list<DsrRouteCacheEntry> >::iterator i =
          m_sortedRoutes.begin (); i != m_sortedRoutes.end (); )
     {
@@ -980,54 +1015,44 @@ DsrRouteCache::Purge ()
        * The route cache entry vector
        */
       Ipv4Address dst = i->first;
-      std::list<DsrRouteCacheEntry> rtVector = i->second;
+      std::list<DsrRouteCacheEntry> &rtVector = i->second;
       NS_LOG_DEBUG ("The route vector size of 1 " << dst << " " << rtVector.size ());
-      if (rtVector.size ())
+      for (std::list<DsrRouteCacheEntry>::iterator j = rtVector.begin (); j != rtVector.end (); )
         {
-          for (std::list<DsrRouteCacheEntry>::iterator j = rtVector.begin (); j != rtVector.end (); )
-            {
-              NS_LOG_DEBUG ("The expire time of every entry with expire time " << j->GetExpireTime ());
-              /*
-               * First verify if the route has expired or not
-               */
-              if (j->GetExpireTime () <= Seconds (0))
-                {
-                  /*
-                   * When the expire time has passed, erase the certain route
-                   */
-                  NS_LOG_DEBUG ("Erase the expired route for " << dst << " with expire time " << j->GetExpireTime ());
-                  j = rtVector.erase (j);
-                }
-              else
-                {
-                  ++j;
-                }
-            }
-          NS_LOG_DEBUG ("The route vector size of 2 " << dst << " " << rtVector.size ());
-          if (rtVector.size ())
+          NS_LOG_DEBUG ("The expire time of every entry with expire time " << j->GetExpireTime ());
+          /*
+           * First verify if the route has expired or not
+           */
+          if (j->GetExpireTime () <= Seconds (0))
             {
-              ++i;
-              m_sortedRoutes.erase (itmp); // erase the entry first
               /*
-               * Save the new route cache along with the destination address in map
+               * When the expire time has passed, erase the certain route
                */
-              m_sortedRoutes.insert (std::make_pair (dst, rtVector));
+              NS_LOG_DEBUG ("Erase the expired route for " << dst << " with expire time " << j->GetExpireTime ());
+              j = rtVector.erase (j);
             }
           else
             {
-              ++i;
-              m_sortedRoutes.erase (itmp);
+              UpdateNextExpire (j->GetExpireTime ());
+              ++j;
             }
         }
-      else
+      NS_LOG_DEBUG ("The route vector size of 2 " << dst << " " << rtVector.size ());
+      ++i;
+      if (rtVector.empty ())
         {
-          ++i;
           m_sortedRoutes.erase (itmp);
         }
     }
   return;
 }
 
+void
+DsrRouteCache::UpdateNextExpire (Time expire)
+{
+  m_nextExpire = std::min (m_nextExpire, Simulator::Now () + expire);
+}
+
 void
 DsrRouteCache::Print (std::ostream &os)
 {
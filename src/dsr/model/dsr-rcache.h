@@ -553,6 +553,8 @@ private:
 
   std::map<Ipv4Address, routeEntryVector> m_sortedRoutes;       ///< Map the ipv4Address to route entry vector
 
+  Time m_nextExpire;                                            ///< Lower bound of the expiration times of the path cache entries, before which Purge has nothing to remove
+
   routeEntryVector m_routeEntryVector;                          ///< Define the route vector
 
   uint32_t m_maxEntriesEachDst;                                 ///< number of entries for each destination
@@ -577,6 +579,17 @@ private:
   std::map<Ipv4Address, DsrRouteCacheEntry::IP_VECTOR> m_bestRoutesTable_link;     ///< for link route cache
   std::map<Link, DsrLinkStab> m_linkCache;                                         ///< The data structure to store link info
   std::map<Ipv4Address, DsrNodeStab> m_nodeCache;                                  ///< The data structure to store node info
+  Time m_nextLinkNodeExpire;                                                       ///< Lower bound of the expiration times of the link and node cache entries
+  /**
+   * \brief lower the earliest expiration time of the path cache, if needed
+   * \param expire the time left before a route cache entry added or updated expires
+   */
+  void UpdateNextExpire (Time expire);
+  /**
+   * \brief lower the earliest expiration time of the link and node caches, if needed
+   * \param stability the time left before a link or node cache entry added or updated expires
+   */
+  void UpdateNextLinkNodeExpire (Time stability);
   /**
    * \brief used by LookupRoute when LinkCache
    * \param id the ip address we are looking for
@@ -67,6 +67,7 @@ DsrSendBuffer::Enqueue (DsrSendBuffEntry & entry)
     }
 
   entry.SetExpireTime (m_sendBufferTimeout);     // Initialize the send buffer timeout
+  m_nextExpire = std::min (m_nextExpire, Simulator::Now () + entry.GetExpireTime ());
   /*
    * Drop the most aged packet when buffer reaches to max
    */
@@ -155,7 +156,13 @@ DsrSendBuffer::Purge ()
    * Purge the buffer to eliminate expired entries
    */
   NS_LOG_INFO ("The send buffer size " << m_sendBuffer.size ());
+  if (Simulator::Now () <= m_nextExpire)
+    {
+      // No entry has expired yet, there is no need to scan the buffer
+      return;
+    }
   IsExpired pred;
+  m_nextExpire = Time::Max ();
   for (std::vector<DsrSendBuffEntry>::iterator i = m_sendBuffer.begin (); i
        != m_sendBuffer.end (); ++i)
     {
@@ -164,6 +171,10 @@ DsrSendBuffer::Purge ()
           NS_LOG_DEBUG ("Dropping Queue Packets");
           Drop (*i, "Drop out-dated packet ");
         }
+      else
+        {
+          m_nextExpire = std::min (m_nextExpire, Simulator::Now () + i->GetExpireTime ());
+        }
     }
   m_sendBuffer.erase (std::remove_if (m_sendBuffer.begin (), m_sendBuffer.end (), pred),
                       m_sendBuffer.end ());
@@ -128,6 +128,7 @@ public:
    * Default constructor
    */
   DsrSendBuffer ()
+    : m_nextExpire (Time::Max ())
   {
   }
   /**
@@ -220,6 +221,7 @@ private:
 
   std::vector<DsrSendBuffEntry> m_sendBuffer;                   ///< The send buffer to cache unsent packet
   void Purge ();                                                ///< Remove all expired entries
+  Time m_nextExpire;                                            ///< Lower bound of the expiration times of the entries, before which Purge has nothing to remove
   void Drop (DsrSendBuffEntry en, std::string reason);          ///< Notify that packet is dropped from queue by timeout
   uint32_t m_maxLen;                                            ///< The maximum number of packets that we allow a routing protocol to buffer.
   Time m_sendBufferTimeout;                                     ///< The maximum period of time that a routing protocol is allowed to buffer a packet for, seconds.
@@ -478,6 +478,124 @@ DsrSendBuffTest::CheckTimeout ()
   NS_TEST_EXPECT_MSG_EQ (q.GetSize (), 0, "Must be empty now");
 }
 // -----------------------------------------------------------------------------
+// / Unit test for the expiration of the DSR route caches and send buffer
+class DsrCacheExpireTest : public TestCase
+{
+public:
+  DsrCacheExpireTest ();
+  ~DsrCacheExpireTest ();
+  virtual void
+  DoRun (void);
+  void CheckRoute (Ptr<dsr::DsrRouteCache> rcache, Ipv4Address dst, bool found);
+  void AddRoute (Ipv4Address dst, Time expire);
+  void UpdateRoute (Ipv4Address dst, Time timeout);
+  void DeleteLink (Ipv4Address source);
+  void CheckSize (uint32_t size);
+
+  Ptr<dsr::DsrRouteCache> m_pathCache;
+  Ptr<dsr::DsrRouteCache> m_linkCache;
+  dsr::DsrSendBuffer q;
+};
+DsrCacheExpireTest::DsrCacheExpireTest ()
+  : TestCase ("DSR cache expiration")
+{
+}
+DsrCacheExpireTest::~DsrCacheExpireTest ()
+{
+}
+void
+DsrCacheExpireTest::CheckRoute (Ptr<dsr::DsrRouteCache> rcache, Ipv4Address dst, bool found)
+{
+  dsr::DsrRouteCacheEntry entry;
+  NS_TEST_EXPECT_MSG_EQ (rcache->LookupRoute (dst, entry), found, "Wrong route to " << dst << " at " << Simulator::Now ().GetSeconds ());
+}
+void
+DsrCacheExpireTest::AddRoute (Ipv4Address dst, Time expire)
+{
+  std::vector<Ipv4Address> ip;
+  ip.push_back (Ipv4Address ("1.0.0.0"));
+  ip.push_back (dst);
+  dsr::DsrRouteCacheEntry entry (ip, dst, expire);
+  m_pathCache->AddRoute (entry);
+}
+void
+DsrCacheExpireTest::UpdateRoute (Ipv4Address dst, Time timeout)
+{
+  m_pathCache->SetCacheTimeout (timeout);
+  m_pathCache->UpdateRouteEntry (dst);
+}
+void
+DsrCacheExpireTest::DeleteLink (Ipv4Address source)
+{
+  // rebuild the best routes of the link cache from the links left
+  m_linkCache->DeleteAllRoutesIncludeLink (Ipv4Address ("9.9.9.9"), Ipv4Address ("9.9.9.8"), source);
+}
+void
+DsrCacheExpireTest::CheckSize (uint32_t size)
+{
+  NS_TEST_EXPECT_MSG_EQ (q.GetSize (), size, "Wrong send buffer size at " << Simulator::Now ().GetSeconds ());
+}
+void
+DsrCacheExpireTest::DoRun ()
+{
+  m_pathCache = CreateObject<dsr::DsrRouteCache> ();
+  std::vector<Ipv4Address> ip;
+  ip.push_back (Ipv4Address ("1.0.0.0"));
+  ip.push_back (Ipv4Address ("1.0.0.1"));
+  ip.push_back (Ipv4Address ("1.0.0.2"));
+  dsr::DsrRouteCacheEntry entry (ip, Ipv4Address ("1.0.0.2"), Seconds (5));
+  m_pathCache->AddRoute (entry);
+  AddRoute (Ipv4Address ("1.0.0.3"), Seconds (10));
+  // the sub route to 1.0.0.1 expires with the route it was taken from
+  Simulator::Schedule (Seconds (1), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.2"), true);
+  Simulator::Schedule (Seconds (1), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.1"), true);
+  Simulator::Schedule (Seconds (6), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.2"), false);
+  Simulator::Schedule (Seconds (6), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.1"), false);
+  Simulator::Schedule (Seconds (6), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.3"), true);
+  // a route added later may expire before the ones left
+  Simulator::Schedule (Seconds (6), &DsrCacheExpireTest::AddRoute, this, Ipv4Address ("1.0.0.4"), Seconds (2));
+  Simulator::Schedule (Seconds (7), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.4"), true);
+  Simulator::Schedule (Seconds (9), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.4"), false);
+  Simulator::Schedule (Seconds (9), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.3"), true);
+  Simulator::Schedule (Seconds (11), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.3"), false);
+  // a route used again expires after the route cache timeout, even if it was due later
+  AddRoute (Ipv4Address ("1.0.0.5"), Seconds (20));
+  Simulator::Schedule (Seconds (12), &DsrCacheExpireTest::UpdateRoute, this, Ipv4Address ("1.0.0.5"), Seconds (1));
+  Simulator::Schedule (Seconds (12.5), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.5"), true);
+  Simulator::Schedule (Seconds (14), &DsrCacheExpireTest::CheckRoute, this, m_pathCache, Ipv4Address ("1.0.0.5"), false);
+
+  m_linkCache = CreateObject<dsr::DsrRouteCache> ();
+  m_linkCache->SetCacheType ("LinkCache");
+  m_linkCache->SetInitStability (Seconds (2));
+  m_linkCache->SetMinLifeTime (Seconds (1));
+  m_linkCache->SetUseExtends (Seconds (1));
+  m_linkCache->SetStabilityDecrFactor (2);
+  m_linkCache->SetStabilityIncrFactor (4);
+  std::vector<Ipv4Address> nodes;
+  nodes.push_back (Ipv4Address ("2.0.0.0"));
+  nodes.push_back (Ipv4Address ("2.0.0.1"));
+  nodes.push_back (Ipv4Address ("2.0.0.2"));
+  m_linkCache->AddRoute_Link (nodes, Ipv4Address ("2.0.0.0"));
+  Simulator::Schedule (Seconds (1), &DsrCacheExpireTest::DeleteLink, this, Ipv4Address ("2.0.0.0"));
+  Simulator::Schedule (Seconds (1), &DsrCacheExpireTest::CheckRoute, this, m_linkCache, Ipv4Address ("2.0.0.2"), true);
+  Simulator::Schedule (Seconds (3), &DsrCacheExpireTest::DeleteLink, this, Ipv4Address ("2.0.0.0"));
+  Simulator::Schedule (Seconds (3), &DsrCacheExpireTest::CheckRoute, this, m_linkCache, Ipv4Address ("2.0.0.2"), false);
+
+  q.SetMaxQueueLen (32);
+  q.SetSendBufferTimeout (Seconds (10));
+  Ptr<const Packet> packet = Create<Packet> ();
+  dsr::DsrSendBuffEntry e1 (packet, Ipv4Address ("0.0.0.1"), Seconds (1));
+  q.Enqueue (e1);
+  dsr::DsrSendBuffEntry e2 (packet, Ipv4Address ("0.0.0.2"), Seconds (1));
+  Simulator::Schedule (Seconds (5), &dsr::DsrSendBuffer::Enqueue, &q, e2);
+  Simulator::Schedule (Seconds (6), &DsrCacheExpireTest::CheckSize, this, 2);
+  Simulator::Schedule (Seconds (11), &DsrCacheExpireTest::CheckSize, this, 1);
+  Simulator::Schedule (Seconds (16), &DsrCacheExpireTest::CheckSize, this, 0);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+// -----------------------------------------------------------------------------
 // / Unit test for DSR routing table entry
 class DsrRreqTableTest : public TestCase
 {
@@ -517,5 +635,6 @@ public:
     AddTestCase (new DsrAckHeaderTest, TestCase::QUICK);
     AddTestCase (new DsrCacheEntryTest, TestCase::QUICK);
     AddTestCase (new DsrSendBuffTest, TestCase::QUICK);
+    AddTestCase (new DsrCacheExpireTest, TestCase::QUICK);
   }
 } g_dsrTestSuite;
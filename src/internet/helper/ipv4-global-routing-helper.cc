@@ -66,9 +66,10 @@ Ipv4GlobalRoutingHelper::PopulateRoutingTables (void)
 void 
 Ipv4GlobalRoutingHelper::RecomputeRoutingTables (void)
 {
-  GlobalRouteManager::DeleteGlobalRoutes ();
-  GlobalRouteManager::BuildGlobalRoutingDatabase ();
-  GlobalRouteManager::InitializeRoutes ();
+  if (GlobalRouteManager::UpdateGlobalRoutingDatabase ())
+    {
+      GlobalRouteManager::InitializeRoutes ();
+    }
 }
 
 
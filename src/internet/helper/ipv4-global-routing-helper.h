@@ -82,6 +82,9 @@ public:
    * Users must first call PopulateRoutingTables() and then may subsequently
    * call RecomputeRoutingTables() at any later time in the simulation.
    *
+   * If no link state advertisement changed since the routes were last
+   * computed, the routes in place are kept and nothing is recomputed.
+   *
    */
   static void RecomputeRoutingTables (void);
 private:
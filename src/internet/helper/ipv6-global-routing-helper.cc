@@ -0,0 +1,63 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv6-global-routing-helper.h"
+#include "ns3/ipv6-global-route-manager.h"
+#include "ns3/ipv6-global-routing.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv6GlobalRoutingHelper");
+
+Ipv6GlobalRoutingHelper::Ipv6GlobalRoutingHelper ()
+{
+}
+
+Ipv6GlobalRoutingHelper::Ipv6GlobalRoutingHelper (const Ipv6GlobalRoutingHelper &o)
+{
+}
+
+Ipv6GlobalRoutingHelper*
+Ipv6GlobalRoutingHelper::Copy (void) const
+{
+  return new Ipv6GlobalRoutingHelper (*this);
+}
+
+Ptr<Ipv6RoutingProtocol>
+Ipv6GlobalRoutingHelper::Create (Ptr<Node> node) const
+{
+  NS_LOG_LOGIC ("Adding Ipv6GlobalRouting Protocol to node " << node->GetId ());
+  return CreateObject<Ipv6GlobalRouting> ();
+}
+
+void
+Ipv6GlobalRoutingHelper::PopulateRoutingTables (void)
+{
+  Ipv6GlobalRouteManager::BuildGlobalRoutingDatabase ();
+  Ipv6GlobalRouteManager::InitializeRoutes ();
+}
+
+void
+Ipv6GlobalRoutingHelper::RecomputeRoutingTables (void)
+{
+  if (Ipv6GlobalRouteManager::UpdateGlobalRoutingDatabase ())
+    {
+      Ipv6GlobalRouteManager::InitializeRoutes ();
+    }
+}
+
+} // namespace ns3
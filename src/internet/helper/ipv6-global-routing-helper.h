@@ -0,0 +1,99 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV6_GLOBAL_ROUTING_HELPER_H
+#define IPV6_GLOBAL_ROUTING_HELPER_H
+
+#include "ns3/node-container.h"
+#include "ns3/ipv6-routing-helper.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv6Helpers
+ *
+ * \brief Helper class that adds ns3::Ipv6GlobalRouting objects
+ *
+ * Global routing is usually added to the Ipv6ListRoutingHelper of the
+ * InternetStackHelper, with a lower priority than Ipv6StaticRouting.
+ * IPv6 forwarding is disabled by default: it must be enabled on the
+ * interfaces of the routers, with Ipv6::SetForwarding or
+ * Ipv6InterfaceContainer::SetForwarding.
+ */
+class Ipv6GlobalRoutingHelper : public Ipv6RoutingHelper
+{
+public:
+  /**
+   * \brief Construct a Ipv6GlobalRoutingHelper to make life easier for
+   * managing global routing tasks.
+   */
+  Ipv6GlobalRoutingHelper ();
+
+  /**
+   * \brief Construct a Ipv6GlobalRoutingHelper from another previously
+   * initialized instance (Copy Constructor).
+   */
+  Ipv6GlobalRoutingHelper (const Ipv6GlobalRoutingHelper &);
+
+  /**
+   * \returns pointer to clone of this Ipv6GlobalRoutingHelper
+   *
+   * This method is mainly for internal use by the other helpers;
+   * clients are expected to free the dynamic memory allocated by this method
+   */
+  Ipv6GlobalRoutingHelper* Copy (void) const;
+
+  /**
+   * \param node the node on which the routing protocol will run
+   * \returns a newly-created routing protocol
+   *
+   * This method will be called by ns3::InternetStackHelper::Install
+   */
+  virtual Ptr<Ipv6RoutingProtocol> Create (Ptr<Node> node) const;
+
+  /**
+   * \brief Build a routing database and initialize the routing tables of
+   * the nodes running Ipv6GlobalRouting.
+   *
+   * All this function does is call the functions
+   * BuildGlobalRoutingDatabase () and InitializeRoutes () of
+   * Ipv6GlobalRouteManager.
+   */
+  static void PopulateRoutingTables (void);
+
+  /**
+   * \brief Remove all routes that were previously installed in a prior call
+   * to either PopulateRoutingTables() or RecomputeRoutingTables(), and
+   * add a new set of routes.
+   *
+   * If the topology and the addresses did not change since the routes
+   * were last computed, the routes in place are kept and nothing is
+   * recomputed.
+   */
+  static void RecomputeRoutingTables (void);
+
+private:
+  /**
+   * \brief Assignment operator declared private and not implemented to disallow
+   * assignment and prevent the compiler from happily inserting its own.
+   * \return
+   */
+  Ipv6GlobalRoutingHelper &operator = (const Ipv6GlobalRoutingHelper &);
+};
+
+} // namespace ns3
+
+#endif /* IPV6_GLOBAL_ROUTING_HELPER_H */
@@ -0,0 +1,183 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "neighbor-cache-helper.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ndisc-cache.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("NeighborCacheHelper");
+
+NeighborCacheHelper::NeighborCacheHelper ()
+{
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (void) const
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < ChannelList::GetNChannels (); i++)
+    {
+      PopulateNeighborCache (ChannelList::GetChannel (i));
+    }
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (Ptr<Channel> channel) const
+{
+  NS_LOG_FUNCTION (this << channel);
+  std::vector<Neighbor> neighbors = GetNeighbors (channel);
+  for (std::vector<Neighbor>::const_iterator i = neighbors.begin (); i != neighbors.end (); i++)
+    {
+      PopulateDevice (*i, neighbors);
+    }
+}
+
+void
+NeighborCacheHelper::PopulateNeighborCache (const NetDeviceContainer &devices) const
+{
+  NS_LOG_FUNCTION (this);
+  for (NetDeviceContainer::Iterator i = devices.Begin (); i != devices.End (); i++)
+    {
+      Ptr<Channel> channel = (*i)->GetChannel ();
+      if (channel != 0)
+        {
+          PopulateDevice (GetNeighbor (*i), GetNeighbors (channel));
+        }
+    }
+}
+
+NeighborCacheHelper::Neighbor
+NeighborCacheHelper::GetNeighbor (Ptr<NetDevice> device)
+{
+  Neighbor neighbor;
+  neighbor.device = device;
+  Ptr<Ipv4L3Protocol> ipv4 = device->GetNode ()->GetObject<Ipv4L3Protocol> ();
+  if (ipv4 != 0)
+    {
+      int32_t interface = ipv4->GetInterfaceForDevice (device);
+      if (interface != -1)
+        {
+          neighbor.ipv4 = ipv4->GetInterface (interface);
+        }
+    }
+  Ptr<Ipv6L3Protocol> ipv6 = device->GetNode ()->GetObject<Ipv6L3Protocol> ();
+  if (ipv6 != 0)
+    {
+      int32_t interface = ipv6->GetInterfaceForDevice (device);
+      if (interface != -1)
+        {
+          neighbor.ipv6 = ipv6->GetInterface (interface);
+        }
+    }
+  return neighbor;
+}
+
+std::vector<NeighborCacheHelper::Neighbor>
+NeighborCacheHelper::GetNeighbors (Ptr<Channel> channel)
+{
+  std::vector<Neighbor> neighbors;
+  for (uint32_t i = 0; i < channel->GetNDevices (); i++)
+    {
+      Ptr<NetDevice> device = channel->GetDevice (i);
+      if (device != 0 && device->GetNode () != 0)
+        {
+          neighbors.push_back (GetNeighbor (device));
+        }
+    }
+  return neighbors;
+}
+
+void
+NeighborCacheHelper::PopulateDevice (const Neighbor &device, const std::vector<Neighbor> &neighbors)
+{
+  NS_LOG_FUNCTION (device.device);
+  Ptr<ArpCache> arpCache = device.ipv4 != 0 ? device.ipv4->GetArpCache () : 0;
+  Ptr<NdiscCache> ndiscCache = device.ipv6 != 0 ? device.ipv6->GetNdiscCache () : 0;
+
+  for (std::vector<Neighbor>::const_iterator i = neighbors.begin (); i != neighbors.end (); i++)
+    {
+      if (i->device == device.device)
+        {
+          continue;
+        }
+      Address mac = i->device->GetAddress ();
+      if (arpCache != 0 && i->ipv4 != 0)
+        {
+          for (uint32_t j = 0; j < i->ipv4->GetNAddresses (); j++)
+            {
+              Ipv4Address address = i->ipv4->GetAddress (j).GetLocal ();
+              ArpCache::Entry *entry = arpCache->Lookup (address);
+              if (entry == 0)
+                {
+                  entry = arpCache->Add (address);
+                }
+              bool waitReply = entry->IsWaitReply ();
+              entry->SetMacAddresss (mac);
+              entry->MarkPermanent ();
+              if (waitReply)
+                {
+                  // send the packets waiting for the address, as an ARP reply would
+                  ArpCache::Ipv4PayloadHeaderPair pending = entry->DequeuePending ();
+                  while (pending.first != 0)
+                    {
+                      arpCache->GetInterface ()->Send (pending.first, pending.second, address);
+                      pending = entry->DequeuePending ();
+                    }
+                }
+              NS_LOG_LOGIC ("ARP entry " << address << " -> " << mac << " on node " << device.device->GetNode ()->GetId ());
+            }
+        }
+      if (ndiscCache != 0 && i->ipv6 != 0)
+        {
+          for (uint32_t j = 0; j < i->ipv6->GetNAddresses (); j++)
+            {
+              Ipv6Address address = i->ipv6->GetAddress (j).GetAddress ();
+              NdiscCache::Entry *entry = ndiscCache->Lookup (address);
+              if (entry == 0)
+                {
+                  entry = ndiscCache->Add (address);
+                }
+              std::list<NdiscCache::Ipv6PayloadHeaderPair> waiting;
+              if (entry->IsIncomplete ())
+                {
+                  waiting = entry->MarkReachable (mac);
+                }
+              entry->SetMacAddress (mac);
+              entry->MarkPermanent ();
+              // send the packets waiting for the address, as a neighbor advertisement would
+              for (std::list<NdiscCache::Ipv6PayloadHeaderPair>::const_iterator it = waiting.begin (); it != waiting.end (); it++)
+                {
+                  ndiscCache->GetInterface ()->Send (it->first, it->second, address);
+                }
+              entry->ClearWaitingPacket ();
+              NS_LOG_LOGIC ("NDISC entry " << address << " -> " << mac << " on node " << device.device->GetNode ()->GetId ());
+            }
+        }
+    }
+}
+
+} // namespace ns3
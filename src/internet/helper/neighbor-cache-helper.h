@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NEIGHBOR_CACHE_HELPER_H
+#define NEIGHBOR_CACHE_HELPER_H
+
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/net-device-container.h"
+
+namespace ns3 {
+
+class Channel;
+class NetDevice;
+class Ipv4Interface;
+class Ipv6Interface;
+
+/**
+ * \ingroup internet
+ *
+ * \brief Helper class that fills the ARP and NDISC caches from the
+ * topology.
+ *
+ * Each device learns the addresses of the devices sharing its channel:
+ * the ArpCache of its IPv4 interface gets an entry for every IPv4 address
+ * of the neighbors, and the NdiscCache of its IPv6 interface an entry for
+ * every IPv6 address, link-local ones included.  The entries are
+ * permanent: they never expire, so the first packets are sent at once,
+ * without any ARP request, Neighbor Solicitation or timer.
+ *
+ * The caches must be populated once the addresses are assigned, usually
+ * right before the simulation starts.  The entries do not follow later
+ * address changes, and are flushed with the cache when an IPv6 interface
+ * goes down; populating the caches again restores them, and sends the
+ * packets waiting for the resolution of an address, as a reply would.
+ * Only the devices attached to the same channel are neighbors: the
+ * devices on the other side of a bridge are still resolved by ARP or
+ * NDISC.
+ */
+class NeighborCacheHelper
+{
+public:
+  NeighborCacheHelper ();
+
+  /**
+   * \brief Populate the caches of all the devices of the simulation.
+   */
+  void PopulateNeighborCache (void) const;
+
+  /**
+   * \brief Populate the caches of the devices attached to a channel.
+   * \param channel the channel
+   */
+  void PopulateNeighborCache (Ptr<Channel> channel) const;
+
+  /**
+   * \brief Populate the caches of some devices, with the addresses of all
+   * the devices sharing their channels.
+   * \param devices the devices
+   */
+  void PopulateNeighborCache (const NetDeviceContainer &devices) const;
+
+private:
+  /// A device and its IP interfaces
+  struct Neighbor
+  {
+    Ptr<NetDevice> device;        //!< the device
+    Ptr<Ipv4Interface> ipv4;      //!< the IPv4 interface of the device, if any
+    Ptr<Ipv6Interface> ipv6;      //!< the IPv6 interface of the device, if any
+  };
+
+  /**
+   * \param device a device
+   * \returns the device and its IP interfaces
+   */
+  static Neighbor GetNeighbor (Ptr<NetDevice> device);
+
+  /**
+   * \param channel a channel
+   * \returns the devices attached to the channel
+   */
+  static std::vector<Neighbor> GetNeighbors (Ptr<Channel> channel);
+
+  /**
+   * \brief Add the addresses of the neighbors of a device to its caches.
+   * \param device the device
+   * \param neighbors the devices sharing its channel, possibly including
+   * the device itself
+   */
+  static void PopulateDevice (const Neighbor &device, const std::vector<Neighbor> &neighbors);
+};
+
+} // namespace ns3
+
+#endif /* NEIGHBOR_CACHE_HELPER_H */
@@ -22,7 +22,8 @@
 #define CANDIDATE_QUEUE_H
 
 #include <stdint.h>
-#include <list>
+#include <vector>
+#include <map>
 #include "ns3/ipv4-address.h"
 
 namespace ns3 {
@@ -47,6 +48,11 @@ class SPFVertex;
  * for a Find () operation, the dynamic nature of the data and the derived
  * requirement for a Reorder () operation led us to implement this simple 
  * enhanced priority queue.
+ *
+ * The queue is a binary heap, indexed by vertex ID, so that Push, Pop,
+ * Find and Reorder (v) are logarithmic in the number of candidates.
+ * Vertices at the same distance and of the same type are popped in the
+ * order in which they were pushed, or last repositioned by Reorder.
  */
 class CandidateQueue
 {
@@ -154,6 +160,19 @@ public:
  */
   void Reorder (void);
 
+/**
+ * @brief Restores the priority order after the distance of one vertex
+ * decreased.
+ *
+ * This is the same as Reorder (), but only moves the given vertex, which
+ * is then ordered after the other vertices with the same priority.
+ *
+ * @see SPFVertex
+ * @param v The vertex whose m_distanceFromRoot changed, which must be in
+ * the queue.
+ */
+  void Reorder (SPFVertex *v);
+
 private:
 /**
  * Candidate Queue copy construction is disallowed (not implemented) to 
@@ -184,8 +203,49 @@ private:
  */
   static bool CompareSPFVertex (const SPFVertex* v1, const SPFVertex* v2);
 
-  typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
+  /**
+   * \brief A candidate, and the order in which it was queued
+   */
+  struct Candidate
+  {
+    SPFVertex *vertex;  //!< the vertex
+    uint64_t sequence;  //!< insertion order, breaks priority ties
+  };
+
+  /**
+   * \brief return true if c1 should be popped before c2
+   * \param c1 first operand
+   * \param c2 second operand
+   * \return True if c1 should be popped before c2; false otherwise
+   */
+  static bool IsBefore (const Candidate &c1, const Candidate &c2);
+
+  /**
+   * \brief Move an entry of the heap towards the top until the heap order
+   * is restored.
+   * \param i the index of the entry
+   */
+  void SiftUp (uint32_t i);
+
+  /**
+   * \brief Move an entry of the heap towards the leaves until the heap order
+   * is restored.
+   * \param i the index of the entry
+   */
+  void SiftDown (uint32_t i);
+
+  /**
+   * \brief Store an entry in the heap and update the index
+   * \param i the index of the entry
+   * \param c the entry
+   */
+  void Place (uint32_t i, const Candidate &c);
+
+  typedef std::vector<Candidate> CandidateList_t; //!< heap of SPFVertex pointers
   CandidateList_t m_candidates;  //!< SPFVertex candidates
+  std::map<SPFVertex*, uint32_t> m_position; //!< position of each vertex in m_candidates
+  std::multimap<Ipv4Address, SPFVertex*> m_index; //!< vertices, by vertex ID
+  uint64_t m_sequence; //!< next insertion sequence number
 
   /**
    * \brief Stream insertion operator.
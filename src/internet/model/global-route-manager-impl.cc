@@ -471,6 +471,24 @@ GlobalRouteManagerLSDB::Insert (Ipv4Address addr, GlobalRoutingLSA* lsa)
   else
     {
       m_database.insert (LSDBPair_t (addr, lsa));
+      //
+      // Index the transit link records for GetLSAByLinkData, which returns the
+      // LSA with the lowest address if several of them match.
+      //
+      for (uint32_t j = 0; j < lsa->GetNLinkRecords (); j++)
+        {
+          GlobalRoutingLinkRecord *lr = lsa->GetLinkRecord (j);
+          if (lr->GetLinkType () != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+              continue;
+            }
+          std::pair<LSDBMap_t::iterator, bool> result =
+            m_linkDataIndex.insert (LSDBPair_t (lr->GetLinkData (), lsa));
+          if (!result.second && lsa->GetLinkStateId () < result.first->second->GetLinkStateId ())
+            {
+              result.first->second = lsa;
+            }
+        }
     }
 }
 
@@ -495,13 +513,10 @@ GlobalRouteManagerLSDB::GetLSA (Ipv4Address addr) const
 //
 // Look up an LSA by its address.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_database.find (addr);
+  if (i != m_database.end ())
     {
-      if (i->first == addr)
-        {
-          return i->second;
-        }
+      return i->second;
     }
   return 0;
 }
@@ -511,24 +526,84 @@ GlobalRouteManagerLSDB::GetLSAByLinkData (Ipv4Address addr) const
 {
   NS_LOG_FUNCTION (this << addr);
 //
-// Look up an LSA by its address.
+// Look up an LSA by the link data of its transit link records.
 //
-  LSDBMap_t::const_iterator i;
-  for (i= m_database.begin (); i!= m_database.end (); i++)
+  LSDBMap_t::const_iterator i = m_linkDataIndex.find (addr);
+  if (i != m_linkDataIndex.end ())
     {
-      GlobalRoutingLSA* temp = i->second;
-// Iterate among temp's Link Records
-      for (uint32_t j = 0; j < temp->GetNLinkRecords (); j++)
+      return i->second;
+    }
+  return 0;
+}
+
+/**
+ * \brief Compare two Link State Advertisements, ignoring their SPF status.
+ *
+ * \param a first LSA
+ * \param b second LSA
+ * \returns true if the LSAs advertise the same links
+ */
+static bool
+IsSameLSA (const GlobalRoutingLSA *a, const GlobalRoutingLSA *b)
+{
+  if (a->GetLSType () != b->GetLSType ()
+      || a->GetLinkStateId () != b->GetLinkStateId ()
+      || a->GetAdvertisingRouter () != b->GetAdvertisingRouter ()
+      || a->GetNetworkLSANetworkMask () != b->GetNetworkLSANetworkMask ()
+      || a->GetNode () != b->GetNode ()
+      || a->GetNLinkRecords () != b->GetNLinkRecords ()
+      || a->GetNAttachedRouters () != b->GetNAttachedRouters ())
+    {
+      return false;
+    }
+  for (uint32_t j = 0; j < a->GetNLinkRecords (); j++)
+    {
+      GlobalRoutingLinkRecord *la = a->GetLinkRecord (j);
+      GlobalRoutingLinkRecord *lb = b->GetLinkRecord (j);
+      if (la->GetLinkType () != lb->GetLinkType ()
+          || la->GetLinkId () != lb->GetLinkId ()
+          || la->GetLinkData () != lb->GetLinkData ()
+          || la->GetMetric () != lb->GetMetric ())
         {
-          GlobalRoutingLinkRecord *lr = temp->GetLinkRecord (j);
-          if ( lr->GetLinkType () == GlobalRoutingLinkRecord::TransitNetwork &&
-               lr->GetLinkData () == addr)
-            {
-              return temp;
-            }
+          return false;
         }
     }
-  return 0;
+  for (uint32_t j = 0; j < a->GetNAttachedRouters (); j++)
+    {
+      if (a->GetAttachedRouter (j) != b->GetAttachedRouter (j))
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
+bool
+GlobalRouteManagerLSDB::IsEqual (const GlobalRouteManagerLSDB &other) const
+{
+  NS_LOG_FUNCTION (this << &other);
+  if (m_database.size () != other.m_database.size ()
+      || m_extdatabase.size () != other.m_extdatabase.size ())
+    {
+      return false;
+    }
+  LSDBMap_t::const_iterator i = m_database.begin ();
+  LSDBMap_t::const_iterator j = other.m_database.begin ();
+  for (; i != m_database.end (); i++, j++)
+    {
+      if (i->first != j->first || !IsSameLSA (i->second, j->second))
+        {
+          return false;
+        }
+    }
+  for (uint32_t k = 0; k < m_extdatabase.size (); k++)
+    {
+      if (!IsSameLSA (m_extdatabase[k], other.m_extdatabase[k]))
+        {
+          return false;
+        }
+    }
+  return true;
 }
 
 // ---------------------------------------------------------------------------
@@ -659,6 +734,53 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase ()
     }
 }
 
+bool
+GlobalRouteManagerImpl::UpdateGlobalRoutingDatabase ()
+{
+  NS_LOG_FUNCTION (this);
+  GlobalRouteManagerLSDB *current = m_lsdb;
+  m_lsdb = new GlobalRouteManagerLSDB ();
+  BuildGlobalRoutingDatabase ();
+  GlobalRouteManagerLSDB *updated = m_lsdb;
+  m_lsdb = current;
+  if (current->IsEqual (*updated))
+    {
+      NS_LOG_INFO ("Link state database unchanged, keeping the global routes");
+      delete updated;
+      return false;
+    }
+  DeleteGlobalRoutes ();
+  delete m_lsdb;
+  m_lsdb = updated;
+  return true;
+}
+
+std::vector<Ptr<Node> >
+GlobalRouteManagerImpl::FindRouterNodes (Ipv4Address routerId) const
+{
+  NS_LOG_FUNCTION (this << routerId);
+  if (!m_routerNodes.empty ())
+    {
+      std::map<Ipv4Address, std::vector<Ptr<Node> > >::const_iterator i = m_routerNodes.find (routerId);
+      if (i == m_routerNodes.end ())
+        {
+          return std::vector<Ptr<Node> > ();
+        }
+      return i->second;
+    }
+  std::vector<Ptr<Node> > nodes;
+  NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr && rtr->GetRouterId () == routerId)
+        {
+          nodes.push_back (*i);
+        }
+    }
+  return nodes;
+}
+
 //
 // For each node that is a global router (which is determined by the presence
 // of an aggregated GlobalRouter interface), run the Dijkstra SPF calculation
@@ -700,7 +822,19 @@ GlobalRouteManagerImpl::InitializeRoutes ()
 // Walk the list of nodes in the system.
 //
   NS_LOG_INFO ("About to start SPF calculation");
+//
+// Index the routers by router ID, so that each SPF calculation can find the
+// node it installs routes on without walking the node list.
+//
   NodeList::Iterator listEnd = NodeList::End ();
+  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
+    {
+      Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter> ();
+      if (rtr)
+        {
+          m_routerNodes[rtr->GetRouterId ()].push_back (*i);
+        }
+    }
   for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
     {
       Ptr<Node> node = *i;
@@ -727,6 +861,7 @@ GlobalRouteManagerImpl::InitializeRoutes ()
           SPFCalculate (rtr->GetRouterId ());
         }
     }
+  m_routerNodes.clear ();
   NS_LOG_INFO ("Finished SPF calculation");
 }
 
@@ -960,7 +1095,7 @@ GlobalRouteManagerImpl::SPFNext (SPFVertex* v, CandidateQueue& candidate)
 // If we've changed the cost to get to the vertex represented by <w>, we 
 // must reorder the priority queue keyed to that cost.
 //
-                  candidate.Reorder ();
+                  candidate.Reorder (cw);
                 }
             } // new lower cost path found
         } // end W is already on the candidate list
@@ -1366,6 +1501,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 // We also mark this vertex as being in the SPF tree.
 //
   m_spfroot= v;
+  m_spfrootNodes = FindRouterNodes (root);
   v->SetDistanceFromRoot (0);
   v->GetLSA ()->SetStatus (GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
   NS_LOG_LOGIC ("Starting SPFCalculate for node " << root);
@@ -1381,6 +1517,8 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
     {
       NS_LOG_LOGIC ("SPFCalculate truncated for stub node " << root);
       delete m_spfroot;
+      m_spfroot = 0;
+      m_spfrootNodes.clear ();
       return;
     }
 
@@ -1502,6 +1640,7 @@ GlobalRouteManagerImpl::SPFCalculate (Ipv4Address root)
 //
   delete m_spfroot;
   m_spfroot = 0;
+  m_spfrootNodes.clear ();
 }
 
 void
@@ -1560,12 +1699,12 @@ GlobalRouteManagerImpl::SPFAddASExternal (GlobalRoutingLSA *extlsa, SPFVertex *v
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// We need to walk the nodes that have the router ID corresponding to the
+// root vertex (found when the SPF calculation started).  This is the one
+// we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
+  std::vector<Ptr<Node> >::const_iterator i = m_spfrootNodes.begin ();
+  std::vector<Ptr<Node> >::const_iterator listEnd = m_spfrootNodes.end ();
   for (; i != listEnd; i++)
     {
       Ptr<Node> node = *i;
@@ -1729,12 +1868,12 @@ GlobalRouteManagerImpl::SPFIntraAddStub (GlobalRoutingLinkRecord *l, SPFVertex*
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// We need to walk the nodes that have the router ID corresponding to the
+// root vertex (found when the SPF calculation started).  This is the one
+// we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
+  std::vector<Ptr<Node> >::const_iterator i = m_spfrootNodes.begin ();
+  std::vector<Ptr<Node> >::const_iterator listEnd = m_spfrootNodes.end ();
   for (; i != listEnd; i++)
     {
       Ptr<Node> node = *i;
@@ -1853,12 +1992,12 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId (Ipv4Address a, Ipv4Mask amask)
 //
   Ipv4Address routerId = m_spfroot->GetVertexId ();
 //
-// Walk the list of nodes in the system looking for the one corresponding to
-// the node at the root of the SPF tree.  This is the node for which we are
-// building the routing table.
+// Walk the nodes corresponding to the node at the root of the SPF tree
+// (found when the SPF calculation started).  This is the node for which we
+// are building the routing table.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
+  std::vector<Ptr<Node> >::const_iterator i = m_spfrootNodes.begin ();
+  std::vector<Ptr<Node> >::const_iterator listEnd = m_spfrootNodes.end ();
   for (; i != listEnd; i++)
     {
       Ptr<Node> node = *i;
@@ -1944,12 +2083,12 @@ GlobalRouteManagerImpl::SPFIntraAddRouter (SPFVertex* v)
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// We need to walk the nodes that have the router ID corresponding to the
+// root vertex (found when the SPF calculation started).  This is the one
+// we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
+  std::vector<Ptr<Node> >::const_iterator i = m_spfrootNodes.begin ();
+  std::vector<Ptr<Node> >::const_iterator listEnd = m_spfrootNodes.end ();
   for (; i != listEnd; i++)
     {
       Ptr<Node> node = *i;
@@ -2089,12 +2228,12 @@ GlobalRouteManagerImpl::SPFIntraAddTransit (SPFVertex* v)
 
   NS_LOG_LOGIC ("Vertex ID = " << routerId);
 //
-// We need to walk the list of nodes looking for the one that has the router
-// ID corresponding to the root vertex.  This is the one we're going to write
-// the routing information to.
+// We need to walk the nodes that have the router ID corresponding to the
+// root vertex (found when the SPF calculation started).  This is the one
+// we're going to write the routing information to.
 //
-  NodeList::Iterator i = NodeList::Begin (); 
-  NodeList::Iterator listEnd = NodeList::End ();
+  std::vector<Ptr<Node> >::const_iterator i = m_spfrootNodes.begin ();
+  std::vector<Ptr<Node> >::const_iterator listEnd = m_spfrootNodes.end ();
   for (; i != listEnd; i++)
     {
       Ptr<Node> node = *i;
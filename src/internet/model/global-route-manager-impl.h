@@ -674,6 +674,16 @@ public:
    */
   uint32_t GetNumExtLSAs () const;
 
+  /**
+   * @brief Compare the content of two Link State Databases.
+   *
+   * The SPF status of the LSAs is ignored.
+   *
+   * @param other the database to compare with
+   * @returns true if both databases hold the same Link State Advertisements
+   */
+  bool IsEqual (const GlobalRouteManagerLSDB &other) const;
+
 
 private:
   typedef std::map<Ipv4Address, GlobalRoutingLSA*> LSDBMap_t; //!< container of IPv4 addresses / Link State Advertisements
@@ -681,6 +691,7 @@ private:
 
   LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
   std::vector<GlobalRoutingLSA*> m_extdatabase; //!< database of External Link State Advertisements
+  LSDBMap_t m_linkDataIndex; //!< LSAs by the link data of their TransitNetwork link records
 
 /**
  * @brief GlobalRouteManagerLSDB copy construction is disallowed.  There's no 
@@ -729,6 +740,15 @@ public:
  */
   virtual void BuildGlobalRoutingDatabase ();
 
+/**
+ * @brief Build a new routing database and, if it differs from the current
+ * one, delete the routes computed from the current one.
+ *
+ * @returns false if the Link State Advertisements did not change, in which
+ * case the routes in place are still valid and the database is kept.
+ */
+  virtual bool UpdateGlobalRoutingDatabase ();
+
 /**
  * @brief Compute routes using a Dijkstra SPF computation and populate
  * per-node forwarding tables
@@ -768,6 +788,16 @@ private:
 
   SPFVertex* m_spfroot; //!< the root node
   GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+  std::vector<Ptr<Node> > m_spfrootNodes; //!< the nodes whose router ID is the one of the root
+  std::map<Ipv4Address, std::vector<Ptr<Node> > > m_routerNodes; //!< nodes by router ID, while routes are initialized
+
+  /**
+   * \brief Find the nodes whose GlobalRouter has a given router ID.
+   *
+   * \param routerId the router ID
+   * \returns the nodes, normally a single one
+   */
+  std::vector<Ptr<Node> > FindRouterNodes (Ipv4Address routerId) const;
 
   /**
    * \brief Test if a node is a stub, from an OSPF sense.
@@ -50,6 +50,14 @@ GlobalRouteManager::BuildGlobalRoutingDatabase (void)
   BuildGlobalRoutingDatabase ();
 }
 
+bool
+GlobalRouteManager::UpdateGlobalRoutingDatabase (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return SimulationSingleton<GlobalRouteManagerImpl>::Get ()->
+         UpdateGlobalRoutingDatabase ();
+}
+
 void
 GlobalRouteManager::InitializeRoutes (void)
 {
@@ -58,6 +58,14 @@ public:
  */
   static void BuildGlobalRoutingDatabase ();
 
+/**
+ * @brief Rebuild the routing database and, if it changed, delete all the
+ * global routes so that they can be computed again.
+ *
+ * @returns true if the routes must be recomputed with InitializeRoutes ()
+ */
+  static bool UpdateGlobalRoutingDatabase ();
+
 /**
  * @brief Compute routes using a Dijkstra SPF computation and populate
  * per-node forwarding tables
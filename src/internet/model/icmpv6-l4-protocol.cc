@@ -400,7 +400,7 @@ void Icmpv6L4Protocol::ReceiveLLA (Icmpv6OptionLinkLayerAddress lla, Ipv6Address
             }
           else
             {
-              if (!entry->IsReachable () || !entry->IsPermanent ())
+              if (!entry->IsPermanent ())
                 {
                   entry->StopNudTimer ();
                   waiting = entry->MarkReachable (lla.GetAddress ());
@@ -411,10 +411,7 @@ void Icmpv6L4Protocol::ReceiveLLA (Icmpv6OptionLinkLayerAddress lla, Ipv6Address
                           cache->GetInterface ()->Send (it->first, it->second, src);
                         }
                     }
-                  if (!entry->IsPermanent ())
-                    {
-                      entry->StartReachableTimer ();
-                    }
+                  entry->StartReachableTimer ();
                 }
             }
         }
@@ -706,7 +703,7 @@ void Icmpv6L4Protocol::HandleNA (Ptr<Packet> packet, Ipv6Address const &src, Ipv
 
               if (naHeader.GetFlagS ())
                 {
-                  if (!entry->IsReachable () || !entry->IsPermanent ())
+                  if (!entry->IsPermanent ())
                     {
                       if (entry->IsProbe ())
                         {
@@ -721,9 +718,6 @@ void Icmpv6L4Protocol::HandleNA (Ptr<Packet> packet, Ipv6Address const &src, Ipv
                         {
                           entry->MarkReachable (lla.GetAddress ());
                         }
-                    }
-                  if (!entry->IsPermanent ())
-                    {
                       entry->StartReachableTimer ();
                     }
                 }
@@ -22,14 +22,15 @@
 #include "ipv4-end-point.h"
 #include "ipv4-interface-address.h"
 #include "ns3/log.h"
-
+#include <algorithm>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Ipv4EndPointDemux");
 
 Ipv4EndPointDemux::Ipv4EndPointDemux ()
-  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152)
+  : m_ephemeral (49152), m_portLast (65535), m_portFirst (49152),
+    m_nextOrder (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -37,36 +38,180 @@ Ipv4EndPointDemux::Ipv4EndPointDemux ()
 Ipv4EndPointDemux::~Ipv4EndPointDemux ()
 {
   NS_LOG_FUNCTION (this);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (OrderedEndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
     {
-      Ipv4EndPoint *endPoint = *i;
+      Ipv4EndPoint *endPoint = i->second;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_connected.clear ();
+  m_ports.clear ();
 }
 
 bool
-Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+Ipv4EndPointDemux::ConnectionKey::operator == (ConnectionKey const &o) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  return localPort == o.localPort && peerPort == o.peerPort
+         && localAddress == o.localAddress && peerAddress == o.peerAddress;
+}
+
+std::size_t
+Ipv4EndPointDemux::ConnectionKeyHash::operator () (ConnectionKey const &key) const
+{
+  Ipv4AddressHash addressHash;
+  std::size_t hash = (static_cast<std::size_t> (key.localPort) << 16) | key.peerPort;
+  hash = hash * 31 + addressHash (key.localAddress);
+  return hash * 31 + addressHash (key.peerAddress);
+}
+
+bool
+Ipv4EndPointDemux::IsConnected (Ipv4EndPoint *endPoint)
+{
+  return endPoint->GetLocalAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv4Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+bool
+Ipv4EndPointDemux::IsAllocatedBefore (Ipv4EndPoint *a, Ipv4EndPoint *b)
+{
+  return a->m_order < b->m_order;
+}
+
+Ipv4EndPoint *
+Ipv4EndPointDemux::Insert (Ipv4EndPoint *endPoint)
+{
+  endPoint->m_demux = this;
+  endPoint->m_order = m_nextOrder++;
+  m_endPoints[endPoint->m_order] = endPoint;
+  AddToIndex (endPoint);
+  return endPoint;
+}
+
+void
+Ipv4EndPointDemux::AddToIndex (Ipv4EndPoint *endPoint)
+{
+  PortEndPoints &port = m_ports[endPoint->GetLocalPort ()];
+  if (IsConnected (endPoint))
+    {
+      ConnectionKey key;
+      key.localPort = endPoint->GetLocalPort ();
+      key.localAddress = endPoint->GetLocalAddress ();
+      key.peerAddress = endPoint->GetPeerAddress ();
+      key.peerPort = endPoint->GetPeerPort ();
+      m_connected.insert (std::make_pair (key, endPoint));
+      endPoint->m_portEntry = port.connected.insert (std::make_pair (endPoint->m_order, endPoint)).first;
+    }
+  else
+    {
+      endPoint->m_portEntry = port.wildcards.insert (std::make_pair (endPoint->m_order, endPoint)).first;
+    }
+}
+
+void
+Ipv4EndPointDemux::RemoveFromIndex (Ipv4EndPoint *endPoint)
+{
+  std::unordered_map<uint16_t, PortEndPoints>::iterator port = m_ports.find (endPoint->GetLocalPort ());
+  if (port == m_ports.end ())
+    {
+      return;
+    }
+  if (IsConnected (endPoint))
     {
-      if ((*i)->GetLocalPort  () == port) 
+      ConnectionKey key;
+      key.localPort = endPoint->GetLocalPort ();
+      key.localAddress = endPoint->GetLocalAddress ();
+      key.peerAddress = endPoint->GetPeerAddress ();
+      key.peerPort = endPoint->GetPeerPort ();
+      std::pair<ConnectionMapI, ConnectionMapI> range = m_connected.equal_range (key);
+      for (ConnectionMapI i = range.first; i != range.second; i++)
         {
-          return true;
+          if (i->second == endPoint)
+            {
+              m_connected.erase (i);
+              break;
+            }
         }
+      port->second.connected.erase (endPoint->m_portEntry);
+    }
+  else
+    {
+      port->second.wildcards.erase (endPoint->m_portEntry);
+    }
+  if (port->second.connected.empty () && port->second.wildcards.empty ())
+    {
+      m_ports.erase (port);
     }
-  return false;
+}
+
+std::vector<Ipv4EndPoint *>
+Ipv4EndPointDemux::GetCandidates (Ipv4Address localAddress, uint16_t localPort,
+                                  Ipv4Address peerAddress, uint16_t peerPort,
+                                  bool firstConnected)
+{
+  std::vector<Ipv4EndPoint *> candidates;
+  std::unordered_map<uint16_t, PortEndPoints>::iterator port = m_ports.find (localPort);
+  if (port == m_ports.end ())
+    {
+      return candidates;
+    }
+  if (!port->second.connected.empty ())
+    {
+      ConnectionKey key;
+      key.localPort = localPort;
+      key.localAddress = localAddress;
+      key.peerAddress = peerAddress;
+      key.peerPort = peerPort;
+      std::pair<ConnectionMapI, ConnectionMapI> range = m_connected.equal_range (key);
+      for (ConnectionMapI i = range.first; i != range.second; i++)
+        {
+          candidates.push_back (i->second);
+        }
+      OrderedEndPointsI first = port->second.connected.begin ();
+      if (firstConnected && std::find (candidates.begin (), candidates.end (), first->second) == candidates.end ())
+        {
+          candidates.push_back (first->second);
+        }
+    }
+  // the lookups pick the first matches in allocation order, and the
+  // wildcards are already sorted
+  std::sort (candidates.begin (), candidates.end (), &Ipv4EndPointDemux::IsAllocatedBefore);
+  std::size_t connected = candidates.size ();
+  for (OrderedEndPointsI i = port->second.wildcards.begin (); i != port->second.wildcards.end (); i++)
+    {
+      candidates.push_back (i->second);
+    }
+  std::inplace_merge (candidates.begin (), candidates.begin () + connected, candidates.end (),
+                      &Ipv4EndPointDemux::IsAllocatedBefore);
+  return candidates;
+}
+
+bool
+Ipv4EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool
 Ipv4EndPointDemux::LookupLocal (Ipv4Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::unordered_map<uint16_t, PortEndPoints>::iterator p = m_ports.find (port);
+  if (p == m_ports.end ())
+    {
+      return false;
+    }
+  for (OrderedEndPointsI i = p->second.wildcards.begin (); i != p->second.wildcards.end (); i++)
     {
-      if ((*i)->GetLocalPort () == port &&
-          (*i)->GetLocalAddress () == addr) 
+      if (i->second->GetLocalAddress () == addr)
+        {
+          return true;
+        }
+    }
+  for (OrderedEndPointsI i = p->second.connected.begin (); i != p->second.connected.end (); i++)
+    {
+      if (i->second->GetLocalAddress () == addr)
         {
           return true;
         }
@@ -85,7 +230,7 @@ Ipv4EndPointDemux::Allocate (void)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (Ipv4Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -101,7 +246,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -124,7 +269,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address address, uint16_t port)
       return 0;
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -134,7 +279,8 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
                              Ipv4Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::vector<Ipv4EndPoint *> candidates = GetCandidates (localAddress, localPort, peerAddress, peerPort, false);
+  for (std::vector<Ipv4EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++) 
     {
       if ((*i)->GetLocalPort () == localPort &&
           (*i)->GetLocalAddress () == localAddress &&
@@ -148,7 +294,7 @@ Ipv4EndPointDemux::Allocate (Ipv4Address localAddress, uint16_t localPort,
     }
   Ipv4EndPoint *endPoint = new Ipv4EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
 
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
 
@@ -159,14 +305,11 @@ void
 Ipv4EndPointDemux::DeAllocate (Ipv4EndPoint *endPoint)
 {
   NS_LOG_FUNCTION (this << endPoint);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  if (endPoint->m_demux == this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      RemoveFromIndex (endPoint);
+      m_endPoints.erase (endPoint->m_order);
+      delete endPoint;
     }
 }
 
@@ -179,9 +322,9 @@ Ipv4EndPointDemux::GetAllEndPoints (void)
   NS_LOG_FUNCTION (this);
   EndPoints ret;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (OrderedEndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv4EndPoint* endP = *i;
+      Ipv4EndPoint* endP = i->second;
       ret.push_back (endP);
     }
   return ret;
@@ -205,8 +348,28 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
   EndPoints retval3; // Matches all but local address
   EndPoints retval4; // Exact match on all 4
 
+  bool subnetDirected = false;
+  Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
+  for (uint32_t i = 0; incomingInterface != 0 && i < incomingInterface->GetNAddresses (); i++)
+    {
+      Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
+      if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
+          daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
+        {
+          subnetDirected = true;
+          incomingInterfaceAddr = addr.GetLocal ();
+        }
+    }
+  bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
+  NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
+
+  // Connected end points only match the packets of their own four-tuple,
+  // so only the ones with this four-tuple are looked at.
+  std::vector<Ipv4EndPoint *> candidates = GetCandidates (isBroadcast ? incomingInterfaceAddr : daddr, dport,
+                                                          saddr, sport, false);
+
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  for (std::vector<Ipv4EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++) 
     {
       Ipv4EndPoint* endP = *i;
 
@@ -241,20 +404,6 @@ Ipv4EndPointDemux::Lookup (Ipv4Address daddr, uint16_t dport,
               continue;
             }
         }
-      bool subnetDirected = false;
-      Ipv4Address incomingInterfaceAddr = daddr;  // may be a broadcast
-      for (uint32_t i = 0; i < incomingInterface->GetNAddresses (); i++)
-        {
-          Ipv4InterfaceAddress addr = incomingInterface->GetAddress (i);
-          if (addr.GetLocal ().CombineMask (addr.GetMask ()) == daddr.CombineMask (addr.GetMask ()) &&
-              daddr.IsSubnetDirectedBroadcast (addr.GetMask ()))
-            {
-              subnetDirected = true;
-              incomingInterfaceAddr = addr.GetLocal ();
-            }
-        }
-      bool isBroadcast = (daddr.IsBroadcast () || subnetDirected == true);
-      NS_LOG_DEBUG ("dest addr " << daddr << " broadcast? " << isBroadcast);
       bool localAddressMatchesWildCard = 
         endP->GetLocalAddress () == Ipv4Address::GetAny ();
       bool localAddressMatchesExact = endP->GetLocalAddress () == daddr;
@@ -330,7 +479,8 @@ Ipv4EndPointDemux::SimpleLookup (Ipv4Address daddr,
   // function.
   uint32_t genericity = 3;
   Ipv4EndPoint *generic = 0;
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++) 
+  std::vector<Ipv4EndPoint *> candidates = GetCandidates (daddr, dport, saddr, sport, true);
+  for (std::vector<Ipv4EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++) 
     {
       if ((*i)->GetLocalPort () != dport) 
         {
@@ -28,6 +28,8 @@
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/boolean.h"
 #include "ns3/node.h"
+#include "ns3/uinteger.h"
+#include "ns3/hash.h"
 #include "ipv4-global-routing.h"
 #include "global-route-manager.h"
 
@@ -48,6 +50,17 @@ Ipv4GlobalRouting::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&Ipv4GlobalRouting::m_randomEcmpRouting),
                    MakeBooleanChecker ())
+    .AddAttribute ("FlowEcmpRouting",
+                   "Set to true if packets are routed among ECMP by a hash of their five-tuple, so that all the packets of a flow follow the same path; ignored if RandomEcmpRouting is set. "
+                   "The source host only knows the ports of TCP segments: it routes the UDP datagrams of all the flows between two hosts along the same path, and the next routers spread them.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv4GlobalRouting::m_flowEcmpRouting),
+                   MakeBooleanChecker ())
+    .AddAttribute ("FlowCacheSize",
+                   "Number of entries of the cache of the routes of recent flows (or destinations, without FlowEcmpRouting); 0 disables the cache",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&Ipv4GlobalRouting::m_flowCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
     .AddAttribute ("RespondToInterfaceEvents",
                    "Set to true if you want to dynamically recompute the global routes upon Interface notification events (up/down, or add/remove address)",
                    BooleanValue (false),
@@ -59,7 +72,12 @@ Ipv4GlobalRouting::GetTypeId (void)
 
 Ipv4GlobalRouting::Ipv4GlobalRouting () 
   : m_randomEcmpRouting (false),
-    m_respondToInterfaceEvents (false)
+    m_flowEcmpRouting (false),
+    m_flowCacheSize (0),
+    m_respondToInterfaceEvents (false),
+    m_routeIndexValid (false),
+    m_flowHashSalt (0),
+    m_flowHashSaltValid (false)
 {
   NS_LOG_FUNCTION (this);
 
@@ -80,6 +98,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
   m_hostRoutes.push_back (route);
+  m_routeIndexValid = false;
 }
 
 void 
@@ -90,6 +109,7 @@ Ipv4GlobalRouting::AddHostRouteTo (Ipv4Address dest,
   Ipv4RoutingTableEntry *route = new Ipv4RoutingTableEntry ();
   *route = Ipv4RoutingTableEntry::CreateHostRouteTo (dest, interface);
   m_hostRoutes.push_back (route);
+  m_routeIndexValid = false;
 }
 
 void 
@@ -105,6 +125,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_routeIndexValid = false;
 }
 
 void 
@@ -118,6 +139,7 @@ Ipv4GlobalRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (route);
+  m_routeIndexValid = false;
 }
 
 void 
@@ -133,22 +155,169 @@ Ipv4GlobalRouting::AddASExternalRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_ASexternalRoutes.push_back (route);
+  m_routeIndexValid = false;
+}
+
+
+void
+Ipv4GlobalRouting::UpdateRouteIndexes (void)
+{
+  if (m_routeIndexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  uint8_t address[4];
+  uint8_t mask[4];
+  m_hostIndex.Clear ();
+  Ipv4Address (Ipv4Mask::GetOnes ().Get ()).Serialize (mask);
+  for (HostRoutesCI i = m_hostRoutes.begin (); i != m_hostRoutes.end (); i++)
+    {
+      (*i)->GetDest ().Serialize (address);
+      m_hostIndex.Insert (address, mask, *i);
+    }
+  m_networkIndex.Clear ();
+  for (NetworkRoutesCI j = m_networkRoutes.begin (); j != m_networkRoutes.end (); j++)
+    {
+      (*j)->GetDestNetwork ().Serialize (address);
+      Ipv4Address ((*j)->GetDestNetworkMask ().Get ()).Serialize (mask);
+      m_networkIndex.Insert (address, mask, *j);
+    }
+  m_ASexternalIndex.Clear ();
+  for (ASExternalRoutesCI k = m_ASexternalRoutes.begin (); k != m_ASexternalRoutes.end (); k++)
+    {
+      (*k)->GetDestNetwork ().Serialize (address);
+      Ipv4Address ((*k)->GetDestNetworkMask ().Get ()).Serialize (mask);
+      m_ASexternalIndex.Insert (address, mask, *k);
+    }
+  // cached routes may have been deleted
+  m_flowCache.clear ();
+  m_routeIndexValid = true;
 }
 
+bool
+Ipv4GlobalRouting::FlowId::operator == (FlowId const &o) const
+{
+  return source == o.source && destination == o.destination && protocol == o.protocol
+         && sourcePort == o.sourcePort && destinationPort == o.destinationPort;
+}
+
+Ipv4GlobalRouting::FlowId
+Ipv4GlobalRouting::GetFlowId (Ptr<const Packet> p, const Ipv4Header &header, bool hasPorts) const
+{
+  FlowId flow;
+  flow.destination = header.GetDestination ();
+  flow.protocol = 0;
+  flow.sourcePort = 0;
+  flow.destinationPort = 0;
+  if (!m_flowEcmpRouting)
+    {
+      // routes only depend on the destination
+      return flow;
+    }
+  flow.source = header.GetSource ();
+  flow.protocol = header.GetProtocol ();
+  // Fragments other than the first one carry no ports, so none of the
+  // fragments of a datagram use them.
+  if (hasPorts && p != 0 && p->GetSize () >= 4
+      && header.GetFragmentOffset () == 0 && header.IsLastFragment ()
+      && (flow.protocol == 6 || flow.protocol == 17))
+    {
+      // TCP and UDP headers both start with the source and destination ports
+      uint8_t ports[4];
+      p->CopyData (ports, 4);
+      flow.sourcePort = (ports[0] << 8) | ports[1];
+      flow.destinationPort = (ports[2] << 8) | ports[3];
+    }
+  return flow;
+}
+
+uint32_t
+Ipv4GlobalRouting::GetFlowHash (FlowId const &flow)
+{
+  if (!m_flowHashSaltValid)
+    {
+      // A different hash on each node, so that consecutive ECMP choices
+      // along a path are not correlated
+      Ptr<Node> node = m_ipv4->GetObject<Node> ();
+      m_flowHashSalt = node != 0 ? node->GetId () : 0;
+      m_flowHashSaltValid = true;
+    }
+  uint8_t buffer[17];
+  flow.source.Serialize (buffer);
+  flow.destination.Serialize (buffer + 4);
+  buffer[8] = flow.protocol;
+  buffer[9] = flow.sourcePort >> 8;
+  buffer[10] = flow.sourcePort & 0xff;
+  buffer[11] = flow.destinationPort >> 8;
+  buffer[12] = flow.destinationPort & 0xff;
+  buffer[13] = m_flowHashSalt >> 24;
+  buffer[14] = (m_flowHashSalt >> 16) & 0xff;
+  buffer[15] = (m_flowHashSalt >> 8) & 0xff;
+  buffer[16] = m_flowHashSalt & 0xff;
+  return Hash32 (reinterpret_cast<const char *> (buffer), sizeof (buffer));
+}
 
 Ptr<Ipv4Route>
-Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
+Ipv4GlobalRouting::CreateRoute (Ipv4RoutingTableEntry *route) const
 {
+  Ptr<Ipv4Route> rtentry = Create<Ipv4Route> ();
+  rtentry->SetDestination (route->GetDest ());
+  /// \todo handle multi-address case
+  rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
+  rtentry->SetGateway (route->GetGateway ());
+  uint32_t interfaceIdx = route->GetInterface ();
+  rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
+  return rtentry;
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::LookupGlobal (FlowId const &flow, Ptr<NetDevice> oif)
+{
+  Ipv4Address dest = flow.destination;
   NS_LOG_FUNCTION (this << dest << oif);
   NS_LOG_LOGIC ("Looking for route for destination " << dest);
-  Ptr<Ipv4Route> rtentry = 0;
   // store all available routes that bring packets to their destination
   typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
   RouteVec_t allRoutes;
 
+  // The indexes return the routes matching dest in table order, so the
+  // route selection below is the same as when scanning the whole tables.
+  UpdateRouteIndexes ();
+
+  // Without random ECMP, the route only depends on the flow: look for it
+  // in the cache first.
+  bool useCache = m_flowCacheSize > 0 && oif == 0 && !m_randomEcmpRouting;
+  uint32_t flowHash = 0;
+  if (useCache || m_flowEcmpRouting)
+    {
+      flowHash = GetFlowHash (flow);
+    }
+  FlowCacheEntry *slot = 0;
+  if (useCache)
+    {
+      if (m_flowCache.size () != m_flowCacheSize)
+        {
+          FlowCacheEntry empty;
+          empty.route = 0;
+          m_flowCache.assign (m_flowCacheSize, empty);
+        }
+      slot = &m_flowCache[flowHash % m_flowCacheSize];
+      if (slot->route != 0 && slot->flow == flow)
+        {
+          NS_LOG_LOGIC ("Found cached route " << slot->route);
+          return CreateRoute (slot->route);
+        }
+    }
+
+  uint8_t address[4];
+  dest.Serialize (address);
+  m_matches.clear ();
+
   NS_LOG_LOGIC ("Number of m_hostRoutes = " << m_hostRoutes.size ());
-  for (HostRoutesCI i = m_hostRoutes.begin (); 
-       i != m_hostRoutes.end (); 
+  m_hostIndex.Lookup (address, m_matches);
+  for (RouteVec_t::const_iterator i = m_matches.begin (); 
+       i != m_matches.end (); 
        i++) 
     {
       NS_ASSERT ((*i)->IsHost ());
@@ -169,8 +338,10 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   if (allRoutes.size () == 0) // if no host route is found
     {
       NS_LOG_LOGIC ("Number of m_networkRoutes" << m_networkRoutes.size ());
-      for (NetworkRoutesI j = m_networkRoutes.begin (); 
-           j != m_networkRoutes.end (); 
+      m_matches.clear ();
+      m_networkIndex.Lookup (address, m_matches);
+      for (RouteVec_t::const_iterator j = m_matches.begin (); 
+           j != m_matches.end (); 
            j++) 
         {
           Ipv4Mask mask = (*j)->GetDestNetworkMask ();
@@ -192,8 +363,10 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
     }
   if (allRoutes.size () == 0)  // consider external if no host/network found
     {
-      for (ASExternalRoutesI k = m_ASexternalRoutes.begin ();
-           k != m_ASexternalRoutes.end ();
+      m_matches.clear ();
+      m_ASexternalIndex.Lookup (address, m_matches);
+      for (RouteVec_t::const_iterator k = m_matches.begin ();
+           k != m_matches.end ();
            k++)
         {
           Ipv4Mask mask = (*k)->GetDestNetworkMask ();
@@ -217,27 +390,30 @@ Ipv4GlobalRouting::LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif)
   if (allRoutes.size () > 0 ) // if route(s) is found
     {
       // pick up one of the routes uniformly at random if random
-      // ECMP routing is enabled, or always select the first route
-      // consistently if random ECMP routing is disabled
+      // ECMP routing is enabled, by the hash of the flow if flow ECMP
+      // routing is enabled, or always select the first route
+      // consistently otherwise
       uint32_t selectIndex;
       if (m_randomEcmpRouting)
         {
           selectIndex = m_rand->GetInteger (0, allRoutes.size ()-1);
         }
+      else if (m_flowEcmpRouting)
+        {
+          selectIndex = flowHash % allRoutes.size ();
+        }
       else 
         {
           selectIndex = 0;
         }
       Ipv4RoutingTableEntry* route = allRoutes.at (selectIndex); 
+      if (slot != 0)
+        {
+          slot->flow = flow;
+          slot->route = route;
+        }
       // create a Ipv4Route object from the selected routing table entry
-      rtentry = Create<Ipv4Route> ();
-      rtentry->SetDestination (route->GetDest ());
-      /// \todo handle multi-address case
-      rtentry->SetSource (m_ipv4->GetAddress (route->GetInterface (), 0).GetLocal ());
-      rtentry->SetGateway (route->GetGateway ());
-      uint32_t interfaceIdx = route->GetInterface ();
-      rtentry->SetOutputDevice (m_ipv4->GetNetDevice (interfaceIdx));
-      return rtentry;
+      return CreateRoute (route);
     }
   else 
     {
@@ -321,6 +497,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
               NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_hostRoutes.size ());
               delete *i;
               m_hostRoutes.erase (i);
+              m_routeIndexValid = false;
               NS_LOG_LOGIC ("Done removing host route " << index << "; host route remaining size = " << m_hostRoutes.size ());
               return;
             }
@@ -338,6 +515,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_networkRoutes.size ());
           delete *j;
           m_networkRoutes.erase (j);
+          m_routeIndexValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -354,6 +532,7 @@ Ipv4GlobalRouting::RemoveRoute (uint32_t index)
           NS_LOG_LOGIC ("Removing route " << index << "; size = " << m_ASexternalRoutes.size ());
           delete *k;
           m_ASexternalRoutes.erase (k);
+          m_routeIndexValid = false;
           NS_LOG_LOGIC ("Done removing network route " << index << "; network route remaining size = " << m_networkRoutes.size ());
           return;
         }
@@ -392,6 +571,10 @@ Ipv4GlobalRouting::DoDispose (void)
     {
       delete (*l);
     }
+  m_hostIndex.Clear ();
+  m_networkIndex.Clear ();
+  m_ASexternalIndex.Clear ();
+  m_routeIndexValid = false;
 
   Ipv4RoutingProtocol::DoDispose ();
 }
@@ -468,7 +651,10 @@ Ipv4GlobalRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<Net
 // See if this is a unicast packet we have a route for.
 //
   NS_LOG_LOGIC ("Unicast destination- looking up");
-  Ptr<Ipv4Route> rtentry = LookupGlobal (header.GetDestination (), oif);
+  // TCP adds its header before it looks up the route, but UDP adds it
+  // after: UDP flows are only identified by their addresses and protocol.
+  bool hasPorts = header.GetProtocol () == 6;
+  Ptr<Ipv4Route> rtentry = LookupGlobal (GetFlowId (p, header, hasPorts), oif);
   if (rtentry)
     {
       sockerr = Socket::ERROR_NOTERROR;
@@ -517,7 +703,7 @@ Ipv4GlobalRouting::RouteInput  (Ptr<const Packet> p, const Ipv4Header &header, P
     }
   // Next, try to find a route
   NS_LOG_LOGIC ("Unicast destination- looking up global route");
-  Ptr<Ipv4Route> rtentry = LookupGlobal (header.GetDestination ());
+  Ptr<Ipv4Route> rtentry = LookupGlobal (GetFlowId (p, header, true));
   if (rtentry != 0)
     {
       NS_LOG_LOGIC ("Found unicast destination- calling unicast callback");
@@ -21,6 +21,7 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include <list>
+#include <vector>
 #include <stdint.h>
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -28,6 +29,7 @@
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -234,6 +236,10 @@ protected:
 private:
   /// Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently
   bool m_randomEcmpRouting;
+  /// Set to true if packets are routed among ECMP by a hash of their five-tuple
+  bool m_flowEcmpRouting;
+  /// Number of entries of the flow cache
+  uint32_t m_flowCacheSize;
   /// Set to true if this interface should respond to interface events by globallly recomputing routes 
   bool m_respondToInterfaceEvents;
   /// A uniform random number generator for randomly routing packets among ECMP 
@@ -260,18 +266,89 @@ private:
   /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
   typedef std::list<Ipv4RoutingTableEntry *>::iterator ASExternalRoutesI;
 
+  /**
+   * \brief The fields identifying a flow.  Without flow ECMP routing,
+   * only the destination is set.
+   */
+  struct FlowId
+  {
+    Ipv4Address source;          //!< source address
+    Ipv4Address destination;     //!< destination address
+    uint8_t protocol;            //!< protocol number
+    uint16_t sourcePort;         //!< TCP or UDP source port
+    uint16_t destinationPort;    //!< TCP or UDP destination port
+
+    /**
+     * \param o another flow
+     * \returns true if both flows are the same
+     */
+    bool operator == (FlowId const &o) const;
+  };
+
+  /**
+   * \brief A slot of the flow cache
+   */
+  struct FlowCacheEntry
+  {
+    FlowId flow;                    //!< the flow
+    Ipv4RoutingTableEntry *route;   //!< its route, or 0 if the slot is empty
+  };
+
+  /**
+   * \brief Get the fields identifying the flow of a packet.
+   * \param p the packet
+   * \param header its IP header
+   * \param hasPorts true if the packet starts with the transport header
+   * \return the flow of the packet
+   */
+  FlowId GetFlowId (Ptr<const Packet> p, const Ipv4Header &header, bool hasPorts) const;
+
+  /**
+   * \brief Hash a flow; the hash also depends on the node.
+   * \param flow the flow
+   * \return the hash
+   */
+  uint32_t GetFlowHash (FlowId const &flow);
+
+  /**
+   * \brief Create the route of a packet following a routing table entry.
+   * \param route the routing table entry
+   * \return the route
+   */
+  Ptr<Ipv4Route> CreateRoute (Ipv4RoutingTableEntry *route) const;
+
   /**
    * \brief Lookup in the forwarding table for destination.
-   * \param dest destination address
+   * \param flow the flow of the packet; the destination selects the
+   * routes, the other fields one of several equal-cost routes
    * \param oif output interface if any (put 0 otherwise)
    * \return Ipv4Route to route the packet to reach dest address
    */
-  Ptr<Ipv4Route> LookupGlobal (Ipv4Address dest, Ptr<NetDevice> oif = 0);
+  Ptr<Ipv4Route> LookupGlobal (FlowId const &flow, Ptr<NetDevice> oif = 0);
+
+  /**
+   * \brief Rebuild the route indexes from the route lists if a route was
+   * added or removed since the last lookup.
+   */
+  void UpdateRouteIndexes (void);
 
   HostRoutes m_hostRoutes;             //!< Routes to hosts
   NetworkRoutes m_networkRoutes;       //!< Routes to networks
   ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+  /// Index of the routes by destination prefix
+  typedef PrefixTrie<Ipv4RoutingTableEntry *, 4> RouteIndex;
+
+  RouteIndex m_hostIndex;              //!< m_hostRoutes by destination
+  RouteIndex m_networkIndex;           //!< m_networkRoutes by destination
+  RouteIndex m_ASexternalIndex;        //!< m_ASexternalRoutes by destination
+  bool m_routeIndexValid;              //!< whether the indexes match the route lists
+  std::vector<Ipv4RoutingTableEntry *> m_matches; //!< routes found by the index lookups, kept across lookups
+
+  std::vector<FlowCacheEntry> m_flowCache; //!< routes of recent flows, by flow hash
+  uint32_t m_flowHashSalt;             //!< node dependent part of the flow hashes
+  bool m_flowHashSaltValid;            //!< whether m_flowHashSalt is set
+
   Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
@@ -54,7 +54,8 @@ Ipv4StaticRouting::GetTypeId (void)
 }
 
 Ipv4StaticRouting::Ipv4StaticRouting () 
-  : m_ipv4 (0)
+  : m_networkIndexValid (false),
+    m_ipv4 (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -73,6 +74,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         nextHop,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_networkIndexValid = false;
 }
 
 void 
@@ -87,6 +89,7 @@ Ipv4StaticRouting::AddNetworkRouteTo (Ipv4Address network,
                                                         networkMask,
                                                         interface);
   m_networkRoutes.push_back (make_pair (route,metric));
+  m_networkIndexValid = false;
 }
 
 void 
@@ -144,6 +147,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute (uint32_t outputInterface)
                                                         networkMask,
                                                         outputInterface);
   m_networkRoutes.push_back (make_pair (route,0));
+  m_networkIndexValid = false;
 }
 
 uint32_t 
@@ -219,6 +223,26 @@ Ipv4StaticRouting::RemoveMulticastRoute (uint32_t index)
     }
 }
 
+void
+Ipv4StaticRouting::UpdateNetworkIndex (void)
+{
+  if (m_networkIndexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_networkIndex.Clear ();
+  for (NetworkRoutesCI i = m_networkRoutes.begin (); i != m_networkRoutes.end (); i++)
+    {
+      uint8_t address[4];
+      uint8_t mask[4];
+      i->first->GetDestNetwork ().Serialize (address);
+      Ipv4Address (i->first->GetDestNetworkMask ().Get ()).Serialize (mask);
+      m_networkIndex.Insert (address, mask, *i);
+    }
+  m_networkIndexValid = true;
+}
+
 Ptr<Ipv4Route>
 Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
 {
@@ -240,8 +264,16 @@ Ipv4StaticRouting::LookupStatic (Ipv4Address dest, Ptr<NetDevice> oif)
     }
 
 
-  for (NetworkRoutesI i = m_networkRoutes.begin (); 
-       i != m_networkRoutes.end (); 
+  // Only the routes matching dest are candidates; they come out of the
+  // index in table order, so the selection below is unchanged.
+  UpdateNetworkIndex ();
+  uint8_t address[4];
+  dest.Serialize (address);
+  m_matches.clear ();
+  m_networkIndex.Lookup (address, m_matches);
+
+  for (std::vector<std::pair <Ipv4RoutingTableEntry *, uint32_t> >::const_iterator i = m_matches.begin (); 
+       i != m_matches.end (); 
        i++) 
     {
       Ipv4RoutingTableEntry *j=i->first;
@@ -449,6 +481,7 @@ Ipv4StaticRouting::RemoveRoute (uint32_t index)
         {
           delete j->first;
           m_networkRoutes.erase (j);
+          m_networkIndexValid = false;
           return;
         }
       tmp++;
@@ -575,6 +608,8 @@ Ipv4StaticRouting::DoDispose (void)
     {
       delete (j->first);
     }
+  m_networkIndex.Clear ();
+  m_networkIndexValid = false;
   for (MulticastRoutesI i = m_multicastRoutes.begin (); 
        i != m_multicastRoutes.end (); 
        i = m_multicastRoutes.erase (i)) 
@@ -615,6 +650,7 @@ Ipv4StaticRouting::NotifyInterfaceDown (uint32_t i)
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_networkIndexValid = false;
         }
       else
         {
@@ -662,6 +698,7 @@ Ipv4StaticRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress
         {
           delete it->first;
           it = m_networkRoutes.erase (it);
+          m_networkIndexValid = false;
         }
       else
         {
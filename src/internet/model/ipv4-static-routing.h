@@ -31,6 +31,7 @@
 #include "ns3/ptr.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -413,11 +414,33 @@ private:
   Ptr<Ipv4MulticastRoute> LookupStatic (Ipv4Address origin, Ipv4Address group,
                                         uint32_t interface);
 
+  /**
+   * \brief Rebuild m_networkIndex from m_networkRoutes if a route was
+   * added or removed since the last lookup.
+   */
+  void UpdateNetworkIndex (void);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief m_networkRoutes indexed by destination prefix.
+   */
+  PrefixTrie<std::pair <Ipv4RoutingTableEntry *, uint32_t>, 4> m_networkIndex;
+
+  /**
+   * \brief Whether m_networkIndex matches m_networkRoutes.
+   */
+  bool m_networkIndexValid;
+
+  /**
+   * \brief The routes found by the last lookup in m_networkIndex, kept to
+   * avoid an allocation per lookup.
+   */
+  std::vector<std::pair <Ipv4RoutingTableEntry *, uint32_t> > m_matches;
+
   /**
    * \brief the forwarding table for multicast.
    */
@@ -21,6 +21,7 @@
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
 #include "ns3/log.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -29,7 +30,8 @@ NS_LOG_COMPONENT_DEFINE ("Ipv6EndPointDemux");
 Ipv6EndPointDemux::Ipv6EndPointDemux ()
   : m_ephemeral (49152),
     m_portFirst (49152),
-    m_portLast (65535)
+    m_portLast (65535),
+    m_nextOrder (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -37,34 +39,170 @@ Ipv6EndPointDemux::Ipv6EndPointDemux ()
 Ipv6EndPointDemux::~Ipv6EndPointDemux ()
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (OrderedEndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
     {
-      Ipv6EndPoint *endPoint = *i;
+      Ipv6EndPoint *endPoint = i->second;
       delete endPoint;
     }
   m_endPoints.clear ();
+  m_connected.clear ();
+  m_ports.clear ();
 }
 
-bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+bool Ipv6EndPointDemux::ConnectionKey::operator == (ConnectionKey const &o) const
 {
-  NS_LOG_FUNCTION (this << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  return localPort == o.localPort && peerPort == o.peerPort
+         && localAddress == o.localAddress && peerAddress == o.peerAddress;
+}
+
+std::size_t Ipv6EndPointDemux::ConnectionKeyHash::operator () (ConnectionKey const &key) const
+{
+  Ipv6AddressHash addressHash;
+  std::size_t hash = (static_cast<std::size_t> (key.localPort) << 16) | key.peerPort;
+  hash = hash * 31 + addressHash (key.localAddress);
+  return hash * 31 + addressHash (key.peerAddress);
+}
+
+bool Ipv6EndPointDemux::IsConnected (Ipv6EndPoint *endPoint)
+{
+  return endPoint->GetLocalAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerAddress () != Ipv6Address::GetAny ()
+         && endPoint->GetPeerPort () != 0;
+}
+
+bool Ipv6EndPointDemux::IsAllocatedBefore (Ipv6EndPoint *a, Ipv6EndPoint *b)
+{
+  return a->m_order < b->m_order;
+}
+
+Ipv6EndPoint* Ipv6EndPointDemux::Insert (Ipv6EndPoint *endPoint)
+{
+  endPoint->m_demux = this;
+  endPoint->m_order = m_nextOrder++;
+  m_endPoints[endPoint->m_order] = endPoint;
+  AddToIndex (endPoint);
+  return endPoint;
+}
+
+void Ipv6EndPointDemux::AddToIndex (Ipv6EndPoint *endPoint)
+{
+  PortEndPoints &port = m_ports[endPoint->GetLocalPort ()];
+  if (IsConnected (endPoint))
+    {
+      ConnectionKey key;
+      key.localPort = endPoint->GetLocalPort ();
+      key.localAddress = endPoint->GetLocalAddress ();
+      key.peerAddress = endPoint->GetPeerAddress ();
+      key.peerPort = endPoint->GetPeerPort ();
+      m_connected.insert (std::make_pair (key, endPoint));
+      endPoint->m_portEntry = port.connected.insert (std::make_pair (endPoint->m_order, endPoint)).first;
+    }
+  else
+    {
+      endPoint->m_portEntry = port.wildcards.insert (std::make_pair (endPoint->m_order, endPoint)).first;
+    }
+}
+
+void Ipv6EndPointDemux::RemoveFromIndex (Ipv6EndPoint *endPoint)
+{
+  std::unordered_map<uint16_t, PortEndPoints>::iterator port = m_ports.find (endPoint->GetLocalPort ());
+  if (port == m_ports.end ())
     {
-      if ((*i)->GetLocalPort  () == port)
+      return;
+    }
+  if (IsConnected (endPoint))
+    {
+      ConnectionKey key;
+      key.localPort = endPoint->GetLocalPort ();
+      key.localAddress = endPoint->GetLocalAddress ();
+      key.peerAddress = endPoint->GetPeerAddress ();
+      key.peerPort = endPoint->GetPeerPort ();
+      std::pair<ConnectionMapI, ConnectionMapI> range = m_connected.equal_range (key);
+      for (ConnectionMapI i = range.first; i != range.second; i++)
         {
-          return true;
+          if (i->second == endPoint)
+            {
+              m_connected.erase (i);
+              break;
+            }
         }
+      port->second.connected.erase (endPoint->m_portEntry);
+    }
+  else
+    {
+      port->second.wildcards.erase (endPoint->m_portEntry);
+    }
+  if (port->second.connected.empty () && port->second.wildcards.empty ())
+    {
+      m_ports.erase (port);
     }
-  return false;
+}
+
+std::vector<Ipv6EndPoint *> Ipv6EndPointDemux::GetCandidates (Ipv6Address localAddress, uint16_t localPort,
+                                                              Ipv6Address peerAddress, uint16_t peerPort,
+                                                              bool firstConnected)
+{
+  std::vector<Ipv6EndPoint *> candidates;
+  std::unordered_map<uint16_t, PortEndPoints>::iterator port = m_ports.find (localPort);
+  if (port == m_ports.end ())
+    {
+      return candidates;
+    }
+  if (!port->second.connected.empty ())
+    {
+      ConnectionKey key;
+      key.localPort = localPort;
+      key.localAddress = localAddress;
+      key.peerAddress = peerAddress;
+      key.peerPort = peerPort;
+      std::pair<ConnectionMapI, ConnectionMapI> range = m_connected.equal_range (key);
+      for (ConnectionMapI i = range.first; i != range.second; i++)
+        {
+          candidates.push_back (i->second);
+        }
+      OrderedEndPointsI first = port->second.connected.begin ();
+      if (firstConnected && std::find (candidates.begin (), candidates.end (), first->second) == candidates.end ())
+        {
+          candidates.push_back (first->second);
+        }
+    }
+  /* the lookups pick the first matches in allocation order, and the
+     wildcards are already sorted */
+  std::sort (candidates.begin (), candidates.end (), &Ipv6EndPointDemux::IsAllocatedBefore);
+  std::size_t connected = candidates.size ();
+  for (OrderedEndPointsI i = port->second.wildcards.begin (); i != port->second.wildcards.end (); i++)
+    {
+      candidates.push_back (i->second);
+    }
+  std::inplace_merge (candidates.begin (), candidates.begin () + connected, candidates.end (),
+                      &Ipv6EndPointDemux::IsAllocatedBefore);
+  return candidates;
+}
+
+bool Ipv6EndPointDemux::LookupPortLocal (uint16_t port)
+{
+  NS_LOG_FUNCTION (this << port);
+  return m_ports.find (port) != m_ports.end ();
 }
 
 bool Ipv6EndPointDemux::LookupLocal (Ipv6Address addr, uint16_t port)
 {
   NS_LOG_FUNCTION (this << addr << port);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::unordered_map<uint16_t, PortEndPoints>::iterator p = m_ports.find (port);
+  if (p == m_ports.end ())
+    {
+      return false;
+    }
+  for (OrderedEndPointsI i = p->second.wildcards.begin (); i != p->second.wildcards.end (); i++)
+    {
+      if (i->second->GetLocalAddress () == addr)
+        {
+          return true;
+        }
+    }
+  for (OrderedEndPointsI i = p->second.connected.begin (); i != p->second.connected.end (); i++)
     {
-      if ((*i)->GetLocalPort () == port
-          && (*i)->GetLocalAddress () == addr)
+      if (i->second->GetLocalAddress () == addr)
         {
           return true;
         }
@@ -82,7 +220,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate ()
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (Ipv6Address::GetAny (), port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -97,7 +235,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -118,7 +256,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address address, uint16_t port)
       return 0;
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (address, port);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
   return endPoint;
 }
@@ -127,7 +265,8 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
                                            Ipv6Address peerAddress, uint16_t peerPort)
 {
   NS_LOG_FUNCTION (this << localAddress << localPort << peerAddress << peerPort);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::vector<Ipv6EndPoint *> candidates = GetCandidates (localAddress, localPort, peerAddress, peerPort, false);
+  for (std::vector<Ipv6EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       if ((*i)->GetLocalPort () == localPort
           && (*i)->GetLocalAddress () == localAddress
@@ -141,7 +280,7 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
     }
   Ipv6EndPoint *endPoint = new Ipv6EndPoint (localAddress, localPort);
   endPoint->SetPeer (peerAddress, peerPort);
-  m_endPoints.push_back (endPoint);
+  Insert (endPoint);
 
   NS_LOG_DEBUG ("Now have >>" << m_endPoints.size () << "<< endpoints.");
 
@@ -151,14 +290,11 @@ Ipv6EndPoint* Ipv6EndPointDemux::Allocate (Ipv6Address localAddress, uint16_t lo
 void Ipv6EndPointDemux::DeAllocate (Ipv6EndPoint *endPoint)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  if (endPoint->m_demux == this)
     {
-      if (*i == endPoint)
-        {
-          delete endPoint;
-          m_endPoints.erase (i);
-          break;
-        }
+      RemoveFromIndex (endPoint);
+      m_endPoints.erase (endPoint->m_order);
+      delete endPoint;
     }
 }
 
@@ -178,8 +314,12 @@ Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::Lookup (Ipv6Address daddr, uint1
   EndPoints retval3; /* Matches all but local address */
   EndPoints retval4; /* Exact match on all 4 */
 
+  /* Connected end points only match the packets of their own four-tuple,
+     so only the ones with this four-tuple are looked at. */
+  std::vector<Ipv6EndPoint *> candidates = GetCandidates (daddr, dport, saddr, sport, false);
+
   NS_LOG_DEBUG ("Looking up endpoint for destination address " << daddr);
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  for (std::vector<Ipv6EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       Ipv6EndPoint* endP = *i;
 
@@ -296,7 +436,8 @@ Ipv6EndPoint* Ipv6EndPointDemux::SimpleLookup (Ipv6Address dst, uint16_t dport,
   uint32_t genericity = 3;
   Ipv6EndPoint *generic = 0;
 
-  for (EndPointsI i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+  std::vector<Ipv6EndPoint *> candidates = GetCandidates (dst, dport, src, sport, true);
+  for (std::vector<Ipv6EndPoint *>::iterator i = candidates.begin (); i != candidates.end (); i++)
     {
       uint32_t tmp = 0;
 
@@ -355,7 +496,12 @@ uint16_t Ipv6EndPointDemux::AllocateEphemeralPort ()
 
 Ipv6EndPointDemux::EndPoints Ipv6EndPointDemux::GetEndPoints () const
 {
-  return m_endPoints;
+  EndPoints ret;
+  for (OrderedEndPoints::const_iterator i = m_endPoints.begin (); i != m_endPoints.end (); i++)
+    {
+      ret.push_back (i->second);
+    }
+  return ret;
 }
 
 } /* namespace ns3 */
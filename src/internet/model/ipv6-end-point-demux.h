@@ -23,6 +23,9 @@
 
 #include <stdint.h>
 #include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
 #include "ns3/ipv6-address.h"
 #include "ipv6-interface.h"
 
@@ -34,6 +37,10 @@ class Ipv6EndPoint;
  * \ingroup ipv6
  *
  * \brief Demultiplexer for end points.
+ *
+ * Connected endpoints, whose addresses and ports are all set, are indexed
+ * by their four-tuple, and the other endpoints by their local port, so
+ * that a lookup only looks at the endpoints which may match the packet.
  */
 class Ipv6EndPointDemux
 {
@@ -147,12 +154,124 @@ public:
   EndPoints GetEndPoints () const;
 
 private:
+  friend class Ipv6EndPoint;
+
   /**
    * \brief Allocate a ephemeral port.
    * \return a port
    */
   uint16_t AllocateEphemeralPort ();
 
+  /**
+   * \brief Add a new end point to the demux.
+   * \param endPoint the end point
+   * \return the end point
+   */
+  Ipv6EndPoint *Insert (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Index an end point by its addresses and ports.
+   * \param endPoint the end point
+   */
+  void AddToIndex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Remove an end point from the indexes, before its addresses or
+   * ports change or it is deallocated.
+   * \param endPoint the end point
+   */
+  void RemoveFromIndex (Ipv6EndPoint *endPoint);
+
+  /**
+   * \brief Get the end points which may match a packet.
+   *
+   * These are the connected end points matching the four-tuple exactly,
+   * and all the other end points on the local port, in allocation order.
+   *
+   * \param localAddress local address
+   * \param localPort local port
+   * \param peerAddress peer address
+   * \param peerPort peer port
+   * \param firstConnected also return the first allocated connected end
+   * point on the local port, even if it does not match the four-tuple
+   * \return the end points
+   */
+  std::vector<Ipv6EndPoint *> GetCandidates (Ipv6Address localAddress, uint16_t localPort,
+                                             Ipv6Address peerAddress, uint16_t peerPort,
+                                             bool firstConnected);
+
+  /**
+   * \brief The four-tuple of a connected end point.
+   */
+  struct ConnectionKey
+  {
+    uint16_t localPort;       //!< local port
+    Ipv6Address localAddress; //!< local address
+    Ipv6Address peerAddress;  //!< peer address
+    uint16_t peerPort;        //!< peer port
+
+    /**
+     * \param o another four-tuple
+     * \return true if the four-tuples are equal
+     */
+    bool operator == (ConnectionKey const &o) const;
+  };
+
+  /**
+   * \brief Hash of a ConnectionKey.
+   */
+  struct ConnectionKeyHash
+  {
+    /**
+     * \param key the four-tuple
+     * \return the hash of the four-tuple
+     */
+    std::size_t operator () (ConnectionKey const &key) const;
+  };
+
+  /**
+   * \brief Container of end points, by allocation order.
+   */
+  typedef std::map<uint64_t, Ipv6EndPoint *> OrderedEndPoints;
+
+  /**
+   * \brief Iterator to a container of end points, by allocation order.
+   */
+  typedef OrderedEndPoints::iterator OrderedEndPointsI;
+
+  /**
+   * \brief The end points on a local port.
+   */
+  struct PortEndPoints
+  {
+    OrderedEndPoints connected; //!< the connected end points
+    OrderedEndPoints wildcards; //!< the other end points
+  };
+
+  /**
+   * \brief Container of the connected end points, by four-tuple.
+   */
+  typedef std::unordered_multimap<ConnectionKey, Ipv6EndPoint *, ConnectionKeyHash> ConnectionMap;
+
+  /**
+   * \brief Iterator to the container of the connected end points.
+   */
+  typedef ConnectionMap::iterator ConnectionMapI;
+
+  /**
+   * \param endPoint an end point
+   * \return true if the addresses and ports of the end point are all set,
+   * so that it only receives the packets of one four-tuple
+   */
+  static bool IsConnected (Ipv6EndPoint *endPoint);
+
+  /**
+   * \param a an end point
+   * \param b another end point
+   * \return true if a was allocated before b
+   */
+  static bool IsAllocatedBefore (Ipv6EndPoint *a, Ipv6EndPoint *b);
+
   /**
    * \brief The ephemeral port.
    */
@@ -169,9 +288,24 @@ private:
   uint16_t m_portLast;
 
   /**
-   * \brief A list of IPv6 end points.
+   * \brief The IPv6 end points, by allocation order.
+   */
+  OrderedEndPoints m_endPoints;
+
+  /**
+   * \brief The connected end points, by four-tuple.
+   */
+  ConnectionMap m_connected;
+
+  /**
+   * \brief The end points, by local port.
+   */
+  std::unordered_map<uint16_t, PortEndPoints> m_ports;
+
+  /**
+   * \brief Allocation order of the next end point.
    */
-  EndPoints m_endPoints;
+  uint64_t m_nextOrder;
 };
 
 } /* namespace ns3 */
@@ -22,6 +22,7 @@
 #define IPV6_END_POINT_H
 
 #include <stdint.h>
+#include <map>
 
 #include "ns3/ipv6-address.h"
 #include "ns3/callback.h"
@@ -34,6 +35,7 @@ namespace ns3
 
 class Header;
 class Packet;
+class Ipv6EndPointDemux;
 
 /**
  * \ingroup ipv6
@@ -236,6 +238,25 @@ private:
    * \brief true if the endpoint can receive packets.
    */
   bool m_rxEnabled;
+
+  friend class Ipv6EndPointDemux;
+
+  /**
+   * \brief The demultiplexer which indexes this endpoint by its addresses
+   * and ports, if any; it is told when they change.
+   */
+  Ipv6EndPointDemux *m_demux;
+
+  /**
+   * \brief The allocation order of this endpoint in m_demux.
+   */
+  uint64_t m_order;
+
+  /**
+   * \brief The entry of this endpoint in the endpoints of its local port
+   * in m_demux, so that it is removed from them at once.
+   */
+  std::map<uint64_t, Ipv6EndPoint *>::iterator m_portEntry;
 };
 
 } /* namespace ns3 */
@@ -0,0 +1,514 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <queue>
+#include <algorithm>
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulation-singleton.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/channel.h"
+#include "ns3/net-device.h"
+#include "ns3/bridge-net-device.h"
+#include "ns3/ipv6.h"
+#include "ns3/ipv6-list-routing.h"
+#include "ipv6-global-routing.h"
+#include "ipv6-global-route-manager.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv6GlobalRouteManager");
+
+// ---------------------------------------------------------------------------
+//
+// Ipv6GlobalRouteManager Implementation
+//
+// ---------------------------------------------------------------------------
+
+void
+Ipv6GlobalRouteManager::DeleteGlobalRoutes (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  SimulationSingleton<Ipv6GlobalRouteManagerImpl>::Get ()->DeleteGlobalRoutes ();
+}
+
+void
+Ipv6GlobalRouteManager::BuildGlobalRoutingDatabase (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  SimulationSingleton<Ipv6GlobalRouteManagerImpl>::Get ()->BuildGlobalRoutingDatabase ();
+}
+
+bool
+Ipv6GlobalRouteManager::UpdateGlobalRoutingDatabase (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return SimulationSingleton<Ipv6GlobalRouteManagerImpl>::Get ()->UpdateGlobalRoutingDatabase ();
+}
+
+void
+Ipv6GlobalRouteManager::InitializeRoutes (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  SimulationSingleton<Ipv6GlobalRouteManagerImpl>::Get ()->InitializeRoutes ();
+}
+
+Ptr<Ipv6GlobalRouting>
+Ipv6GlobalRouteManager::GetGlobalRouting (Ptr<Node> node)
+{
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+  if (ipv6 == 0 || ipv6->GetRoutingProtocol () == 0)
+    {
+      return 0;
+    }
+  Ptr<Ipv6RoutingProtocol> routing = ipv6->GetRoutingProtocol ();
+  Ptr<Ipv6GlobalRouting> globalRouting = DynamicCast<Ipv6GlobalRouting> (routing);
+  if (globalRouting != 0)
+    {
+      return globalRouting;
+    }
+  Ptr<Ipv6ListRouting> list = DynamicCast<Ipv6ListRouting> (routing);
+  if (list != 0)
+    {
+      for (uint32_t i = 0; i < list->GetNRoutingProtocols (); i++)
+        {
+          int16_t priority;
+          globalRouting = DynamicCast<Ipv6GlobalRouting> (list->GetRoutingProtocol (i, priority));
+          if (globalRouting != 0)
+            {
+              return globalRouting;
+            }
+        }
+    }
+  return 0;
+}
+
+// ---------------------------------------------------------------------------
+//
+// Ipv6GlobalRouteManagerImpl Implementation
+//
+// ---------------------------------------------------------------------------
+
+bool
+Ipv6GlobalRouteManagerImpl::Link::operator== (Link const &o) const
+{
+  return vertex == o.vertex && interface == o.interface && nextHop == o.nextHop && metric == o.metric;
+}
+
+bool
+Ipv6GlobalRouteManagerImpl::Vertex::operator== (Vertex const &o) const
+{
+  return node == o.node && links == o.links && prefixes == o.prefixes;
+}
+
+bool
+Ipv6GlobalRouteManagerImpl::NextHop::operator== (NextHop const &o) const
+{
+  return interface == o.interface && gateway == o.gateway;
+}
+
+Ipv6GlobalRouteManagerImpl::Ipv6GlobalRouteManagerImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+Ipv6GlobalRouteManagerImpl::~Ipv6GlobalRouteManagerImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+Ipv6GlobalRouteManagerImpl::DeleteGlobalRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      Ptr<Ipv6GlobalRouting> globalRouting = Ipv6GlobalRouteManager::GetGlobalRouting (*i);
+      if (globalRouting == 0)
+        {
+          continue;
+        }
+      while (globalRouting->GetNRoutes () > 0)
+        {
+          globalRouting->RemoveRoute (0);
+        }
+    }
+}
+
+void
+Ipv6GlobalRouteManagerImpl::BuildGlobalRoutingDatabase (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_lsdb.clear ();
+  m_prefixes.clear ();
+  BuildDatabase (m_lsdb, m_prefixes);
+}
+
+bool
+Ipv6GlobalRouteManagerImpl::UpdateGlobalRoutingDatabase (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<Vertex> lsdb;
+  std::vector<Prefix> prefixes;
+  BuildDatabase (lsdb, prefixes);
+  if (lsdb == m_lsdb && prefixes == m_prefixes)
+    {
+      NS_LOG_LOGIC ("Link-state database unchanged");
+      return false;
+    }
+  m_lsdb.swap (lsdb);
+  m_prefixes.swap (prefixes);
+  DeleteGlobalRoutes ();
+  return true;
+}
+
+void
+Ipv6GlobalRouteManagerImpl::InitializeRoutes (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_lsdb.size (); i++)
+    {
+      if (m_lsdb[i].node != NO_NODE)
+        {
+          SPFCalculate (i);
+        }
+    }
+}
+
+Ptr<Channel>
+Ipv6GlobalRouteManagerImpl::GetFirstChannel (Ptr<NetDevice> device)
+{
+  if (device->IsBridge ())
+    {
+      Ptr<BridgeNetDevice> bridge = DynamicCast<BridgeNetDevice> (device);
+      NS_ABORT_MSG_UNLESS (bridge, "Ipv6GlobalRouteManagerImpl::GetFirstChannel (): bridge is not a BridgeNetDevice");
+      for (uint32_t i = 0; i < bridge->GetNBridgePorts (); i++)
+        {
+          if (bridge->GetBridgePort (i)->GetChannel () != 0)
+            {
+              return bridge->GetBridgePort (i)->GetChannel ();
+            }
+        }
+      return 0;
+    }
+  return device->GetChannel ();
+}
+
+void
+Ipv6GlobalRouteManagerImpl::GetLinkDevices (Ptr<NetDevice> device, std::vector<Ptr<Channel> > &channels,
+                                            std::vector<Ptr<NetDevice> > &devices)
+{
+  NS_LOG_FUNCTION (device);
+  channels.clear ();
+  devices.clear ();
+  channels.push_back (GetFirstChannel (device));
+  std::vector<Ptr<BridgeNetDevice> > bridges;
+  for (uint32_t c = 0; c < channels.size (); c++)
+    {
+      Ptr<Channel> channel = channels[c];
+      for (uint32_t i = 0; i < channel->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> attached = channel->GetDevice (i);
+          // a bridge port stands for all the links of its bridge
+          Ptr<BridgeNetDevice> bridge = 0;
+          Ptr<Node> node = attached->GetNode ();
+          for (uint32_t j = 0; bridge == 0 && j < node->GetNDevices (); j++)
+            {
+              Ptr<BridgeNetDevice> candidate = DynamicCast<BridgeNetDevice> (node->GetDevice (j));
+              for (uint32_t k = 0; candidate != 0 && k < candidate->GetNBridgePorts (); k++)
+                {
+                  if (candidate->GetBridgePort (k) == attached)
+                    {
+                      bridge = candidate;
+                      break;
+                    }
+                }
+            }
+          if (bridge == 0)
+            {
+              devices.push_back (attached);
+              continue;
+            }
+          if (std::find (bridges.begin (), bridges.end (), bridge) != bridges.end ())
+            {
+              continue;
+            }
+          bridges.push_back (bridge);
+          devices.push_back (bridge);
+          for (uint32_t k = 0; k < bridge->GetNBridgePorts (); k++)
+            {
+              Ptr<Channel> other = bridge->GetBridgePort (k)->GetChannel ();
+              if (other != 0 && std::find (channels.begin (), channels.end (), other) == channels.end ())
+                {
+                  channels.push_back (other);
+                }
+            }
+        }
+    }
+}
+
+Ipv6Address
+Ipv6GlobalRouteManagerImpl::GetLinkLocalAddress (Ptr<Ipv6> ipv6, uint32_t interface)
+{
+  Ipv6Address global = Ipv6Address::GetZero ();
+  for (uint32_t i = 0; i < ipv6->GetNAddresses (interface); i++)
+    {
+      Ipv6InterfaceAddress address = ipv6->GetAddress (interface, i);
+      if (address.GetScope () == Ipv6InterfaceAddress::LINKLOCAL)
+        {
+          return address.GetAddress ();
+        }
+      if (address.GetScope () == Ipv6InterfaceAddress::GLOBAL && global.IsAny ())
+        {
+          global = address.GetAddress ();
+        }
+    }
+  return global;
+}
+
+void
+Ipv6GlobalRouteManagerImpl::AddPrefixes (Ptr<Ipv6> ipv6, uint32_t interface, uint32_t metric, Vertex &vertex,
+                                         std::vector<Prefix> &prefixes, std::map<Prefix, uint32_t> &prefixIds)
+{
+  for (uint32_t i = 0; i < ipv6->GetNAddresses (interface); i++)
+    {
+      Ipv6InterfaceAddress address = ipv6->GetAddress (interface, i);
+      if (address.GetScope () != Ipv6InterfaceAddress::GLOBAL)
+        {
+          continue;
+        }
+      Prefix prefix (address.GetAddress ().CombinePrefix (address.GetPrefix ()),
+                     address.GetPrefix ().GetPrefixLength ());
+      std::map<Prefix, uint32_t>::iterator it = prefixIds.find (prefix);
+      if (it == prefixIds.end ())
+        {
+          it = prefixIds.insert (std::make_pair (prefix, prefixes.size ())).first;
+          prefixes.push_back (prefix);
+        }
+      std::pair<uint32_t, uint32_t> entry (it->second, metric);
+      if (std::find (vertex.prefixes.begin (), vertex.prefixes.end (), entry) == vertex.prefixes.end ())
+        {
+          vertex.prefixes.push_back (entry);
+        }
+    }
+}
+
+void
+Ipv6GlobalRouteManagerImpl::BuildDatabase (std::vector<Vertex> &lsdb, std::vector<Prefix> &prefixes)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  std::map<Prefix, uint32_t> prefixIds;
+
+  // one vertex per router
+  std::map<uint32_t, uint32_t> routers;
+  for (NodeList::Iterator i = NodeList::Begin (); i != NodeList::End (); i++)
+    {
+      if (Ipv6GlobalRouteManager::GetGlobalRouting (*i) != 0)
+        {
+          routers[(*i)->GetId ()] = lsdb.size ();
+          Vertex router;
+          router.node = (*i)->GetId ();
+          lsdb.push_back (router);
+        }
+    }
+
+  // one vertex per link, created when the first of its routers is found
+  std::map<Ptr<Channel>, uint32_t> links;
+  std::vector<Ptr<Channel> > channels;
+  std::vector<Ptr<NetDevice> > devices;
+  for (std::map<uint32_t, uint32_t>::const_iterator r = routers.begin (); r != routers.end (); r++)
+    {
+      Ptr<Ipv6> ipv6 = NodeList::GetNode (r->first)->GetObject<Ipv6> ();
+      for (uint32_t i = 0; i < ipv6->GetNInterfaces (); i++)
+        {
+          if (!ipv6->IsUp (i))
+            {
+              continue;
+            }
+          Ptr<Channel> channel = GetFirstChannel (ipv6->GetNetDevice (i));
+          if (channel == 0)
+            {
+              // the prefixes of an interface without link belong to the router
+              AddPrefixes (ipv6, i, ipv6->GetMetric (i), lsdb[r->second], prefixes, prefixIds);
+              continue;
+            }
+          std::map<Ptr<Channel>, uint32_t>::const_iterator l = links.find (channel);
+          if (l == links.end ())
+            {
+              uint32_t vertex = lsdb.size ();
+              Vertex link;
+              link.node = NO_NODE;
+              GetLinkDevices (ipv6->GetNetDevice (i), channels, devices);
+              for (std::vector<Ptr<Channel> >::const_iterator c = channels.begin (); c != channels.end (); c++)
+                {
+                  links[*c] = vertex;
+                }
+              for (std::vector<Ptr<NetDevice> >::const_iterator d = devices.begin (); d != devices.end (); d++)
+                {
+                  Ptr<Ipv6> attached = (*d)->GetNode ()->GetObject<Ipv6> ();
+                  int32_t interface = attached != 0 ? attached->GetInterfaceForDevice (*d) : -1;
+                  if (interface < 0 || !attached->IsUp (interface))
+                    {
+                      continue;
+                    }
+                  AddPrefixes (attached, interface, 0, link, prefixes, prefixIds);
+                  std::map<uint32_t, uint32_t>::const_iterator peer = routers.find ((*d)->GetNode ()->GetId ());
+                  if (peer != routers.end ())
+                    {
+                      Link toRouter;
+                      toRouter.vertex = peer->second;
+                      toRouter.interface = interface;
+                      toRouter.nextHop = GetLinkLocalAddress (attached, interface);
+                      toRouter.metric = 0;
+                      link.links.push_back (toRouter);
+                    }
+                }
+              lsdb.push_back (link);
+              l = links.find (channel);
+            }
+          Link toLink;
+          toLink.vertex = l->second;
+          toLink.interface = i;
+          toLink.nextHop = Ipv6Address::GetZero ();
+          toLink.metric = ipv6->GetMetric (i);
+          lsdb[r->second].links.push_back (toLink);
+        }
+    }
+  NS_LOG_LOGIC ("Link-state database of " << lsdb.size () << " vertices and " << prefixes.size () << " prefixes");
+}
+
+void
+Ipv6GlobalRouteManagerImpl::AddNextHop (std::vector<NextHop> &hops, NextHop const &hop)
+{
+  if (std::find (hops.begin (), hops.end (), hop) == hops.end ())
+    {
+      hops.push_back (hop);
+    }
+}
+
+void
+Ipv6GlobalRouteManagerImpl::SPFCalculate (uint32_t root)
+{
+  NS_LOG_FUNCTION (this << root);
+  Ptr<Ipv6GlobalRouting> globalRouting = Ipv6GlobalRouteManager::GetGlobalRouting (NodeList::GetNode (m_lsdb[root].node));
+  NS_ASSERT (globalRouting != 0);
+
+  const uint32_t infinity = 0xffffffff;
+  std::vector<uint32_t> distance (m_lsdb.size (), infinity);
+  std::vector<bool> done (m_lsdb.size (), false);
+  std::vector<std::vector<NextHop> > hops (m_lsdb.size ());
+
+  // The candidates are ordered by distance, then links before routers: a
+  // router at the same distance as a link it is attached to gets all the
+  // equal-cost next hops of the link before being expanded.
+  typedef std::pair<uint32_t, std::pair<bool, uint32_t> > Candidate;
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > candidates;
+  distance[root] = 0;
+  candidates.push (Candidate (0, std::make_pair (true, root)));
+  while (!candidates.empty ())
+    {
+      uint32_t u = candidates.top ().second.second;
+      candidates.pop ();
+      if (done[u])
+        {
+          continue;
+        }
+      done[u] = true;
+      for (std::vector<Link>::const_iterator l = m_lsdb[u].links.begin (); l != m_lsdb[u].links.end (); l++)
+        {
+          uint32_t v = l->vertex;
+          uint32_t d = distance[u] + l->metric;
+          if (v == root || done[v] || d > distance[v])
+            {
+              continue;
+            }
+          if (d < distance[v])
+            {
+              distance[v] = d;
+              hops[v].clear ();
+              candidates.push (Candidate (d, std::make_pair (m_lsdb[v].node != NO_NODE, v)));
+            }
+          if (u == root)
+            {
+              NextHop hop;
+              hop.interface = l->interface;
+              hop.gateway = Ipv6Address::GetZero ();
+              AddNextHop (hops[v], hop);
+              continue;
+            }
+          for (std::vector<NextHop>::const_iterator h = hops[u].begin (); h != hops[u].end (); h++)
+            {
+              NextHop hop = *h;
+              if (hop.gateway.IsAny () && m_lsdb[u].node == NO_NODE)
+                {
+                  // a router on a link attached to the root
+                  hop.gateway = l->nextHop;
+                }
+              AddNextHop (hops[v], hop);
+            }
+        }
+    }
+
+  // the shortest path to each prefix, through any of the vertices
+  // advertising it
+  std::vector<uint32_t> prefixDistance (m_prefixes.size (), infinity);
+  std::vector<uint32_t> prefixVertices;
+  std::vector<std::vector<NextHop> > prefixHops (m_prefixes.size ());
+  for (uint32_t u = 0; u < m_lsdb.size (); u++)
+    {
+      if (u == root || distance[u] == infinity)
+        {
+          continue;
+        }
+      for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator p = m_lsdb[u].prefixes.begin ();
+           p != m_lsdb[u].prefixes.end (); p++)
+        {
+          uint32_t d = distance[u] + p->second;
+          if (d > prefixDistance[p->first])
+            {
+              continue;
+            }
+          if (d < prefixDistance[p->first])
+            {
+              if (prefixDistance[p->first] == infinity)
+                {
+                  prefixVertices.push_back (p->first);
+                }
+              prefixDistance[p->first] = d;
+              prefixHops[p->first].clear ();
+            }
+          for (std::vector<NextHop>::const_iterator h = hops[u].begin (); h != hops[u].end (); h++)
+            {
+              AddNextHop (prefixHops[p->first], *h);
+            }
+        }
+    }
+
+  for (std::vector<uint32_t>::const_iterator p = prefixVertices.begin (); p != prefixVertices.end (); p++)
+    {
+      Prefix const &prefix = m_prefixes[*p];
+      for (std::vector<NextHop>::const_iterator h = prefixHops[*p].begin (); h != prefixHops[*p].end (); h++)
+        {
+          NS_LOG_LOGIC ("Node " << m_lsdb[root].node << " adds route to " << prefix.first << "/" << int (prefix.second)
+                                << " through " << h->gateway << " on interface " << h->interface);
+          globalRouting->AddNetworkRouteTo (prefix.first, Ipv6Prefix (prefix.second), h->gateway, h->interface);
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,260 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV6_GLOBAL_ROUTE_MANAGER_H
+#define IPV6_GLOBAL_ROUTE_MANAGER_H
+
+#include <stdint.h>
+#include <vector>
+#include <map>
+#include "ns3/ptr.h"
+#include "ns3/ipv6-address.h"
+
+namespace ns3 {
+
+class Node;
+class Ipv6;
+class NetDevice;
+class Channel;
+class Ipv6GlobalRouting;
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief The global route manager of IPv6.
+ *
+ * This singleton object looks for the nodes running Ipv6GlobalRouting,
+ * builds a link-state database describing how they are connected, and
+ * computes shortest paths on a per-node basis to fill their routing
+ * tables, like GlobalRouteManager does for IPv4.
+ *
+ * The database follows OSPFv3 \RFC{5340}: the links are described by the
+ * topology and the addresses by prefixes, the routers attached to a
+ * link reach each other through their link-local addresses, and the
+ * link is a vertex of the graph, carrying the prefixes of all the
+ * interfaces attached to it, including those of the hosts which do not
+ * run global routing.
+ */
+class Ipv6GlobalRouteManager
+{
+public:
+  /**
+   * \brief Delete all the routes installed on the nodes running
+   * Ipv6GlobalRouting.
+   */
+  static void DeleteGlobalRoutes (void);
+
+  /**
+   * \brief Build the link-state database from the nodes running
+   * Ipv6GlobalRouting.
+   */
+  static void BuildGlobalRoutingDatabase (void);
+
+  /**
+   * \brief Rebuild the link-state database and, if it changed, delete
+   * all the global routes so that they can be computed again.
+   * \returns true if the routes must be recomputed with InitializeRoutes ()
+   */
+  static bool UpdateGlobalRoutingDatabase (void);
+
+  /**
+   * \brief Compute the shortest paths from every node running
+   * Ipv6GlobalRouting and fill their routing tables.
+   */
+  static void InitializeRoutes (void);
+
+  /**
+   * \brief Get the Ipv6GlobalRouting of a node.
+   *
+   * \param node the node
+   * \returns the Ipv6GlobalRouting, which is the routing protocol of the
+   * node or one of the protocols of its Ipv6ListRouting, or 0 if the node
+   * does not run global routing
+   */
+  static Ptr<Ipv6GlobalRouting> GetGlobalRouting (Ptr<Node> node);
+
+private:
+  /**
+   * \brief Copy construction is disallowed.
+   * \param srm object to copy from
+   */
+  Ipv6GlobalRouteManager (Ipv6GlobalRouteManager& srm);
+
+  /**
+   * \brief Copy assignment is disallowed.
+   * \param srm object to copy from
+   * \returns the copied object
+   */
+  Ipv6GlobalRouteManager& operator= (Ipv6GlobalRouteManager& srm);
+};
+
+/**
+ * \ingroup globalrouting
+ *
+ * \brief Implementation of Ipv6GlobalRouteManager
+ *
+ * The vertices of the graph are the routers and the links; a router
+ * reaches a link through one of its interfaces, at the cost of the
+ * interface metric, and a link reaches each of its routers at no cost.
+ * Bridged links form a single vertex.  The shortest paths are computed
+ * with Dijkstra's algorithm and a binary heap, and keep all the
+ * equal-cost next hops.
+ */
+class Ipv6GlobalRouteManagerImpl
+{
+public:
+  Ipv6GlobalRouteManagerImpl ();
+  virtual ~Ipv6GlobalRouteManagerImpl ();
+
+  /**
+   * \brief Delete all the routes installed on the nodes running
+   * Ipv6GlobalRouting.
+   */
+  void DeleteGlobalRoutes (void);
+
+  /**
+   * \brief Build the link-state database.
+   */
+  void BuildGlobalRoutingDatabase (void);
+
+  /**
+   * \brief Rebuild the link-state database and, if it changed, delete
+   * all the global routes.
+   * \returns true if the database changed
+   */
+  bool UpdateGlobalRoutingDatabase (void);
+
+  /**
+   * \brief Compute the routes of every router.
+   */
+  void InitializeRoutes (void);
+
+private:
+  /// An edge of the graph
+  struct Link
+  {
+    uint32_t vertex;      //!< the vertex reached
+    uint32_t interface;   //!< the interface of the router on the link
+    Ipv6Address nextHop;  //!< from a link to a router: the address of the router on the link
+    uint32_t metric;      //!< the cost of the edge
+    /**
+     * \param o another link
+     * \returns true if the links are the same
+     */
+    bool operator== (Link const &o) const;
+  };
+
+  /// A router or a link, and the prefixes it advertises
+  struct Vertex
+  {
+    uint32_t node;                                        //!< the node of a router, or NO_NODE for a link
+    std::vector<Link> links;                              //!< the edges to the adjacent vertices
+    std::vector<std::pair<uint32_t, uint32_t> > prefixes; //!< the prefixes (index in m_prefixes, cost)
+    /**
+     * \param o another vertex
+     * \returns true if the vertices are the same
+     */
+    bool operator== (Vertex const &o) const;
+  };
+
+  /// An equal-cost first hop towards a vertex
+  struct NextHop
+  {
+    uint32_t interface;   //!< the output interface of the root
+    Ipv6Address gateway;  //!< the next router, or the zero address on the attached links
+    /**
+     * \param o another next hop
+     * \returns true if the next hops are the same
+     */
+    bool operator== (NextHop const &o) const;
+  };
+
+  /// A prefix: network and prefix length
+  typedef std::pair<Ipv6Address, uint8_t> Prefix;
+
+  static const uint32_t NO_NODE = 0xffffffff; //!< the node of a link vertex
+
+  /**
+   * \brief Build a link-state database from the current topology.
+   *
+   * \param lsdb the vertices
+   * \param prefixes the prefixes the vertices refer to
+   */
+  static void BuildDatabase (std::vector<Vertex> &lsdb, std::vector<Prefix> &prefixes);
+
+  /**
+   * \brief Find the devices attached to the link of a device, across
+   * bridges.
+   *
+   * \param device the device
+   * \param channels the channels of the link
+   * \param devices the devices attached to the link, the bridges
+   * standing for their ports
+   */
+  static void GetLinkDevices (Ptr<NetDevice> device, std::vector<Ptr<Channel> > &channels,
+                              std::vector<Ptr<NetDevice> > &devices);
+
+  /**
+   * \param device a device
+   * \returns the first channel of the link of the device, or 0 for a
+   * device which is not attached to any link
+   */
+  static Ptr<Channel> GetFirstChannel (Ptr<NetDevice> device);
+
+  /**
+   * \param ipv6 an IPv6 stack
+   * \param interface one of its interfaces
+   * \returns the link-local address of the interface
+   */
+  static Ipv6Address GetLinkLocalAddress (Ptr<Ipv6> ipv6, uint32_t interface);
+
+  /**
+   * \brief Add the global prefixes of an interface to a vertex.
+   *
+   * \param ipv6 an IPv6 stack
+   * \param interface one of its interfaces
+   * \param metric the cost of the prefixes
+   * \param vertex the vertex
+   * \param prefixes the prefixes the vertices refer to
+   * \param prefixIds the index of the prefixes in prefixes
+   */
+  static void AddPrefixes (Ptr<Ipv6> ipv6, uint32_t interface, uint32_t metric, Vertex &vertex,
+                           std::vector<Prefix> &prefixes, std::map<Prefix, uint32_t> &prefixIds);
+
+  /**
+   * \brief Add a next hop to a list of equal-cost next hops, unless it
+   * is already there.
+   *
+   * \param hops the next hops
+   * \param hop the next hop
+   */
+  static void AddNextHop (std::vector<NextHop> &hops, NextHop const &hop);
+
+  /**
+   * \brief Compute the shortest paths from a router and fill its routing
+   * table.
+   *
+   * \param root the vertex of the router
+   */
+  void SPFCalculate (uint32_t root);
+
+  std::vector<Vertex> m_lsdb;       //!< the link-state database
+  std::vector<Prefix> m_prefixes;   //!< the prefixes advertised in the database
+};
+
+} // namespace ns3
+
+#endif /* IPV6_GLOBAL_ROUTE_MANAGER_H */
@@ -0,0 +1,416 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <iomanip>
+#include "ns3/names.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/boolean.h"
+#include "ns3/ipv6-route.h"
+#include "ipv6-routing-table-entry.h"
+#include "ipv6-global-routing.h"
+#include "ipv6-global-route-manager.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Ipv6GlobalRouting");
+
+NS_OBJECT_ENSURE_REGISTERED (Ipv6GlobalRouting);
+
+TypeId
+Ipv6GlobalRouting::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::Ipv6GlobalRouting")
+    .SetParent<Ipv6RoutingProtocol> ()
+    .SetGroupName ("Internet")
+    .AddConstructor<Ipv6GlobalRouting> ()
+    .AddAttribute ("RandomEcmpRouting",
+                   "Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv6GlobalRouting::m_randomEcmpRouting),
+                   MakeBooleanChecker ())
+    .AddAttribute ("RespondToInterfaceEvents",
+                   "Set to true if you want to dynamically recompute the global routes upon Interface notification events (up/down, or add/remove address)",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&Ipv6GlobalRouting::m_respondToInterfaceEvents),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+Ipv6GlobalRouting::Ipv6GlobalRouting ()
+  : m_randomEcmpRouting (false),
+    m_respondToInterfaceEvents (false),
+    m_routeIndexValid (false)
+{
+  NS_LOG_FUNCTION (this);
+
+  m_rand = CreateObject<UniformRandomVariable> ();
+}
+
+Ipv6GlobalRouting::~Ipv6GlobalRouting ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+Ipv6GlobalRouting::AddHostRouteTo (Ipv6Address dest, Ipv6Address nextHop, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << dest << nextHop << interface);
+  Ipv6RoutingTableEntry *route = new Ipv6RoutingTableEntry ();
+  *route = Ipv6RoutingTableEntry::CreateHostRouteTo (dest, nextHop, interface);
+  m_routes.push_back (route);
+  m_routeIndexValid = false;
+}
+
+void
+Ipv6GlobalRouting::AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ipv6Address nextHop, uint32_t interface)
+{
+  NS_LOG_FUNCTION (this << network << networkPrefix << nextHop << interface);
+  Ipv6RoutingTableEntry *route = new Ipv6RoutingTableEntry ();
+  *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo (network, networkPrefix, nextHop, interface);
+  m_routes.push_back (route);
+  m_routeIndexValid = false;
+}
+
+void
+Ipv6GlobalRouting::UpdateRouteIndex (void)
+{
+  if (m_routeIndexValid)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_routeIndex.Clear ();
+  for (RoutesCI it = m_routes.begin (); it != m_routes.end (); it++)
+    {
+      uint8_t address[16];
+      uint8_t mask[16];
+      (*it)->GetDestNetwork ().Serialize (address);
+      (*it)->GetDestNetworkPrefix ().GetBytes (mask);
+      m_routeIndex.Insert (address, mask, *it);
+    }
+  m_routeIndexValid = true;
+}
+
+Ptr<Ipv6Route>
+Ipv6GlobalRouting::LookupGlobal (Ipv6Address dest, Ptr<NetDevice> oif)
+{
+  NS_LOG_FUNCTION (this << dest << oif);
+
+  // The index returns the routes matching dest in table order: keep the
+  // ones with the longest prefix, which are the equal-cost paths.
+  UpdateRouteIndex ();
+  uint8_t address[16];
+  dest.Serialize (address);
+  std::vector<Ipv6RoutingTableEntry *> matches;
+  m_routeIndex.Lookup (address, matches);
+
+  std::vector<Ipv6RoutingTableEntry *> allRoutes;
+  uint8_t longestPrefix = 0;
+  for (std::vector<Ipv6RoutingTableEntry *>::const_iterator it = matches.begin (); it != matches.end (); it++)
+    {
+      Ipv6Prefix prefix = (*it)->GetDestNetworkPrefix ();
+      if (!prefix.IsMatch (dest, (*it)->GetDestNetwork ()))
+        {
+          continue;
+        }
+      if (oif != 0 && oif != m_ipv6->GetNetDevice ((*it)->GetInterface ()))
+        {
+          NS_LOG_LOGIC ("Not on requested interface, skipping");
+          continue;
+        }
+      uint8_t length = prefix.GetPrefixLength ();
+      if (allRoutes.size () > 0 && length < longestPrefix)
+        {
+          continue;
+        }
+      if (length > longestPrefix)
+        {
+          allRoutes.clear ();
+          longestPrefix = length;
+        }
+      allRoutes.push_back (*it);
+      NS_LOG_LOGIC (allRoutes.size () << " found global route " << **it);
+    }
+
+  if (allRoutes.size () == 0)
+    {
+      return 0;
+    }
+
+  // pick up one of the routes uniformly at random if random ECMP routing
+  // is enabled, or always select the first route consistently otherwise
+  uint32_t selectIndex = 0;
+  if (m_randomEcmpRouting)
+    {
+      selectIndex = m_rand->GetInteger (0, allRoutes.size () - 1);
+    }
+  Ipv6RoutingTableEntry *route = allRoutes.at (selectIndex);
+  uint32_t interfaceIdx = route->GetInterface ();
+
+  Ptr<Ipv6Route> rtentry = Create<Ipv6Route> ();
+  rtentry->SetSource (m_ipv6->SourceAddressSelection (interfaceIdx, dest));
+  rtentry->SetDestination (dest);
+  rtentry->SetGateway (route->GetGateway ());
+  rtentry->SetOutputDevice (m_ipv6->GetNetDevice (interfaceIdx));
+  return rtentry;
+}
+
+uint32_t
+Ipv6GlobalRouting::GetNRoutes (void) const
+{
+  return m_routes.size ();
+}
+
+Ipv6RoutingTableEntry *
+Ipv6GlobalRouting::GetRoute (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  NS_ASSERT_MSG (i < m_routes.size (), "Ipv6GlobalRouting::GetRoute (): index out of range");
+  RoutesCI it = m_routes.begin ();
+  std::advance (it, i);
+  return *it;
+}
+
+void
+Ipv6GlobalRouting::RemoveRoute (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  NS_ASSERT_MSG (i < m_routes.size (), "Ipv6GlobalRouting::RemoveRoute (): index out of range");
+  RoutesI it = m_routes.begin ();
+  std::advance (it, i);
+  delete *it;
+  m_routes.erase (it);
+  m_routeIndexValid = false;
+}
+
+int64_t
+Ipv6GlobalRouting::AssignStreams (int64_t stream)
+{
+  NS_LOG_FUNCTION (this << stream);
+  m_rand->SetStream (stream);
+  return 1;
+}
+
+void
+Ipv6GlobalRouting::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (RoutesI it = m_routes.begin (); it != m_routes.end (); it = m_routes.erase (it))
+    {
+      delete *it;
+    }
+  m_routeIndex.Clear ();
+  m_routeIndexValid = false;
+  m_ipv6 = 0;
+
+  Ipv6RoutingProtocol::DoDispose ();
+}
+
+void
+Ipv6GlobalRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
+{
+  NS_LOG_FUNCTION (this << stream);
+  std::ostream* os = stream->GetStream ();
+
+  *os << "Node: " << m_ipv6->GetObject<Node> ()->GetId ()
+      << ", Time: " << Now ().As (Time::S)
+      << ", Local time: " << GetObject<Node> ()->GetLocalTime ().As (Time::S)
+      << ", Ipv6GlobalRouting table" << std::endl;
+
+  if (GetNRoutes () > 0)
+    {
+      *os << "Destination                    Next Hop                   Flag Met Ref Use If" << std::endl;
+      for (RoutesCI it = m_routes.begin (); it != m_routes.end (); it++)
+        {
+          std::ostringstream dest, gw, flags;
+          Ipv6RoutingTableEntry *route = *it;
+          dest << route->GetDest () << "/" << int (route->GetDestNetworkPrefix ().GetPrefixLength ());
+          *os << std::setiosflags (std::ios::left) << std::setw (31) << dest.str ();
+          gw << route->GetGateway ();
+          *os << std::setiosflags (std::ios::left) << std::setw (27) << gw.str ();
+          flags << "U";
+          if (route->IsHost ())
+            {
+              flags << "H";
+            }
+          else if (route->IsGateway ())
+            {
+              flags << "G";
+            }
+          *os << std::setiosflags (std::ios::left) << std::setw (5) << flags.str ();
+          // Metric, Ref ct and Use not implemented
+          *os << "-" << "   ";
+          *os << "-" << "   ";
+          *os << "-" << "   ";
+          if (Names::FindName (m_ipv6->GetNetDevice (route->GetInterface ())) != "")
+            {
+              *os << Names::FindName (m_ipv6->GetNetDevice (route->GetInterface ()));
+            }
+          else
+            {
+              *os << route->GetInterface ();
+            }
+          *os << std::endl;
+        }
+    }
+  *os << std::endl;
+}
+
+Ptr<Ipv6Route>
+Ipv6GlobalRouting::RouteOutput (Ptr<Packet> p, const Ipv6Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr)
+{
+  NS_LOG_FUNCTION (this << p << header << oif);
+  Ipv6Address destination = header.GetDestinationAddress ();
+  if (destination.IsMulticast ())
+    {
+      NS_LOG_LOGIC ("Multicast destination-- returning false");
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+      return 0; // Let other routing protocols try to handle this
+    }
+
+  Ptr<Ipv6Route> rtentry = LookupGlobal (destination, oif);
+  if (rtentry)
+    {
+      sockerr = Socket::ERROR_NOTERROR;
+    }
+  else
+    {
+      sockerr = Socket::ERROR_NOROUTETOHOST;
+    }
+  return rtentry;
+}
+
+bool
+Ipv6GlobalRouting::RouteInput (Ptr<const Packet> p, const Ipv6Header &header, Ptr<const NetDevice> idev,
+                               UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                               LocalDeliverCallback lcb, ErrorCallback ecb)
+{
+  NS_LOG_FUNCTION (this << p << header << header.GetSourceAddress () << header.GetDestinationAddress () << idev);
+  NS_ASSERT (m_ipv6 != 0);
+  // Check if input device supports IP
+  NS_ASSERT (m_ipv6->GetInterfaceForDevice (idev) >= 0);
+  uint32_t iif = m_ipv6->GetInterfaceForDevice (idev);
+  Ipv6Address dst = header.GetDestinationAddress ();
+
+  if (dst.IsMulticast ())
+    {
+      NS_LOG_LOGIC ("Multicast destination-- returning false");
+      return false; // Let other routing protocols try to handle this
+    }
+
+  // Check if input device supports IP forwarding
+  if (m_ipv6->IsForwarding (iif) == false)
+    {
+      NS_LOG_LOGIC ("Forwarding disabled for this interface");
+      if (!ecb.IsNull ())
+        {
+          ecb (p, header, Socket::ERROR_NOROUTETOHOST);
+        }
+      return true;
+    }
+
+  // Next, try to find a route
+  NS_LOG_LOGIC ("Unicast destination- looking up global route");
+  Ptr<Ipv6Route> rtentry = LookupGlobal (dst);
+  if (rtentry != 0)
+    {
+      NS_LOG_LOGIC ("Found unicast destination- calling unicast callback");
+      ucb (idev, rtentry, p, header);
+      return true;
+    }
+  else
+    {
+      NS_LOG_LOGIC ("Did not find unicast destination- returning false");
+      return false; // Let other routing protocols try to handle this
+    }
+}
+
+void
+Ipv6GlobalRouting::NotifyInterfaceUp (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
+    {
+      Ipv6GlobalRouteManager::DeleteGlobalRoutes ();
+      Ipv6GlobalRouteManager::BuildGlobalRoutingDatabase ();
+      Ipv6GlobalRouteManager::InitializeRoutes ();
+    }
+}
+
+void
+Ipv6GlobalRouting::NotifyInterfaceDown (uint32_t i)
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
+    {
+      Ipv6GlobalRouteManager::DeleteGlobalRoutes ();
+      Ipv6GlobalRouteManager::BuildGlobalRoutingDatabase ();
+      Ipv6GlobalRouteManager::InitializeRoutes ();
+    }
+}
+
+void
+Ipv6GlobalRouting::NotifyAddAddress (uint32_t interface, Ipv6InterfaceAddress address)
+{
+  NS_LOG_FUNCTION (this << interface << address);
+  if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
+    {
+      Ipv6GlobalRouteManager::DeleteGlobalRoutes ();
+      Ipv6GlobalRouteManager::BuildGlobalRoutingDatabase ();
+      Ipv6GlobalRouteManager::InitializeRoutes ();
+    }
+}
+
+void
+Ipv6GlobalRouting::NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAddress address)
+{
+  NS_LOG_FUNCTION (this << interface << address);
+  if (m_respondToInterfaceEvents && Simulator::Now ().GetSeconds () > 0)  // avoid startup events
+    {
+      Ipv6GlobalRouteManager::DeleteGlobalRoutes ();
+      Ipv6GlobalRouteManager::BuildGlobalRoutingDatabase ();
+      Ipv6GlobalRouteManager::InitializeRoutes ();
+    }
+}
+
+void
+Ipv6GlobalRouting::NotifyAddRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse)
+{
+  // the routes only come from the global route manager
+  NS_LOG_FUNCTION (this << dst << mask << nextHop << interface << prefixToUse);
+}
+
+void
+Ipv6GlobalRouting::NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse)
+{
+  NS_LOG_FUNCTION (this << dst << mask << nextHop << interface << prefixToUse);
+}
+
+void
+Ipv6GlobalRouting::SetIpv6 (Ptr<Ipv6> ipv6)
+{
+  NS_LOG_FUNCTION (this << ipv6);
+  NS_ASSERT (m_ipv6 == 0 && ipv6 != 0);
+  m_ipv6 = ipv6;
+}
+
+} // namespace ns3
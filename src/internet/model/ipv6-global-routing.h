@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV6_GLOBAL_ROUTING_H
+#define IPV6_GLOBAL_ROUTING_H
+
+#include <list>
+#include <stdint.h>
+#include "ns3/ipv6-address.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ptr.h"
+#include "ns3/ipv6.h"
+#include "ns3/ipv6-routing-protocol.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/prefix-trie.h"
+
+namespace ns3 {
+
+class Packet;
+class NetDevice;
+class Ipv6RoutingTableEntry;
+
+/**
+ * \ingroup ipv6Routing
+ *
+ * \brief Global routing protocol for IPv6 stacks.
+ *
+ * This is the IPv6 counterpart of Ipv4GlobalRouting: it holds the routes
+ * computed by the Ipv6GlobalRouteManager "routing oracle", which has an
+ * omniscient view of the topology and computes shortest paths between
+ * all the nodes running this protocol, without any control traffic.
+ * The routes are kept apart from the ones of Ipv6StaticRouting, as they
+ * are cleared and rebuilt whenever the routes are recomputed.
+ *
+ * The next hop of a route is the link-local address of the neighbor
+ * router.  Routes to the same destination with the same cost are
+ * equal-cost multipaths: the first one is used, or one of them at random
+ * if RandomEcmpRouting is set.
+ *
+ * This class deals with IPv6 unicast routes only.
+ *
+ * \see Ipv6RoutingProtocol
+ * \see Ipv6GlobalRouteManager
+ */
+class Ipv6GlobalRouting : public Ipv6RoutingProtocol
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  Ipv6GlobalRouting ();
+  virtual ~Ipv6GlobalRouting ();
+
+  // These methods inherited from base class
+  virtual Ptr<Ipv6Route> RouteOutput (Ptr<Packet> p, const Ipv6Header &header, Ptr<NetDevice> oif, Socket::SocketErrno &sockerr);
+  virtual bool RouteInput  (Ptr<const Packet> p, const Ipv6Header &header, Ptr<const NetDevice> idev,
+                            UnicastForwardCallback ucb, MulticastForwardCallback mcb,
+                            LocalDeliverCallback lcb, ErrorCallback ecb);
+  virtual void NotifyInterfaceUp (uint32_t interface);
+  virtual void NotifyInterfaceDown (uint32_t interface);
+  virtual void NotifyAddAddress (uint32_t interface, Ipv6InterfaceAddress address);
+  virtual void NotifyRemoveAddress (uint32_t interface, Ipv6InterfaceAddress address);
+  virtual void NotifyAddRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse = Ipv6Address::GetZero ());
+  virtual void NotifyRemoveRoute (Ipv6Address dst, Ipv6Prefix mask, Ipv6Address nextHop, uint32_t interface, Ipv6Address prefixToUse = Ipv6Address::GetZero ());
+  virtual void SetIpv6 (Ptr<Ipv6> ipv6);
+  virtual void PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const;
+
+  /**
+   * \brief Add a host route to the global routing table.
+   *
+   * \param dest the destination
+   * \param nextHop the next hop, or the zero address for an on-link
+   * destination
+   * \param interface the output interface
+   */
+  void AddHostRouteTo (Ipv6Address dest, Ipv6Address nextHop, uint32_t interface);
+
+  /**
+   * \brief Add a network route to the global routing table.
+   *
+   * \param network the destination network
+   * \param networkPrefix the prefix of the destination network
+   * \param nextHop the next hop, or the zero address for an on-link
+   * network
+   * \param interface the output interface
+   */
+  void AddNetworkRouteTo (Ipv6Address network, Ipv6Prefix networkPrefix, Ipv6Address nextHop, uint32_t interface);
+
+  /**
+   * \brief Get the number of individual unicast routes that have been
+   * added to the routing table.
+   * \returns the number of routes
+   */
+  uint32_t GetNRoutes (void) const;
+
+  /**
+   * \brief Get a route from the global unicast routing table.
+   *
+   * \param i the index of the route, from 0 to GetNRoutes () - 1
+   * \returns the route
+   */
+  Ipv6RoutingTableEntry *GetRoute (uint32_t i) const;
+
+  /**
+   * \brief Remove a route from the global unicast routing table.
+   *
+   * \param i the index of the route, from 0 to GetNRoutes () - 1
+   */
+  void RemoveRoute (uint32_t i);
+
+  /**
+   * Assign a fixed random variable stream number to the random variables
+   * used by this model.  Return the number of streams (possibly zero) that
+   * have been assigned.
+   *
+   * \param stream first stream index to use
+   * \return the number of stream indices assigned by this model
+   */
+  int64_t AssignStreams (int64_t stream);
+
+protected:
+  void DoDispose (void);
+
+private:
+  /**
+   * \brief Look up a route.
+   *
+   * \param dest the destination
+   * \param oif the output device, or 0 for any
+   * \returns the route, or 0 if there is none
+   */
+  Ptr<Ipv6Route> LookupGlobal (Ipv6Address dest, Ptr<NetDevice> oif = 0);
+
+  /**
+   * \brief Rebuild the route index after the routes changed.
+   */
+  void UpdateRouteIndex (void);
+
+  /// Set to true if packets are randomly routed among ECMP; set to false for using only one route consistently
+  bool m_randomEcmpRouting;
+  /// Set to true if this interface should respond to interface events by globally recomputing routes
+  bool m_respondToInterfaceEvents;
+  /// A uniform random number generator for randomly routing packets among ECMP
+  Ptr<UniformRandomVariable> m_rand;
+
+  /// container of Ipv6RoutingTableEntry (routes)
+  typedef std::list<Ipv6RoutingTableEntry *> Routes;
+  /// const iterator of container of Ipv6RoutingTableEntry (routes)
+  typedef std::list<Ipv6RoutingTableEntry *>::const_iterator RoutesCI;
+  /// iterator of container of Ipv6RoutingTableEntry (routes)
+  typedef std::list<Ipv6RoutingTableEntry *>::iterator RoutesI;
+
+  Routes m_routes;                                     //!< the routes
+  PrefixTrie<Ipv6RoutingTableEntry *, 16> m_routeIndex; //!< index of m_routes
+  bool m_routeIndexValid;                              //!< false when m_routeIndex must be rebuilt
+
+  Ptr<Ipv6> m_ipv6; //!< associated IPv6 instance
+};
+
+} // Namespace ns3
+
+#endif /* IPV6_GLOBAL_ROUTING_H */
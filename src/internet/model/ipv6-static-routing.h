@@ -30,6 +30,7 @@
 #include "ns3/ipv6.h"
 #include "ns3/ipv6-header.h"
 #include "ns3/ipv6-routing-protocol.h"
+#include "ns3/prefix-trie.h"
 
 namespace ns3 {
 
@@ -287,11 +288,27 @@ private:
    */
   Ptr<Ipv6MulticastRoute> LookupStatic (Ipv6Address origin, Ipv6Address group, uint32_t ifIndex);
 
+  /**
+   * \brief Rebuild m_networkIndex from m_networkRoutes if a route was
+   * added or removed since the last lookup.
+   */
+  void UpdateNetworkIndex (void);
+
   /**
    * \brief the forwarding table for network.
    */
   NetworkRoutes m_networkRoutes;
 
+  /**
+   * \brief m_networkRoutes indexed by destination prefix.
+   */
+  PrefixTrie<std::pair <Ipv6RoutingTableEntry *, uint32_t>, 16> m_networkIndex;
+
+  /**
+   * \brief Whether m_networkIndex matches m_networkRoutes.
+   */
+  bool m_networkIndexValid;
+
   /**
    * \brief the forwarding table for multicast.
    */
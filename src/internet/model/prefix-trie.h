@@ -0,0 +1,393 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PREFIX_TRIE_H
+#define PREFIX_TRIE_H
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+namespace ns3 {
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief An index of routes by destination prefix
+ *
+ * The routing protocols keep their routes in lists, and used to find the
+ * routes matching a destination by checking every route of the list.
+ * This class indexes the (address, mask) pairs of a list of routes in a
+ * path-compressed binary trie: a lookup walks at most one node per bit of
+ * the address, and each node only holds the prefixes which end there.
+ *
+ * Lookup returns all the routes matching an address, in the order in
+ * which they were inserted, so that the routing protocols can apply their
+ * own selection rules (longest prefix, metric, first match...) to this
+ * short list exactly as they did to the whole list.  Routes whose mask is
+ * not a prefix mask are kept aside and checked one by one.
+ *
+ * Routes are inserted in bulk, and the trie is built on the first lookup
+ * which follows.  Routing protocols clear and refill the index whenever
+ * their route list changes.
+ *
+ * \tparam T the type of the routes
+ * \tparam BYTES the size of the addresses, in bytes (4 or 16)
+ */
+template <typename T, uint32_t BYTES>
+class PrefixTrie
+{
+public:
+  PrefixTrie ();
+
+  /**
+   * \brief Remove all the routes.
+   */
+  void Clear (void);
+
+  /**
+   * \brief Add a route.
+   *
+   * \param address the destination of the route, in network byte order.
+   * Only the bits selected by the mask are significant.
+   * \param mask the destination mask, in network byte order
+   * \param route the route
+   */
+  void Insert (const uint8_t *address, const uint8_t *mask, T route);
+
+  /**
+   * \brief Find the routes matching an address.
+   *
+   * \param address the address to look up, in network byte order
+   * \param matches the routes whose destination matches the address are
+   * appended to this vector, in insertion order
+   */
+  void Lookup (const uint8_t *address, std::vector<T> &matches) const;
+
+  /**
+   * \returns the number of routes
+   */
+  uint32_t GetN (void) const;
+
+private:
+  /**
+   * \brief A route and its mask
+   */
+  struct Entry
+  {
+    uint8_t address[BYTES];  //!< destination, masked
+    uint8_t mask[BYTES];     //!< mask
+    uint32_t length;         //!< prefix length, if the mask is a prefix mask
+    uint32_t order;          //!< insertion order
+    T route;                 //!< the route
+  };
+
+  /**
+   * \brief A node of the trie: a prefix, the routes for exactly this
+   * prefix, and the subtrees of longer prefixes.
+   */
+  struct Node
+  {
+    uint8_t prefix[BYTES];   //!< the prefix, masked
+    uint32_t length;         //!< prefix length
+    int32_t child[2];        //!< subtrees, by value of bit 'length', or -1
+    uint32_t begin;          //!< first route, in m_routes
+    uint32_t end;            //!< past the last route, in m_routes
+  };
+
+  /**
+   * \param a an address or prefix
+   * \param bit a bit index, 0 being the most significant bit
+   * \returns the value of the bit
+   */
+  static uint32_t GetBit (const uint8_t *a, uint32_t bit);
+
+  /**
+   * \param a an address or prefix
+   * \param b another address or prefix
+   * \param length a number of bits
+   * \returns true if the first length bits of a and b are equal
+   */
+  static bool IsMatch (const uint8_t *a, const uint8_t *b, uint32_t length);
+
+  /**
+   * \param mask a mask
+   * \returns the prefix length of the mask, or BYTES * 8 + 1 if the mask
+   * is not a prefix mask
+   */
+  static uint32_t GetPrefixLength (const uint8_t *mask);
+
+  /**
+   * \brief Build the trie from m_entries.
+   */
+  void Build (void) const;
+
+  /**
+   * \brief Build the subtree holding a set of prefixes.
+   *
+   * \param entries indices in m_entries of prefixes sharing the first
+   * length bits, sorted by insertion order
+   * \param length the length of the prefix of the node to create
+   * \returns the index of the node in m_nodes
+   */
+  int32_t BuildNode (std::vector<uint32_t> const &entries, uint32_t length) const;
+
+  std::vector<Entry> m_entries;          //!< routes, in insertion order
+  std::vector<uint32_t> m_unindexed;     //!< routes whose mask is not a prefix mask
+  mutable std::vector<Node> m_nodes;     //!< the trie, root first
+  mutable std::vector<uint32_t> m_routes; //!< routes of the nodes, as indices in m_entries
+  mutable bool m_built;                  //!< whether m_nodes reflects m_entries
+  mutable std::vector<uint32_t> m_found; //!< scratch buffer of Lookup, kept to avoid an allocation per lookup
+};
+
+template <typename T, uint32_t BYTES>
+PrefixTrie<T, BYTES>::PrefixTrie ()
+  : m_built (false)
+{
+}
+
+template <typename T, uint32_t BYTES>
+void
+PrefixTrie<T, BYTES>::Clear (void)
+{
+  m_entries.clear ();
+  m_unindexed.clear ();
+  m_nodes.clear ();
+  m_routes.clear ();
+  m_built = false;
+}
+
+template <typename T, uint32_t BYTES>
+void
+PrefixTrie<T, BYTES>::Insert (const uint8_t *address, const uint8_t *mask, T route)
+{
+  Entry entry;
+  for (uint32_t i = 0; i < BYTES; i++)
+    {
+      entry.address[i] = address[i] & mask[i];
+      entry.mask[i] = mask[i];
+    }
+  entry.length = GetPrefixLength (mask);
+  entry.order = m_entries.size ();
+  entry.route = route;
+  if (entry.length > BYTES * 8)
+    {
+      m_unindexed.push_back (m_entries.size ());
+    }
+  m_entries.push_back (entry);
+  m_built = false;
+}
+
+template <typename T, uint32_t BYTES>
+uint32_t
+PrefixTrie<T, BYTES>::GetN (void) const
+{
+  return m_entries.size ();
+}
+
+template <typename T, uint32_t BYTES>
+uint32_t
+PrefixTrie<T, BYTES>::GetBit (const uint8_t *a, uint32_t bit)
+{
+  return (a[bit / 8] >> (7 - bit % 8)) & 1;
+}
+
+template <typename T, uint32_t BYTES>
+bool
+PrefixTrie<T, BYTES>::IsMatch (const uint8_t *a, const uint8_t *b, uint32_t length)
+{
+  uint32_t bytes = length / 8;
+  if (std::memcmp (a, b, bytes) != 0)
+    {
+      return false;
+    }
+  uint32_t bits = length % 8;
+  if (bits == 0)
+    {
+      return true;
+    }
+  uint8_t mask = static_cast<uint8_t> (0xff << (8 - bits));
+  return ((a[bytes] ^ b[bytes]) & mask) == 0;
+}
+
+template <typename T, uint32_t BYTES>
+uint32_t
+PrefixTrie<T, BYTES>::GetPrefixLength (const uint8_t *mask)
+{
+  uint32_t length = 0;
+  while (length < BYTES * 8 && GetBit (mask, length))
+    {
+      length++;
+    }
+  for (uint32_t bit = length; bit < BYTES * 8; bit++)
+    {
+      if (GetBit (mask, bit))
+        {
+          return BYTES * 8 + 1;
+        }
+    }
+  return length;
+}
+
+template <typename T, uint32_t BYTES>
+void
+PrefixTrie<T, BYTES>::Build (void) const
+{
+  m_nodes.clear ();
+  m_routes.clear ();
+  std::vector<uint32_t> entries;
+  entries.reserve (m_entries.size ());
+  for (uint32_t i = 0; i < m_entries.size (); i++)
+    {
+      if (m_entries[i].length <= BYTES * 8)
+        {
+          entries.push_back (i);
+        }
+    }
+  if (!entries.empty ())
+    {
+      BuildNode (entries, 0);
+    }
+  m_built = true;
+}
+
+template <typename T, uint32_t BYTES>
+int32_t
+PrefixTrie<T, BYTES>::BuildNode (std::vector<uint32_t> const &entries, uint32_t length) const
+{
+  int32_t index = m_nodes.size ();
+  m_nodes.push_back (Node ());
+  Node node;
+  std::memset (node.prefix, 0, BYTES);
+  const uint8_t *first = m_entries[entries.front ()].address;
+  for (uint32_t bit = 0; bit < length; bit++)
+    {
+      node.prefix[bit / 8] |= GetBit (first, bit) << (7 - bit % 8);
+    }
+  node.length = length;
+  node.child[0] = -1;
+  node.child[1] = -1;
+
+  //
+  // The routes for exactly this prefix stay here; the others go down the
+  // subtree selected by their next bit.
+  //
+  node.begin = m_routes.size ();
+  std::vector<uint32_t> sub[2];
+  for (std::vector<uint32_t>::const_iterator i = entries.begin (); i != entries.end (); i++)
+    {
+      Entry const &entry = m_entries[*i];
+      if (entry.length == length)
+        {
+          m_routes.push_back (*i);
+        }
+      else
+        {
+          sub[GetBit (entry.address, length)].push_back (*i);
+        }
+    }
+  node.end = m_routes.size ();
+
+  for (uint32_t b = 0; b < 2; b++)
+    {
+      if (sub[b].empty ())
+        {
+          continue;
+        }
+      //
+      // Path compression: skip the bits all the prefixes of the subtree
+      // have in common.
+      //
+      uint32_t common = BYTES * 8;
+      const uint8_t *ref = m_entries[sub[b].front ()].address;
+      for (std::vector<uint32_t>::const_iterator i = sub[b].begin (); i != sub[b].end (); i++)
+        {
+          Entry const &entry = m_entries[*i];
+          common = std::min (common, entry.length);
+          uint32_t bit = length + 1;
+          while (bit < common && GetBit (entry.address, bit) == GetBit (ref, bit))
+            {
+              bit++;
+            }
+          common = std::min (common, bit);
+        }
+      node.child[b] = BuildNode (sub[b], common);
+    }
+  m_nodes[index] = node;
+  return index;
+}
+
+template <typename T, uint32_t BYTES>
+void
+PrefixTrie<T, BYTES>::Lookup (const uint8_t *address, std::vector<T> &matches) const
+{
+  if (!m_built)
+    {
+      Build ();
+    }
+  std::vector<uint32_t> &found = m_found;
+  found.clear ();
+  // the routes of a node are in insertion order; only a lookup matching
+  // routes of several nodes, or unindexed routes, needs to sort them
+  bool sorted = true;
+  int32_t current = m_nodes.empty () ? -1 : 0;
+  while (current >= 0)
+    {
+      Node const &node = m_nodes[current];
+      if (!IsMatch (address, node.prefix, node.length))
+        {
+          break;
+        }
+      if (node.begin != node.end)
+        {
+          sorted = sorted && (found.empty () || found.back () < m_routes[node.begin]);
+          found.insert (found.end (), m_routes.begin () + node.begin, m_routes.begin () + node.end);
+        }
+      if (node.length == BYTES * 8)
+        {
+          break;
+        }
+      current = node.child[GetBit (address, node.length)];
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_unindexed.begin (); i != m_unindexed.end (); i++)
+    {
+      Entry const &entry = m_entries[*i];
+      bool match = true;
+      for (uint32_t j = 0; j < BYTES && match; j++)
+        {
+          match = (address[j] & entry.mask[j]) == entry.address[j];
+        }
+      if (match)
+        {
+          sorted = sorted && (found.empty () || found.back () < *i);
+          found.push_back (*i);
+        }
+    }
+  // indices in m_entries are in insertion order
+  if (!sorted)
+    {
+      std::sort (found.begin (), found.end ());
+    }
+  for (std::vector<uint32_t>::const_iterator i = found.begin (); i != found.end (); i++)
+    {
+      matches.push_back (m_entries[*i].route);
+    }
+}
+
+} // namespace ns3
+
+#endif /* PREFIX_TRIE_H */
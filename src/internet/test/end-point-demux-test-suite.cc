@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-interface.h"
+#include "../model/ipv4-end-point.h"
+#include "../model/ipv4-end-point-demux.h"
+#include "../model/ipv6-end-point.h"
+#include "../model/ipv6-end-point-demux.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the end points returned by Ipv4EndPointDemux, as connected
+ * and listening end points are allocated, connected and deallocated.
+ */
+class Ipv4EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv4EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4EndPointDemuxTestCase::Ipv4EndPointDemuxTestCase ()
+  : TestCase ("Ipv4EndPointDemux lookups")
+{
+}
+
+void
+Ipv4EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv4EndPointDemux demux;
+  Ptr<Ipv4Interface> interface = CreateObject<Ipv4Interface> ();
+  Ipv4Address local ("10.0.0.1");
+  Ipv4Address peer ("10.0.0.2");
+
+  Ipv4EndPoint *listener = demux.Allocate (80);
+  Ipv4EndPoint *connected = demux.Allocate (local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (connected, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 80, peer, 1000), 0, "Duplicate four-tuple allocated");
+
+  Ipv4EndPointDemux::EndPoints found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), connected, "Connected end point not found");
+  found = demux.Lookup (local, 80, peer, 1001, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Listening end point not found");
+  found = demux.Lookup (local, 81, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 0, "End point found on an unused port");
+
+  // an end point bound to a port, then connected
+  Ipv4EndPoint *bound = demux.Allocate (local, 81);
+  bound->SetPeer (peer, 2000);
+  found = demux.Lookup (local, 81, peer, 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), bound, "End point not found after SetPeer");
+  found = demux.Lookup (local, 81, peer, 2001, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 0, "End point found for another peer");
+
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), true, "Port 80 not in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (81), true, "Port 81 not in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (82), false, "Port 82 in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (local, 81), true, "Address and port 81 not in use");
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupLocal (peer, 81), false, "Peer address and port 81 in use");
+
+  // the least generic end point on the port wins, as before
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 80, peer, 1000), connected, "Exact match not found");
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 80, Ipv4Address ("10.0.0.3"), 5), connected,
+                         "Least generic end point not found");
+
+  Ipv4EndPointDemux::EndPoints all = demux.GetAllEndPoints ();
+  NS_TEST_ASSERT_MSG_EQ (all.size (), 3, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (all.front (), listener, "End points not in allocation order");
+  NS_TEST_ASSERT_MSG_EQ (all.back (), bound, "End points not in allocation order");
+
+  demux.DeAllocate (connected);
+  found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Listening end point not found");
+  demux.DeAllocate (listener);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (80), false, "Port 80 still in use");
+
+  // the first allocated connected end point is the least generic, even if
+  // it was connected last
+  Ipv4EndPoint *early = demux.Allocate (local, 82);
+  Ipv4EndPoint *late = demux.Allocate (local, 82, peer, 3000);
+  early->SetPeer (peer, 3001);
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 82, peer, 3000), late, "Exact match not found");
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 82, Ipv4Address ("10.0.0.3"), 5), early,
+                         "First connected end point not found");
+  demux.DeAllocate (early);
+  NS_TEST_ASSERT_MSG_EQ (demux.SimpleLookup (local, 82, Ipv4Address ("10.0.0.3"), 5), late,
+                         "Remaining connected end point not found");
+  demux.DeAllocate (late);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (82), false, "Port 82 still in use");
+
+  // ephemeral ports skip the ports used by connected end points
+  Ipv4EndPoint *ephemeral = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_EQ (ephemeral->GetLocalPort (), 49153, "Wrong ephemeral port");
+  demux.Allocate (local, 49154, peer, 3000);
+  ephemeral = demux.Allocate ();
+  NS_TEST_ASSERT_MSG_EQ (ephemeral->GetLocalPort (), 49155, "Ephemeral port in use allocated");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the end points returned by Ipv6EndPointDemux.
+ */
+class Ipv6EndPointDemuxTestCase : public TestCase
+{
+public:
+  Ipv6EndPointDemuxTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv6EndPointDemuxTestCase::Ipv6EndPointDemuxTestCase ()
+  : TestCase ("Ipv6EndPointDemux lookups")
+{
+}
+
+void
+Ipv6EndPointDemuxTestCase::DoRun (void)
+{
+  Ipv6EndPointDemux demux;
+  Ptr<Ipv6Interface> interface = CreateObject<Ipv6Interface> ();
+  Ipv6Address local ("2001:db8::1");
+  Ipv6Address peer ("2001:db8::2");
+
+  Ipv6EndPoint *listener = demux.Allocate (80);
+  Ipv6EndPoint *connected = demux.Allocate (local, 80, peer, 1000);
+  NS_TEST_ASSERT_MSG_NE (connected, 0, "Allocation failed");
+  NS_TEST_ASSERT_MSG_EQ (demux.Allocate (local, 80, peer, 1000), 0, "Duplicate four-tuple allocated");
+
+  Ipv6EndPointDemux::EndPoints found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), connected, "Connected end point not found");
+  found = demux.Lookup (local, 80, peer, 1001, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Listening end point not found");
+
+  // an end point moved to another port and peer
+  Ipv6EndPoint *moved = demux.Allocate (local, 81);
+  moved->SetLocalPort (82);
+  moved->SetPeer (peer, 2000);
+  NS_TEST_ASSERT_MSG_EQ (demux.LookupPortLocal (81), false, "Port 81 still in use");
+  found = demux.Lookup (local, 82, peer, 2000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), moved, "End point not found after SetLocalPort");
+
+  NS_TEST_ASSERT_MSG_EQ (demux.GetEndPoints ().size (), 3, "Wrong number of end points");
+  demux.DeAllocate (connected);
+  found = demux.Lookup (local, 80, peer, 1000, interface);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 1, "Wrong number of end points");
+  NS_TEST_ASSERT_MSG_EQ (found.front (), listener, "Listening end point not found");
+  NS_TEST_ASSERT_MSG_EQ (demux.GetEndPoints ().size (), 2, "Wrong number of end points");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief End point demultiplexer TestSuite
+ */
+class EndPointDemuxTestSuite : public TestSuite
+{
+public:
+  EndPointDemuxTestSuite ()
+    : TestSuite ("end-point-demux", UNIT)
+  {
+    AddTestCase (new Ipv4EndPointDemuxTestCase, TestCase::QUICK);
+    AddTestCase (new Ipv6EndPointDemuxTestCase, TestCase::QUICK);
+  }
+};
+
+static EndPointDemuxTestSuite g_endPointDemuxTestSuite;
@@ -214,6 +214,62 @@ GlobalRouteManagerImplTestCase::DoRun (void)
 }
 
 
+class CandidateQueueOrderTestCase : public TestCase
+{
+public:
+  CandidateQueueOrderTestCase ();
+  virtual void DoRun (void);
+};
+
+CandidateQueueOrderTestCase::CandidateQueueOrderTestCase ()
+  : TestCase ("CandidateQueue ordering")
+{
+}
+
+void
+CandidateQueueOrderTestCase::DoRun (void)
+{
+  CandidateQueue candidate;
+  // vertex i is 0.0.0.i, at distance distances[i]
+  const uint32_t distances[] = { 5, 3, 5, 1, 3, 5, 2 };
+  const uint32_t n = sizeof (distances) / sizeof (distances[0]);
+  SPFVertex *vertices[n];
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      vertices[i] = new SPFVertex;
+      vertices[i]->SetVertexId (Ipv4Address (i));
+      vertices[i]->SetVertexType (SPFVertex::VertexRouter);
+      vertices[i]->SetDistanceFromRoot (distances[i]);
+      candidate.Push (vertices[i]);
+    }
+  // a network vertex comes before routers at the same distance
+  SPFVertex *network = new SPFVertex;
+  network->SetVertexId (Ipv4Address ("10.0.0.1"));
+  network->SetVertexType (SPFVertex::VertexNetwork);
+  network->SetDistanceFromRoot (3);
+  candidate.Push (network);
+
+  NS_TEST_ASSERT_MSG_EQ (candidate.Size (), n + 1, "Wrong queue size");
+  NS_TEST_ASSERT_MSG_EQ (candidate.Find (Ipv4Address (2)), vertices[2], "Find failed");
+  NS_TEST_ASSERT_MSG_EQ (candidate.Find (Ipv4Address (100)), 0, "Found a vertex not in the queue");
+
+  // 0.0.0.5 gets closer, and goes after the other vertices at distance 3
+  vertices[5]->SetDistanceFromRoot (3);
+  candidate.Reorder (vertices[5]);
+
+  SPFVertex *expected[] = { vertices[3], vertices[6], network, vertices[1], vertices[4],
+                            vertices[5], vertices[0], vertices[2] };
+  for (uint32_t i = 0; i < n + 1; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (candidate.Top (), expected[i], "Wrong top of queue at step " << i);
+      SPFVertex *v = candidate.Pop ();
+      NS_TEST_ASSERT_MSG_EQ (v, expected[i], "Wrong pop order at step " << i);
+      NS_TEST_ASSERT_MSG_EQ (candidate.Find (v->GetVertexId ()), 0, "Popped vertex still found");
+      delete v;
+    }
+  NS_TEST_ASSERT_MSG_EQ (candidate.Empty (), true, "Queue not empty");
+}
+
 static class GlobalRouteManagerImplTestSuite : public TestSuite
 {
 public:
@@ -221,5 +277,6 @@ public:
     : TestSuite ("global-route-manager-impl", UNIT)
   {
     AddTestCase (new GlobalRouteManagerImplTestCase (), TestCase::QUICK);
+    AddTestCase (new CandidateQueueOrderTestCase (), TestCase::QUICK);
   }
 } g_globalRoutingManagerImplTestSuite;
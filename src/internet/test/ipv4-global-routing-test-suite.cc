@@ -42,6 +42,7 @@
 #include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-global-routing.h"
 #include "ns3/bridge-helper.h"
+#include "ns3/tcp-header.h"
 
 using namespace ns3;
 
@@ -1167,6 +1168,109 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+// Two equal-cost routes to 10.2.0.0/16, through two interfaces; with
+// FlowEcmpRouting, each flow must consistently use one of them, with or
+// without the flow cache, and the flows must use both, including the TCP
+// flows between the same two hosts.
+class Ipv4GlobalRoutingFlowEcmpTestCase : public TestCase
+{
+public:
+  Ipv4GlobalRoutingFlowEcmpTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Ipv4GlobalRoutingFlowEcmpTestCase::Ipv4GlobalRoutingFlowEcmpTestCase ()
+  : TestCase ("Per-flow ECMP routing and flow cache")
+{
+}
+
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::DoRun (void)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper internet;
+  internet.Install (node);
+  SimpleNetDeviceHelper simpleHelper;
+  NetDeviceContainer net = simpleHelper.Install (node, CreateObject<SimpleChannel> ());
+  net.Add (simpleHelper.Install (node, CreateObject<SimpleChannel> ()));
+  Ipv4AddressHelper ipv4;
+  ipv4.SetBase ("10.1.1.0", "255.255.255.0");
+  ipv4.Assign (net.Get (0));
+  ipv4.SetBase ("10.1.2.0", "255.255.255.0");
+  ipv4.Assign (net.Get (1));
+
+  Ptr<Ipv4GlobalRouting> routing = CreateObject<Ipv4GlobalRouting> ();
+  routing->SetAttribute ("FlowEcmpRouting", BooleanValue (true));
+  routing->SetIpv4 (node->GetObject<Ipv4> ());
+  routing->AddNetworkRouteTo (Ipv4Address ("10.2.0.0"), Ipv4Mask ("255.255.0.0"), Ipv4Address ("10.1.1.2"), 1);
+  routing->AddNetworkRouteTo (Ipv4Address ("10.2.0.0"), Ipv4Mask ("255.255.0.0"), Ipv4Address ("10.1.2.2"), 2);
+
+  const uint32_t nFlows = 64;
+  std::vector<Ipv4Address> gateways;
+  Socket::SocketErrno sockerr;
+  Ipv4Header header;
+  header.SetDestination (Ipv4Address ("10.2.0.1"));
+  header.SetProtocol (17);
+  uint32_t first = 0;
+  for (uint32_t i = 0; i < nFlows; ++i)
+    {
+      header.SetSource (Ipv4Address (0x0a030000 + i));
+      Ptr<Ipv4Route> route = routing->RouteOutput (0, header, 0, sockerr);
+      NS_TEST_ASSERT_MSG_NE (route, 0, "No route for flow " << i);
+      gateways.push_back (route->GetGateway ());
+      first += (route->GetGateway () == Ipv4Address ("10.1.1.2"));
+    }
+  NS_TEST_EXPECT_MSG_GT (first, 0, "The first route is never used");
+  NS_TEST_EXPECT_MSG_LT (first, nFlows, "The second route is never used");
+
+  // again with a cache, then a small one with collisions, then none
+  const uint32_t cacheSizes[] = { 256, 4, 0 };
+  for (uint32_t c = 0; c < 3; ++c)
+    {
+      uint32_t cacheSize = cacheSizes[c];
+      routing->SetAttribute ("FlowCacheSize", UintegerValue (cacheSize));
+      for (uint32_t i = 0; i < nFlows; ++i)
+        {
+          header.SetSource (Ipv4Address (0x0a030000 + i));
+          Ptr<Ipv4Route> route = routing->RouteOutput (0, header, 0, sockerr);
+          NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), gateways[i], "Flow " << i << " changed route, cache size " << cacheSize);
+        }
+    }
+
+  // TCP segments carry their ports when their route is looked up
+  header.SetSource (Ipv4Address ("10.1.1.1"));
+  header.SetProtocol (6);
+  first = 0;
+  for (uint32_t i = 0; i < nFlows; ++i)
+    {
+      TcpHeader tcpHeader;
+      tcpHeader.SetSourcePort (49153 + i);
+      tcpHeader.SetDestinationPort (80);
+      Ptr<Packet> segment = Create<Packet> (100);
+      segment->AddHeader (tcpHeader);
+      Ptr<Ipv4Route> route = routing->RouteOutput (segment, header, 0, sockerr);
+      Ptr<Ipv4Route> again = routing->RouteOutput (segment, header, 0, sockerr);
+      NS_TEST_EXPECT_MSG_EQ (again->GetGateway (), route->GetGateway (), "TCP flow " << i << " changed route");
+      first += (route->GetGateway () == Ipv4Address ("10.1.1.2"));
+    }
+  NS_TEST_EXPECT_MSG_GT (first, 0, "The TCP flows never use the first route");
+  NS_TEST_EXPECT_MSG_LT (first, nFlows, "The TCP flows never use the second route");
+
+  // cached routes must not outlive the routing table entries
+  routing->SetAttribute ("FlowCacheSize", UintegerValue (256));
+  routing->RemoveRoute (1);
+  for (uint32_t i = 0; i < nFlows; ++i)
+    {
+      header.SetSource (Ipv4Address (0x0a030000 + i));
+      Ptr<Ipv4Route> route = routing->RouteOutput (0, header, 0, sockerr);
+      NS_TEST_EXPECT_MSG_EQ (route->GetGateway (), Ipv4Address ("10.1.1.2"), "Stale route for flow " << i);
+    }
+
+  Simulator::Destroy ();
+}
+
 class Ipv4GlobalRoutingTestSuite : public TestSuite
 {
 public:
@@ -1184,6 +1288,7 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite ()
     AddTestCase (new TwoBridgeTest, TestCase::QUICK);
     AddTestCase (new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase (new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase (new Ipv4GlobalRoutingFlowEcmpTestCase, TestCase::QUICK);
   }
 
 // Do not forget to allocate an instance of this TestSuite
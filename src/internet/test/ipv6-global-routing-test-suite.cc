@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/ipv6-interface-container.h"
+#include "ns3/ipv6-list-routing-helper.h"
+#include "ns3/ipv6-static-routing-helper.h"
+#include "ns3/ipv6-global-routing-helper.h"
+#include "ns3/ipv6-global-routing.h"
+#include "ns3/ipv6-global-route-manager.h"
+#include "ns3/ipv6-routing-table-entry.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Populate the IPv6 global routes of a square of routers between
+ * a host and a shared link, and check the equal-cost routes, the
+ * delivery of packets, and the routes recomputed after a link went down.
+ *
+ * \verbatim
+                  R1
+                 /  \
+     A -------- R0    R3 ----+---- B
+                 \  /        |
+                  R2         +---- C (no global routing)
+   \endverbatim
+ */
+class Ipv6GlobalRoutingSquareTestCase : public TestCase
+{
+public:
+  Ipv6GlobalRoutingSquareTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send a packet from A to B and to C.
+   */
+  void SendToAll (void);
+
+  /**
+   * \brief Receive the packets of a node.
+   * \param socket the receiving socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  /**
+   * \param node a node
+   * \param destination an address
+   * \returns the number of global routes of the node to the address
+   */
+  uint32_t CountRoutes (Ptr<Node> node, Ipv6Address destination);
+
+  Ptr<Socket> m_sender;        //!< the socket of A
+  Ipv6Address m_addressB;      //!< the address of B
+  Ipv6Address m_addressC;      //!< the address of C
+  uint32_t m_received;         //!< packets received by B and C
+};
+
+Ipv6GlobalRoutingSquareTestCase::Ipv6GlobalRoutingSquareTestCase ()
+  : TestCase ("IPv6 global routing on a square of routers"),
+    m_received (0)
+{
+}
+
+void
+Ipv6GlobalRoutingSquareTestCase::SendToAll (void)
+{
+  m_sender->SendTo (Create<Packet> (100), 0, Inet6SocketAddress (m_addressB, 1234));
+  m_sender->SendTo (Create<Packet> (100), 0, Inet6SocketAddress (m_addressC, 1234));
+}
+
+void
+Ipv6GlobalRoutingSquareTestCase::Receive (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      m_received++;
+    }
+}
+
+uint32_t
+Ipv6GlobalRoutingSquareTestCase::CountRoutes (Ptr<Node> node, Ipv6Address destination)
+{
+  Ptr<Ipv6GlobalRouting> routing = Ipv6GlobalRouteManager::GetGlobalRouting (node);
+  uint32_t n = 0;
+  for (uint32_t i = 0; i < routing->GetNRoutes (); i++)
+    {
+      Ipv6RoutingTableEntry *route = routing->GetRoute (i);
+      if (route->GetDestNetworkPrefix ().IsMatch (destination, route->GetDestNetwork ()))
+        {
+          NS_TEST_EXPECT_MSG_EQ (route->GetGateway ().IsLinkLocal (), true, "Next hop is not a link-local address");
+          n++;
+        }
+    }
+  return n;
+}
+
+void
+Ipv6GlobalRoutingSquareTestCase::DoRun (void)
+{
+  NodeContainer hosts;
+  hosts.Create (2);
+  NodeContainer routers;
+  routers.Create (4);
+  Ptr<Node> c = CreateObject<Node> ();
+
+  Ipv6ListRoutingHelper list;
+  list.Add (Ipv6StaticRoutingHelper (), 0);
+  list.Add (Ipv6GlobalRoutingHelper (), -10);
+  InternetStackHelper stack;
+  stack.SetIpv4StackInstall (false);
+  stack.SetRoutingHelper (list);
+  stack.Install (hosts);
+  stack.Install (routers);
+  InternetStackHelper staticStack;
+  staticStack.SetIpv4StackInstall (false);
+  staticStack.Install (c);
+
+  NodeContainer all (hosts, routers, c);
+  for (uint32_t i = 0; i < all.GetN (); i++)
+    {
+      all.Get (i)->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+    }
+  for (uint32_t i = 0; i < routers.GetN (); i++)
+    {
+      routers.Get (i)->GetObject<Ipv6> ()->SetAttribute ("IpForward", BooleanValue (true));
+    }
+
+  SimpleNetDeviceHelper p2p;
+  p2p.SetNetDevicePointToPointMode (true);
+  Ipv6AddressHelper address (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  address.Assign (p2p.Install (NodeContainer (hosts.Get (0), routers.Get (0))));
+  address.NewNetwork ();
+  Ipv6InterfaceContainer down = address.Assign (p2p.Install (NodeContainer (routers.Get (0), routers.Get (1))));
+  address.NewNetwork ();
+  address.Assign (p2p.Install (NodeContainer (routers.Get (0), routers.Get (2))));
+  address.NewNetwork ();
+  address.Assign (p2p.Install (NodeContainer (routers.Get (1), routers.Get (3))));
+  address.NewNetwork ();
+  address.Assign (p2p.Install (NodeContainer (routers.Get (2), routers.Get (3))));
+  address.NewNetwork ();
+  SimpleNetDeviceHelper shared;
+  Ipv6InterfaceContainer lan = address.Assign (shared.Install (NodeContainer (routers.Get (3), hosts.Get (1), c)));
+  m_addressB = lan.GetAddress (1, 1);
+  m_addressC = lan.GetAddress (2, 1);
+
+  Ipv6GlobalRoutingHelper::PopulateRoutingTables ();
+
+  // two equal-cost paths from R0 to the shared link, through R1 and R2;
+  // A goes through R0, and R3 is attached
+  NS_TEST_ASSERT_MSG_EQ (CountRoutes (routers.Get (0), m_addressB), 2, "Equal-cost routes not found");
+  NS_TEST_ASSERT_MSG_EQ (CountRoutes (hosts.Get (0), m_addressB), 1, "Route of A not found");
+  NS_TEST_ASSERT_MSG_EQ (Ipv6GlobalRouteManager::GetGlobalRouting (c), 0, "C runs global routing");
+
+  NodeContainer receivers (hosts.Get (1), c);
+  for (uint32_t i = 0; i < receivers.GetN (); i++)
+    {
+      Ptr<Socket> socket = Socket::CreateSocket (receivers.Get (i), UdpSocketFactory::GetTypeId ());
+      socket->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+      socket->SetRecvCallback (MakeCallback (&Ipv6GlobalRoutingSquareTestCase::Receive, this));
+    }
+  m_sender = Socket::CreateSocket (hosts.Get (0), UdpSocketFactory::GetTypeId ());
+
+  Simulator::Schedule (Seconds (1), &Ipv6GlobalRoutingSquareTestCase::SendToAll, this);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_received, 2, "Packets lost");
+
+  // nothing changed: the routes are kept
+  Ipv6RoutingTableEntry *route = Ipv6GlobalRouteManager::GetGlobalRouting (routers.Get (0))->GetRoute (0);
+  Ipv6GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_ASSERT_MSG_EQ (Ipv6GlobalRouteManager::GetGlobalRouting (routers.Get (0))->GetRoute (0), route,
+                         "Routes recomputed without any change");
+
+  // the link from R0 to R1 goes down: a single path remains
+  routers.Get (0)->GetObject<Ipv6> ()->SetDown (down.GetInterfaceIndex (0));
+  routers.Get (1)->GetObject<Ipv6> ()->SetDown (down.GetInterfaceIndex (1));
+  Ipv6GlobalRoutingHelper::RecomputeRoutingTables ();
+  NS_TEST_ASSERT_MSG_EQ (CountRoutes (routers.Get (0), m_addressB), 1, "Routes not recomputed");
+
+  m_received = 0;
+  Simulator::Schedule (Seconds (1), &Ipv6GlobalRoutingSquareTestCase::SendToAll, this);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (m_received, 2, "Packets lost after the link went down");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief IPv6 global routing TestSuite
+ */
+class Ipv6GlobalRoutingTestSuite : public TestSuite
+{
+public:
+  Ipv6GlobalRoutingTestSuite ()
+    : TestSuite ("ipv6-global-routing", UNIT)
+  {
+    AddTestCase (new Ipv6GlobalRoutingSquareTestCase, TestCase::QUICK);
+  }
+};
+
+static Ipv6GlobalRoutingTestSuite g_ipv6GlobalRoutingTestSuite;
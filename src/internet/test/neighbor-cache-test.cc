@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv6-address-helper.h"
+#include "ns3/neighbor-cache-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/arp-cache.h"
+#include "ns3/ndisc-cache.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Populate the neighbor caches of a LAN, and check that the
+ * entries are permanent, that the first packets are delivered without
+ * any address resolution, and that the packets waiting for an address
+ * resolution are sent when the caches are populated again.
+ */
+class NeighborCacheTestCase : public TestCase
+{
+public:
+  NeighborCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Receive the packets of a node.
+   * \param socket the receiving socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  /**
+   * \brief Send a packet.
+   * \param socket the sending socket
+   * \param to the destination
+   */
+  void SendTo (Ptr<Socket> socket, Address to);
+
+  /**
+   * \brief Populate the neighbor caches of all the devices.
+   */
+  void PopulateNeighborCache (void);
+
+  std::vector<Time> m_received; //!< the reception times
+};
+
+NeighborCacheTestCase::NeighborCacheTestCase ()
+  : TestCase ("Populate the neighbor caches of a LAN")
+{
+}
+
+void
+NeighborCacheTestCase::Receive (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      m_received.push_back (Simulator::Now ());
+    }
+}
+
+void
+NeighborCacheTestCase::SendTo (Ptr<Socket> socket, Address to)
+{
+  socket->SendTo (Create<Packet> (100), 0, to);
+}
+
+void
+NeighborCacheTestCase::PopulateNeighborCache (void)
+{
+  NeighborCacheHelper neighbors;
+  neighbors.PopulateNeighborCache ();
+}
+
+void
+NeighborCacheTestCase::DoRun (void)
+{
+  NodeContainer nodes;
+  nodes.Create (3);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      nodes.Get (i)->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+    }
+
+  SimpleNetDeviceHelper simple;
+  simple.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  NetDeviceContainer devices = simple.Install (nodes);
+  Ipv4AddressHelper ipv4 ("10.1.1.0", "255.255.255.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4.Assign (devices);
+  Ipv6AddressHelper ipv6 (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6.Assign (devices);
+
+  NeighborCacheHelper neighbors;
+  neighbors.PopulateNeighborCache ();
+
+  Ptr<Ipv4L3Protocol> ipv4Node0 = nodes.Get (0)->GetObject<Ipv4L3Protocol> ();
+  Ptr<ArpCache> arpCache = ipv4Node0->GetInterface (ipv4Interfaces.Get (0).second)->GetArpCache ();
+  ArpCache::Entry *arpEntry = arpCache->Lookup (ipv4Interfaces.GetAddress (1));
+  NS_TEST_ASSERT_MSG_NE (arpEntry, 0, "No ARP entry for a neighbor");
+  NS_TEST_EXPECT_MSG_EQ (arpEntry->IsPermanent (), true, "ARP entry not permanent");
+  NS_TEST_EXPECT_MSG_EQ (arpEntry->GetMacAddress (), devices.Get (1)->GetAddress (), "Wrong ARP entry");
+  NS_TEST_EXPECT_MSG_EQ (arpCache->Lookup (ipv4Interfaces.GetAddress (0)), 0, "ARP entry for the node itself");
+
+  Ptr<Ipv6L3Protocol> ipv6Node0 = nodes.Get (0)->GetObject<Ipv6L3Protocol> ();
+  Ptr<NdiscCache> ndiscCache = ipv6Node0->GetInterface (ipv6Interfaces.GetInterfaceIndex (0))->GetNdiscCache ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      NdiscCache::Entry *ndiscEntry = ndiscCache->Lookup (ipv6Interfaces.GetAddress (2, i));
+      NS_TEST_ASSERT_MSG_NE (ndiscEntry, 0, "No NDISC entry for a neighbor");
+      NS_TEST_EXPECT_MSG_EQ (ndiscEntry->IsPermanent (), true, "NDISC entry not permanent");
+      NS_TEST_EXPECT_MSG_EQ (ndiscEntry->GetMacAddress (), devices.Get (2)->GetAddress (), "Wrong NDISC entry");
+    }
+
+  Ptr<Socket> receiver = Socket::CreateSocket (nodes.Get (1), UdpSocketFactory::GetTypeId ());
+  receiver->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+  receiver->SetRecvCallback (MakeCallback (&NeighborCacheTestCase::Receive, this));
+  Ptr<Socket> receiver6 = Socket::CreateSocket (nodes.Get (2), UdpSocketFactory::GetTypeId ());
+  receiver6->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 1234));
+  receiver6->SetRecvCallback (MakeCallback (&NeighborCacheTestCase::Receive, this));
+
+  Ptr<Socket> sender = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  sender->Bind ();
+  Ptr<Socket> sender6 = Socket::CreateSocket (nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  sender6->Bind6 ();
+  Simulator::Schedule (Seconds (1), &NeighborCacheTestCase::SendTo, this, sender,
+                       InetSocketAddress (ipv4Interfaces.GetAddress (1), 1234));
+  Simulator::Schedule (Seconds (1), &NeighborCacheTestCase::SendTo, this, sender6,
+                       Inet6SocketAddress (ipv6Interfaces.GetAddress (2, 1), 1234));
+
+  // addresses added after the caches were populated are resolved when the
+  // first packets are sent to them, and the caches are populated again
+  // before the replies come back
+  Ptr<Ipv4L3Protocol> ipv4Node1 = nodes.Get (1)->GetObject<Ipv4L3Protocol> ();
+  ipv4Node1->AddAddress (ipv4Interfaces.Get (1).second,
+                         Ipv4InterfaceAddress (Ipv4Address ("10.1.1.100"), Ipv4Mask ("255.255.255.0")));
+  Ptr<Ipv6L3Protocol> ipv6Node2 = nodes.Get (2)->GetObject<Ipv6L3Protocol> ();
+  ipv6Node2->AddAddress (ipv6Interfaces.GetInterfaceIndex (2),
+                         Ipv6InterfaceAddress (Ipv6Address ("2001:1::100"), Ipv6Prefix (64)));
+  Simulator::Schedule (Seconds (3), &NeighborCacheTestCase::SendTo, this, sender,
+                       InetSocketAddress (Ipv4Address ("10.1.1.100"), 1234));
+  Simulator::Schedule (Seconds (3), &NeighborCacheTestCase::SendTo, this, sender6,
+                       Inet6SocketAddress (Ipv6Address ("2001:1::100"), 1234));
+  Simulator::Schedule (Seconds (3) + MilliSeconds (1), &NeighborCacheTestCase::PopulateNeighborCache, this);
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+
+  // a single channel delay: no request and reply went first
+  NS_TEST_ASSERT_MSG_EQ (m_received.size (), 4, "Packets lost");
+  NS_TEST_EXPECT_MSG_EQ (m_received[0], Seconds (1) + MilliSeconds (2), "IPv4 packet delayed");
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], Seconds (1) + MilliSeconds (2), "IPv6 packet delayed");
+  NS_TEST_EXPECT_MSG_EQ (arpEntry->IsPermanent (), true, "ARP entry not permanent anymore");
+  // sent when the caches were populated, before the replies came back
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], Seconds (3) + MilliSeconds (3), "Waiting IPv4 packet not sent");
+  NS_TEST_EXPECT_MSG_EQ (m_received[3], Seconds (3) + MilliSeconds (3), "Waiting IPv6 packet not sent");
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Neighbor cache helper TestSuite
+ */
+class NeighborCacheTestSuite : public TestSuite
+{
+public:
+  NeighborCacheTestSuite ()
+    : TestSuite ("neighbor-cache", UNIT)
+  {
+    AddTestCase (new NeighborCacheTestCase, TestCase::QUICK);
+  }
+};
+
+static NeighborCacheTestSuite g_neighborCacheTestSuite;
@@ -0,0 +1,210 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include <algorithm>
+#include "ns3/test.h"
+#include "ns3/prefix-trie.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that PrefixTrie returns the same routes, in the same order,
+ * as a scan of all the prefixes.
+ *
+ * Prefixes are drawn around a few base addresses so that many of them
+ * nest and share bits, and include duplicates, the default route, host
+ * routes and masks which are not prefix masks.
+ */
+template <uint32_t BYTES>
+class PrefixTrieTestCase : public TestCase
+{
+public:
+  /**
+   * \param name test name
+   * \param nPrefixes number of prefixes to insert
+   */
+  PrefixTrieTestCase (std::string name, uint32_t nPrefixes);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \returns a pseudo-random number
+   */
+  uint32_t Next (void);
+
+  /**
+   * \brief Draw an address close to one of the base addresses.
+   * \param address the address
+   */
+  void DrawAddress (uint8_t *address);
+
+  /// A prefix
+  struct Prefix
+  {
+    uint8_t address[BYTES];  //!< address
+    uint8_t mask[BYTES];     //!< mask
+  };
+
+  uint32_t m_nPrefixes;      //!< number of prefixes
+  uint32_t m_state;          //!< pseudo-random generator state
+  uint8_t m_base[4][BYTES];  //!< base addresses
+};
+
+template <uint32_t BYTES>
+PrefixTrieTestCase<BYTES>::PrefixTrieTestCase (std::string name, uint32_t nPrefixes)
+  : TestCase (name),
+    m_nPrefixes (nPrefixes),
+    m_state (12345)
+{
+}
+
+template <uint32_t BYTES>
+uint32_t
+PrefixTrieTestCase<BYTES>::Next (void)
+{
+  m_state = m_state * 1103515245 + 12345;
+  return m_state >> 8;
+}
+
+template <uint32_t BYTES>
+void
+PrefixTrieTestCase<BYTES>::DrawAddress (uint8_t *address)
+{
+  uint8_t *base = m_base[Next () % 4];
+  uint32_t keep = Next () % (BYTES * 8 + 1);
+  for (uint32_t bit = 0; bit < BYTES * 8; bit++)
+    {
+      uint32_t value = bit < keep ? (base[bit / 8] >> (7 - bit % 8)) & 1 : Next () & 1;
+      if (value)
+        {
+          address[bit / 8] |= 1 << (7 - bit % 8);
+        }
+      else
+        {
+          address[bit / 8] &= ~(1 << (7 - bit % 8));
+        }
+    }
+}
+
+template <uint32_t BYTES>
+void
+PrefixTrieTestCase<BYTES>::DoRun (void)
+{
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      for (uint32_t j = 0; j < BYTES; j++)
+        {
+          m_base[i][j] = Next () & 0xff;
+        }
+    }
+
+  PrefixTrie<uint32_t, BYTES> trie;
+  std::vector<Prefix> prefixes;
+  for (uint32_t i = 0; i < m_nPrefixes; i++)
+    {
+      Prefix prefix;
+      if (i > 0 && Next () % 10 == 0)
+        {
+          // duplicate of an earlier prefix
+          prefix = prefixes[Next () % prefixes.size ()];
+        }
+      else
+        {
+          DrawAddress (prefix.address);
+          uint32_t length = Next () % (BYTES * 8 + 1);
+          for (uint32_t j = 0; j < BYTES; j++)
+            {
+              uint32_t ones = length > j * 8 ? std::min (length - j * 8, 8U) : 0;
+              prefix.mask[j] = static_cast<uint8_t> (0xff00 >> ones);
+            }
+          if (Next () % 20 == 0)
+            {
+              // not a prefix mask
+              prefix.mask[Next () % BYTES] ^= 0x5a;
+            }
+        }
+      prefixes.push_back (prefix);
+      trie.Insert (prefix.address, prefix.mask, i);
+    }
+  NS_TEST_ASSERT_MSG_EQ (trie.GetN (), m_nPrefixes, "Wrong number of routes");
+
+  for (uint32_t n = 0; n < 20 * m_nPrefixes; n++)
+    {
+      uint8_t address[BYTES];
+      if (n % 2)
+        {
+          DrawAddress (address);
+        }
+      else
+        {
+          Prefix const &prefix = prefixes[Next () % prefixes.size ()];
+          for (uint32_t j = 0; j < BYTES; j++)
+            {
+              address[j] = prefix.address[j];
+            }
+        }
+
+      std::vector<uint32_t> expected;
+      for (uint32_t i = 0; i < prefixes.size (); i++)
+        {
+          bool match = true;
+          for (uint32_t j = 0; j < BYTES; j++)
+            {
+              match = match && ((address[j] ^ prefixes[i].address[j]) & prefixes[i].mask[j]) == 0;
+            }
+          if (match)
+            {
+              expected.push_back (i);
+            }
+        }
+      std::vector<uint32_t> found;
+      trie.Lookup (address, found);
+      NS_TEST_ASSERT_MSG_EQ (found.size (), expected.size (), "Wrong number of matching routes");
+      for (uint32_t i = 0; i < found.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (found[i], expected[i], "Wrong matching route");
+        }
+    }
+
+  trie.Clear ();
+  std::vector<uint32_t> found;
+  trie.Lookup (prefixes[0].address, found);
+  NS_TEST_ASSERT_MSG_EQ (found.size (), 0, "Routes left after Clear");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief PrefixTrie TestSuite
+ */
+class PrefixTrieTestSuite : public TestSuite
+{
+public:
+  PrefixTrieTestSuite ()
+    : TestSuite ("prefix-trie", UNIT)
+  {
+    AddTestCase (new PrefixTrieTestCase<4> ("IPv4 prefixes", 500), TestCase::QUICK);
+    AddTestCase (new PrefixTrieTestCase<16> ("IPv6 prefixes", 500), TestCase::QUICK);
+  }
+};
+
+static PrefixTrieTestSuite g_prefixTrieTestSuite;
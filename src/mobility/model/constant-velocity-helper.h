@@ -70,6 +70,13 @@ public:
    * \param vel Velocity vector
    */
   void SetVelocity (const Vector &vel);
+  /**
+   * Set new velocity vector at a time, not later than the current time,
+   * when the position was last updated
+   * \param vel Velocity vector
+   * \param now The time of the new velocity
+   */
+  void SetVelocity (const Vector &vel, const Time &now);
   /**
    * Pause mobility at current position
    */
@@ -84,15 +91,35 @@ public:
    * \param rectangle 2D bounding rectangle for resulting position; object will not move outside the rectangle 
    */
   void UpdateWithBounds (const Rectangle &rectangle) const;
+  /**
+   * Update position, if not paused, from last position and time of last
+   * update to a time, not later than the current time
+   * \param rectangle 2D bounding rectangle for resulting position; object will not move outside the rectangle
+   * \param now The time to update the position to
+   */
+  void UpdateWithBounds (const Rectangle &rectangle, const Time &now) const;
   /**
    * Update position, if not paused, from last position and time of last update
    * \param bounds 3D bounding box for resulting position; object will not move outside the box 
    */
   void UpdateWithBounds (const Box &bounds) const;
+  /**
+   * Update position, if not paused, from last position and time of last
+   * update to a time, not later than the current time
+   * \param bounds 3D bounding box for resulting position; object will not move outside the box
+   * \param now The time to update the position to
+   */
+  void UpdateWithBounds (const Box &bounds, const Time &now) const;
   /**
    * Update position, if not paused, from last position and time of last update
    */
   void Update (void) const;
+  /**
+   * Update position, if not paused, from last position and time of last
+   * update to a time, not later than the current time
+   * \param now The time to update the position to
+   */
+  void Update (const Time &now) const;
 private:
   mutable Time m_lastUpdate; //!< time of last update
   mutable Vector m_position; //!< state variable for current position
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "course-change-scheduler.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("CourseChangeScheduler");
+
+CourseChangeScheduler::CourseChangeScheduler ()
+  : m_lazy (false),
+    m_changing (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+CourseChangeScheduler::SetLazy (bool lazy)
+{
+  NS_LOG_FUNCTION (this << lazy);
+  if (m_lazy == lazy)
+    {
+      return;
+    }
+  if (lazy)
+    {
+      // the pending course change, if any, is kept for later
+      Simulator::Remove (m_event);
+      m_lazy = true;
+    }
+  else
+    {
+      Update ();
+      m_lazy = false;
+      if (m_pending != 0)
+        {
+          m_event = Simulator::Schedule (m_pendingTime - Simulator::Now (), &CourseChangeScheduler::Invoke, this);
+        }
+    }
+}
+
+bool
+CourseChangeScheduler::IsLazy (void) const
+{
+  return m_lazy;
+}
+
+Time
+CourseChangeScheduler::GetNow (void) const
+{
+  return m_changing ? m_now : Simulator::Now ();
+}
+
+void
+CourseChangeScheduler::Schedule (const Time &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay << event);
+  Cancel ();
+  m_pending = Ptr<EventImpl> (event, false);
+  m_pendingTime = GetNow () + delay;
+  if (!m_lazy)
+    {
+      m_event = Simulator::Schedule (delay, &CourseChangeScheduler::Invoke, this);
+    }
+}
+
+void
+CourseChangeScheduler::Cancel (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_event.Cancel ();
+  m_pending = 0;
+}
+
+void
+CourseChangeScheduler::Update (void) const
+{
+  if (!m_lazy || m_changing)
+    {
+      // the position may be queried while a course change is made
+      return;
+    }
+  DoUpdate (Simulator::Now (), true);
+}
+
+void
+CourseChangeScheduler::UpdateBeforeNow (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_lazy || m_changing)
+    {
+      return;
+    }
+  DoUpdate (Simulator::Now (), false);
+}
+
+void
+CourseChangeScheduler::DoUpdate (const Time &time, bool inclusive) const
+{
+  while (m_pending != 0
+         && (m_pendingTime < time || (inclusive && m_pendingTime == time)))
+    {
+      Invoke ();
+    }
+}
+
+void
+CourseChangeScheduler::Invoke (void) const
+{
+  Ptr<EventImpl> event = m_pending;
+  m_pending = 0;
+  m_now = m_pendingTime;
+  m_changing = true;
+  event->Invoke ();
+  m_changing = false;
+}
+
+} // namespace ns3
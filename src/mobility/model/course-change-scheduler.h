@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef COURSE_CHANGE_SCHEDULER_H
+#define COURSE_CHANGE_SCHEDULER_H
+
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/event-impl.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Utility class used by the random mobility models to schedule
+ * their next course change, either as a simulator event or lazily.
+ *
+ * In lazy mode, the next course change is kept instead of scheduled,
+ * and made the next time the model is queried (see Update), along with
+ * all the ones which followed it by then: no event is scheduled for
+ * the models nobody queries.  While a course change is made, GetNow
+ * returns the time it was due at, which the model uses instead of the
+ * current time.  The course changes, and thus the draws of their
+ * random variables, are the same in both modes; only the time they
+ * are notified at differs.
+ */
+class CourseChangeScheduler
+{
+public:
+  CourseChangeScheduler ();
+
+  /**
+   * Make the next course changes lazily or as events.
+   *
+   * \param [in] lazy Whether to make the course changes lazily
+   */
+  void SetLazy (bool lazy);
+  /** \returns Whether the course changes are made lazily. */
+  bool IsLazy (void) const;
+
+  /**
+   * \returns The time the course change being made was due at, or the
+   * current time outside of the course changes.
+   */
+  Time GetNow (void) const;
+
+  /**
+   * Schedule the next course change, in place of the pending one.
+   *
+   * \param [in] delay The delay after GetNow of the course change
+   * \param [in] event The course change, created with MakeEvent
+   */
+  void Schedule (const Time &delay, EventImpl *event);
+  /** Cancel the pending course change. */
+  void Cancel (void);
+
+  /**
+   * In lazy mode, make the course changes due by the current time.
+   *
+   * The models call it before they evaluate their position or velocity.
+   */
+  void Update (void) const;
+  /**
+   * In lazy mode, make the course changes due before the current time.
+   *
+   * The models call it before they are moved: the course changes due
+   * at the current time may not have been made yet in scheduled mode,
+   * and are replaced along with the pending one.
+   */
+  void UpdateBeforeNow (void);
+
+private:
+  /**
+   * Make the pending course changes due by a given time.
+   *
+   * \param [in] time The time the course changes are made up to
+   * \param [in] inclusive Whether to make the course changes due at the time
+   */
+  void DoUpdate (const Time &time, bool inclusive) const;
+
+  /** Make the pending course change. */
+  void Invoke (void) const;
+
+  bool m_lazy;                          //!< Whether the course changes are made lazily
+  EventId m_event;                      //!< The event of the pending course change, outside of lazy mode
+  mutable Ptr<EventImpl> m_pending;     //!< The pending course change
+  mutable Time m_pendingTime;           //!< The time the pending course change is due at
+  mutable Time m_now;                   //!< The time of the course change being made
+  mutable bool m_changing;              //!< Whether a course change is being made
+};
+
+} // namespace ns3
+
+#endif /* COURSE_CHANGE_SCHEDULER_H */
@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
 #include "gauss-markov-mobility-model.h"
 #include "position-allocator.h"
 
@@ -80,7 +81,14 @@ GaussMarkovMobilityModel::GetTypeId (void)
                    "A gaussian random variable used to calculate the next pitch value.",
                    StringValue ("ns3::NormalRandomVariable[Mean=0.0|Variance=1.0|Bound=10.0]"),
                    MakePointerAccessor (&GaussMarkovMobilityModel::m_normalPitch),
-                   MakePointerChecker<NormalRandomVariable> ());
+                   MakePointerChecker<NormalRandomVariable> ())
+    .AddAttribute ("Lazy",
+                   "Calculate the next velocity, direction, and pitch when the position "
+                   "or velocity is next queried, instead of in a scheduled event.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&GaussMarkovMobilityModel::SetLazy,
+                                        &GaussMarkovMobilityModel::IsLazy),
+                   MakeBooleanChecker ());
 
   return tid;
 }
@@ -90,13 +98,14 @@ GaussMarkovMobilityModel::GaussMarkovMobilityModel ()
   m_meanVelocity = 0.0;
   m_meanDirection = 0.0;
   m_meanPitch = 0.0;
-  m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+  m_scheduler.Schedule (Seconds (0), MakeEvent (&GaussMarkovMobilityModel::Start, this));
   m_helper.Unpause ();
 }
 
 void
 GaussMarkovMobilityModel::Start (void)
 {
+  Time now = m_scheduler.GetNow ();
   if (m_meanVelocity == 0.0)
     {
       //Initialize the mean velocity, direction, and pitch variables
@@ -112,9 +121,9 @@ GaussMarkovMobilityModel::Start (void)
       m_Direction = m_meanDirection;
       m_Pitch = m_meanPitch;
       //Set the velocity vector to give to the constant velocity helper
-      m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP));
+      m_helper.SetVelocity (Vector (m_Velocity*cosD*cosP, m_Velocity*sinD*cosP, m_Velocity*sinP), now);
     }
-  m_helper.Update ();
+  m_helper.Update (now);
 
   //Get the next values from the gaussian distributions for velocity, direction, and pitch
   double rv = m_normalVelocity->GetValue ();
@@ -138,7 +147,7 @@ GaussMarkovMobilityModel::Start (void)
   double vx = m_Velocity * cosDir * cosPit;
   double vy = m_Velocity * sinDir * cosPit;
   double vz = m_Velocity * sinPit;
-  m_helper.SetVelocity (Vector (vx, vy, vz));
+  m_helper.SetVelocity (Vector (vx, vy, vz), now);
 
   m_helper.Unpause ();
 
@@ -148,7 +157,8 @@ GaussMarkovMobilityModel::Start (void)
 void
 GaussMarkovMobilityModel::DoWalk (Time delayLeft)
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  Time now = m_scheduler.GetNow ();
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
   Vector nextPosition = position;
@@ -161,7 +171,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
   // If out of bounds, then alter the velocity vector and average direction to keep the position in bounds
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      m_scheduler.Schedule (delayLeft, MakeEvent (&GaussMarkovMobilityModel::Start, this));
     }
   else
     {
@@ -185,9 +195,9 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
 
       m_Direction = m_meanDirection;
       m_Pitch = m_meanPitch;
-      m_helper.SetVelocity (speed);
+      m_helper.SetVelocity (speed, now);
       m_helper.Unpause ();
-      m_event = Simulator::Schedule (delayLeft, &GaussMarkovMobilityModel::Start, this);
+      m_scheduler.Schedule (delayLeft, MakeEvent (&GaussMarkovMobilityModel::Start, this));
     }
   NotifyCourseChange ();
 }
@@ -195,6 +205,7 @@ GaussMarkovMobilityModel::DoWalk (Time delayLeft)
 void
 GaussMarkovMobilityModel::DoDispose (void)
 {
+  m_scheduler.Cancel ();
   // chain up
   MobilityModel::DoDispose ();
 }
@@ -202,21 +213,41 @@ GaussMarkovMobilityModel::DoDispose (void)
 Vector
 GaussMarkovMobilityModel::DoGetPosition (void) const
 {
-  m_helper.Update ();
+  m_scheduler.Update ();
+  m_helper.Update (m_scheduler.GetNow ());
   return m_helper.GetCurrentPosition ();
 }
 void 
 GaussMarkovMobilityModel::DoSetPosition (const Vector &position)
 {
+  // the earlier course changes draw their random variables first
+  m_scheduler.UpdateBeforeNow ();
   m_helper.SetPosition (position);
-  Simulator::Remove (m_event);
-  m_event = Simulator::ScheduleNow (&GaussMarkovMobilityModel::Start, this);
+  m_scheduler.Schedule (Seconds (0), MakeEvent (&GaussMarkovMobilityModel::Start, this));
 }
 Vector
 GaussMarkovMobilityModel::DoGetVelocity (void) const
 {
+  m_scheduler.Update ();
   return m_helper.GetVelocity ();
 }
+bool
+GaussMarkovMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  // the lazy course changes are notified late
+  return !m_scheduler.IsLazy ();
+}
+void
+GaussMarkovMobilityModel::SetLazy (bool lazy)
+{
+  m_scheduler.SetLazy (lazy);
+  NotifyPiecewiseLinearChange ();
+}
+bool
+GaussMarkovMobilityModel::IsLazy (void) const
+{
+  return m_scheduler.IsLazy ();
+}
 
 int64_t
 GaussMarkovMobilityModel::DoAssignStreams (int64_t stream)
@@ -23,6 +23,7 @@
 #define GAUSS_MARKOV_MOBILITY_MODEL_H
 
 #include "constant-velocity-helper.h"
+#include "course-change-scheduler.h"
 #include "mobility-model.h"
 #include "position-allocator.h"
 #include "ns3/ptr.h"
@@ -50,6 +51,11 @@ namespace ns3 {
  * and pitch are the key variables.
  * The motion field is limited by a 3D bounding box (called "box") which is a 3D
  * version of the "rectangle" field that is used in 2-dimensional ns-3 mobility models.
+ *
+ * With the Lazy attribute, the velocity, direction, and pitch of each
+ * timestep are calculated when the position or velocity is next queried
+ * rather than in scheduled events, in the same sequence: see
+ * CourseChangeScheduler.
  * 
  * Here is an example of how to implement the model and set the initial node positions:
  * \code
@@ -100,7 +106,16 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual bool DoIsPiecewiseLinear (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  /**
+   * \param lazy whether to calculate the velocity, direction, and pitch lazily
+   */
+  void SetLazy (bool lazy);
+  /**
+   * \return whether the velocity, direction, and pitch are calculated lazily
+   */
+  bool IsLazy (void) const;
   ConstantVelocityHelper m_helper; //!< constant velocity helper
   Time m_timeStep; //!< duraiton after which direction and speed should change
   double m_alpha; //!< tunable constant in the model
@@ -116,7 +131,7 @@ private:
   Ptr<NormalRandomVariable> m_normalDirection; //!< Gaussian rv for next direction value
   Ptr<RandomVariableStream> m_rndMeanPitch; //!< rv used to assign avg. pitch 
   Ptr<NormalRandomVariable> m_normalPitch; //!< Gaussian rv for next pitch
-  EventId m_event; //!< event id of scheduled start
+  CourseChangeScheduler m_scheduler; //!< scheduler of the timesteps
   Box m_bounds; //!< bounding box
 };
 
@@ -0,0 +1,203 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <algorithm>
+#include <cmath>
+#include "mobility-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/simulation-singleton.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MobilityManager");
+
+MobilityManager::MobilityManager ()
+  : m_evaluated (false)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MobilityManager::~MobilityManager ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Ptr<MobilityModel> >::const_iterator i = m_models.begin (); i != m_models.end (); i++)
+    {
+      (*i)->m_manager = 0;
+    }
+}
+
+MobilityManager *
+MobilityManager::Get (void)
+{
+  return SimulationSingleton<MobilityManager>::Get ();
+}
+
+uint32_t
+MobilityManager::Add (Ptr<MobilityModel> mobility)
+{
+  NS_ASSERT (mobility != 0);
+  if (mobility->m_manager == this)
+    {
+      return mobility->m_managerIndex;
+    }
+  NS_LOG_FUNCTION (this << mobility);
+  NS_ASSERT_MSG (mobility->m_manager == 0, "Mobility model added to the managers of two simulations");
+  uint32_t index = m_models.size ();
+  mobility->m_manager = this;
+  mobility->m_managerIndex = index;
+  m_models.push_back (mobility);
+  // set by Update
+  m_linear.push_back (true);
+  m_x0.push_back (0);
+  m_y0.push_back (0);
+  m_z0.push_back (0);
+  m_vx.push_back (0);
+  m_vy.push_back (0);
+  m_vz.push_back (0);
+  m_t0.push_back (0);
+  m_x.push_back (0);
+  m_y.push_back (0);
+  m_z.push_back (0);
+  Update (index);
+  return index;
+}
+
+uint32_t
+MobilityManager::GetN (void) const
+{
+  return m_models.size ();
+}
+
+Ptr<MobilityModel>
+MobilityManager::GetMobilityModel (uint32_t index) const
+{
+  NS_ASSERT (index < m_models.size ());
+  return m_models[index];
+}
+
+void
+MobilityManager::Update (uint32_t index)
+{
+  NS_LOG_FUNCTION (this << index);
+  NS_ASSERT (index < m_models.size ());
+  Ptr<MobilityModel> mobility = m_models[index];
+  Vector position = mobility->GetPosition ();
+  m_x0[index] = position.x;
+  m_y0[index] = position.y;
+  m_z0[index] = position.z;
+  m_t0[index] = Simulator::Now ().GetSeconds ();
+  bool linear = mobility->IsPiecewiseLinear ();
+  if (linear != m_linear[index])
+    {
+      m_linear[index] = linear;
+      if (linear)
+        {
+          m_nonLinear.erase (std::find (m_nonLinear.begin (), m_nonLinear.end (), index));
+        }
+      else
+        {
+          m_nonLinear.push_back (index);
+        }
+    }
+  Vector velocity;
+  if (linear)
+    {
+      velocity = mobility->GetVelocity ();
+    }
+  m_vx[index] = velocity.x;
+  m_vy[index] = velocity.y;
+  m_vz[index] = velocity.z;
+  if (m_evaluated && m_evaluationTime == Simulator::Now ())
+    {
+      m_x[index] = position.x;
+      m_y[index] = position.y;
+      m_z[index] = position.z;
+    }
+}
+
+Vector
+MobilityManager::GetPosition (uint32_t index) const
+{
+  NS_ASSERT (index < m_models.size ());
+  if (m_evaluated && m_evaluationTime == Simulator::Now ())
+    {
+      return Vector (m_x[index], m_y[index], m_z[index]);
+    }
+  if (!m_linear[index])
+    {
+      return m_models[index]->GetPosition ();
+    }
+  double dt = Simulator::Now ().GetSeconds () - m_t0[index];
+  return Vector (m_x0[index] + m_vx[index] * dt,
+                 m_y0[index] + m_vy[index] * dt,
+                 m_z0[index] + m_vz[index] * dt);
+}
+
+double
+MobilityManager::GetDistance (uint32_t a, uint32_t b) const
+{
+  return CalculateDistance (GetPosition (a), GetPosition (b));
+}
+
+bool
+MobilityManager::IsPiecewiseLinear (uint32_t index) const
+{
+  NS_ASSERT (index < m_models.size ());
+  return m_linear[index];
+}
+
+const std::vector<uint32_t> &
+MobilityManager::GetNonLinear (void) const
+{
+  return m_nonLinear;
+}
+
+void
+MobilityManager::EvaluatePositions (void)
+{
+  NS_LOG_FUNCTION (this);
+  double t = Simulator::Now ().GetSeconds ();
+  uint32_t n = m_models.size ();
+  const double *x0 = m_x0.empty () ? 0 : &m_x0[0];
+  const double *y0 = m_y0.empty () ? 0 : &m_y0[0];
+  const double *z0 = m_z0.empty () ? 0 : &m_z0[0];
+  const double *vx = m_vx.empty () ? 0 : &m_vx[0];
+  const double *vy = m_vy.empty () ? 0 : &m_vy[0];
+  const double *vz = m_vz.empty () ? 0 : &m_vz[0];
+  const double *t0 = m_t0.empty () ? 0 : &m_t0[0];
+  double *x = m_x.empty () ? 0 : &m_x[0];
+  double *y = m_y.empty () ? 0 : &m_y[0];
+  double *z = m_z.empty () ? 0 : &m_z[0];
+  for (uint32_t i = 0; i < n; i++)
+    {
+      double dt = t - t0[i];
+      x[i] = x0[i] + vx[i] * dt;
+      y[i] = y0[i] + vy[i] * dt;
+      z[i] = z0[i] + vz[i] * dt;
+    }
+  for (std::vector<uint32_t>::const_iterator i = m_nonLinear.begin (); i != m_nonLinear.end (); i++)
+    {
+      Vector position = m_models[*i]->GetPosition ();
+      m_x[*i] = position.x;
+      m_y[*i] = position.y;
+      m_z[*i] = position.z;
+    }
+  m_evaluated = true;
+  m_evaluationTime = Simulator::Now ();
+}
+
+} // namespace ns3
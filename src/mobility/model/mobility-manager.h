@@ -0,0 +1,143 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MOBILITY_MANAGER_H
+#define MOBILITY_MANAGER_H
+
+#include <vector>
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "ns3/vector.h"
+#include "ns3/ptr.h"
+#include "mobility-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Keep the kinematic state of the mobility models of a
+ * simulation, to evaluate their positions by index, one at a time or
+ * all at once.
+ *
+ * The models are numbered in the order they are added.  The position,
+ * velocity and time of the last course change of the piecewise linear
+ * models (see MobilityModel::IsPiecewiseLinear) are kept in a
+ * structure of arrays, from which their position at any time is
+ * extrapolated without calling them: EvaluatePositions does so for all
+ * the models in a single loop over the arrays, which the compiler may
+ * vectorize.  The other models are asked for their position.
+ *
+ * The models notify the manager of their course changes, and of the
+ * positions set, before their "CourseChange" trace sources fire; the
+ * manager asks them again whether they are piecewise linear then, and
+ * when they notify that this may have changed, e.g. when the lazy
+ * course changes of a random model are enabled.  The
+ * extrapolated positions may differ from the ones the models report by
+ * a few units in the last place, as the models accumulate their
+ * displacements since their last course change in several steps.
+ *
+ * There is one manager per simulation, returned by Get and deleted by
+ * Simulator::Destroy, after which the indices of the models are no
+ * longer valid.
+ */
+class MobilityManager
+{
+public:
+  MobilityManager ();
+  ~MobilityManager ();
+
+  /**
+   * \returns The manager of the current simulation, created on first use.
+   */
+  static MobilityManager * Get (void);
+
+  /**
+   * Add a mobility model to the manager, if not added already.
+   *
+   * \param [in] mobility The mobility model
+   * \returns The index of the model
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+  /** \returns The number of models added. */
+  uint32_t GetN (void) const;
+  /**
+   * \param [in] index The index of a model
+   * \returns The mobility model
+   */
+  Ptr<MobilityModel> GetMobilityModel (uint32_t index) const;
+
+  /**
+   * \param [in] index The index of a model
+   * \returns The current position of the model
+   */
+  Vector GetPosition (uint32_t index) const;
+  /**
+   * \param [in] a The index of a model
+   * \param [in] b The index of another model
+   * \returns The current distance between the two models, in meters
+   */
+  double GetDistance (uint32_t a, uint32_t b) const;
+  /**
+   * \param [in] index The index of a model
+   * \returns true if the model was piecewise linear at its last update
+   */
+  bool IsPiecewiseLinear (uint32_t index) const;
+  /** \returns The indices of the models which are not piecewise linear. */
+  const std::vector<uint32_t> & GetNonLinear (void) const;
+
+  /**
+   * Evaluate the current positions of all the models.
+   *
+   * Until the simulation time advances, GetPosition and GetDistance
+   * return the positions evaluated, which are kept up to date with the
+   * course changes of the models.
+   */
+  void EvaluatePositions (void);
+
+  /**
+   * Sample the position and velocity of a model which changed course,
+   * or which may have stopped or started being piecewise linear.
+   *
+   * Called by the mobility models added to the manager.
+   *
+   * \param [in] index The index of the model
+   */
+  void Update (uint32_t index);
+
+private:
+  std::vector<Ptr<MobilityModel> > m_models;   //!< The models, by index
+  std::vector<bool> m_linear;                  //!< Whether each model is piecewise linear
+  std::vector<uint32_t> m_nonLinear;           //!< The indices of the models which are not piecewise linear
+  // kinematic state of the piecewise linear models at their last course
+  // change; the models which are not piecewise linear have no velocity
+  std::vector<double> m_x0;                    //!< The abscissas at the last course change
+  std::vector<double> m_y0;                    //!< The ordinates at the last course change
+  std::vector<double> m_z0;                    //!< The heights at the last course change
+  std::vector<double> m_vx;                    //!< The velocities along the x axis
+  std::vector<double> m_vy;                    //!< The velocities along the y axis
+  std::vector<double> m_vz;                    //!< The velocities along the z axis
+  std::vector<double> m_t0;                    //!< The times of the last course change, in seconds
+  // positions evaluated
+  std::vector<double> m_x;                     //!< The abscissas evaluated
+  std::vector<double> m_y;                     //!< The ordinates evaluated
+  std::vector<double> m_z;                     //!< The heights evaluated
+  bool m_evaluated;                            //!< Whether the positions were evaluated at least once
+  Time m_evaluationTime;                       //!< The time the positions were evaluated at
+};
+
+} // namespace ns3
+
+#endif /* MOBILITY_MANAGER_H */
@@ -21,6 +21,7 @@
 #include <cmath>
 
 #include "mobility-model.h"
+#include "mobility-manager.h"
 #include "ns3/trace-source-accessor.h"
 
 namespace ns3 {
@@ -53,6 +54,8 @@ MobilityModel::GetTypeId (void)
 }
 
 MobilityModel::MobilityModel ()
+  : m_manager (0),
+    m_managerIndex (0)
 {
 }
 
@@ -75,6 +78,12 @@ void
 MobilityModel::SetPosition (const Vector &position)
 {
   DoSetPosition (position);
+  // some models notify their course change in an event scheduled now:
+  // the MobilityManager must not extrapolate their old course until then
+  if (m_manager != 0)
+    {
+      m_manager->Update (m_managerIndex);
+    }
 }
 
 double 
@@ -97,9 +106,22 @@ MobilityModel::GetRelativeSpeed (Ptr<const MobilityModel> other) const
 void
 MobilityModel::NotifyCourseChange (void) const
 {
+  if (m_manager != 0)
+    {
+      m_manager->Update (m_managerIndex);
+    }
   m_courseChangeTrace (this);
 }
 
+void
+MobilityModel::NotifyPiecewiseLinearChange (void) const
+{
+  if (m_manager != 0)
+    {
+      m_manager->Update (m_managerIndex);
+    }
+}
+
 int64_t
 MobilityModel::AssignStreams (int64_t start)
 {
@@ -113,5 +135,17 @@ MobilityModel::DoAssignStreams (int64_t start)
   return 0;
 }
 
+bool
+MobilityModel::IsPiecewiseLinear (void) const
+{
+  return DoIsPiecewiseLinear ();
+}
+
+bool
+MobilityModel::DoIsPiecewiseLinear (void) const
+{
+  return false;
+}
+
 
 } // namespace ns3
@@ -26,6 +26,8 @@
 
 namespace ns3 {
 
+class MobilityManager;
+
 /**
  * \ingroup mobility
  * \brief Keep track of the current position and velocity of an object.
@@ -78,6 +80,14 @@ public:
    * \return the number of stream indices assigned by this model
    */
   int64_t AssignStreams (int64_t stream);
+  /**
+   * \return true if the model moves in a straight line at the velocity
+   * it reports between two course changes, false otherwise.
+   *
+   * The MobilityManager extrapolates the positions of such models from
+   * their last course change instead of asking them.
+   */
+  bool IsPiecewiseLinear (void) const;
 
   /**
    *  TracedCallback signature.
@@ -92,6 +102,11 @@ protected:
    * position changes to notify course change listeners.
    */
   void NotifyCourseChange (void) const;
+  /**
+   * Must be invoked by subclasses when the value returned by
+   * DoIsPiecewiseLinear may have changed, to notify the MobilityManager.
+   */
+  void NotifyPiecewiseLinearChange (void) const;
 private:
   /**
    * \return the current position.
@@ -122,6 +137,16 @@ private:
    * \return the number of streams used
    */
   virtual int64_t DoAssignStreams (int64_t start);
+  /**
+   * The default implementation returns false.  Subclasses which move in
+   * a straight line between two course changes, and notify a course
+   * change whenever their velocity changes, are expected to override
+   * this and return true.
+   * \return true if the model is piecewise linear
+   */
+  virtual bool DoIsPiecewiseLinear (void) const;
+
+  friend class MobilityManager;
 
   /**
    * Used to alert subscribers that a change in direction, velocity,
@@ -129,6 +154,8 @@ private:
    */
   ns3::TracedCallback<Ptr<const MobilityModel> > m_courseChangeTrace;
 
+  MobilityManager *m_manager;   //!< The MobilityManager the model is added to, if any
+  uint32_t m_managerIndex;      //!< The index of the model in the MobilityManager
 };
 
 } // namespace ns3
@@ -0,0 +1,274 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <algorithm>
+#include <cmath>
+#include "position-grid.h"
+#include "ns3/simulator.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PositionGrid");
+
+PositionGrid::PositionGrid (double cellSize)
+  : m_cellSize (cellSize),
+    m_manager (0),
+    m_maxSpeed (0),
+    m_refreshTime (Simulator::Now ()),
+    m_nonLinearTime (TimeStep (-1))
+{
+  NS_LOG_FUNCTION (this << cellSize);
+  NS_ASSERT_MSG (cellSize > 0, "The cells of a position grid must have a positive size");
+}
+
+PositionGrid::~PositionGrid ()
+{
+  NS_LOG_FUNCTION (this);
+  m_unbindEvent.Cancel ();
+  for (std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_mobilityItems.begin ();
+       i != m_mobilityItems.end (); i++)
+    {
+      m_items[i->second.front ()].mobility->TraceDisconnectWithoutContext
+        ("CourseChange", MakeCallback (&PositionGrid::CourseChanged, this));
+    }
+}
+
+double
+PositionGrid::GetCellSize (void) const
+{
+  return m_cellSize;
+}
+
+uint32_t
+PositionGrid::GetNItems (void) const
+{
+  return m_items.size ();
+}
+
+uint32_t
+PositionGrid::Add (Ptr<MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  NS_ASSERT (mobility != 0);
+  Bind ();
+  uint32_t item = m_items.size ();
+  Item newItem;
+  newItem.mobility = mobility;
+  newItem.index = m_manager->Add (mobility);
+  newItem.cell = GetCell (m_manager->GetPosition (newItem.index));
+  m_items.push_back (newItem);
+  m_cells[newItem.cell].push_back (item);
+  if (m_manager->IsPiecewiseLinear (newItem.index))
+    {
+      m_maxSpeed = std::max (m_maxSpeed, CalculateDistance (mobility->GetVelocity (), Vector ()));
+    }
+  std::vector<uint32_t> &items = m_mobilityItems[PeekPointer (mobility)];
+  if (items.empty ())
+    {
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&PositionGrid::CourseChanged, this));
+    }
+  items.push_back (item);
+  return item;
+}
+
+Vector
+PositionGrid::GetPosition (uint32_t item) const
+{
+  NS_ASSERT (item < m_items.size ());
+  if (m_manager == 0)
+    {
+      return m_items[item].mobility->GetPosition ();
+    }
+  return m_manager->GetPosition (m_items[item].index);
+}
+
+bool
+PositionGrid::IsWithin (uint32_t item, const Vector &position, double distance) const
+{
+  // the positions extrapolated by the manager may differ from the ones of
+  // the models by a few units in the last place
+  const double tolerance = 1e-6;
+  double d = CalculateDistance (position, GetPosition (item));
+  if (std::abs (d - distance) > tolerance)
+    {
+      return d <= distance;
+    }
+  return CalculateDistance (position, m_items[item].mobility->GetPosition ()) <= distance;
+}
+
+PositionGrid::Cell
+PositionGrid::GetCell (const Vector &position) const
+{
+  return Cell (static_cast<int64_t> (std::floor (position.x / m_cellSize)),
+               static_cast<int64_t> (std::floor (position.y / m_cellSize)));
+}
+
+void
+PositionGrid::Bind (void)
+{
+  if (m_manager != 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this);
+  m_manager = MobilityManager::Get ();
+  // the manager is deleted when the simulator is destroyed, and the next
+  // simulation has a new one
+  m_unbindEvent = Simulator::ScheduleDestroy (&PositionGrid::Unbind, this);
+  for (std::vector<Item>::iterator i = m_items.begin (); i != m_items.end (); i++)
+    {
+      i->index = m_manager->Add (i->mobility);
+    }
+  if (!m_items.empty ())
+    {
+      Refresh ();
+    }
+}
+
+void
+PositionGrid::Unbind (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_manager = 0;
+  m_nonLinearTime = TimeStep (-1);
+}
+
+void
+PositionGrid::Update (uint32_t item)
+{
+  Item &i = m_items[item];
+  Cell cell = GetCell (m_manager->GetPosition (i.index));
+  if (m_manager->IsPiecewiseLinear (i.index))
+    {
+      m_maxSpeed = std::max (m_maxSpeed, CalculateDistance (i.mobility->GetVelocity (), Vector ()));
+    }
+  if (cell == i.cell)
+    {
+      return;
+    }
+  std::map<Cell, std::vector<uint32_t> >::iterator old = m_cells.find (i.cell);
+  NS_ASSERT (old != m_cells.end ());
+  old->second.erase (std::find (old->second.begin (), old->second.end (), item));
+  if (old->second.empty ())
+    {
+      m_cells.erase (old);
+    }
+  m_cells[cell].push_back (item);
+  i.cell = cell;
+}
+
+void
+PositionGrid::CourseChanged (Ptr<const MobilityModel> mobility)
+{
+  NS_LOG_FUNCTION (this << mobility);
+  if (m_manager == 0)
+    {
+      // indexed again when added to the next manager
+      return;
+    }
+  std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i = m_mobilityItems.find (PeekPointer (mobility));
+  NS_ASSERT (i != m_mobilityItems.end ());
+  for (std::vector<uint32_t>::const_iterator item = i->second.begin (); item != i->second.end (); item++)
+    {
+      Update (*item);
+    }
+}
+
+void
+PositionGrid::Refresh (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_maxSpeed = 0;
+  m_refreshTime = Simulator::Now ();
+  m_manager->EvaluatePositions ();
+  for (uint32_t item = 0; item < m_items.size (); item++)
+    {
+      Update (item);
+    }
+}
+
+void
+PositionGrid::RefreshNonLinear (void)
+{
+  if (m_nonLinearTime == Simulator::Now ())
+    {
+      return;
+    }
+  m_nonLinearTime = Simulator::Now ();
+  // the list may grow while the models are asked for their position
+  const std::vector<uint32_t> &nonLinear = m_manager->GetNonLinear ();
+  for (uint32_t k = 0; k < nonLinear.size (); k++)
+    {
+      std::map<const MobilityModel *, std::vector<uint32_t> >::const_iterator i =
+        m_mobilityItems.find (PeekPointer (m_manager->GetMobilityModel (nonLinear[k])));
+      if (i == m_mobilityItems.end ())
+        {
+          continue;
+        }
+      for (std::vector<uint32_t>::const_iterator item = i->second.begin (); item != i->second.end (); item++)
+        {
+          Update (*item);
+        }
+    }
+}
+
+void
+PositionGrid::GetItemsNear (const Vector &position, double distance, std::vector<uint32_t> &items)
+{
+  NS_LOG_FUNCTION (this << position << distance);
+  Bind ();
+  RefreshNonLinear ();
+  double drift = m_maxSpeed * (Simulator::Now () - m_refreshTime).GetSeconds ();
+  if (drift > m_cellSize / 2)
+    {
+      Refresh ();
+      drift = 0;
+    }
+  double range = distance + drift;
+  Cell low = GetCell (Vector (position.x - range, position.y - range, 0));
+  Cell high = GetCell (Vector (position.x + range, position.y + range, 0));
+  items.clear ();
+  if ((high.first - low.first + 1) * (high.second - low.second + 1) > static_cast<int64_t> (m_cells.size ()))
+    {
+      // fewer cells are occupied than covered by the range
+      for (std::map<Cell, std::vector<uint32_t> >::const_iterator i = m_cells.begin (); i != m_cells.end (); i++)
+        {
+          if (i->first.first >= low.first && i->first.first <= high.first
+              && i->first.second >= low.second && i->first.second <= high.second)
+            {
+              items.insert (items.end (), i->second.begin (), i->second.end ());
+            }
+        }
+    }
+  else
+    {
+      for (int64_t x = low.first; x <= high.first; x++)
+        {
+          for (int64_t y = low.second; y <= high.second; y++)
+            {
+              std::map<Cell, std::vector<uint32_t> >::const_iterator i = m_cells.find (Cell (x, y));
+              if (i != m_cells.end ())
+                {
+                  items.insert (items.end (), i->second.begin (), i->second.end ());
+                }
+            }
+        }
+    }
+  std::sort (items.begin (), items.end ());
+}
+
+} // namespace ns3
@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef POSITION_GRID_H
+#define POSITION_GRID_H
+
+#include <map>
+#include <vector>
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "ns3/event-id.h"
+#include "ns3/vector.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
+#include "mobility-model.h"
+#include "mobility-manager.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Index the positions of a set of mobility models with a
+ * uniform grid, to find the ones near a position without visiting
+ * all of them.
+ *
+ * The items of the grid, such as the PHYs attached to a channel, are
+ * numbered in the order they are added; several items may share a
+ * mobility model.  Each item is kept in the cell of the horizontal
+ * plane which contained its position when it was last indexed, and is
+ * indexed again when its mobility model notifies a course change.
+ *
+ * Between two course changes, a piecewise linear mobility model (see
+ * MobilityModel::IsPiecewiseLinear) moves in a straight line at the
+ * velocity it reported at the last one: its items may thus drift away
+ * from their cell by at most the highest of these speeds times the time
+ * elapsed since the grid was last refreshed.  The queries are widened
+ * by this drift, and all the items are indexed again once it exceeds
+ * half a cell.  The items of the other mobility models, such as the
+ * accelerating ones or the ones changing course lazily, are indexed
+ * again before every query made at a new time.
+ *
+ * The positions of the items are evaluated by the MobilityManager of
+ * the simulation, all at once when the grid is refreshed.  The grid
+ * adds its items to the manager of each simulation it is used in.
+ */
+class PositionGrid : public SimpleRefCount<PositionGrid>
+{
+public:
+  /**
+   * Constructor.
+   *
+   * \param [in] cellSize The width of the square cells of the grid, in
+   *        meters, which must be positive
+   */
+  PositionGrid (double cellSize);
+  /** Destructor. */
+  ~PositionGrid ();
+
+  /** \returns The width of the cells of the grid, in meters. */
+  double GetCellSize (void) const;
+  /** \returns The number of items in the grid. */
+  uint32_t GetNItems (void) const;
+
+  /**
+   * Add an item to the grid.
+   *
+   * \param [in] mobility The mobility model of the item
+   * \returns The number of the item
+   */
+  uint32_t Add (Ptr<MobilityModel> mobility);
+  /**
+   * \param [in] item The number of an item
+   * \returns The current position of the item
+   */
+  Vector GetPosition (uint32_t item) const;
+  /**
+   * Check whether an item is within some distance of a position.
+   *
+   * The distance is evaluated from the position of the item returned by
+   * GetPosition, or from the one its mobility model reports when both
+   * are too close to tell apart, so that the result is the same as with
+   * the mobility model.
+   *
+   * \param [in] item The number of an item
+   * \param [in] position The position
+   * \param [in] distance The distance, in meters
+   * \returns true if the item is within the distance of the position
+   */
+  bool IsWithin (uint32_t item, const Vector &position, double distance) const;
+
+  /**
+   * Get the items which may be within some distance of a position.
+   *
+   * Every item within the distance is returned, along with some items
+   * farther away: the caller is expected to check the distance of
+   * each one.
+   *
+   * \param [in] position The position
+   * \param [in] distance The distance, in meters
+   * \param [out] items The numbers of the items, in increasing order
+   */
+  void GetItemsNear (const Vector &position, double distance, std::vector<uint32_t> &items);
+
+private:
+  /** A cell of the grid, indexed by the coordinates of its lower corner divided by the cell size. */
+  typedef std::pair<int64_t, int64_t> Cell;
+
+  /** An item of the grid. */
+  struct Item
+  {
+    Ptr<MobilityModel> mobility;  //!< The mobility model of the item
+    uint32_t index;               //!< The index of the mobility model in the MobilityManager
+    Cell cell;                    //!< The cell the item is indexed in
+  };
+
+  /**
+   * \param [in] position A position
+   * \returns The cell containing the position
+   */
+  Cell GetCell (const Vector &position) const;
+  /**
+   * Add the items to the MobilityManager of the current simulation, if
+   * they are not yet, and index them again.
+   */
+  void Bind (void);
+  /** Forget the MobilityManager, when the simulator is destroyed. */
+  void Unbind (void);
+  /**
+   * Index an item in the cell of its current position, and account
+   * for its current speed if it is piecewise linear.
+   *
+   * \param [in] item The number of the item
+   */
+  void Update (uint32_t item);
+  /**
+   * Index the items of a mobility model which changed course.
+   *
+   * \param [in] mobility The mobility model
+   */
+  void CourseChanged (Ptr<const MobilityModel> mobility);
+  /** Index all the items again. */
+  void Refresh (void);
+  /** Index the items which are not piecewise linear again, once per time. */
+  void RefreshNonLinear (void);
+
+  double m_cellSize;                                    //!< The width of the cells
+  MobilityManager *m_manager;                           //!< The MobilityManager of the items, or 0 until they are added to one
+  EventId m_unbindEvent;                                //!< The event of Unbind, at simulator destruction
+  std::vector<Item> m_items;                            //!< The items
+  std::map<Cell, std::vector<uint32_t> > m_cells;       //!< The items of the non-empty cells
+  std::map<const MobilityModel *, std::vector<uint32_t> > m_mobilityItems;   //!< The items of each mobility model
+  double m_maxSpeed;                                    //!< The highest speed of the items since the last refresh
+  Time m_refreshTime;                                   //!< The time of the last refresh
+  Time m_nonLinearTime;                                 //!< The time the items not piecewise linear were last indexed
+};
+
+} // namespace ns3
+
+#endif /* POSITION_GRID_H */
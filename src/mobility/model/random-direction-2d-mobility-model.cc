@@ -23,6 +23,7 @@
 #include "ns3/log.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "random-direction-2d-mobility-model.h"
 
 namespace ns3 {
@@ -51,6 +52,13 @@ RandomDirection2dMobilityModel::GetTypeId (void)
                    StringValue ("ns3::ConstantRandomVariable[Constant=2.0]"),
                    MakePointerAccessor (&RandomDirection2dMobilityModel::m_pause),
                    MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Lazy",
+                   "Pause and change the direction and speed when the position or "
+                   "velocity is next queried, instead of in scheduled events.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomDirection2dMobilityModel::SetLazy,
+                                        &RandomDirection2dMobilityModel::IsLazy),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -63,6 +71,7 @@ RandomDirection2dMobilityModel::RandomDirection2dMobilityModel ()
 void 
 RandomDirection2dMobilityModel::DoDispose (void)
 {
+  m_scheduler.Cancel ();
   // chain up.
   MobilityModel::DoDispose ();
 }
@@ -83,11 +92,10 @@ RandomDirection2dMobilityModel::DoInitializePrivate (void)
 void
 RandomDirection2dMobilityModel::BeginPause (void)
 {
-  m_helper.Update ();
+  m_helper.Update (m_scheduler.GetNow ());
   m_helper.Pause ();
   Time pause = Seconds (m_pause->GetValue ());
-  m_event.Cancel ();
-  m_event = Simulator::Schedule (pause, &RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this);
+  m_scheduler.Schedule (pause, MakeEvent (&RandomDirection2dMobilityModel::ResetDirectionAndSpeed, this));
   NotifyCourseChange ();
 }
 
@@ -95,19 +103,18 @@ void
 RandomDirection2dMobilityModel::SetDirectionAndSpeed (double direction)
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_helper.UpdateWithBounds (m_bounds);
+  Time now = m_scheduler.GetNow ();
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   double speed = m_speed->GetValue ();
   const Vector vector (std::cos (direction) * speed,
                        std::sin (direction) * speed,
                        0.0);
-  m_helper.SetVelocity (vector);
+  m_helper.SetVelocity (vector, now);
   m_helper.Unpause ();
   Vector next = m_bounds.CalculateIntersection (position, vector);
   Time delay = Seconds (CalculateDistance (position, next) / speed);
-  m_event.Cancel ();
-  m_event = Simulator::Schedule (delay,
-                                 &RandomDirection2dMobilityModel::BeginPause, this);
+  m_scheduler.Schedule (delay, MakeEvent (&RandomDirection2dMobilityModel::BeginPause, this));
   NotifyCourseChange ();
 }
 void
@@ -115,7 +122,7 @@ RandomDirection2dMobilityModel::ResetDirectionAndSpeed (void)
 {
   double direction = m_direction->GetValue (0, M_PI);
 
-  m_helper.UpdateWithBounds (m_bounds);
+  m_helper.UpdateWithBounds (m_bounds, m_scheduler.GetNow ());
   Vector position = m_helper.GetCurrentPosition ();
   switch (m_bounds.GetClosestSide (position))
     {
@@ -137,22 +144,41 @@ RandomDirection2dMobilityModel::ResetDirectionAndSpeed (void)
 Vector
 RandomDirection2dMobilityModel::DoGetPosition (void) const
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  m_scheduler.Update ();
+  m_helper.UpdateWithBounds (m_bounds, m_scheduler.GetNow ());
   return m_helper.GetCurrentPosition ();
 }
 void
 RandomDirection2dMobilityModel::DoSetPosition (const Vector &position)
 {
+  // the earlier course changes draw their random variables first
+  m_scheduler.UpdateBeforeNow ();
   m_helper.SetPosition (position);
-  Simulator::Remove (m_event);
-  m_event.Cancel ();
-  m_event = Simulator::ScheduleNow (&RandomDirection2dMobilityModel::DoInitializePrivate, this);
+  m_scheduler.Schedule (Seconds (0), MakeEvent (&RandomDirection2dMobilityModel::DoInitializePrivate, this));
 }
 Vector
 RandomDirection2dMobilityModel::DoGetVelocity (void) const
 {
+  m_scheduler.Update ();
   return m_helper.GetVelocity ();
 }
+bool
+RandomDirection2dMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  // the lazy course changes are notified late
+  return !m_scheduler.IsLazy ();
+}
+void
+RandomDirection2dMobilityModel::SetLazy (bool lazy)
+{
+  m_scheduler.SetLazy (lazy);
+  NotifyPiecewiseLinearChange ();
+}
+bool
+RandomDirection2dMobilityModel::IsLazy (void) const
+{
+  return m_scheduler.IsLazy ();
+}
 int64_t
 RandomDirection2dMobilityModel::DoAssignStreams (int64_t stream)
 {
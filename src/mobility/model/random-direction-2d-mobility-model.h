@@ -28,6 +28,7 @@
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
 #include "constant-velocity-helper.h"
+#include "course-change-scheduler.h"
 
 namespace ns3 {
 
@@ -40,6 +41,10 @@ namespace ns3 {
  * then travels in the specific direction until it reaches one of
  * the boundaries of the model. When it reaches the boundary, it pauses,
  * selects a new direction and speed, aso.
+ *
+ * With the Lazy attribute, the pauses and changes of direction and speed
+ * are made when the position or velocity is next queried rather than
+ * scheduled as events, in the same sequence: see CourseChangeScheduler.
  */
 class RandomDirection2dMobilityModel : public MobilityModel
 {
@@ -74,13 +79,22 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual bool DoIsPiecewiseLinear (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  /**
+   * \param lazy whether to pause and change the direction and speed lazily
+   */
+  void SetLazy (bool lazy);
+  /**
+   * \return whether the pauses and changes of direction and speed are made lazily
+   */
+  bool IsLazy (void) const;
 
   Ptr<UniformRandomVariable> m_direction; //!< rv to control direction
   Rectangle m_bounds; //!< the 2D bounding area
   Ptr<RandomVariableStream> m_speed; //!< a random variable to control speed
   Ptr<RandomVariableStream> m_pause; //!< a random variable to control pause 
-  EventId m_event; //!< event ID of next scheduled event
+  CourseChangeScheduler m_scheduler; //!< scheduler of the pauses and changes of direction and speed
   ConstantVelocityHelper m_helper; //!< helper for velocity computations
 };
 
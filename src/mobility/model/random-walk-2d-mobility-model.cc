@@ -22,6 +22,7 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
+#include "ns3/boolean.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include <cmath>
@@ -70,7 +71,14 @@ RandomWalk2dMobilityModel::GetTypeId (void)
                    "A random variable used to pick the speed (m/s).",
                    StringValue ("ns3::UniformRandomVariable[Min=2.0|Max=4.0]"),
                    MakePointerAccessor (&RandomWalk2dMobilityModel::m_speed),
-                   MakePointerChecker<RandomVariableStream> ());
+                   MakePointerChecker<RandomVariableStream> ())
+    .AddAttribute ("Lazy",
+                   "Change the direction and speed when the position or velocity "
+                   "is next queried, instead of in a scheduled event.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RandomWalk2dMobilityModel::SetLazy,
+                                        &RandomWalk2dMobilityModel::IsLazy),
+                   MakeBooleanChecker ());
   return tid;
 }
 
@@ -84,13 +92,14 @@ RandomWalk2dMobilityModel::DoInitialize (void)
 void
 RandomWalk2dMobilityModel::DoInitializePrivate (void)
 {
-  m_helper.Update ();
+  Time now = m_scheduler.GetNow ();
+  m_helper.Update (now);
   double speed = m_speed->GetValue ();
   double direction = m_direction->GetValue ();
   Vector vector (std::cos (direction) * speed,
                  std::sin (direction) * speed,
                  0.0);
-  m_helper.SetVelocity (vector);
+  m_helper.SetVelocity (vector, now);
   m_helper.Unpause ();
 
   Time delayLeft;
@@ -113,17 +122,16 @@ RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
   Vector nextPosition = position;
   nextPosition.x += speed.x * delayLeft.GetSeconds ();
   nextPosition.y += speed.y * delayLeft.GetSeconds ();
-  m_event.Cancel ();
   if (m_bounds.IsInside (nextPosition))
     {
-      m_event = Simulator::Schedule (delayLeft, &RandomWalk2dMobilityModel::DoInitializePrivate, this);
+      m_scheduler.Schedule (delayLeft, MakeEvent (&RandomWalk2dMobilityModel::DoInitializePrivate, this));
     }
   else
     {
       nextPosition = m_bounds.CalculateIntersection (position, speed);
       Time delay = Seconds ((nextPosition.x - position.x) / speed.x);
-      m_event = Simulator::Schedule (delay, &RandomWalk2dMobilityModel::Rebound, this,
-                                     delayLeft - delay);
+      m_scheduler.Schedule (delay, MakeEvent (&RandomWalk2dMobilityModel::Rebound, this,
+                                              delayLeft - delay));
     }
   NotifyCourseChange ();
 }
@@ -131,7 +139,8 @@ RandomWalk2dMobilityModel::DoWalk (Time delayLeft)
 void
 RandomWalk2dMobilityModel::Rebound (Time delayLeft)
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  Time now = m_scheduler.GetNow ();
+  m_helper.UpdateWithBounds (m_bounds, now);
   Vector position = m_helper.GetCurrentPosition ();
   Vector speed = m_helper.GetVelocity ();
   switch (m_bounds.GetClosestSide (position))
@@ -145,7 +154,7 @@ RandomWalk2dMobilityModel::Rebound (Time delayLeft)
       speed.y = -speed.y;
       break;
     }
-  m_helper.SetVelocity (speed);
+  m_helper.SetVelocity (speed, now);
   m_helper.Unpause ();
   DoWalk (delayLeft);
 }
@@ -153,28 +162,49 @@ RandomWalk2dMobilityModel::Rebound (Time delayLeft)
 void
 RandomWalk2dMobilityModel::DoDispose (void)
 {
+  m_scheduler.Cancel ();
   // chain up
   MobilityModel::DoDispose ();
 }
 Vector
 RandomWalk2dMobilityModel::DoGetPosition (void) const
 {
-  m_helper.UpdateWithBounds (m_bounds);
+  m_scheduler.Update ();
+  m_helper.UpdateWithBounds (m_bounds, m_scheduler.GetNow ());
   return m_helper.GetCurrentPosition ();
 }
 void
 RandomWalk2dMobilityModel::DoSetPosition (const Vector &position)
 {
+  // the earlier course changes draw their random variables first
+  m_scheduler.UpdateBeforeNow ();
   NS_ASSERT (m_bounds.IsInside (position));
   m_helper.SetPosition (position);
-  Simulator::Remove (m_event);
-  m_event = Simulator::ScheduleNow (&RandomWalk2dMobilityModel::DoInitializePrivate, this);
+  m_scheduler.Schedule (Seconds (0), MakeEvent (&RandomWalk2dMobilityModel::DoInitializePrivate, this));
 }
 Vector
 RandomWalk2dMobilityModel::DoGetVelocity (void) const
 {
+  m_scheduler.Update ();
   return m_helper.GetVelocity ();
 }
+bool
+RandomWalk2dMobilityModel::DoIsPiecewiseLinear (void) const
+{
+  // the lazy course changes are notified late
+  return !m_scheduler.IsLazy ();
+}
+void
+RandomWalk2dMobilityModel::SetLazy (bool lazy)
+{
+  m_scheduler.SetLazy (lazy);
+  NotifyPiecewiseLinearChange ();
+}
+bool
+RandomWalk2dMobilityModel::IsLazy (void) const
+{
+  return m_scheduler.IsLazy ();
+}
 int64_t
 RandomWalk2dMobilityModel::DoAssignStreams (int64_t stream)
 {
@@ -27,6 +27,7 @@
 #include "ns3/random-variable-stream.h"
 #include "mobility-model.h"
 #include "constant-velocity-helper.h"
+#include "course-change-scheduler.h"
 
 namespace ns3 {
 
@@ -42,6 +43,10 @@ namespace ns3 {
  * of the model, we rebound on the boundary with a reflexive angle
  * and speed. This model is often identified as a brownian motion
  * model.
+ *
+ * With the Lazy attribute, the changes of direction and speed are made
+ * when the position or velocity is next queried rather than scheduled
+ * as events, in the same sequence: see CourseChangeScheduler.
  */
 class RandomWalk2dMobilityModel : public MobilityModel 
 {
@@ -77,10 +82,19 @@ private:
   virtual Vector DoGetPosition (void) const;
   virtual void DoSetPosition (const Vector &position);
   virtual Vector DoGetVelocity (void) const;
+  virtual bool DoIsPiecewiseLinear (void) const;
   virtual int64_t DoAssignStreams (int64_t);
+  /**
+   * \param lazy whether to change the direction and speed lazily
+   */
+  void SetLazy (bool lazy);
+  /**
+   * \return whether the direction and speed are changed lazily
+   */
+  bool IsLazy (void) const;
 
   ConstantVelocityHelper m_helper; //!< helper for this object
-  EventId m_event; //!< stored event ID 
+  CourseChangeScheduler m_scheduler; //!< scheduler of the changes of direction and speed
   enum Mode m_mode; //!< whether in time or distance mode
   double m_modeDistance; //!< Change direction and speed after this distance
   Time m_modeTime; //!< Change current direction and speed after this delay
@@ -0,0 +1,180 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/object-factory.h"
+#include "ns3/mobility-model.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that a random mobility model follows the same course
+ * whether it changes course lazily or in scheduled events, given the
+ * same random streams, and that it schedules no event in lazy mode.
+ */
+class LazyMobilityModelTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param factory the factory of the mobility models
+   */
+  LazyMobilityModelTestCase (ObjectFactory factory);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Create a mobility model.
+   * \param lazy whether the model changes course lazily
+   * \param courseChanges the counter of its course changes
+   * \return the mobility model
+   */
+  Ptr<MobilityModel> Create (bool lazy, uint32_t *courseChanges);
+  /**
+   * Count a course change.
+   * \param courseChanges the counter of the course changes
+   * \param model the mobility model
+   */
+  static void CourseChange (uint32_t *courseChanges, Ptr<const MobilityModel> model);
+  /** Check the positions and velocities of the two models. */
+  void Check (void);
+
+  ObjectFactory m_factory;                //!< the factory of the mobility models
+  Ptr<MobilityModel> m_scheduled;         //!< the model changing course in events
+  Ptr<MobilityModel> m_lazy;              //!< the model changing course lazily
+  uint32_t m_scheduledChanges;            //!< the course changes of the model changing course in events
+  uint32_t m_lazyChanges;                 //!< the course changes of the model changing course lazily
+};
+
+LazyMobilityModelTestCase::LazyMobilityModelTestCase (ObjectFactory factory)
+  : TestCase ("Check the lazy course changes of " + factory.GetTypeId ().GetName ()),
+    m_factory (factory),
+    m_scheduledChanges (0),
+    m_lazyChanges (0)
+{
+}
+
+void
+LazyMobilityModelTestCase::CourseChange (uint32_t *courseChanges, Ptr<const MobilityModel> model)
+{
+  (*courseChanges)++;
+}
+
+Ptr<MobilityModel>
+LazyMobilityModelTestCase::Create (bool lazy, uint32_t *courseChanges)
+{
+  m_factory.Set ("Lazy", BooleanValue (lazy));
+  Ptr<MobilityModel> model = m_factory.Create<MobilityModel> ();
+  model->AssignStreams (1);
+  model->SetPosition (Vector (10, 20, 30));
+  model->TraceConnectWithoutContext ("CourseChange", MakeBoundCallback (&LazyMobilityModelTestCase::CourseChange, courseChanges));
+  model->Initialize ();
+  return model;
+}
+
+void
+LazyMobilityModelTestCase::Check (void)
+{
+  Vector position = m_scheduled->GetPosition ();
+  Vector lazyPosition = m_lazy->GetPosition ();
+  Vector velocity = m_scheduled->GetVelocity ();
+  Vector lazyVelocity = m_lazy->GetVelocity ();
+  double t = Simulator::Now ().GetSeconds ();
+  NS_TEST_EXPECT_MSG_EQ_TOL (lazyPosition.x, position.x, 1e-6, "Wrong abscissa at " << t);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lazyPosition.y, position.y, 1e-6, "Wrong ordinate at " << t);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lazyPosition.z, position.z, 1e-6, "Wrong height at " << t);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lazyVelocity.x, velocity.x, 1e-9, "Wrong velocity at " << t);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lazyVelocity.y, velocity.y, 1e-9, "Wrong velocity at " << t);
+  NS_TEST_EXPECT_MSG_EQ_TOL (lazyVelocity.z, velocity.z, 1e-9, "Wrong velocity at " << t);
+  NS_TEST_EXPECT_MSG_EQ (m_lazyChanges, m_scheduledChanges, "Wrong number of course changes at " << t);
+}
+
+void
+LazyMobilityModelTestCase::DoRun (void)
+{
+  // alone, a lazy model schedules no event
+  uint32_t courseChanges = 0;
+  Ptr<MobilityModel> model = Create (true, &courseChanges);
+  NS_TEST_EXPECT_MSG_EQ (model->IsPiecewiseLinear (), false, "Lazy model notifies its course changes late");
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_EQ (Simulator::Now (), Seconds (0), "Lazy model scheduled events");
+  model = 0;
+  Simulator::Destroy ();
+
+  m_scheduled = Create (false, &m_scheduledChanges);
+  m_lazy = Create (true, &m_lazyChanges);
+  for (double t = 0.3; t < 300; t *= 1.5)
+    {
+      Simulator::Schedule (Seconds (t), &LazyMobilityModelTestCase::Check, this);
+    }
+  // moved, the models start over from their new position
+  Simulator::Schedule (Seconds (100.05), &MobilityModel::SetPosition, m_scheduled, Vector (50, 60, 70));
+  Simulator::Schedule (Seconds (100.05), &MobilityModel::SetPosition, m_lazy, Vector (50, 60, 70));
+  Simulator::Stop (Seconds (300));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_GT (m_scheduledChanges, 10, "Too few course changes");
+  m_scheduled = 0;
+  m_lazy = 0;
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Lazy mobility models TestSuite
+ */
+class LazyMobilityModelTestSuite : public TestSuite
+{
+public:
+  LazyMobilityModelTestSuite ();
+};
+
+LazyMobilityModelTestSuite::LazyMobilityModelTestSuite ()
+  : TestSuite ("lazy-mobility-model", UNIT)
+{
+  ObjectFactory factory;
+  factory.SetTypeId ("ns3::RandomWalk2dMobilityModel");
+  factory.Set ("Bounds", StringValue ("0|100|0|100"));
+  factory.Set ("Mode", StringValue ("Time"));
+  factory.Set ("Time", StringValue ("3s"));
+  factory.Set ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+  AddTestCase (new LazyMobilityModelTestCase (factory), TestCase::QUICK);
+
+  factory = ObjectFactory ();
+  factory.SetTypeId ("ns3::RandomDirection2dMobilityModel");
+  factory.Set ("Bounds", StringValue ("0|100|0|100"));
+  factory.Set ("Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]"));
+  factory.Set ("Pause", StringValue ("ns3::ExponentialRandomVariable[Mean=2.0]"));
+  AddTestCase (new LazyMobilityModelTestCase (factory), TestCase::QUICK);
+
+  factory = ObjectFactory ();
+  factory.SetTypeId ("ns3::GaussMarkovMobilityModel");
+  factory.Set ("Bounds", StringValue ("0|100|0|100|0|100"));
+  factory.Set ("TimeStep", StringValue ("0.5s"));
+  factory.Set ("Alpha", StringValue ("0.85"));
+  factory.Set ("MeanVelocity", StringValue ("ns3::UniformRandomVariable[Min=5|Max=15]"));
+  factory.Set ("MeanPitch", StringValue ("ns3::UniformRandomVariable[Min=0.05|Max=0.05]"));
+  AddTestCase (new LazyMobilityModelTestCase (factory), TestCase::QUICK);
+}
+
+static LazyMobilityModelTestSuite g_lazyMobilityModelTestSuite;
@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/pointer.h"
+#include "ns3/position-allocator.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/constant-acceleration-mobility-model.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/random-waypoint-mobility-model.h"
+#include "ns3/random-direction-2d-mobility-model.h"
+#include "ns3/gauss-markov-mobility-model.h"
+#include "ns3/mobility-manager.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the positions of the mobility manager, evaluated
+ * one at a time or all at once, follow the ones of the mobility models
+ * while they change course and are moved.
+ */
+class MobilityManagerTestCase : public TestCase
+{
+public:
+  MobilityManagerTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the positions of all the models.
+   * \param all whether to evaluate all the positions at once first
+   */
+  void CheckPositions (bool all);
+  /**
+   * Move a model, and check its position right away.
+   * \param index the index of the model
+   * \param position the new position
+   */
+  void Move (uint32_t index, Vector position);
+  /**
+   * Set whether a model changes course lazily, and check the positions.
+   * \param index the index of the model
+   * \param lazy whether the model is lazy
+   */
+  void SetLazy (uint32_t index, bool lazy);
+
+  std::vector<Ptr<MobilityModel> > m_models;   //!< the mobility models
+  std::vector<uint32_t> m_indices;             //!< the indices of the models
+  uint32_t m_checks;                           //!< the positions checked
+};
+
+MobilityManagerTestCase::MobilityManagerTestCase ()
+  : TestCase ("Check the positions of the mobility manager"),
+    m_checks (0)
+{
+}
+
+void
+MobilityManagerTestCase::CheckPositions (bool all)
+{
+  MobilityManager *manager = MobilityManager::Get ();
+  if (all)
+    {
+      manager->EvaluatePositions ();
+    }
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      // the manager first, as asking the model catches up its lazy
+      // course changes
+      Vector position = manager->GetPosition (m_indices[i]);
+      Vector expected = m_models[i]->GetPosition ();
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.x, expected.x, 1e-6, "Wrong abscissa of model " << i << " at " << Simulator::Now ().GetSeconds ());
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.y, expected.y, 1e-6, "Wrong ordinate of model " << i << " at " << Simulator::Now ().GetSeconds ());
+      NS_TEST_EXPECT_MSG_EQ_TOL (position.z, expected.z, 1e-6, "Wrong height of model " << i << " at " << Simulator::Now ().GetSeconds ());
+      m_checks++;
+    }
+  NS_TEST_EXPECT_MSG_EQ_TOL (manager->GetDistance (m_indices[0], m_indices[1]),
+                             m_models[0]->GetDistanceFrom (m_models[1]), 1e-6, "Wrong distance");
+}
+
+void
+MobilityManagerTestCase::Move (uint32_t index, Vector position)
+{
+  m_models[index]->SetPosition (position);
+  CheckPositions (false);
+}
+
+void
+MobilityManagerTestCase::SetLazy (uint32_t index, bool lazy)
+{
+  m_models[index]->SetAttribute ("Lazy", BooleanValue (lazy));
+  CheckPositions (false);
+}
+
+void
+MobilityManagerTestCase::DoRun (void)
+{
+  Ptr<ConstantVelocityMobilityModel> constantVelocity = CreateObject<ConstantVelocityMobilityModel> ();
+  constantVelocity->SetPosition (Vector (10, 20, 1));
+  constantVelocity->SetVelocity (Vector (1, -0.5, 0.1));
+  Ptr<ConstantAccelerationMobilityModel> constantAcceleration = CreateObject<ConstantAccelerationMobilityModel> ();
+  constantAcceleration->SetVelocityAndAcceleration (Vector (1, 0, 0), Vector (0.1, 0.2, 0));
+  Ptr<RandomRectanglePositionAllocator> waypoints = CreateObject<RandomRectanglePositionAllocator> ();
+  waypoints->SetAttribute ("X", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+  waypoints->SetAttribute ("Y", StringValue ("ns3::UniformRandomVariable[Min=0.0|Max=100.0]"));
+  waypoints->AssignStreams (1);
+
+  m_models.push_back (CreateObject<ConstantPositionMobilityModel> ());
+  m_models.push_back (constantVelocity);
+  m_models.push_back (constantAcceleration);
+  m_models.push_back (CreateObjectWithAttributes<RandomWalk2dMobilityModel> ("Mode", StringValue ("Time"),
+                                                                            "Time", StringValue ("2s"),
+                                                                            "Speed", StringValue ("ns3::UniformRandomVariable[Min=5.0|Max=20.0]")));
+  m_models.push_back (CreateObjectWithAttributes<RandomWaypointMobilityModel> ("PositionAllocator", PointerValue (waypoints),
+                                                                              "Pause", StringValue ("ns3::ConstantRandomVariable[Constant=0.5]")));
+  m_models.push_back (CreateObject<RandomDirection2dMobilityModel> ());
+  m_models.push_back (CreateObject<GaussMarkovMobilityModel> ());
+  m_models[0]->SetPosition (Vector (3, 4, 0));
+  for (uint32_t i = 3; i < m_models.size (); i++)
+    {
+      m_models[i]->SetPosition (Vector (50, 50, 0));
+      m_models[i]->AssignStreams (10 * i);
+    }
+
+  NS_TEST_EXPECT_MSG_EQ (m_models[0]->IsPiecewiseLinear (), true, "ConstantPositionMobilityModel not piecewise linear");
+  NS_TEST_EXPECT_MSG_EQ (m_models[2]->IsPiecewiseLinear (), false, "ConstantAccelerationMobilityModel piecewise linear");
+
+  MobilityManager *manager = MobilityManager::Get ();
+  for (uint32_t i = 0; i < m_models.size (); i++)
+    {
+      m_indices.push_back (manager->Add (m_models[i]));
+      m_models[i]->Initialize ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (manager->GetN (), m_models.size (), "Models not added");
+  NS_TEST_EXPECT_MSG_EQ (manager->Add (m_models[4]), m_indices[4], "Model added twice");
+  NS_TEST_EXPECT_MSG_EQ (manager->GetMobilityModel (m_indices[5]), m_models[5], "Wrong model");
+
+  for (double t = 0; t < 60; t += 0.37)
+    {
+      Simulator::Schedule (Seconds (t), &MobilityManagerTestCase::CheckPositions, this, false);
+      Simulator::Schedule (Seconds (t + 0.1), &MobilityManagerTestCase::CheckPositions, this, true);
+    }
+  // the random models notify their course change in an event scheduled
+  // when they are moved: their position is checked before it
+  Simulator::Schedule (Seconds (10.05), &MobilityManagerTestCase::Move, this, 4, Vector (20, 30, 0));
+  Simulator::Schedule (Seconds (20.05), &MobilityManagerTestCase::Move, this, 3, Vector (70, 60, 0));
+  Simulator::Schedule (Seconds (30.05), &MobilityManagerTestCase::Move, this, 1, Vector (0, 0, 0));
+  // the Gauss-Markov model changes course lazily from then on
+  Simulator::Schedule (Seconds (25.02), &MobilityManagerTestCase::SetLazy, this, 6, true);
+  Simulator::Stop (Seconds (60));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_GT (m_checks, 0, "No position checked");
+  Simulator::Destroy ();
+
+  // the next simulation has its own manager
+  manager = MobilityManager::Get ();
+  NS_TEST_EXPECT_MSG_EQ (manager->GetN (), 0, "Models kept from the previous simulation");
+  NS_TEST_EXPECT_MSG_EQ (manager->Add (m_models[0]), 0, "Model not added to the new manager");
+  m_models.clear ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Mobility manager TestSuite
+ */
+class MobilityManagerTestSuite : public TestSuite
+{
+public:
+  MobilityManagerTestSuite ()
+    : TestSuite ("mobility-manager", UNIT)
+  {
+    AddTestCase (new MobilityManagerTestCase, TestCase::QUICK);
+  }
+};
+
+static MobilityManagerTestSuite g_mobilityManagerTestSuite;
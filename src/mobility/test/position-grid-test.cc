@@ -0,0 +1,268 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include "ns3/simulator.h"
+#include "ns3/double.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/rectangle.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/constant-acceleration-mobility-model.h"
+#include "ns3/gauss-markov-mobility-model.h"
+#include "ns3/box.h"
+#include "ns3/random-walk-2d-mobility-model.h"
+#include "ns3/position-grid.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the queries of a position grid return every item
+ * within the distance, while the items move and change course, or
+ * accelerate.
+ */
+class PositionGridTestCase : public TestCase
+{
+public:
+  PositionGridTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /** Check the items near random positions. */
+  void CheckItems (void);
+  /**
+   * Change the velocity of a mobility model.
+   * \param mobility the mobility model
+   */
+  void ChangeVelocity (Ptr<ConstantVelocityMobilityModel> mobility);
+
+  Ptr<PositionGrid> m_grid;                     //!< the grid
+  std::vector<Ptr<MobilityModel> > m_items;     //!< the mobility models of the items
+  Ptr<UniformRandomVariable> m_rng;             //!< the random positions and velocities
+  uint32_t m_returned;                          //!< the items returned by the queries
+  uint32_t m_near;                              //!< the items within the distance
+};
+
+PositionGridTestCase::PositionGridTestCase ()
+  : TestCase ("Check the items near a position in a position grid"),
+    m_returned (0),
+    m_near (0)
+{
+}
+
+void
+PositionGridTestCase::CheckItems (void)
+{
+  for (uint32_t k = 0; k < 21; k++)
+    {
+      Vector position (m_rng->GetValue (-100, 1100), m_rng->GetValue (-100, 1100), 0);
+      double distance = m_rng->GetValue (0, 300);
+      if (k == 20)
+        {
+          // near the accelerating item, which soon outruns the others
+          position = m_items[101]->GetPosition ();
+          distance = 10;
+        }
+      std::vector<uint32_t> items;
+      m_grid->GetItemsNear (position, distance, items);
+      NS_TEST_EXPECT_MSG_EQ ((std::adjacent_find (items.begin (), items.end (), std::greater_equal<uint32_t> ()) == items.end ()),
+                             true, "Items not in increasing order");
+      m_returned += items.size ();
+      for (uint32_t i = 0; i < m_items.size (); i++)
+        {
+          if (CalculateDistance (m_items[i]->GetPosition (), position) <= distance)
+            {
+              m_near++;
+              NS_TEST_EXPECT_MSG_EQ (std::binary_search (items.begin (), items.end (), i), true,
+                                     "Item " << i << " missed at " << Simulator::Now ().GetSeconds () << " s");
+            }
+        }
+    }
+}
+
+void
+PositionGridTestCase::ChangeVelocity (Ptr<ConstantVelocityMobilityModel> mobility)
+{
+  mobility->SetVelocity (Vector (m_rng->GetValue (-20, 20), m_rng->GetValue (-20, 20), 0));
+}
+
+void
+PositionGridTestCase::DoRun (void)
+{
+  m_rng = CreateObject<UniformRandomVariable> ();
+  m_grid = Create<PositionGrid> (100);
+  for (uint32_t i = 0; i < 100; i++)
+    {
+      Vector position (m_rng->GetValue (0, 1000), m_rng->GetValue (0, 1000), m_rng->GetValue (0, 10));
+      Ptr<MobilityModel> mobility;
+      if (i % 3 == 0)
+        {
+          mobility = CreateObject<ConstantPositionMobilityModel> ();
+        }
+      else if (i % 3 == 1)
+        {
+          Ptr<ConstantVelocityMobilityModel> constantVelocity = CreateObject<ConstantVelocityMobilityModel> ();
+          for (uint32_t t = 5; t < 100; t += 10)
+            {
+              Simulator::Schedule (Seconds (t), &PositionGridTestCase::ChangeVelocity, this, constantVelocity);
+            }
+          mobility = constantVelocity;
+        }
+      else
+        {
+          mobility = CreateObject<RandomWalk2dMobilityModel> ();
+          mobility->SetAttribute ("Bounds", RectangleValue (Rectangle (0, 1000, 0, 1000)));
+          mobility->SetAttribute ("Speed", StringValue ("ns3::UniformRandomVariable[Min=10.0|Max=30.0]"));
+          mobility->SetAttribute ("Time", StringValue ("3s"));
+          mobility->SetAttribute ("Mode", StringValue ("Time"));
+          mobility->Initialize ();
+        }
+      mobility->SetPosition (position);
+      m_items.push_back (mobility);
+      NS_TEST_EXPECT_MSG_EQ (m_grid->Add (mobility), i, "Wrong item number");
+    }
+  // two items sharing a mobility model
+  NS_TEST_EXPECT_MSG_EQ (m_grid->Add (m_items[1]), 100, "Wrong item number");
+  m_items.push_back (m_items[1]);
+  // items which are not piecewise linear: an accelerating one, starting
+  // at rest, and a lazy one
+  Ptr<ConstantAccelerationMobilityModel> constantAcceleration = CreateObject<ConstantAccelerationMobilityModel> ();
+  constantAcceleration->SetPosition (Vector (100, 100, 0));
+  constantAcceleration->SetVelocityAndAcceleration (Vector (0, 0, 0), Vector (1, 0.8, 0));
+  m_items.push_back (constantAcceleration);
+  Ptr<MobilityModel> gaussMarkov = CreateObjectWithAttributes<GaussMarkovMobilityModel>
+      ("Bounds", BoxValue (Box (0, 1000, 0, 1000, 0, 10)),
+       "TimeStep", TimeValue (Seconds (0.5)),
+       "Lazy", BooleanValue (true));
+  gaussMarkov->SetPosition (Vector (600, 600, 0));
+  gaussMarkov->Initialize ();
+  m_items.push_back (gaussMarkov);
+  NS_TEST_EXPECT_MSG_EQ (m_grid->Add (constantAcceleration), 101, "Wrong item number");
+  NS_TEST_EXPECT_MSG_EQ (m_grid->Add (gaussMarkov), 102, "Wrong item number");
+
+  for (double t = 0; t < 100; t += 0.7)
+    {
+      Simulator::Schedule (Seconds (t), &PositionGridTestCase::CheckItems, this);
+    }
+  Simulator::Stop (Seconds (100));
+  Simulator::Run ();
+  NS_TEST_EXPECT_MSG_GT (m_near, 0, "No item near the positions");
+  // the queries are expected to return a fraction of the items only
+  NS_TEST_EXPECT_MSG_LT (m_returned, 143 * 21 * m_items.size () / 3, "Too many items returned");
+  m_grid = 0;
+  m_items.clear ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that a position grid can be queried in a simulation
+ * following the one it was created in.
+ */
+class PositionGridReuseTestCase : public TestCase
+{
+public:
+  PositionGridReuseTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Check the items within a distance of a position, and the distances.
+   * \param grid the grid
+   * \param position the position
+   * \param expected the number of items expected
+   */
+  void CheckItems (Ptr<PositionGrid> grid, Vector position, uint32_t expected);
+};
+
+PositionGridReuseTestCase::PositionGridReuseTestCase ()
+  : TestCase ("Check a position grid used in successive simulations")
+{
+}
+
+void
+PositionGridReuseTestCase::CheckItems (Ptr<PositionGrid> grid, Vector position, uint32_t expected)
+{
+  std::vector<uint32_t> items;
+  grid->GetItemsNear (position, 50, items);
+  uint32_t within = 0;
+  for (std::vector<uint32_t>::const_iterator item = items.begin (); item != items.end (); item++)
+    {
+      if (grid->IsWithin (*item, position, 50))
+        {
+          within++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (within, expected, "Wrong items near " << position << " at " << Simulator::Now ().GetSeconds () << " s");
+}
+
+void
+PositionGridReuseTestCase::DoRun (void)
+{
+  Ptr<PositionGrid> grid = Create<PositionGrid> (50);
+  Ptr<ConstantPositionMobilityModel> constantPosition = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantVelocityMobilityModel> constantVelocity = CreateObject<ConstantVelocityMobilityModel> ();
+  constantPosition->SetPosition (Vector (0, 0, 0));
+  constantVelocity->SetPosition (Vector (0, 0, 0));
+  constantVelocity->SetVelocity (Vector (10, 0, 0));
+  grid->Add (constantPosition);
+  grid->Add (constantVelocity);
+  Simulator::Schedule (Seconds (1), &PositionGridReuseTestCase::CheckItems, this, grid, Vector (0, 0, 0), 2);
+  Simulator::Schedule (Seconds (8), &PositionGridReuseTestCase::CheckItems, this, grid, Vector (0, 0, 0), 1);
+  // exactly at the distance
+  Simulator::Schedule (Seconds (8), &PositionGridReuseTestCase::CheckItems, this, grid, Vector (30, 0, 0), 2);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the models restart from the origin in the next simulation
+  constantPosition->SetPosition (Vector (200, 0, 0));
+  constantVelocity->SetPosition (Vector (0, 0, 0));
+  constantVelocity->SetVelocity (Vector (0, 10, 0));
+  Simulator::Schedule (Seconds (1), &PositionGridReuseTestCase::CheckItems, this, grid, Vector (0, 0, 0), 1);
+  Simulator::Schedule (Seconds (10), &PositionGridReuseTestCase::CheckItems, this, grid, Vector (0, 100, 0), 1);
+  Simulator::Schedule (Seconds (10), &PositionGridReuseTestCase::CheckItems, this, grid, Vector (200, 0, 0), 1);
+  Simulator::Run ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Position grid TestSuite
+ */
+class PositionGridTestSuite : public TestSuite
+{
+public:
+  PositionGridTestSuite ()
+    : TestSuite ("position-grid", UNIT)
+  {
+    AddTestCase (new PositionGridTestCase, TestCase::QUICK);
+    AddTestCase (new PositionGridReuseTestCase, TestCase::QUICK);
+  }
+};
+
+static PositionGridTestSuite g_positionGridTestSuite;
@@ -56,6 +56,21 @@ PcapHelper::CreateFile (
   NS_LOG_FUNCTION (filename << filemode << dataLinkType << snapLen << tzCorrection);
 
   Ptr<PcapFileWrapper> file = CreateObject<PcapFileWrapper> ();
+
+  Ptr<PcapNgFileWrapper> ngFile = GetPcapNgRedirect ();
+  if (ngFile != 0)
+    {
+      std::string name = filename;
+      std::string::size_type dot = name.rfind (".pcap");
+      if (dot != std::string::npos && dot + 5 == name.size ())
+        {
+          name.erase (dot);
+        }
+      uint32_t interfaceId = ngFile->AddInterface (dataLinkType, snapLen, name);
+      file->SetPcapNgInterface (ngFile, interfaceId);
+      return file;
+    }
+
   file->Open (filename, filemode);
   NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename << " for mode " << filemode);
 
@@ -76,6 +91,38 @@ PcapHelper::CreateFile (
   return file;
 }
 
+Ptr<PcapNgFileWrapper>
+PcapHelper::CreateNgFile (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+
+  Ptr<PcapNgFileWrapper> file = CreateObject<PcapNgFileWrapper> ();
+  file->Open (filename);
+  NS_ABORT_MSG_IF (file->Fail (), "Unable to Open " << filename);
+
+  //
+  // Records sit in memory until a buffer fills up, so make sure whatever is
+  // left reaches the disk even if the script keeps a reference to the file
+  // past the end of the simulation.
+  //
+  Simulator::ScheduleDestroy (&PcapNgFileWrapper::Flush, file);
+  return file;
+}
+
+Ptr<PcapNgFileWrapper> &
+PcapHelper::GetPcapNgRedirect (void)
+{
+  static Ptr<PcapNgFileWrapper> redirect = 0;
+  return redirect;
+}
+
+void
+PcapHelper::SetPcapNgRedirect (Ptr<PcapNgFileWrapper> file)
+{
+  NS_LOG_FUNCTION (file);
+  GetPcapNgRedirect () = file;
+}
+
 std::string
 PcapHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -208,6 +255,24 @@ AsciiTraceHelper::CreateFileStream (std::string filename, std::ios::openmode fil
   return StreamWrapper;
 }
 
+Ptr<OutputStreamWrapper>
+AsciiTraceHelper::CreateBinaryFileStream (std::string filename, uint32_t summaryBytes)
+{
+  NS_LOG_FUNCTION (filename << summaryBytes);
+
+  Ptr<BinaryTraceFile> file = Create<BinaryTraceFile> ();
+  NS_ABORT_MSG_UNLESS (file->Open (filename, summaryBytes), "AsciiTraceHelper::CreateBinaryFileStream():  " <<
+                       "Unable to Open " << filename);
+
+  //
+  // The string table is written when the file is closed.  Unlike a text
+  // stream, a binary file is useless until then, so make sure this happens
+  // even if a callback still holds the stream at the end of the simulation.
+  //
+  Simulator::ScheduleDestroy (&BinaryTraceFile::Close, file);
+  return Create<OutputStreamWrapper> (file);
+}
+
 std::string
 AsciiTraceHelper::GetFilenameFromDevice (std::string prefix, Ptr<NetDevice> device, bool useObjectNames)
 {
@@ -310,6 +375,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), '+', "", p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -317,6 +388,12 @@ void
 AsciiTraceHelper::DefaultEnqueueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), '+', context, p);
+      return;
+    }
   *stream->GetStream () << "+ " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -336,6 +413,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), 'd', "", p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -343,6 +426,12 @@ void
 AsciiTraceHelper::DefaultDropSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), 'd', context, p);
+      return;
+    }
   *stream->GetStream () << "d " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -363,6 +452,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), '-', "", p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -370,6 +465,12 @@ void
 AsciiTraceHelper::DefaultDequeueSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), '-', context, p);
+      return;
+    }
   *stream->GetStream () << "- " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -387,6 +488,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithoutContext (Ptr<OutputStreamWrapper> stream, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), 'r', "", p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << *p << std::endl;
 }
 
@@ -394,6 +501,12 @@ void
 AsciiTraceHelper::DefaultReceiveSinkWithContext (Ptr<OutputStreamWrapper> stream, std::string context, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (stream << p);
+  Ptr<BinaryTraceFile> binary = stream->GetBinaryFile ();
+  if (binary != 0)
+    {
+      binary->Write (Simulator::Now (), 'r', context, p);
+      return;
+    }
   *stream->GetStream () << "r " << Simulator::Now ().GetSeconds () << " " << context << " " << *p << std::endl;
 }
 
@@ -441,6 +554,45 @@ PcapHelperForDevice::EnablePcapAll (std::string prefix, bool promiscuous)
   EnablePcap (prefix, NodeContainer::GetGlobal (), promiscuous);
 }
 
+Ptr<PcapNgFileWrapper>
+PcapHelperForDevice::EnablePcapNg (std::string filename, NetDeviceContainer d, bool promiscuous)
+{
+  PcapHelper pcapHelper;
+  Ptr<PcapNgFileWrapper> file = pcapHelper.CreateNgFile (filename);
+
+  //
+  // The device helpers build per-device file names from the prefix; those
+  // names end up as the interface names in the pcapng file.
+  //
+  std::string prefix = filename;
+  std::string::size_type dot = prefix.rfind ('.');
+  if (dot != std::string::npos && dot != 0)
+    {
+      prefix.erase (dot);
+    }
+
+  PcapHelper::SetPcapNgRedirect (file);
+  EnablePcap (prefix, d, promiscuous);
+  PcapHelper::SetPcapNgRedirect (0);
+  return file;
+}
+
+Ptr<PcapNgFileWrapper>
+PcapHelperForDevice::EnablePcapNgAll (std::string filename, bool promiscuous)
+{
+  NetDeviceContainer devs;
+  NodeContainer n = NodeContainer::GetGlobal ();
+  for (NodeContainer::Iterator i = n.Begin (); i != n.End (); ++i)
+    {
+      Ptr<Node> node = *i;
+      for (uint32_t j = 0; j < node->GetNDevices (); ++j)
+        {
+          devs.Add (node->GetDevice (j));
+        }
+    }
+  return EnablePcapNg (filename, devs, promiscuous);
+}
+
 void 
 PcapHelperForDevice::EnablePcap (std::string prefix, uint32_t nodeid, uint32_t deviceid, bool promiscuous)
 {
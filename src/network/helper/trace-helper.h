@@ -24,7 +24,9 @@
 #include "ns3/node-container.h"
 #include "ns3/simulator.h"
 #include "ns3/pcap-file-wrapper.h"
+#include "ns3/pcapng-file-wrapper.h"
 #include "ns3/output-stream-wrapper.h"
+#include "ns3/binary-trace-file.h"
 
 namespace ns3 {
 
@@ -109,6 +111,29 @@ public:
                                    DataLinkType dataLinkType,
                                    uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
                                    int32_t tzCorrection = 0);
+  /**
+   * @brief Create a buffered pcapng file able to hold the packets of many
+   * devices.
+   *
+   * The file is flushed when the simulator is destroyed.  Its buffering
+   * and compression are controlled by the ns3::PcapNgFileWrapper attributes.
+   *
+   * @param filename file name
+   * @returns a smart pointer to the pcapng file
+   */
+  Ptr<PcapNgFileWrapper> CreateNgFile (std::string filename);
+
+  /**
+   * @brief Make subsequent calls to CreateFile, from any PcapHelper, add an
+   * interface to the given pcapng file instead of creating a pcap file.
+   *
+   * This is how PcapHelperForDevice::EnablePcapNg multiplexes devices into
+   * one file without changes to the device helpers.
+   *
+   * @param file the pcapng file, or 0 to restore the normal behavior
+   */
+  static void SetPcapNgRedirect (Ptr<PcapNgFileWrapper> file);
+
   /**
    * @brief Hook a trace source to the default trace sink
    * 
@@ -119,6 +144,11 @@ public:
   template <typename T> void HookDefaultSink (Ptr<T> object, std::string traceName, Ptr<PcapFileWrapper> file);
 
 private:
+  /**
+   * @returns the pcapng file CreateFile currently redirects to, if any
+   */
+  static Ptr<PcapNgFileWrapper> & GetPcapNgRedirect (void);
+
   /**
    * The basic default trace sink.
    *
@@ -222,6 +252,22 @@ public:
   Ptr<OutputStreamWrapper> CreateFileStream (std::string filename, 
                                              std::ios::openmode filemode = std::ios::out);
 
+  /**
+   * @brief Create a stream which makes the default trace sinks write
+   * fixed-width binary records instead of formatted text.
+   *
+   * The records are much cheaper to produce than the text lines; the text
+   * can be regenerated later with BinaryTraceFile::ConvertToAscii, or the
+   * convert-binary-trace program.  The file is completed when the stream
+   * is released or when the simulator is destroyed, whichever comes first.
+   *
+   * @param filename file name
+   * @param summaryBytes number of serialized header bytes kept per record
+   * @returns a smart pointer to the output stream
+   */
+  Ptr<OutputStreamWrapper> CreateBinaryFileStream (std::string filename,
+                                                   uint32_t summaryBytes = BinaryTraceFile::SUMMARY_BYTES_DEFAULT);
+
   /**
    * @brief Hook a trace source to the default enqueue operation trace sink that
    * does not accept nor log a trace context.
@@ -632,6 +678,32 @@ public:
    * @param promiscuous If true capture all possible packets available at the device.
    */
   void EnablePcapAll (std::string prefix, bool promiscuous = false);
+
+  /**
+   * @brief Enable pcap output on each device in the container which is of the
+   * appropriate type, writing all of them into a single pcapng file.
+   *
+   * Each device is described by its own interface block, named like the
+   * file EnablePcap would have created for it.  Records are buffered and
+   * written by a background thread, see ns3::PcapNgFileWrapper.
+   *
+   * @param filename Name of the pcapng file.
+   * @param d container of devices.
+   * @param promiscuous If true capture all possible packets available at the device.
+   * @returns the pcapng file, e.g. to flush it before the end of the simulation.
+   */
+  Ptr<PcapNgFileWrapper> EnablePcapNg (std::string filename, NetDeviceContainer d, bool promiscuous = false);
+
+  /**
+   * @brief Enable pcap output on each device (which is of the appropriate type)
+   * in the set of all nodes created in the simulation, writing all of them
+   * into a single pcapng file.
+   *
+   * @param filename Name of the pcapng file.
+   * @param promiscuous If true capture all possible packets available at the device.
+   * @returns the pcapng file, e.g. to flush it before the end of the simulation.
+   */
+  Ptr<PcapNgFileWrapper> EnablePcapNgAll (std::string filename, bool promiscuous = false);
 };
 
 /**
@@ -33,10 +33,15 @@ NS_LOG_COMPONENT_DEFINE ("PacketMetadata");
 
 bool PacketMetadata::m_enable = false;
 bool PacketMetadata::m_enableChecking = false;
+bool PacketMetadata::m_lazy = true;
 bool PacketMetadata::m_metadataSkipped = false;
 uint32_t PacketMetadata::m_maxSize = 0;
 uint16_t PacketMetadata::m_chunkUid = 0;
 PacketMetadata::DataFreeList PacketMetadata::m_freeList;
+PacketMetadata::DataFreeList PacketMetadata::m_logFreeList;
+
+/// Number of operations the lazy log holds before it is replayed
+static const uint32_t LOG_MAX_ENTRIES = 16;
 
 PacketMetadata::DataFreeList::~DataFreeList ()
 {
@@ -70,6 +75,13 @@ PacketMetadata::EnableChecking (void)
   m_enableChecking = true;
 }
 
+void
+PacketMetadata::SetLazy (bool lazy)
+{
+  NS_LOG_FUNCTION (lazy);
+  m_lazy = lazy;
+}
+
 void
 PacketMetadata::ReserveCopy (uint32_t size)
 {
@@ -651,19 +663,137 @@ PacketMetadata::CreateFragment (uint32_t start, uint32_t end) const
   return fragment;
 }
 
+void
+PacketMetadata::AppendLog (struct LogEntry const &entry)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (entry.operation));
+  if (m_logUsed == LOG_MAX_ENTRIES * sizeof (struct LogEntry))
+    {
+      Materialize ();
+    }
+  if (m_log == 0)
+    {
+      if (m_logFreeList.empty ())
+        {
+          m_log = PacketMetadata::Allocate (LOG_MAX_ENTRIES * sizeof (struct LogEntry));
+        }
+      else
+        {
+          m_log = m_logFreeList.back ();
+          m_logFreeList.pop_back ();
+          m_log->m_count = 1;
+        }
+      m_log->m_dirtyEnd = 0;
+      m_logUsed = 0;
+    }
+  else if (m_log->m_count > 1 && m_log->m_dirtyEnd != m_logUsed)
+    {
+      // another copy already appended past our end: copy the log
+      struct PacketMetadata::Data *log = PacketMetadata::Allocate (LOG_MAX_ENTRIES * sizeof (struct LogEntry));
+      memcpy (log->m_data, m_log->m_data, m_logUsed);
+      ReleaseLog (m_log);
+      m_log = log;
+    }
+  memcpy (&m_log->m_data[m_logUsed], &entry, sizeof (struct LogEntry));
+  m_logUsed += sizeof (struct LogEntry);
+  m_log->m_dirtyEnd = m_logUsed;
+}
+
+bool
+PacketMetadata::CancelLog (uint8_t operation, uint32_t uid, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << static_cast<uint32_t> (operation) << uid << size);
+  if (m_logUsed == 0)
+    {
+      return false;
+    }
+  struct LogEntry last;
+  memcpy (&last, &m_log->m_data[m_logUsed - sizeof (struct LogEntry)], sizeof (struct LogEntry));
+  if (last.operation != operation || last.typeUid != uid || last.size != size)
+    {
+      return false;
+    }
+  // Removing the item just added restores the previous list exactly.
+  m_logUsed -= sizeof (struct LogEntry);
+  if (m_logUsed == 0)
+    {
+      ReleaseLog (m_log);
+      m_log = 0;
+    }
+  return true;
+}
+
+void
+PacketMetadata::Materialize (void) const
+{
+  if (m_log == 0)
+    {
+      return;
+    }
+  NS_LOG_FUNCTION (this << m_logUsed);
+  // The replay changes the representation, not the items described.
+  PacketMetadata *self = const_cast<PacketMetadata *> (this);
+  struct PacketMetadata::Data *log = m_log;
+  uint16_t used = m_logUsed;
+  self->m_log = 0;
+  self->m_logUsed = 0;
+  for (uint16_t offset = 0; offset < used; offset += sizeof (struct LogEntry))
+    {
+      struct LogEntry entry;
+      memcpy (&entry, &log->m_data[offset], sizeof (struct LogEntry));
+      switch (entry.operation)
+        {
+        case LOG_ADD_HEADER:
+          self->DoAddHeader (entry.typeUid, entry.size, entry.chunkUid);
+          break;
+        case LOG_REMOVE_HEADER:
+          self->DoRemoveHeader (entry.typeUid, entry.size);
+          break;
+        case LOG_ADD_TRAILER:
+          self->DoAddTrailer (entry.typeUid, entry.size, entry.chunkUid);
+          break;
+        case LOG_REMOVE_TRAILER:
+          self->DoRemoveTrailer (entry.typeUid, entry.size);
+          break;
+        case LOG_REMOVE_AT_START:
+          self->DoRemoveAtStart (entry.size);
+          break;
+        case LOG_REMOVE_AT_END:
+          self->DoRemoveAtEnd (entry.size);
+          break;
+        default:
+          NS_ASSERT (false);
+          break;
+        }
+    }
+  ReleaseLog (log);
+}
+
 void 
 PacketMetadata::AddHeader (const Header &header, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &header << size);
   NS_ASSERT (IsStateOk ());
   uint32_t uid = header.GetInstanceTypeId ().GetUid () << 1;
-  DoAddHeader (uid, size);
+  if (!m_enable)
+    {
+      m_metadataSkipped = true;
+      return;
+    }
+  if (IsLazy ())
+    {
+      struct LogEntry entry = { LOG_ADD_HEADER, 0, m_chunkUid++, uid, size };
+      AppendLog (entry);
+      return;
+    }
+  Materialize ();
+  DoAddHeader (uid, size, m_chunkUid++);
   NS_ASSERT (IsStateOk ());
 }
 void
-PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
+PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size, uint16_t chunkUid)
 {
-  NS_LOG_FUNCTION (this << uid << size);
+  NS_LOG_FUNCTION (this << uid << size << chunkUid);
   if (!m_enable)
     {
       m_metadataSkipped = true;
@@ -675,8 +805,7 @@ PacketMetadata::DoAddHeader (uint32_t uid, uint32_t size)
   item.prev = 0xffff;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = chunkUid;
   uint16_t written = AddSmall (&item);
   UpdateHead (written);
 }
@@ -691,6 +820,22 @@ PacketMetadata::RemoveHeader (const Header &header, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (IsLazy ())
+    {
+      if (!CancelLog (LOG_ADD_HEADER, uid, size))
+        {
+          struct LogEntry entry = { LOG_REMOVE_HEADER, 0, 0, uid, size };
+          AppendLog (entry);
+        }
+      return;
+    }
+  Materialize ();
+  DoRemoveHeader (uid, size);
+}
+void
+PacketMetadata::DoRemoveHeader (uint32_t uid, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << uid << size);
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_head, &item, &extraItem);
@@ -739,13 +884,25 @@ PacketMetadata::AddTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (IsLazy ())
+    {
+      struct LogEntry entry = { LOG_ADD_TRAILER, 0, m_chunkUid++, uid, size };
+      AppendLog (entry);
+      return;
+    }
+  Materialize ();
+  DoAddTrailer (uid, size, m_chunkUid++);
+}
+void
+PacketMetadata::DoAddTrailer (uint32_t uid, uint32_t size, uint16_t chunkUid)
+{
+  NS_LOG_FUNCTION (this << uid << size << chunkUid);
   struct PacketMetadata::SmallItem item;
   item.next = 0xffff;
   item.prev = m_tail;
   item.typeUid = uid;
   item.size = size;
-  item.chunkUid = m_chunkUid;
-  m_chunkUid++;
+  item.chunkUid = chunkUid;
   uint16_t written = AddSmall (&item);
   UpdateTail (written);
   NS_ASSERT (IsStateOk ());
@@ -761,6 +918,22 @@ PacketMetadata::RemoveTrailer (const Trailer &trailer, uint32_t size)
       m_metadataSkipped = true;
       return;
     }
+  if (IsLazy ())
+    {
+      if (!CancelLog (LOG_ADD_TRAILER, uid, size))
+        {
+          struct LogEntry entry = { LOG_REMOVE_TRAILER, 0, 0, uid, size };
+          AppendLog (entry);
+        }
+      return;
+    }
+  Materialize ();
+  DoRemoveTrailer (uid, size);
+}
+void
+PacketMetadata::DoRemoveTrailer (uint32_t uid, uint32_t size)
+{
+  NS_LOG_FUNCTION (this << uid << size);
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
   uint32_t read = ReadItems (m_tail, &item, &extraItem);
@@ -808,6 +981,8 @@ PacketMetadata::AddAtEnd (PacketMetadata const&o)
       m_metadataSkipped = true;
       return;
     }
+  Materialize ();
+  o.Materialize ();
   if (m_tail == 0xffff)
     {
       // We have no items so 'AddAtEnd' is 
@@ -896,6 +1071,19 @@ PacketMetadata::RemoveAtStart (uint32_t start)
       m_metadataSkipped = true;
       return;
     }
+  if (IsLazy ())
+    {
+      struct LogEntry entry = { LOG_REMOVE_AT_START, 0, 0, 0, start };
+      AppendLog (entry);
+      return;
+    }
+  Materialize ();
+  DoRemoveAtStart (start);
+}
+void
+PacketMetadata::DoRemoveAtStart (uint32_t start)
+{
+  NS_LOG_FUNCTION (this << start);
   NS_ASSERT (m_data != 0);
   uint32_t leftToRemove = start;
   uint16_t current = m_head;
@@ -959,6 +1147,19 @@ PacketMetadata::RemoveAtEnd (uint32_t end)
       m_metadataSkipped = true;
       return;
     }
+  if (IsLazy ())
+    {
+      struct LogEntry entry = { LOG_REMOVE_AT_END, 0, 0, 0, end };
+      AppendLog (entry);
+      return;
+    }
+  Materialize ();
+  DoRemoveAtEnd (end);
+}
+void
+PacketMetadata::DoRemoveAtEnd (uint32_t end)
+{
+  NS_LOG_FUNCTION (this << end);
   NS_ASSERT (m_data != 0);
 
   uint32_t leftToRemove = end;
@@ -1018,6 +1219,7 @@ uint32_t
 PacketMetadata::GetTotalSize (void) const
 {
   NS_LOG_FUNCTION (this);
+  Materialize ();
   uint32_t totalSize = 0;
   uint16_t current = m_head;
   uint16_t tail = m_tail;
@@ -1047,6 +1249,7 @@ PacketMetadata::ItemIterator
 PacketMetadata::BeginItem (Buffer buffer) const
 {
   NS_LOG_FUNCTION (this << &buffer);
+  Materialize ();
   return ItemIterator (this, buffer);
 }
 PacketMetadata::ItemIterator::ItemIterator (const PacketMetadata *metadata, Buffer buffer)
@@ -1146,6 +1349,7 @@ PacketMetadata::GetSerializedSize (void) const
     {
       return totalSize;
     }
+  Materialize ();
 
   struct PacketMetadata::SmallItem item;
   struct PacketMetadata::ExtraItem extraItem;
@@ -1179,6 +1383,7 @@ uint32_t
 PacketMetadata::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
   NS_LOG_FUNCTION (this << &buffer << maxSize);
+  Materialize ();
   uint8_t* start = buffer;
 
   buffer = AddToRawU64 (m_packetUid, start, buffer, maxSize);
@@ -1280,6 +1485,7 @@ uint32_t
 PacketMetadata::Deserialize (const uint8_t* buffer, uint32_t size)
 {
   NS_LOG_FUNCTION (this << &buffer << size);
+  Materialize ();
   const uint8_t* start = buffer;
   uint32_t desSize = size - 4;
 
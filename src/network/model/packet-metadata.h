@@ -74,6 +74,16 @@ class Trailer;
  * integers, and some others as variable-size 32-bit integers.
  * The variable-size 32 bit integers are stored using the uleb128
  * encoding.
+ *
+ * Maintaining this linked list on every header and trailer operation
+ * is costly, and most packets are never printed. Unless checking is
+ * enabled, operations are therefore first appended, as fixed-size
+ * records, to a small per-packet log which is shared between packet
+ * copies just like the item buffer.  A header or trailer removed right
+ * after it was added simply cancels the logged addition.  The log is
+ * replayed into the linked list only when the items are needed
+ * (BeginItem, serialization, AddAtEnd) or when it is full, which gives
+ * exactly the list an immediate update would have given.
  */
 class PacketMetadata 
 {
@@ -159,6 +169,16 @@ private:
    * \brief Enable the packet metadata checking
    */
   static void EnableChecking (void);
+  /**
+   * \brief Enable or disable the lazy recording of metadata operations
+   *
+   * Lazy recording is enabled by default; it is never used while checking
+   * is enabled, since checking must happen when a header is removed.
+   *
+   * \param lazy true to log operations and replay them on demand, false
+   * to update the item list on every operation.
+   */
+  static void SetLazy (bool lazy);
 
   /**
    * \brief Constructor
@@ -613,8 +633,91 @@ public:
    * \brief Add an header
    * \param uid header's uid to add
    * \param size header serialized size
+   * \param chunkUid the chunk uid of the new item
+   */
+  void DoAddHeader (uint32_t uid, uint32_t size, uint16_t chunkUid);
+  /**
+   * \brief Remove an header
+   * \param uid header's uid to remove
+   * \param size header serialized size
+   */
+  void DoRemoveHeader (uint32_t uid, uint32_t size);
+  /**
+   * \brief Add a trailer
+   * \param uid trailer's uid to add
+   * \param size trailer serialized size
+   * \param chunkUid the chunk uid of the new item
+   */
+  void DoAddTrailer (uint32_t uid, uint32_t size, uint16_t chunkUid);
+  /**
+   * \brief Remove a trailer
+   * \param uid trailer's uid to remove
+   * \param size trailer serialized size
    */
-  void DoAddHeader (uint32_t uid, uint32_t size);
+  void DoRemoveTrailer (uint32_t uid, uint32_t size);
+  /**
+   * \brief Remove a chunk of metadata at the metadata start
+   * \param start the size of metadata to remove
+   */
+  void DoRemoveAtStart (uint32_t start);
+  /**
+   * \brief Remove a chunk of metadata at the metadata end
+   * \param end the size of metadata to remove
+   */
+  void DoRemoveAtEnd (uint32_t end);
+
+  /**
+   * Operations recorded in the lazy log
+   */
+  enum LogOperation
+  {
+    LOG_ADD_HEADER,
+    LOG_REMOVE_HEADER,
+    LOG_ADD_TRAILER,
+    LOG_REMOVE_TRAILER,
+    LOG_REMOVE_AT_START,
+    LOG_REMOVE_AT_END
+  };
+  /**
+   * \brief Entry of the lazy log
+   */
+  struct LogEntry
+  {
+    uint8_t operation;  //!< a LogOperation
+    uint8_t unused;     //!< padding
+    uint16_t chunkUid;  //!< chunk uid of an added header or trailer
+    uint32_t typeUid;   //!< type uid of the header or trailer, shifted left by one
+    uint32_t size;      //!< size of the header or trailer, or of the removed area
+  };
+  /**
+   * \returns true if operations should be appended to the lazy log
+   */
+  static inline bool IsLazy (void);
+  /**
+   * \brief Append an operation to the lazy log
+   * \param entry the operation
+   */
+  void AppendLog (struct LogEntry const &entry);
+  /**
+   * \brief Cancel the last logged operation if it added the given item
+   * \param operation LOG_ADD_HEADER or LOG_ADD_TRAILER
+   * \param uid the type uid of the item being removed
+   * \param size the size of the item being removed
+   * \returns true if the last logged operation was cancelled
+   */
+  bool CancelLog (uint8_t operation, uint32_t uid, uint32_t size);
+  /**
+   * \brief Replay the lazy log into the item list, and release it
+   *
+   * This does not change the items the metadata describes, so it is
+   * allowed on a const object.
+   */
+  void Materialize (void) const;
+  /**
+   * \brief Release a reference to a lazy log
+   * \param log the log
+   */
+  static inline void ReleaseLog (struct PacketMetadata::Data *log);
   /**
    * \brief Check if the metadata state is ok
    * \returns true if the internal state is ok
@@ -657,8 +760,10 @@ public:
   static void Deallocate (struct PacketMetadata::Data *data);
 
   static DataFreeList m_freeList; //!< the metadata data storage
+  static DataFreeList m_logFreeList; //!< the lazy log storage
   static bool m_enable; //!< Enable the packet metadata
   static bool m_enableChecking; //!< Enable the packet metadata checking
+  static bool m_lazy; //!< Log operations and replay them on demand
 
   /**
    * Set to true when adding metadata to a packet is skipped because
@@ -680,6 +785,8 @@ public:
   uint16_t m_tail; //!< list tail
   uint16_t m_used; //!< used portion
   uint64_t m_packetUid; //!< packet Uid
+  struct Data *m_log; //!< lazy log, or 0 if no operation is pending
+  uint16_t m_logUsed; //!< used portion of the lazy log
 };
 
 } // namespace ns3
@@ -691,12 +798,14 @@ PacketMetadata::PacketMetadata (uint64_t uid, uint32_t size)
     m_head (0xffff),
     m_tail (0xffff),
     m_used (0),
-    m_packetUid (uid)
+    m_packetUid (uid),
+    m_log (0),
+    m_logUsed (0)
 {
   memset (m_data->m_data, 0xff, 4);
   if (size > 0)
     {
-      DoAddHeader (0, size);
+      DoAddHeader (0, size, m_chunkUid++);
     }
 }
 PacketMetadata::PacketMetadata (PacketMetadata const &o)
@@ -704,11 +813,17 @@ PacketMetadata::PacketMetadata (PacketMetadata const &o)
     m_head (o.m_head),
     m_tail (o.m_tail),
     m_used (o.m_used),
-    m_packetUid (o.m_packetUid)
+    m_packetUid (o.m_packetUid),
+    m_log (o.m_log),
+    m_logUsed (o.m_logUsed)
 {
   NS_ASSERT (m_data != 0);
   NS_ASSERT (m_data->m_count < std::numeric_limits<uint32_t>::max());
   m_data->m_count++;
+  if (m_log != 0)
+    {
+      m_log->m_count++;
+    }
 }
 PacketMetadata &
 PacketMetadata::operator = (PacketMetadata const& o)
@@ -726,10 +841,20 @@ PacketMetadata::operator = (PacketMetadata const& o)
       NS_ASSERT (m_data != 0);
       m_data->m_count++;
     }
+  if (m_log != o.m_log)
+    {
+      if (o.m_log != 0)
+        {
+          o.m_log->m_count++;
+        }
+      ReleaseLog (m_log);
+      m_log = o.m_log;
+    }
   m_head = o.m_head;
   m_tail = o.m_tail;
   m_used = o.m_used;
   m_packetUid = o.m_packetUid;
+  m_logUsed = o.m_logUsed;
   return *this;
 }
 PacketMetadata::~PacketMetadata ()
@@ -740,6 +865,31 @@ PacketMetadata::~PacketMetadata ()
     {
       PacketMetadata::Recycle (m_data);
     }
+  ReleaseLog (m_log);
+}
+bool
+PacketMetadata::IsLazy (void)
+{
+  return m_lazy && !m_enableChecking;
+}
+void
+PacketMetadata::ReleaseLog (struct PacketMetadata::Data *log)
+{
+  if (log != 0)
+    {
+      log->m_count--;
+      if (log->m_count == 0)
+        {
+          if (!m_enable || m_logFreeList.size () > 1000)
+            {
+              PacketMetadata::Deallocate (log);
+            }
+          else
+            {
+              m_logFreeList.push_back (log);
+            }
+        }
+    }
 }
 
 } // namespace ns3
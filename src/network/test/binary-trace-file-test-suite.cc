@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <sstream>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/packet.h"
+#include "ns3/ethernet-header.h"
+#include "ns3/ethernet-trailer.h"
+#include "ns3/llc-snap-header.h"
+#include "ns3/binary-trace-file.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("binary-trace-file-test-suite");
+
+// ===========================================================================
+// Feed the same packets to the default ASCII sinks, once with a text stream
+// and once with a binary stream, and check that converting the binary file
+// gives back the text output.
+// ===========================================================================
+class BinaryTraceConvertTestCase : public TestCase
+{
+public:
+  BinaryTraceConvertTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Send a packet to the default sinks of both streams.
+   * \param p the packet
+   */
+  void Trace (Ptr<const Packet> p);
+
+  Ptr<OutputStreamWrapper> m_text;    //!< text stream
+  Ptr<OutputStreamWrapper> m_binary;  //!< binary stream
+};
+
+BinaryTraceConvertTestCase::BinaryTraceConvertTestCase ()
+  : TestCase ("Check that a binary trace converts back to the ASCII trace")
+{
+}
+
+void
+BinaryTraceConvertTestCase::Trace (Ptr<const Packet> p)
+{
+  std::string context = "/NodeList/3/DeviceList/1/$ns3::CsmaNetDevice/TxQueue/Enqueue";
+  AsciiTraceHelper::DefaultEnqueueSinkWithContext (m_text, context, p);
+  AsciiTraceHelper::DefaultEnqueueSinkWithContext (m_binary, context, p);
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (m_text, p);
+  AsciiTraceHelper::DefaultDequeueSinkWithoutContext (m_binary, p);
+  AsciiTraceHelper::DefaultDropSinkWithContext (m_text, "/NodeList/0", p);
+  AsciiTraceHelper::DefaultDropSinkWithContext (m_binary, "/NodeList/0", p);
+  AsciiTraceHelper::DefaultReceiveSinkWithoutContext (m_text, p);
+  AsciiTraceHelper::DefaultReceiveSinkWithoutContext (m_binary, p);
+}
+
+void
+BinaryTraceConvertTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("convert.btr");
+  Packet::EnablePrinting ();
+
+  std::ostringstream text;
+  AsciiTraceHelper helper;
+  m_text = Create<OutputStreamWrapper> (&text);
+  m_binary = helper.CreateBinaryFileStream (filename);
+
+  Ptr<Packet> p = Create<Packet> (100);
+  LlcSnapHeader llc;
+  llc.SetType (0x0800);
+  p->AddHeader (llc);
+  EthernetHeader eth (false);
+  eth.SetSource (Mac48Address ("00:00:00:00:00:01"));
+  eth.SetDestination (Mac48Address ("00:00:00:00:00:02"));
+  eth.SetLengthType (p->GetSize ());
+  p->AddHeader (eth);
+  EthernetTrailer fcs;
+  fcs.EnableFcs (true);
+  fcs.CalcFcs (p);
+  p->AddTrailer (fcs);
+
+  Simulator::Schedule (Seconds (1.5), &BinaryTraceConvertTestCase::Trace, this, p);
+  Simulator::Schedule (MicroSeconds (2000001), &BinaryTraceConvertTestCase::Trace, this,
+                       p->CreateFragment (10, 50));
+  Simulator::Schedule (Seconds (3), &BinaryTraceConvertTestCase::Trace, this,
+                       Ptr<const Packet> (Create<Packet> (20)));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_binary->GetBinaryFile ()->GetNRecords (), 12, "Wrong number of records");
+  m_text = 0;
+  m_binary = 0;
+
+  std::ostringstream converted;
+  bool ok = BinaryTraceFile::ConvertToAscii (filename, converted);
+  NS_TEST_ASSERT_MSG_EQ (ok, true, "Conversion of " << filename << " failed");
+  NS_TEST_ASSERT_MSG_EQ (converted.str (), text.str (), "Converted trace differs from the ASCII trace");
+
+  std::remove (filename.c_str ());
+}
+
+// ===========================================================================
+// A record only has room for a few header bytes and items; what does not fit
+// must still be described, without corrupting the following records.
+// ===========================================================================
+class BinaryTraceTruncationTestCase : public TestCase
+{
+public:
+  BinaryTraceTruncationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+BinaryTraceTruncationTestCase::BinaryTraceTruncationTestCase ()
+  : TestCase ("Check records whose headers do not fit")
+{
+}
+
+void
+BinaryTraceTruncationTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("truncate.btr");
+  Packet::EnablePrinting ();
+
+  Ptr<Packet> p = Create<Packet> (10);
+  for (uint32_t i = 0; i < BinaryTraceFile::MAX_ITEMS + 1; ++i)
+    {
+      LlcSnapHeader llc;
+      llc.SetType (i);
+      p->AddHeader (llc);
+    }
+
+  BinaryTraceFile f;
+  NS_TEST_ASSERT_MSG_EQ (f.Open (filename, 16), true, "Open (" << filename << ") failed");
+  f.Write (Seconds (1), 'r', "", p);
+  f.Write (Seconds (2), 'r', "", Create<Packet> (5));
+  f.Close ();
+
+  std::ostringstream converted;
+  NS_TEST_ASSERT_MSG_EQ (BinaryTraceFile::ConvertToAscii (filename, converted), true, "Conversion failed");
+
+  // two LLC/SNAP headers (8 bytes each) fit in 16 bytes, the others print
+  // without their fields, and the seventh item is cut off.
+  std::ostringstream first;
+  first << "r 1 ";
+  for (uint32_t i = 0; i < BinaryTraceFile::MAX_ITEMS; ++i)
+    {
+      if (i < 2)
+        {
+          LlcSnapHeader llc;
+          llc.SetType (BinaryTraceFile::MAX_ITEMS - i);
+          first << "ns3::LlcSnapHeader (";
+          llc.Print (first);
+          first << ") ";
+        }
+      else
+        {
+          first << "ns3::LlcSnapHeader () ";
+        }
+    }
+  first << "...";
+  std::string expected = first.str () + "\nr 2 Payload (size=5)\n";
+  NS_TEST_ASSERT_MSG_EQ (converted.str (), expected, "Unexpected conversion of truncated records");
+
+  std::remove (filename.c_str ());
+}
+
+class BinaryTraceFileTestSuite : public TestSuite
+{
+public:
+  BinaryTraceFileTestSuite ();
+};
+
+BinaryTraceFileTestSuite::BinaryTraceFileTestSuite ()
+  : TestSuite ("binary-trace-file", UNIT)
+{
+  AddTestCase (new BinaryTraceConvertTestCase, TestCase::QUICK);
+  AddTestCase (new BinaryTraceTruncationTestCase, TestCase::QUICK);
+}
+
+static BinaryTraceFileTestSuite binaryTraceFileTestSuite;
@@ -19,6 +19,7 @@
 #include "ns3/test.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/uinteger.h"
+#include "ns3/callback.h"
 
 using namespace ns3;
 
@@ -77,6 +78,105 @@ DropTailQueueTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ ((item == 0), true, "There are really no packets in there");
 }
 
+class DropTailQueueRingTestCase : public TestCase
+{
+public:
+  DropTailQueueRingTestCase ();
+  virtual void DoRun (void);
+private:
+  /// Count an enqueued packet
+  void Enqueued (Ptr<const Packet> p);
+  uint32_t m_enqueued; //!< number of enqueued packets
+};
+
+DropTailQueueRingTestCase::DropTailQueueRingTestCase ()
+  : TestCase ("Check the drop tail queue ring buffer wraps around, grows and batches in order"),
+    m_enqueued (0)
+{
+}
+void
+DropTailQueueRingTestCase::Enqueued (Ptr<const Packet> p)
+{
+  m_enqueued++;
+}
+void
+DropTailQueueRingTestCase::DoRun (void)
+{
+  Ptr<DropTailQueue> queue = CreateObject<DropTailQueue> ();
+  queue->SetMaxPackets (5);
+
+  // Enqueue and dequeue so that the items wrap around the end of the ring
+  std::vector<Ptr<Packet> > packets;
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      packets.push_back (Create<Packet> (i + 1));
+    }
+  uint32_t next = 0;
+  for (uint32_t i = 0; i < 20; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (queue->Enqueue (Create<QueueItem> (packets[i])), true, "Enqueue failed");
+      if (i % 5 != 0)
+        {
+          Ptr<QueueItem> item = queue->Dequeue ();
+          NS_TEST_EXPECT_MSG_EQ (item->GetPacket ()->GetUid (), packets[next++]->GetUid (), "Out of order");
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (queue->GetCapacity (), 8, "The ring should be sized for MaxPackets once");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNPackets (), 20 - next, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (queue->Peek ()->GetPacket ()->GetUid (), packets[next]->GetUid (), "Bad peek");
+
+  // The batch calls drop what does not fit and dequeue in order
+  std::vector<Ptr<QueueItem> > items;
+  for (uint32_t i = 0; i < 4; ++i)
+    {
+      items.push_back (Create<QueueItem> (Create<Packet> (10)));
+    }
+  uint32_t room = 5 - queue->GetNPackets ();
+  NS_TEST_EXPECT_MSG_EQ (queue->EnqueueBatch (items), room, "Batch should fill the queue");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetTotalDroppedPackets (), 4 - room, "Batch should drop the rest");
+  items.clear ();
+  NS_TEST_EXPECT_MSG_EQ (queue->DequeueBatch (items, 100), 5, "Batch should drain the queue");
+  NS_TEST_EXPECT_MSG_EQ (items.front ()->GetPacket ()->GetUid (), packets[next]->GetUid (), "Out of order");
+  NS_TEST_EXPECT_MSG_EQ (queue->IsEmpty (), true, "Queue should be empty");
+  NS_TEST_EXPECT_MSG_EQ (queue->GetNBytes (), 0, "Queue should hold no bytes");
+
+  // In byte mode the ring grows as needed, keeping the order
+  Ptr<DropTailQueue> bytes = CreateObject<DropTailQueue> ();
+  bytes->SetMode (Queue::QUEUE_MODE_BYTES);
+  bytes->SetMaxBytes (1000);
+  for (uint32_t i = 0; i < 10; ++i)
+    {
+      bytes->Enqueue (Create<QueueItem> (packets[i]));
+      if (i == 2)
+        {
+          bytes->Dequeue ();
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (bytes->GetNPackets (), 9, "Unexpected number of packets");
+  NS_TEST_EXPECT_MSG_EQ (bytes->GetCapacity (), 16, "The ring should have doubled up to 16");
+  for (uint32_t i = 1; i < 10; ++i)
+    {
+      NS_TEST_EXPECT_MSG_EQ (bytes->Dequeue ()->GetPacket ()->GetUid (), packets[i]->GetUid (), "Out of order");
+    }
+
+  // A batch skips the items which exceed the byte limit, and counts the others
+  bytes->TraceConnectWithoutContext ("Enqueue", MakeCallback (&DropTailQueueRingTestCase::Enqueued, this));
+  items.clear ();
+  items.push_back (Create<QueueItem> (Create<Packet> (400)));
+  items.push_back (Create<QueueItem> (Create<Packet> (500)));
+  items.push_back (Create<QueueItem> (Create<Packet> (200)));
+  items.push_back (Create<QueueItem> (Create<Packet> (100)));
+  NS_TEST_EXPECT_MSG_EQ (bytes->EnqueueBatch (items), 3, "The third item should be dropped");
+  NS_TEST_EXPECT_MSG_EQ (m_enqueued, 3, "The Enqueue trace should fire per item");
+  NS_TEST_EXPECT_MSG_EQ (bytes->GetNBytes (), 1000, "Unexpected number of bytes");
+  NS_TEST_EXPECT_MSG_EQ (bytes->GetNPackets (), 3, "Unexpected number of packets");
+  items.clear ();
+  NS_TEST_EXPECT_MSG_EQ (bytes->DequeueBatch (items, 2), 2, "Batch should dequeue two items");
+  NS_TEST_EXPECT_MSG_EQ (items.back ()->GetPacketSize (), 500, "Out of order");
+  NS_TEST_EXPECT_MSG_EQ (bytes->GetNBytes (), 100, "Unexpected number of bytes");
+  NS_TEST_EXPECT_MSG_EQ (bytes->Peek ()->GetPacketSize (), 100, "Out of order");
+}
+
 static class DropTailQueueTestSuite : public TestSuite
 {
 public:
@@ -84,5 +184,6 @@ public:
     : TestSuite ("drop-tail-queue", UNIT)
   {
     AddTestCase (new DropTailQueueTestCase (), TestCase::QUICK);
+    AddTestCase (new DropTailQueueRingTestCase (), TestCase::QUICK);
   }
 } g_dropTailQueueTestSuite;
@@ -823,6 +823,98 @@ PacketMetadataTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (msg, std::string ("hello world"), "Could not find original data in received packet");
 }
 //-----------------------------------------------------------------------------
+/**
+ * Run the same sequence of operations, without looking at the metadata in
+ * between, with lazy recording enabled and disabled, and compare the items.
+ */
+class PacketMetadataLazyTest : public TestCase {
+public:
+  PacketMetadataLazyTest ();
+  virtual void DoRun (void);
+private:
+  /**
+   * \returns a description of the items of a packet
+   * \param p the packet
+   */
+  std::string Describe (Ptr<const Packet> p);
+  /**
+   * \returns the description of the packets built by the sequence
+   * \param lazy whether metadata recording is lazy
+   */
+  std::string RunSequence (bool lazy);
+};
+
+PacketMetadataLazyTest::PacketMetadataLazyTest ()
+  : TestCase ("Lazy packet metadata")
+{
+}
+
+std::string
+PacketMetadataLazyTest::Describe (Ptr<const Packet> p)
+{
+  std::ostringstream oss;
+  PacketMetadata::ItemIterator k = p->BeginItem ();
+  while (k.HasNext ())
+    {
+      struct PacketMetadata::Item item = k.Next ();
+      oss << item.type << ":";
+      if (item.type != PacketMetadata::Item::PAYLOAD)
+        {
+          // the type of the payload items is not set
+          oss << item.tid.GetName ();
+        }
+      oss << ":" << item.isFragment
+          << ":" << item.currentSize << ":" << item.currentTrimedFromStart
+          << ":" << item.currentTrimedFromEnd << " ";
+    }
+  oss << "(" << p->GetSerializedSize () << ")" << std::endl;
+  return oss.str ();
+}
+
+std::string
+PacketMetadataLazyTest::RunSequence (bool lazy)
+{
+  PacketMetadata::SetLazy (lazy);
+  Ptr<Packet> p = Create<Packet> (100);
+  ADD_HEADER (p, 1);
+  ADD_HEADER (p, 2);
+  ADD_HEADER (p, 3);
+  REM_HEADER (p, 3);
+  ADD_TRAILER (p, 4);
+  ADD_TRAILER (p, 5);
+  REM_TRAILER (p, 5);
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      ADD_HEADER (p, 6);
+      ADD_HEADER (p, 7);
+      REM_HEADER (p, 7);
+    }
+  Ptr<Packet> p1 = p->Copy ();
+  ADD_HEADER (p1, 8);
+  ADD_TRAILER (p, 9);
+  REM_HEADER (p, 6);
+  p->RemoveAtStart (7);
+  p1->RemoveAtEnd (3);
+  Ptr<Packet> p2 = p1->CreateFragment (5, 50);
+  ADD_HEADER (p2, 10);
+  p->AddAtEnd (p2);
+  Ptr<Packet> p3 = p->Copy ();
+  p3->RemoveAtEnd (20);
+  ADD_TRAILER (p3, 2);
+  std::string result = Describe (p) + Describe (p1) + Describe (p2) + Describe (p3);
+  PacketMetadata::SetLazy (true);
+  return result;
+}
+
+void
+PacketMetadataLazyTest::DoRun (void)
+{
+  PacketMetadata::Enable ();
+  std::string eager = RunSequence (false);
+  std::string lazy = RunSequence (true);
+  NS_TEST_EXPECT_MSG_EQ (lazy, eager, "Lazy metadata differs from eager metadata");
+}
+//-----------------------------------------------------------------------------
 class PacketMetadataTestSuite : public TestSuite
 {
 public:
@@ -833,6 +925,7 @@ PacketMetadataTestSuite::PacketMetadataTestSuite ()
   : TestSuite ("packet-metadata", UNIT)
 {
   AddTestCase (new PacketMetadataTest, TestCase::QUICK);
+  AddTestCase (new PacketMetadataLazyTest, TestCase::QUICK);
 }
 
 PacketMetadataTestSuite g_packetMetadataTest;
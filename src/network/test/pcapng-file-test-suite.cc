@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/packet.h"
+#include "ns3/pcapng-file.h"
+#include "ns3/pcapng-file-wrapper.h"
+#include "ns3/trace-helper.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("pcapng-file-test-suite");
+
+/**
+ * \returns the whole content of a file
+ * \param filename the file to read
+ */
+static std::vector<uint8_t>
+ReadWholeFile (std::string filename)
+{
+  std::ifstream in (filename.c_str (), std::ios::in | std::ios::binary);
+  return std::vector<uint8_t> ((std::istreambuf_iterator<char> (in)),
+                               std::istreambuf_iterator<char> ());
+}
+
+/**
+ * \returns the 32 bit word at a given offset of a buffer
+ * \param buf the buffer
+ * \param offset the offset
+ */
+static uint32_t
+Read32 (std::vector<uint8_t> const &buf, uint32_t offset)
+{
+  uint32_t v;
+  std::memcpy (&v, &buf[offset], 4);
+  return v;
+}
+
+// ===========================================================================
+// Write records on two interfaces through buffers small enough to exercise
+// the writer thread, and walk the resulting blocks.
+// ===========================================================================
+class PcapNgBlockLayoutTestCase : public TestCase
+{
+public:
+  PcapNgBlockLayoutTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapNgBlockLayoutTestCase::PcapNgBlockLayoutTestCase ()
+  : TestCase ("Check the block layout written by PcapNgFile")
+{
+}
+
+void
+PcapNgBlockLayoutTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("layout.pcapng");
+  const uint32_t nPackets = 500;
+
+  PcapNgFile f;
+  f.Open (filename, false, 1024, 2);
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Open (" << filename << ") returns error");
+
+  uint32_t if0 = f.AddInterface (1, 65535, "n0-dev0");
+  uint32_t if1 = f.AddInterface (9, 10, "");
+  NS_TEST_ASSERT_MSG_EQ (if0, 0, "Unexpected first interface id");
+  NS_TEST_ASSERT_MSG_EQ (if1, 1, "Unexpected second interface id");
+
+  uint8_t data[37];
+  for (uint32_t i = 0; i < sizeof (data); ++i)
+    {
+      data[i] = i;
+    }
+  for (uint32_t i = 0; i < nPackets; ++i)
+    {
+      f.Write (i % 2, 5000000000ULL + i, data, sizeof (data));
+    }
+  f.Close ();
+  NS_TEST_ASSERT_MSG_EQ (f.Fail (), false, "Writing " << filename << " failed");
+
+  std::vector<uint8_t> buf = ReadWholeFile (filename);
+  NS_TEST_ASSERT_MSG_GT (buf.size (), 28, "File too short");
+
+  uint32_t offset = 0;
+  NS_TEST_ASSERT_MSG_EQ (Read32 (buf, 0), 0x0a0d0d0a, "Missing section header block");
+  NS_TEST_ASSERT_MSG_EQ (Read32 (buf, 8), 0x1a2b3c4d, "Bad byte order magic");
+  offset += Read32 (buf, 4);
+
+  uint32_t nIdb = 0;
+  uint32_t nEpb = 0;
+  while (offset < buf.size ())
+    {
+      uint32_t type = Read32 (buf, offset);
+      uint32_t len = Read32 (buf, offset + 4);
+      NS_TEST_ASSERT_MSG_EQ (len % 4, 0, "Block length not a multiple of four");
+      NS_TEST_ASSERT_MSG_EQ (Read32 (buf, offset + len - 4), len, "Trailing block length mismatch");
+      if (type == 1)
+        {
+          ++nIdb;
+        }
+      else
+        {
+          NS_TEST_ASSERT_MSG_EQ (type, 6, "Unexpected block type");
+          uint32_t interfaceId = Read32 (buf, offset + 8);
+          uint64_t ts = (static_cast<uint64_t> (Read32 (buf, offset + 12)) << 32) | Read32 (buf, offset + 16);
+          uint32_t inclLen = Read32 (buf, offset + 20);
+          uint32_t origLen = Read32 (buf, offset + 24);
+          NS_TEST_ASSERT_MSG_EQ (interfaceId, nEpb % 2, "Packets interleaved in the wrong order");
+          NS_TEST_ASSERT_MSG_EQ (ts, 5000000000ULL + nEpb, "Bad timestamp");
+          NS_TEST_ASSERT_MSG_EQ (origLen, sizeof (data), "Bad original length");
+          uint32_t expectedLen = (interfaceId == 0) ? sizeof (data) : 10;
+          NS_TEST_ASSERT_MSG_EQ (inclLen, expectedLen, "Snap length not applied");
+          NS_TEST_ASSERT_MSG_EQ (std::memcmp (&buf[offset + 28], data, inclLen), 0, "Packet data mismatch");
+          ++nEpb;
+        }
+      offset += len;
+    }
+  NS_TEST_ASSERT_MSG_EQ (offset, buf.size (), "Trailing garbage at end of file");
+  NS_TEST_ASSERT_MSG_EQ (nIdb, 2, "Wrong number of interface description blocks");
+  NS_TEST_ASSERT_MSG_EQ (nEpb, nPackets, "Wrong number of enhanced packet blocks");
+
+  std::remove (filename.c_str ());
+}
+
+// ===========================================================================
+// PcapHelper::CreateFile must hand out wrappers which write into the shared
+// pcapng file while a redirect is installed.
+// ===========================================================================
+class PcapNgRedirectTestCase : public TestCase
+{
+public:
+  PcapNgRedirectTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PcapNgRedirectTestCase::PcapNgRedirectTestCase ()
+  : TestCase ("Check that PcapHelper redirects pcap files into a pcapng file")
+{
+}
+
+void
+PcapNgRedirectTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("redirect.pcapng");
+  std::string unused = CreateTempDirFilename ("redirect-0-0.pcap");
+
+  PcapHelper helper;
+  Ptr<PcapNgFileWrapper> ngFile = helper.CreateNgFile (filename);
+  PcapHelper::SetPcapNgRedirect (ngFile);
+  Ptr<PcapFileWrapper> a = helper.CreateFile (unused, std::ios::out, PcapHelper::DLT_PPP);
+  Ptr<PcapFileWrapper> b = helper.CreateFile (unused, std::ios::out, PcapHelper::DLT_EN10MB);
+  PcapHelper::SetPcapNgRedirect (0);
+
+  NS_TEST_ASSERT_MSG_EQ (a->Fail (), false, "Redirected file reports an error");
+  a->Write (Seconds (1), Create<Packet> (100));
+  b->Write (Seconds (2), Create<Packet> (200));
+  ngFile->Close ();
+
+  std::ifstream check (unused.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (check.good (), false, "A per-device pcap file was created");
+
+  std::vector<uint8_t> buf = ReadWholeFile (filename);
+  uint32_t nameLen = unused.size () - 5;        // interface named after the file, less ".pcap"
+  uint32_t expected = 28;                       // section header
+  expected += 2 * (20 + 4 + ((nameLen + 3) & ~3U) + 8 + 4);
+  expected += (32 + 100) + (32 + 200);          // two packets
+  NS_TEST_ASSERT_MSG_EQ (buf.size (), expected, "Unexpected pcapng file size");
+
+  std::remove (filename.c_str ());
+}
+
+class PcapNgFileTestSuite : public TestSuite
+{
+public:
+  PcapNgFileTestSuite ();
+};
+
+PcapNgFileTestSuite::PcapNgFileTestSuite ()
+  : TestSuite ("pcapng-file", UNIT)
+{
+  AddTestCase (new PcapNgBlockLayoutTestCase, TestCase::QUICK);
+  AddTestCase (new PcapNgRedirectTestCase, TestCase::QUICK);
+}
+
+static PcapNgFileTestSuite pcapNgFileTestSuite;
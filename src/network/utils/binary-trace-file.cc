@@ -0,0 +1,501 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/chunk.h"
+#include "ns3/buffer.h"
+#include "ns3/type-id.h"
+#include "ns3/network-config.h"
+#include "binary-trace-file.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("BinaryTraceFile");
+
+static const uint8_t BINARY_TRACE_MAGIC[8] = { 'n', 's', '3', 'b', 't', 'r', 'c', 0 }; /**< File magic */
+static const uint32_t BINARY_TRACE_VERSION = 1;        /**< Format version */
+static const uint64_t MAP_CHUNK = 16 << 20;            /**< Bytes mapped at a time */
+
+static const uint16_t ITEM_FRAGMENT = 1;               /**< Item is a fragment */
+static const uint16_t ITEM_TRAILER = 2;                /**< Item is a trailer */
+static const uint16_t ITEM_BYTES = 4;                  /**< Item bytes are stored in the record */
+
+static const uint32_t RECORD_TRUNCATED = 1;            /**< More than MAX_ITEMS items */
+
+BinaryTraceFile::BinaryTraceFile ()
+  : m_file (0),
+    m_recordSize (0),
+    m_nRecords (0),
+    m_writeOffset (0),
+    m_map (0),
+    m_mapOffset (0),
+    m_mapSize (0)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+BinaryTraceFile::~BinaryTraceFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+BinaryTraceFile::Open (std::string const &filename, uint32_t summaryBytes)
+{
+  NS_LOG_FUNCTION (this << filename << summaryBytes);
+  NS_ASSERT (m_file == 0);
+
+  m_file = std::fopen (filename.c_str (), "w+b");
+  if (m_file == 0)
+    {
+      return false;
+    }
+  m_filename = filename;
+
+  // The number of header bytes used in a record is kept in 16 bits.
+  summaryBytes = std::min<uint32_t> (summaryBytes, 0xffff);
+
+  //
+  // Keep every record 8-byte aligned so that the fixed part can be filled
+  // in place in the mapping.
+  //
+  m_recordSize = (sizeof (Record) + summaryBytes + 7) & ~7U;
+  m_nRecords = 0;
+  m_writeOffset = sizeof (FileHeader);
+  m_scratch.resize (m_recordSize);
+  m_contexts.clear ();
+  m_contextNames.clear ();
+  m_typeNames.clear ();
+  m_lastContext.clear ();
+  m_lastInfo = LookupContext ("");
+
+  FileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.m_magic, BINARY_TRACE_MAGIC, sizeof (header.m_magic));
+  header.m_version = BINARY_TRACE_VERSION;
+  header.m_recordSize = m_recordSize;
+  WriteAt (0, &header, sizeof (header));
+  return true;
+}
+
+void
+BinaryTraceFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_file == 0)
+    {
+      return;
+    }
+  Unmap ();
+#ifdef HAVE_SYS_MMAN_H
+  // The mappings grow the file by whole chunks
+  std::fflush (m_file);
+  if (ftruncate (fileno (m_file), m_writeOffset) != 0)
+    {
+      NS_LOG_WARN ("Unable to truncate " << m_filename);
+    }
+#endif
+
+  //
+  // String table: the contexts, by id, then the header types, by uid.
+  //
+  std::vector<uint8_t> table;
+  uint32_t n = m_contextNames.size ();
+  table.insert (table.end (), reinterpret_cast<uint8_t *> (&n), reinterpret_cast<uint8_t *> (&n) + 4);
+  for (std::vector<std::string>::const_iterator i = m_contextNames.begin (); i != m_contextNames.end (); ++i)
+    {
+      uint32_t len = i->size ();
+      table.insert (table.end (), reinterpret_cast<uint8_t *> (&len), reinterpret_cast<uint8_t *> (&len) + 4);
+      table.insert (table.end (), i->begin (), i->end ());
+    }
+  n = 0;
+  for (uint32_t uid = 0; uid < m_typeNames.size (); ++uid)
+    {
+      n += m_typeNames[uid].empty () ? 0 : 1;
+    }
+  table.insert (table.end (), reinterpret_cast<uint8_t *> (&n), reinterpret_cast<uint8_t *> (&n) + 4);
+  for (uint32_t uid = 0; uid < m_typeNames.size (); ++uid)
+    {
+      if (m_typeNames[uid].empty ())
+        {
+          continue;
+        }
+      uint32_t len = m_typeNames[uid].size ();
+      table.insert (table.end (), reinterpret_cast<uint8_t *> (&uid), reinterpret_cast<uint8_t *> (&uid) + 4);
+      table.insert (table.end (), reinterpret_cast<uint8_t *> (&len), reinterpret_cast<uint8_t *> (&len) + 4);
+      table.insert (table.end (), m_typeNames[uid].begin (), m_typeNames[uid].end ());
+    }
+  if (!table.empty ())
+    {
+      WriteAt (m_writeOffset, &table[0], table.size ());
+    }
+
+  FileHeader header;
+  std::memset (&header, 0, sizeof (header));
+  std::memcpy (header.m_magic, BINARY_TRACE_MAGIC, sizeof (header.m_magic));
+  header.m_version = BINARY_TRACE_VERSION;
+  header.m_recordSize = m_recordSize;
+  header.m_nRecords = m_nRecords;
+  header.m_tableOffset = m_writeOffset;
+  WriteAt (0, &header, sizeof (header));
+
+  std::fclose (m_file);
+  m_file = 0;
+}
+
+std::string
+BinaryTraceFile::GetFilename (void) const
+{
+  return m_filename;
+}
+
+uint64_t
+BinaryTraceFile::GetNRecords (void) const
+{
+  return m_nRecords;
+}
+
+void
+BinaryTraceFile::WriteAt (uint64_t offset, void const *data, uint32_t size)
+{
+  if (std::fseek (m_file, offset, SEEK_SET) != 0
+      || std::fwrite (data, 1, size, m_file) != size)
+    {
+      NS_LOG_WARN ("Unable to write to " << m_filename);
+    }
+}
+
+void
+BinaryTraceFile::Map (uint64_t offset, uint32_t size)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (m_map != 0 && offset >= m_mapOffset && offset + size <= m_mapOffset + m_mapSize)
+    {
+      return;
+    }
+  Unmap ();
+  uint64_t page = sysconf (_SC_PAGESIZE);
+  uint64_t start = offset - (offset % page);
+  uint64_t length = MAP_CHUNK;
+  while (start + length < offset + size)
+    {
+      length += MAP_CHUNK;
+    }
+  std::fflush (m_file);
+  if (ftruncate (fileno (m_file), start + length) != 0)
+    {
+      NS_LOG_WARN ("Unable to grow " << m_filename);
+      return;
+    }
+  void *map = mmap (0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fileno (m_file), start);
+  if (map == MAP_FAILED)
+    {
+      NS_LOG_WARN ("Unable to map " << m_filename << ", falling back to write ()");
+      return;
+    }
+  m_map = static_cast<uint8_t *> (map);
+  m_mapOffset = start;
+  m_mapSize = length;
+#endif
+}
+
+void
+BinaryTraceFile::Unmap (void)
+{
+#ifdef HAVE_SYS_MMAN_H
+  if (m_map != 0)
+    {
+      munmap (m_map, m_mapSize);
+      m_map = 0;
+      m_mapOffset = 0;
+      m_mapSize = 0;
+    }
+#endif
+}
+
+uint8_t *
+BinaryTraceFile::NextRecord (void)
+{
+  Map (m_writeOffset, m_recordSize);
+  if (m_map != 0)
+    {
+      return m_map + (m_writeOffset - m_mapOffset);
+    }
+  return &m_scratch[0];
+}
+
+void
+BinaryTraceFile::CommitRecord (void)
+{
+  if (m_map == 0)
+    {
+      WriteAt (m_writeOffset, &m_scratch[0], m_recordSize);
+    }
+  m_writeOffset += m_recordSize;
+  ++m_nRecords;
+}
+
+BinaryTraceFile::ContextInfo const &
+BinaryTraceFile::LookupContext (std::string const &context)
+{
+  std::map<std::string, ContextInfo>::iterator i = m_contexts.find (context);
+  if (i != m_contexts.end ())
+    {
+      return i->second;
+    }
+
+  ContextInfo info;
+  info.m_id = m_contextNames.size ();
+  info.m_node = NO_ID;
+  info.m_device = NO_ID;
+  const char *nodeList = "/NodeList/";
+  const char *deviceList = "/DeviceList/";
+  if (context.compare (0, std::strlen (nodeList), nodeList) == 0)
+    {
+      char *end;
+      const char *s = context.c_str () + std::strlen (nodeList);
+      info.m_node = std::strtoul (s, &end, 10);
+      if (std::strncmp (end, deviceList, std::strlen (deviceList)) == 0)
+        {
+          info.m_device = std::strtoul (end + std::strlen (deviceList), 0, 10);
+        }
+    }
+  m_contextNames.push_back (context);
+  return m_contexts.insert (std::make_pair (context, info)).first->second;
+}
+
+void
+BinaryTraceFile::Write (Time t, char event, std::string const &context, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << t << event << context << p);
+  if (m_file == 0)
+    {
+      return;
+    }
+
+  if (context != m_lastContext)
+    {
+      m_lastInfo = LookupContext (context);
+      m_lastContext = context;
+    }
+
+  uint8_t *dst = NextRecord ();
+  Record *r = reinterpret_cast<Record *> (dst);
+  std::memset (r, 0, sizeof (Record));
+  r->m_timeNs = t.GetNanoSeconds ();
+  r->m_packetUid = p->GetUid ();
+  r->m_node = m_lastInfo.m_node;
+  r->m_device = m_lastInfo.m_device;
+  r->m_context = m_lastInfo.m_id;
+  r->m_size = p->GetSize ();
+  r->m_event = event;
+
+  uint8_t *bytes = dst + sizeof (Record);
+  uint32_t room = m_recordSize - sizeof (Record);
+  uint32_t used = 0;
+  PacketMetadata::ItemIterator i = p->BeginItem ();
+  while (i.HasNext ())
+    {
+      if (r->m_nItems == MAX_ITEMS)
+        {
+          r->m_flags |= RECORD_TRUNCATED;
+          break;
+        }
+      PacketMetadata::Item item = i.Next ();
+      ItemSummary &s = r->m_items[r->m_nItems++];
+      s.m_size = item.currentSize;
+      s.m_start = item.currentTrimedFromStart;
+      if (item.isFragment)
+        {
+          s.m_flags |= ITEM_FRAGMENT;
+        }
+      if (item.type == PacketMetadata::Item::PAYLOAD)
+        {
+          continue;
+        }
+      uint16_t uid = item.tid.GetUid ();
+      s.m_typeUid = uid;
+      if (uid >= m_typeNames.size ())
+        {
+          m_typeNames.resize (uid + 1);
+        }
+      if (m_typeNames[uid].empty ())
+        {
+          m_typeNames[uid] = item.tid.GetName ();
+        }
+      if (item.type == PacketMetadata::Item::TRAILER)
+        {
+          s.m_flags |= ITEM_TRAILER;
+        }
+      if (!item.isFragment && used + item.currentSize <= room)
+        {
+          Buffer::Iterator current = item.current;
+          if (item.type == PacketMetadata::Item::TRAILER)
+            {
+              current.Prev (item.currentSize);
+            }
+          current.Read (bytes + used, item.currentSize);
+          used += item.currentSize;
+          s.m_flags |= ITEM_BYTES;
+        }
+    }
+  r->m_bytesUsed = used;
+  CommitRecord ();
+}
+
+bool
+BinaryTraceFile::ConvertToAscii (std::string const &filename, std::ostream &os)
+{
+  NS_LOG_FUNCTION (filename);
+  std::ifstream in (filename.c_str (), std::ios::in | std::ios::binary);
+  FileHeader header;
+  in.read (reinterpret_cast<char *> (&header), sizeof (header));
+  if (in.fail ()
+      || std::memcmp (header.m_magic, BINARY_TRACE_MAGIC, sizeof (header.m_magic)) != 0
+      || header.m_version != BINARY_TRACE_VERSION
+      || header.m_recordSize < sizeof (Record)
+      || header.m_tableOffset == 0)
+    {
+      NS_LOG_WARN (filename << " is not a complete binary trace file");
+      return false;
+    }
+
+  //
+  // Read the string table and resolve the header types in this program.
+  //
+  in.seekg (header.m_tableOffset, std::ios::beg);
+  uint32_t n = 0;
+  in.read (reinterpret_cast<char *> (&n), 4);
+  std::vector<std::string> contexts;
+  for (uint32_t i = 0; i < n && in.good (); ++i)
+    {
+      uint32_t len = 0;
+      in.read (reinterpret_cast<char *> (&len), 4);
+      std::string s (len, '\0');
+      in.read (&s[0], len);
+      contexts.push_back (s);
+    }
+  n = 0;
+  in.read (reinterpret_cast<char *> (&n), 4);
+  std::map<uint16_t, std::string> names;
+  std::map<uint16_t, TypeId> types;
+  for (uint32_t i = 0; i < n && in.good (); ++i)
+    {
+      uint32_t uid = 0;
+      uint32_t len = 0;
+      in.read (reinterpret_cast<char *> (&uid), 4);
+      in.read (reinterpret_cast<char *> (&len), 4);
+      std::string s (len, '\0');
+      in.read (&s[0], len);
+      names[uid] = s;
+      TypeId tid;
+      if (TypeId::LookupByNameFailSafe (s, &tid) && tid.HasConstructor ())
+        {
+          types[uid] = tid;
+        }
+    }
+  if (in.fail ())
+    {
+      return false;
+    }
+
+  in.seekg (sizeof (FileHeader), std::ios::beg);
+  std::vector<uint8_t> buf (header.m_recordSize);
+  for (uint64_t k = 0; k < header.m_nRecords; ++k)
+    {
+      in.read (reinterpret_cast<char *> (&buf[0]), header.m_recordSize);
+      if (in.fail ())
+        {
+          return false;
+        }
+      Record r;
+      std::memcpy (&r, &buf[0], sizeof (Record));
+      uint8_t const *bytes = &buf[sizeof (Record)];
+
+      os << r.m_event << " " << NanoSeconds (r.m_timeNs).GetSeconds () << " ";
+      if (r.m_context < contexts.size () && !contexts[r.m_context].empty ())
+        {
+          os << contexts[r.m_context] << " ";
+        }
+
+      //
+      // Same layout as Packet::Print
+      //
+      uint32_t offset = 0;
+      for (uint32_t j = 0; j < r.m_nItems; ++j)
+        {
+          ItemSummary const &s = r.m_items[j];
+          std::string name = s.m_typeUid == 0 ? std::string ("Payload") : names[s.m_typeUid];
+          if (s.m_flags & ITEM_FRAGMENT)
+            {
+              os << name << " Fragment [" << s.m_start << ":" << (s.m_start + s.m_size) << "]";
+            }
+          else if (s.m_typeUid == 0)
+            {
+              os << "Payload (size=" << s.m_size << ")";
+            }
+          else
+            {
+              os << name << " (";
+              std::map<uint16_t, TypeId>::const_iterator tid = types.find (s.m_typeUid);
+              if ((s.m_flags & ITEM_BYTES) && tid != types.end ())
+                {
+                  Buffer chunkBuffer;
+                  chunkBuffer.AddAtStart (s.m_size);
+                  chunkBuffer.Begin ().Write (bytes + offset, s.m_size);
+                  ObjectBase *instance = tid->second.GetConstructor () ();
+                  Chunk *chunk = dynamic_cast<Chunk *> (instance);
+                  if (chunk != 0)
+                    {
+                      chunk->Deserialize ((s.m_flags & ITEM_TRAILER) ? chunkBuffer.End () : chunkBuffer.Begin ());
+                      chunk->Print (os);
+                    }
+                  delete instance;
+                }
+              os << ")";
+            }
+          if (s.m_flags & ITEM_BYTES)
+            {
+              offset += s.m_size;
+            }
+          if (j + 1 < r.m_nItems)
+            {
+              os << " ";
+            }
+        }
+      if (r.m_flags & RECORD_TRUNCATED)
+        {
+          os << " ...";
+        }
+      os << std::endl;
+    }
+  return true;
+}
+
+} // namespace ns3
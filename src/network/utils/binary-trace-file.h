@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef BINARY_TRACE_FILE_H
+#define BINARY_TRACE_FILE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+#include <cstdio>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/nstime.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \brief A compact, binary replacement for the ASCII packet traces
+ *
+ * The default ASCII trace sinks format every packet with Packet::Print,
+ * which deserializes and pretty-prints each header.  This class instead
+ * appends one fixed-width record per event to a memory-mapped file:
+ * the time, node and device ids, the event type ('+', '-', 'd' or 'r'),
+ * the packet uid and size, and a header summary made of the type and
+ * size of up to MAX_ITEMS headers, trailers and payload chunks, followed
+ * by the raw serialized bytes of those headers and trailers.
+ *
+ * Header types and trace contexts are stored once, in a string table
+ * written when the file is closed.  ConvertToAscii later rebuilds the
+ * headers from their bytes and prints the lines the ASCII sinks would
+ * have written, so the cost of formatting is only paid for the traces
+ * somebody actually reads.  The lines only differ where a record could
+ * not hold the whole packet: the headers whose bytes did not fit in the
+ * summary print their type without their fields, and the lines of
+ * packets with more than MAX_ITEMS chunks end with " ..." instead of the
+ * remaining chunks.
+ *
+ * The records are written through a memory mapping of the file where
+ * sys/mman.h is available, and with plain writes otherwise.
+ *
+ * The header summary is only available if packet metadata is enabled
+ * (Packet::EnablePrinting); otherwise records carry the payload size only,
+ * just like Packet::Print would.
+ */
+class BinaryTraceFile : public SimpleRefCount<BinaryTraceFile>
+{
+public:
+  static const uint32_t MAX_ITEMS = 6;                 /**< Max number of chunks described per record */
+  static const uint32_t SUMMARY_BYTES_DEFAULT = 80;    /**< Default number of header bytes kept per record */
+  static const uint32_t NO_ID = 0xffffffff;            /**< Node or device id which is not known */
+
+  BinaryTraceFile ();
+  ~BinaryTraceFile ();
+
+  /**
+   * \brief Create a new binary trace file
+   *
+   * \param filename name of the file
+   * \param summaryBytes number of serialized header bytes kept per
+   * record, at most 65535.  Headers which do not fit are still described
+   * by type and size, but print without their fields.
+   * \returns false if the file could not be created
+   */
+  bool Open (std::string const &filename, uint32_t summaryBytes = SUMMARY_BYTES_DEFAULT);
+
+  /**
+   * \brief Write the string table and the final file header, and close
+   * the file.
+   */
+  void Close (void);
+
+  /**
+   * \returns the name the file was opened with
+   */
+  std::string GetFilename (void) const;
+
+  /**
+   * \returns the number of records written so far
+   */
+  uint64_t GetNRecords (void) const;
+
+  /**
+   * \brief Append one record
+   *
+   * \param t event time
+   * \param event event type, one of '+', '-', 'd' or 'r'
+   * \param context trace context, as passed to the ASCII sinks.  Node and
+   * device ids are parsed from "/NodeList/n/DeviceList/d" contexts.
+   * \param p the packet
+   */
+  void Write (Time t, char event, std::string const &context, Ptr<const Packet> p);
+
+  /**
+   * \brief Regenerate the ASCII trace from a binary trace file
+   *
+   * \param filename the binary trace file
+   * \param os where to print the ASCII lines
+   * \returns false if the file is not a valid binary trace file
+   */
+  static bool ConvertToAscii (std::string const &filename, std::ostream &os);
+
+private:
+  /**
+   * \brief Description of one header, trailer or payload chunk
+   */
+  struct ItemSummary
+  {
+    uint16_t m_typeUid;       //!< TypeId uid, 0 for payload
+    uint16_t m_flags;         //!< ITEM_* flags
+    uint32_t m_size;          //!< size of the chunk, or of the fragment
+    uint32_t m_start;         //!< bytes trimmed from the start of a fragment
+  };
+
+  /**
+   * \brief Fixed-width part of a record.  It is followed by the serialized
+   * header bytes, for a total of m_recordSize bytes.
+   */
+  struct Record
+  {
+    int64_t m_timeNs;         //!< event time, in nanoseconds
+    uint64_t m_packetUid;     //!< packet uid
+    uint32_t m_node;          //!< node id
+    uint32_t m_device;        //!< device index
+    uint32_t m_context;       //!< index in the context table
+    uint32_t m_size;          //!< packet size
+    uint8_t m_event;          //!< event type
+    uint8_t m_nItems;         //!< number of valid entries in m_items
+    uint16_t m_bytesUsed;     //!< number of header bytes following the record
+    uint32_t m_flags;         //!< RECORD_* flags
+    ItemSummary m_items[MAX_ITEMS]; //!< chunk descriptions
+  };
+
+  /**
+   * \brief Fixed file header.
+   */
+  struct FileHeader
+  {
+    uint8_t m_magic[8];       //!< BINARY_TRACE_MAGIC
+    uint32_t m_version;       //!< format version
+    uint32_t m_recordSize;    //!< size of one record, including header bytes
+    uint64_t m_nRecords;      //!< number of records
+    uint64_t m_tableOffset;   //!< file offset of the string table, 0 if not closed
+  };
+
+  /**
+   * \brief Context bookkeeping
+   */
+  struct ContextInfo
+  {
+    uint32_t m_id;            //!< index in the context table
+    uint32_t m_node;          //!< node id, or NO_ID
+    uint32_t m_device;        //!< device index, or NO_ID
+  };
+
+  /**
+   * \param context a trace context
+   * \returns the bookkeeping entry of the context, created on first use
+   */
+  ContextInfo const & LookupContext (std::string const &context);
+  /**
+   * \returns a pointer to m_recordSize writable bytes for the next record
+   */
+  uint8_t * NextRecord (void);
+  /**
+   * \brief Account for the record returned by NextRecord, and write it
+   * out if the file is not memory-mapped.
+   */
+  void CommitRecord (void);
+  /**
+   * \brief Make sure [offset, offset + size) of the file is mapped
+   * \param offset file offset
+   * \param size number of bytes
+   */
+  void Map (uint64_t offset, uint32_t size);
+  /**
+   * \brief Release the current mapping
+   */
+  void Unmap (void);
+  /**
+   * \brief Write bytes at a given file offset
+   * \param offset file offset
+   * \param data bytes to write
+   * \param size number of bytes
+   */
+  void WriteAt (uint64_t offset, void const *data, uint32_t size);
+
+  std::string m_filename;               //!< file name
+  std::FILE *m_file;                    //!< the file, 0 if closed
+  uint32_t m_recordSize;                //!< bytes per record
+  uint64_t m_nRecords;                  //!< records written so far
+  uint64_t m_writeOffset;               //!< offset of the next record
+  uint8_t *m_map;                       //!< current mapping, or 0
+  uint64_t m_mapOffset;                 //!< file offset of m_map
+  uint64_t m_mapSize;                   //!< size of m_map
+  std::vector<uint8_t> m_scratch;       //!< record staging area without mmap
+  std::map<std::string, ContextInfo> m_contexts; //!< known contexts
+  std::vector<std::string> m_contextNames;       //!< contexts, by id
+  std::vector<std::string> m_typeNames;          //!< header type names, by TypeId uid
+  std::string m_lastContext;            //!< context of the previous record
+  ContextInfo m_lastInfo;               //!< bookkeeping of m_lastContext
+};
+
+} // namespace ns3
+
+#endif /* BINARY_TRACE_FILE_H */
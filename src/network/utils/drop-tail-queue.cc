@@ -18,6 +18,7 @@
 
 #include "ns3/log.h"
 #include "drop-tail-queue.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -25,6 +26,9 @@ NS_LOG_COMPONENT_DEFINE ("DropTailQueue");
 
 NS_OBJECT_ENSURE_REGISTERED (DropTailQueue);
 
+/// Largest ring allocated up front in packet mode; beyond, the ring doubles as needed
+static const uint32_t MAX_PREALLOCATED = 1 << 16;
+
 TypeId DropTailQueue::GetTypeId (void)
 {
   static TypeId tid = TypeId ("ns3::DropTailQueue")
@@ -37,7 +41,9 @@ TypeId DropTailQueue::GetTypeId (void)
 
 DropTailQueue::DropTailQueue () :
   Queue (),
-  m_packets ()
+  m_mask (0),
+  m_head (0),
+  m_count (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -47,39 +53,142 @@ DropTailQueue::~DropTailQueue ()
   NS_LOG_FUNCTION (this);
 }
 
+void
+DropTailQueue::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ring.clear ();
+  m_mask = 0;
+  m_head = 0;
+  m_count = 0;
+  Queue::DoDispose ();
+}
+
+uint32_t
+DropTailQueue::GetCapacity (void) const
+{
+  return m_ring.size ();
+}
+
+void
+DropTailQueue::Grow (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  uint32_t size = m_ring.empty () ? 1 : m_ring.size ();
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  if (size == m_ring.size ())
+    {
+      return;
+    }
+
+  //
+  // Unroll the items so that the head is at index 0 of the new array.
+  //
+  std::vector<Ptr<QueueItem> > ring (size);
+  for (uint32_t i = 0; i < m_count; ++i)
+    {
+      ring[i] = m_ring[(m_head + i) & m_mask];
+    }
+  m_ring.swap (ring);
+  m_mask = size - 1;
+  m_head = 0;
+}
+
+void
+DropTailQueue::Reserve (uint32_t n)
+{
+  if (m_count + n > m_ring.size ())
+    {
+      //
+      // In packet mode, size the ring for the whole queue at once; the
+      // limit is only known here because it may be set after construction.
+      //
+      uint32_t capacity = m_count + n;
+      if (GetMode () == QUEUE_MODE_PACKETS)
+        {
+          capacity = std::max (capacity, std::min (GetMaxPackets (), MAX_PREALLOCATED));
+        }
+      Grow (capacity);
+    }
+}
+
 bool 
 DropTailQueue::DoEnqueue (Ptr<QueueItem> item)
 {
   NS_LOG_FUNCTION (this << item);
-  NS_ASSERT (m_packets.size () == GetNPackets ());
+  NS_ASSERT (m_count == GetNPackets ());
+
+  Reserve (1);
+  m_ring[(m_head + m_count) & m_mask] = item;
+  m_count++;
+
+  return true;
+}
+
+bool
+DropTailQueue::DoEnqueueBatch (std::vector<Ptr<QueueItem> > const &items, uint32_t first, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << first << n);
+  NS_ASSERT (m_count == GetNPackets ());
 
-  m_packets.push (item);
+  Reserve (n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      m_ring[(m_head + m_count + i) & m_mask] = items[first + i];
+    }
+  m_count += n;
 
   return true;
 }
 
+Ptr<QueueItem>
+DropTailQueue::PopHead (void)
+{
+  Ptr<QueueItem> item = m_ring[m_head];
+  m_ring[m_head] = 0;
+  m_head = (m_head + 1) & m_mask;
+  m_count--;
+  return item;
+}
+
 Ptr<QueueItem>
 DropTailQueue::DoDequeue (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_packets.size () == GetNPackets ());
+  NS_ASSERT (m_count == GetNPackets ());
 
-  Ptr<QueueItem> item = m_packets.front ();
-  m_packets.pop ();
+  Ptr<QueueItem> item = PopHead ();
 
   NS_LOG_LOGIC ("Popped " << item);
 
   return item;
 }
 
+bool
+DropTailQueue::DoDequeueBatch (std::vector<Ptr<QueueItem> > &items, uint32_t n)
+{
+  NS_LOG_FUNCTION (this << n);
+  NS_ASSERT (m_count == GetNPackets () && n <= m_count);
+
+  items.reserve (items.size () + n);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      items.push_back (PopHead ());
+    }
+
+  return true;
+}
+
 Ptr<QueueItem>
 DropTailQueue::DoRemove (void)
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_packets.size () == GetNPackets ());
+  NS_ASSERT (m_count == GetNPackets ());
 
-  Ptr<QueueItem> item = m_packets.front ();
-  m_packets.pop ();
+  Ptr<QueueItem> item = PopHead ();
 
   NS_LOG_LOGIC ("Removed " << item);
 
@@ -90,10 +199,9 @@ Ptr<const QueueItem>
 DropTailQueue::DoPeek (void) const
 {
   NS_LOG_FUNCTION (this);
-  NS_ASSERT (m_packets.size () == GetNPackets ());
+  NS_ASSERT (m_count == GetNPackets ());
 
-  return m_packets.front ();
+  return m_ring[m_head];
 }
 
 } // namespace ns3
-
@@ -19,7 +19,7 @@
 #ifndef DROPTAIL_H
 #define DROPTAIL_H
 
-#include <queue>
+#include <vector>
 #include "ns3/queue.h"
 
 namespace ns3 {
@@ -28,6 +28,12 @@ namespace ns3 {
  * \ingroup queue
  *
  * \brief A FIFO packet queue that drops tail-end packets on overflow
+ *
+ * The items are kept in a power-of-two sized circular array.  In
+ * QUEUE_MODE_PACKETS the array is sized once for MaxPackets (up to 65536
+ * items), so that enqueue and dequeue never allocate; otherwise it grows
+ * by doubling as needed and then stays at its largest size.  Batches of
+ * items are copied in and out of the array at once.
  */
 class DropTailQueue : public Queue
 {
@@ -46,13 +52,41 @@ public:
 
   virtual ~DropTailQueue();
 
+  /**
+   * \return the number of items the queue can currently hold without
+   * growing its storage
+   */
+  uint32_t GetCapacity (void) const;
+
 private:
   virtual bool DoEnqueue (Ptr<QueueItem> item);
   virtual Ptr<QueueItem> DoDequeue (void);
   virtual Ptr<QueueItem> DoRemove (void);
   virtual Ptr<const QueueItem> DoPeek (void) const;
+  virtual bool DoEnqueueBatch (std::vector<Ptr<QueueItem> > const &items, uint32_t first, uint32_t n);
+  virtual bool DoDequeueBatch (std::vector<Ptr<QueueItem> > &items, uint32_t n);
+  virtual void DoDispose (void);
+
+  /**
+   * Make room in the ring buffer for the given number of additional items
+   * \param n the number of items
+   */
+  void Reserve (uint32_t n);
+  /**
+   * Resize the ring buffer to at least the given number of items
+   * \param capacity the minimum capacity
+   */
+  void Grow (uint32_t capacity);
+  /**
+   * Pop the item at the head of the ring buffer
+   * \return the item
+   */
+  Ptr<QueueItem> PopHead (void);
 
-  std::queue<Ptr<QueueItem> > m_packets; //!< the items in the queue
+  std::vector<Ptr<QueueItem> > m_ring; //!< the items in the queue
+  uint32_t m_mask;                     //!< m_ring.size () - 1
+  uint32_t m_head;                     //!< index of the first item
+  uint32_t m_count;                    //!< number of items in the ring
 };
 
 } // namespace ns3
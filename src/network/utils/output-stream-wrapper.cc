@@ -46,19 +46,52 @@ OutputStreamWrapper::OutputStreamWrapper (std::ostream* os)
   NS_ABORT_MSG_UNLESS (m_ostream->good (), "Output stream is not vaild for writing.");
 }
 
+OutputStreamWrapper::OutputStreamWrapper (Ptr<BinaryTraceFile> file)
+  : m_ostream (0), m_destroyable (true), m_binary (file)
+{
+  NS_LOG_FUNCTION (this << file);
+}
+
 OutputStreamWrapper::~OutputStreamWrapper ()
 {
   NS_LOG_FUNCTION (this);
-  FatalImpl::UnregisterStream (m_ostream);
-  if (m_destroyable) delete m_ostream;
+  if (m_ostream != 0)
+    {
+      FatalImpl::UnregisterStream (m_ostream);
+      if (m_destroyable) delete m_ostream;
+    }
   m_ostream = 0;
+  if (m_binary != 0)
+    {
+      m_binary->Close ();
+    }
 }
 
 std::ostream *
 OutputStreamWrapper::GetStream (void)
 {
   NS_LOG_FUNCTION (this);
+  if (m_ostream == 0 && m_binary != 0)
+    {
+      //
+      // Custom sinks only know how to format text; give them a file of
+      // their own rather than mixing text into the binary records.
+      //
+      std::string filename = m_binary->GetFilename () + ".tr";
+      std::ofstream* os = new std::ofstream ();
+      os->open (filename.c_str (), std::ios::out);
+      m_ostream = os;
+      FatalImpl::RegisterStream (m_ostream);
+      NS_ABORT_MSG_UNLESS (os->is_open (), "OutputStreamWrapper::GetStream():  " <<
+                           "Unable to Open " << filename);
+    }
   return m_ostream;
 }
 
+Ptr<BinaryTraceFile>
+OutputStreamWrapper::GetBinaryFile (void) const
+{
+  return m_binary;
+}
+
 } // namespace ns3
@@ -23,6 +23,7 @@
 #include "ns3/object.h"
 #include "ns3/ptr.h"
 #include "ns3/simple-ref-count.h"
+#include "ns3/binary-trace-file.h"
 
 namespace ns3 {
 
@@ -81,6 +82,16 @@ public:
    * \param os output stream
    */
   OutputStreamWrapper (std::ostream* os);
+  /**
+   * Constructor
+   *
+   * The default AsciiTraceHelper sinks write their records to the binary
+   * file instead of formatting them.  Other sinks still get a text stream
+   * from GetStream, which is opened on first use next to the binary file.
+   *
+   * \param file binary trace file
+   */
+  OutputStreamWrapper (Ptr<BinaryTraceFile> file);
   ~OutputStreamWrapper ();
 
   /**
@@ -92,9 +103,16 @@ public:
    */
   std::ostream *GetStream (void);
 
+  /**
+   * \returns the binary trace file the default sinks should write to, or 0
+   * if this wrapper holds a plain output stream.
+   */
+  Ptr<BinaryTraceFile> GetBinaryFile (void) const;
+
 private:
   std::ostream *m_ostream; //!< The output stream
   bool m_destroyable; //!< Can be destroyed
+  Ptr<BinaryTraceFile> m_binary; //!< The binary trace file, if any
 };
 
 } // namespace ns3
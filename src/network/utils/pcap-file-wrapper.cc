@@ -52,6 +52,8 @@ PcapFileWrapper::GetTypeId (void)
 
 
 PcapFileWrapper::PcapFileWrapper ()
+  : m_ngFile (0),
+    m_ngInterface (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -66,6 +68,10 @@ bool
 PcapFileWrapper::Fail (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_ngFile != 0)
+    {
+      return m_ngFile->Fail ();
+    }
   return m_file.Fail ();
 }
 
@@ -86,6 +92,7 @@ void
 PcapFileWrapper::Close (void)
 {
   NS_LOG_FUNCTION (this);
+  m_ngFile = 0;
   m_file.Close ();
 }
 
@@ -119,6 +126,11 @@ void
 PcapFileWrapper::Write (Time t, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -139,6 +151,11 @@ void
 PcapFileWrapper::Write (Time t, const Header &header, Ptr<const Packet> p)
 {
   NS_LOG_FUNCTION (this << t << &header << p);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t, header, p);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -159,6 +176,11 @@ void
 PcapFileWrapper::Write (Time t, uint8_t const *buffer, uint32_t length)
 {
   NS_LOG_FUNCTION (this << t << &buffer << length);
+  if (m_ngFile != 0)
+    {
+      m_ngFile->Write (m_ngInterface, t, buffer, length);
+      return;
+    }
   if (m_file.IsNanoSecMode())
     {
       uint64_t current = t.GetNanoSeconds ();
@@ -207,6 +229,14 @@ PcapFileWrapper::Read (Time &t)
 
 }
 
+void
+PcapFileWrapper::SetPcapNgInterface (Ptr<PcapNgFileWrapper> file, uint32_t interfaceId)
+{
+  NS_LOG_FUNCTION (this << file << interfaceId);
+  m_ngFile = file;
+  m_ngInterface = interfaceId;
+}
+
 uint32_t
 PcapFileWrapper::GetMagic (void)
 {
@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/nstime.h"
 #include "pcap-file.h"
+#include "pcapng-file-wrapper.h"
 
 namespace ns3 {
 
@@ -150,6 +151,21 @@ public:
    */
   Ptr<Packet> Read (Time &t);
 
+  /**
+   * \brief Redirect the records written through this wrapper to one
+   * interface of a shared pcapng file.
+   *
+   * Once redirected, the Write methods no longer touch the underlying pcap
+   * file (which need not be opened at all) but append to the pcapng file.
+   * This lets device helpers that expect a PcapFileWrapper trace into a
+   * single multiplexed file without modification.
+   *
+   * \param file the shared pcapng file
+   * \param interfaceId the interface id returned by
+   * PcapNgFileWrapper::AddInterface
+   */
+  void SetPcapNgInterface (Ptr<PcapNgFileWrapper> file, uint32_t interfaceId);
+
 /**
    * \brief Returns the magic number of the pcap file as defined by the magic_number
    * field in the pcap global header.
@@ -224,6 +240,8 @@ private:
   PcapFile m_file; //!< Pcap file
   uint32_t m_snapLen; //!< max length of saved packets
   bool     m_nanosecMode; //!< Timestamps in nanosecond mode
+  Ptr<PcapNgFileWrapper> m_ngFile; //!< Shared pcapng file, if redirected
+  uint32_t m_ngInterface; //!< Interface id in the shared pcapng file
 };
 
 } // namespace ns3
@@ -0,0 +1,122 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_WRAPPER_H
+#define PCAPNG_FILE_WRAPPER_H
+
+#include <string>
+#include <limits>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/object.h"
+#include "ns3/nstime.h"
+#include "pcapng-file.h"
+
+namespace ns3 {
+
+/**
+ * A class that wraps a PcapNgFile as an ns3::Object, so that a single
+ * buffered pcapng file can be shared by the trace sinks of many devices.
+ * The buffering and compression parameters are exposed as attributes.
+ */
+class PcapNgFileWrapper : public Object
+{
+public:
+  /**
+   * \brief Get the type ID.
+   * \return the object TypeId
+   */
+  static TypeId GetTypeId (void);
+
+  PcapNgFileWrapper ();
+  ~PcapNgFileWrapper ();
+
+  /**
+   * \return true if opening or writing the underlying file failed.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Create a new pcapng file, using the BufferSize, MaxPendingBuffers and
+   * Compress attributes.
+   *
+   * \param filename String containing the name of the file.
+   */
+  void Open (std::string const &filename);
+
+  /**
+   * Flush all buffered records and close the underlying file.
+   */
+  void Close (void);
+
+  /**
+   * Wait until every record written so far has reached the file.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Describe a new interface in the file.
+   *
+   * \param dataLinkType data link type of the packets of this interface
+   * \param snapLen maximum number of bytes stored per packet.  If not
+   * provided, the "CaptureSize" attribute is used.
+   * \param name interface name (may be empty)
+   * \returns the interface id to pass to Write
+   */
+  uint32_t AddInterface (uint32_t dataLinkType,
+                         uint32_t snapLen = std::numeric_limits<uint32_t>::max (),
+                         std::string const &name = "");
+
+  /**
+   * \brief Write the next packet to file
+   *
+   * \param interfaceId interface id returned by AddInterface.
+   * \param t Packet timestamp as ns3::Time.
+   * \param p Packet to write to the file.
+   */
+  void Write (uint32_t interfaceId, Time t, Ptr<const Packet> p);
+
+  /**
+   * \brief Write the provided header along with the packet to the file.
+   *
+   * \param interfaceId interface id returned by AddInterface.
+   * \param t Packet timestamp as ns3::Time.
+   * \param header The Header to prepend to the packet.
+   * \param p Packet to write to the file.
+   */
+  void Write (uint32_t interfaceId, Time t, const Header &header, Ptr<const Packet> p);
+
+  /**
+   * \brief Write the provided data buffer to the file.
+   *
+   * \param interfaceId interface id returned by AddInterface.
+   * \param t Packet timestamp as ns3::Time.
+   * \param buffer The buffer to write.
+   * \param length The size of the buffer.
+   */
+  void Write (uint32_t interfaceId, Time t, uint8_t const *buffer, uint32_t length);
+
+private:
+  PcapNgFile m_file;      //!< The pcapng file
+  uint32_t m_snapLen;     //!< Default max length of saved packets
+  uint32_t m_bufferSize;  //!< Size of one write buffer
+  uint32_t m_maxPending;  //!< Max number of buffers queued for the writer
+  bool m_compress;        //!< Whether the file is gzip-compressed
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_WRAPPER_H */
@@ -0,0 +1,458 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cstring>
+#include "ns3/assert.h"
+#include "ns3/packet.h"
+#include "ns3/header.h"
+#include "ns3/buffer.h"
+#include "ns3/fatal-impl.h"
+#include "ns3/log.h"
+#include "ns3/network-config.h"
+#include "pcapng-file.h"
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+//
+// The block layout follows the PCAP Next Generation Dump File Format draft
+// (https://github.com/pcapng/pcapng).  Blocks are written in host byte order;
+// readers detect the byte order from the section header magic.
+//
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("PcapNgFile");
+
+const uint32_t SECTION_HEADER_BLOCK = 0x0a0d0d0a;   /**< Section Header Block type */
+const uint32_t INTERFACE_DESCRIPTION_BLOCK = 1;     /**< Interface Description Block type */
+const uint32_t ENHANCED_PACKET_BLOCK = 6;           /**< Enhanced Packet Block type */
+const uint32_t BYTE_ORDER_MAGIC = 0x1a2b3c4d;       /**< Section byte order magic */
+const uint16_t NG_VERSION_MAJOR = 1;                /**< Major version of the pcapng format */
+const uint16_t NG_VERSION_MINOR = 0;                /**< Minor version of the pcapng format */
+const uint16_t OPT_ENDOFOPT = 0;                    /**< End of options marker */
+const uint16_t OPT_IF_NAME = 2;                     /**< Interface name option */
+const uint16_t OPT_IF_TSRESOL = 9;                  /**< Interface timestamp resolution option */
+
+/**
+ * \param len a length in bytes
+ * \returns len rounded up to the next multiple of four
+ */
+static inline uint32_t
+Pad32 (uint32_t len)
+{
+  return (len + 3) & ~3U;
+}
+
+PcapNgFile::PcapNgFile ()
+  : m_file (),
+    m_gzFile (0),
+    m_open (false),
+    m_fail (false),
+    m_bufferSize (BUFFER_SIZE_DEFAULT),
+    m_maxPending (MAX_PENDING_DEFAULT)
+#ifdef HAVE_PTHREAD_H
+  , m_inFlight (0),
+    m_stop (false)
+#endif
+{
+  NS_LOG_FUNCTION (this);
+}
+
+PcapNgFile::~PcapNgFile ()
+{
+  NS_LOG_FUNCTION (this);
+  Close ();
+}
+
+bool
+PcapNgFile::Fail (void) const
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_PTHREAD_H
+  CriticalSection cs (m_mutex);
+#endif
+  return m_fail;
+}
+
+void
+PcapNgFile::Open (std::string const &filename, bool compress, uint32_t bufferSize, uint32_t maxPending)
+{
+  NS_LOG_FUNCTION (this << filename << compress << bufferSize << maxPending);
+  NS_ASSERT (!m_open);
+
+  m_bufferSize = bufferSize;
+  m_maxPending = maxPending > 0 ? maxPending : 1;
+  m_fail = false;
+  m_snapLen.clear ();
+
+  if (compress)
+    {
+#ifdef HAVE_ZLIB
+      m_gzFile = gzopen (filename.c_str (), "wb");
+      m_fail = (m_gzFile == 0);
+#else
+      NS_LOG_WARN ("zlib support not available, writing " << filename << " uncompressed");
+      compress = false;
+#endif
+    }
+  if (!compress)
+    {
+      m_file.open (filename.c_str (), std::ios::out | std::ios::binary);
+      m_fail = m_file.fail ();
+    }
+  if (m_fail)
+    {
+      return;
+    }
+  if (m_file.is_open ())
+    {
+      FatalImpl::RegisterStream (&m_file);
+    }
+  m_open = true;
+
+  m_buffer.reserve (m_bufferSize);
+
+  //
+  // The section header block: no options, and a section length of -1 since
+  // we do not know in advance how long the section will be.
+  //
+  Append32 (SECTION_HEADER_BLOCK);
+  Append32 (28);
+  Append32 (BYTE_ORDER_MAGIC);
+  Append16 (NG_VERSION_MAJOR);
+  Append16 (NG_VERSION_MINOR);
+  Append32 (0xffffffff);
+  Append32 (0xffffffff);
+  Append32 (28);
+
+#ifdef HAVE_PTHREAD_H
+  m_stop = false;
+  m_inFlight = 0;
+  m_writer = Create<SystemThread> (MakeCallback (&PcapNgFile::WriterLoop, this));
+  m_writer->Start ();
+#endif
+}
+
+void
+PcapNgFile::Close (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_open)
+    {
+      return;
+    }
+  Flush ();
+#ifdef HAVE_PTHREAD_H
+  {
+    CriticalSection cs (m_mutex);
+    m_stop = true;
+  }
+  m_wakeWriter.SetCondition (true);
+  m_wakeWriter.Signal ();
+  m_writer->Join ();
+  m_writer = 0;
+#endif
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      gzclose (static_cast<gzFile> (m_gzFile));
+      m_gzFile = 0;
+    }
+#endif
+  if (m_file.is_open ())
+    {
+      m_file.close ();
+      FatalImpl::UnregisterStream (&m_file);
+    }
+  m_open = false;
+}
+
+void
+PcapNgFile::Flush (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_open)
+    {
+      return;
+    }
+  Submit ();
+#ifdef HAVE_PTHREAD_H
+  while (true)
+    {
+      m_wakeProducer.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        if (m_inFlight == 0)
+          {
+            break;
+          }
+      }
+      m_wakeProducer.TimedWait (1000000);
+    }
+#endif
+  if (m_gzFile == 0)
+    {
+      m_file.flush ();
+    }
+}
+
+uint32_t
+PcapNgFile::AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name)
+{
+  NS_LOG_FUNCTION (this << dataLinkType << snapLen << name);
+  NS_ASSERT (m_open);
+
+  uint32_t nameLen = name.size ();
+  uint32_t optionsLen = 0;
+  if (nameLen > 0)
+    {
+      optionsLen += 4 + Pad32 (nameLen);
+    }
+  optionsLen += 4 + 4;      // if_tsresol
+  optionsLen += 4;          // opt_endofopt
+  uint32_t blockLen = 20 + optionsLen;
+
+  Append32 (INTERFACE_DESCRIPTION_BLOCK);
+  Append32 (blockLen);
+  Append16 (static_cast<uint16_t> (dataLinkType));
+  Append16 (0);
+  Append32 (snapLen);
+  if (nameLen > 0)
+    {
+      Append16 (OPT_IF_NAME);
+      Append16 (static_cast<uint16_t> (nameLen));
+      Append (name.data (), nameLen);
+      uint32_t zero = 0;
+      Append (&zero, Pad32 (nameLen) - nameLen);
+    }
+  uint8_t tsresol[4] = { 9, 0, 0, 0 };   // 10^-9 seconds
+  Append16 (OPT_IF_TSRESOL);
+  Append16 (1);
+  Append (tsresol, 4);
+  Append16 (OPT_ENDOFOPT);
+  Append16 (0);
+  Append32 (blockLen);
+
+  m_snapLen.push_back (snapLen);
+  return m_snapLen.size () - 1;
+}
+
+uint32_t
+PcapNgFile::GetNInterfaces (void) const
+{
+  return m_snapLen.size ();
+}
+
+uint8_t *
+PcapNgFile::BeginPacketBlock (uint32_t interfaceId, uint64_t tsNs, uint32_t totalLen, uint32_t &inclLen)
+{
+  NS_ASSERT (m_open);
+  NS_ASSERT_MSG (interfaceId < m_snapLen.size (), "Unknown pcapng interface " << interfaceId);
+
+  uint32_t snapLen = m_snapLen[interfaceId];
+  inclLen = totalLen > snapLen ? snapLen : totalLen;
+  uint32_t padded = Pad32 (inclLen);
+  uint32_t blockLen = 32 + padded;
+
+  Append32 (ENHANCED_PACKET_BLOCK);
+  Append32 (blockLen);
+  Append32 (interfaceId);
+  Append32 (static_cast<uint32_t> (tsNs >> 32));
+  Append32 (static_cast<uint32_t> (tsNs & 0xffffffff));
+  Append32 (inclLen);
+  Append32 (totalLen);
+
+  //
+  // Reserve room for the (padded) data and the trailing block length.  The
+  // padding is zeroed here, the caller copies the packet bytes in front of it.
+  //
+  uint32_t start = m_buffer.size ();
+  m_buffer.resize (start + padded + 4, 0);
+  uint8_t *trailer = &m_buffer[start + padded];
+  std::memcpy (trailer, &blockLen, 4);
+  return &m_buffer[start];
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, uint8_t const *data, uint32_t totalLen)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << &data << totalLen);
+  uint32_t inclLen;
+  uint8_t *dst = BeginPacketBlock (interfaceId, tsNs, totalLen, inclLen);
+  std::memcpy (dst, data, inclLen);
+  MaybeSubmit ();
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << p);
+  uint32_t inclLen;
+  uint8_t *dst = BeginPacketBlock (interfaceId, tsNs, p->GetSize (), inclLen);
+  p->CopyData (dst, inclLen);
+  MaybeSubmit ();
+}
+
+void
+PcapNgFile::Write (uint32_t interfaceId, uint64_t tsNs, const Header &header, Ptr<const Packet> p)
+{
+  NS_LOG_FUNCTION (this << interfaceId << tsNs << &header << p);
+  uint32_t headerSize = header.GetSerializedSize ();
+  uint32_t inclLen;
+  uint8_t *dst = BeginPacketBlock (interfaceId, tsNs, headerSize + p->GetSize (), inclLen);
+
+  Buffer headerBuffer;
+  headerBuffer.AddAtStart (headerSize);
+  header.Serialize (headerBuffer.Begin ());
+  uint32_t toCopy = std::min (headerSize, inclLen);
+  headerBuffer.CopyData (dst, toCopy);
+  p->CopyData (dst + toCopy, inclLen - toCopy);
+  MaybeSubmit ();
+}
+
+void
+PcapNgFile::Append (void const *data, uint32_t len)
+{
+  uint8_t const *bytes = static_cast<uint8_t const *> (data);
+  m_buffer.insert (m_buffer.end (), bytes, bytes + len);
+}
+
+void
+PcapNgFile::Append32 (uint32_t v)
+{
+  Append (&v, 4);
+}
+
+void
+PcapNgFile::Append16 (uint16_t v)
+{
+  Append (&v, 2);
+}
+
+void
+PcapNgFile::MaybeSubmit (void)
+{
+  if (m_buffer.size () >= m_bufferSize)
+    {
+      Submit ();
+    }
+}
+
+void
+PcapNgFile::Submit (void)
+{
+  NS_LOG_FUNCTION (this << m_buffer.size ());
+  if (m_buffer.empty ())
+    {
+      return;
+    }
+#ifdef HAVE_PTHREAD_H
+  //
+  // Block while the writer is too far behind, so that a slow disk cannot
+  // make the queue of pending buffers grow without bound.
+  //
+  while (true)
+    {
+      m_wakeProducer.SetCondition (false);
+      {
+        CriticalSection cs (m_mutex);
+        if (m_inFlight < m_maxPending)
+          {
+            m_pending.push_back (std::vector<uint8_t> ());
+            m_pending.back ().swap (m_buffer);
+            ++m_inFlight;
+            break;
+          }
+      }
+      m_wakeProducer.TimedWait (1000000);
+    }
+  m_wakeWriter.SetCondition (true);
+  m_wakeWriter.Signal ();
+  m_buffer.reserve (m_bufferSize);
+#else
+  WriteBuffer (m_buffer);
+  m_buffer.clear ();
+#endif
+}
+
+void
+PcapNgFile::WriteBuffer (std::vector<uint8_t> const &buffer)
+{
+  bool fail;
+#ifdef HAVE_ZLIB
+  if (m_gzFile != 0)
+    {
+      int written = gzwrite (static_cast<gzFile> (m_gzFile), &buffer[0], buffer.size ());
+      fail = (written != static_cast<int> (buffer.size ()));
+    }
+  else
+#endif
+    {
+      m_file.write (reinterpret_cast<const char *> (&buffer[0]), buffer.size ());
+      fail = m_file.fail ();
+    }
+  if (fail)
+    {
+      // the simulation reads the flag while the writer thread writes it
+#ifdef HAVE_PTHREAD_H
+      CriticalSection cs (m_mutex);
+#endif
+      m_fail = true;
+    }
+}
+
+void
+PcapNgFile::WriterLoop (void)
+{
+#ifdef HAVE_PTHREAD_H
+  std::vector<uint8_t> buffer;
+  while (true)
+    {
+      m_wakeWriter.SetCondition (false);
+      bool stop;
+      {
+        CriticalSection cs (m_mutex);
+        if (!m_pending.empty ())
+          {
+            buffer.swap (m_pending.front ());
+            m_pending.pop_front ();
+          }
+        stop = m_stop;
+      }
+      if (!buffer.empty ())
+        {
+          WriteBuffer (buffer);
+          buffer.clear ();
+          {
+            CriticalSection cs (m_mutex);
+            --m_inFlight;
+          }
+          m_wakeProducer.SetCondition (true);
+          m_wakeProducer.Signal ();
+          continue;
+        }
+      if (stop)
+        {
+          break;
+        }
+      m_wakeWriter.TimedWait (10000000);
+    }
+#endif
+}
+
+} // namespace ns3
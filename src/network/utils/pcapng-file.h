@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PCAPNG_FILE_H
+#define PCAPNG_FILE_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <fstream>
+#include <stdint.h>
+#include "ns3/ptr.h"
+#include "ns3/core-config.h"
+#ifdef HAVE_PTHREAD_H
+#include "ns3/system-thread.h"
+#include "ns3/system-mutex.h"
+#include "ns3/system-condition.h"
+#endif
+
+namespace ns3 {
+
+class Packet;
+class Header;
+
+/**
+ * \brief A buffered, write-only pcapng file able to hold many interfaces
+ *
+ * Unlike PcapFile, which performs one stream write per record, this class
+ * serializes pcapng blocks into a large in-memory buffer.  Full buffers are
+ * handed over to a background writer thread (when threading is available)
+ * which performs the actual file I/O, optionally through zlib so that the
+ * output is a gzip-compressed pcapng file readable by wireshark and tcpdump.
+ *
+ * A single file may carry packets from any number of interfaces, each with
+ * its own data link type and snap length, so that a whole topology can be
+ * traced into one file instead of one file per device.
+ *
+ * All timestamps are written with nanosecond resolution.
+ */
+class PcapNgFile
+{
+public:
+  static const uint32_t BUFFER_SIZE_DEFAULT = 1 << 20;  /**< Default size of one write buffer, in bytes */
+  static const uint32_t MAX_PENDING_DEFAULT = 8;        /**< Default number of full buffers queued for the writer */
+
+  PcapNgFile ();
+  ~PcapNgFile ();
+
+  /**
+   * \return true if opening or writing the underlying file failed.
+   */
+  bool Fail (void) const;
+
+  /**
+   * Create a new pcapng file and write its section header.
+   *
+   * \param filename name of the file to create.
+   * \param compress gzip-compress the stream.  Ignored (with a warning)
+   * when ns-3 was configured without zlib.
+   * \param bufferSize size of one write buffer, in bytes.
+   * \param maxPending maximum number of full buffers waiting for the
+   * writer thread before the simulation blocks.
+   */
+  void Open (std::string const &filename,
+             bool compress = false,
+             uint32_t bufferSize = BUFFER_SIZE_DEFAULT,
+             uint32_t maxPending = MAX_PENDING_DEFAULT);
+
+  /**
+   * Flush all buffered records, stop the writer thread and close the file.
+   */
+  void Close (void);
+
+  /**
+   * Hand the current buffer to the writer and wait until every record
+   * written so far has reached the file.
+   */
+  void Flush (void);
+
+  /**
+   * \brief Describe a new interface in the file.
+   *
+   * \param dataLinkType data link type of the packets of this interface
+   * \param snapLen maximum number of bytes stored per packet
+   * \param name interface name stored in the if_name option (may be empty)
+   * \returns the interface id to pass to Write
+   */
+  uint32_t AddInterface (uint32_t dataLinkType, uint32_t snapLen, std::string const &name);
+
+  /**
+   * \returns the number of interfaces described so far.
+   */
+  uint32_t GetNInterfaces (void) const;
+
+  /**
+   * \brief Write the next packet to the file
+   *
+   * \param interfaceId interface id returned by AddInterface
+   * \param tsNs packet timestamp, in nanoseconds
+   * \param data data buffer
+   * \param totalLen total packet length
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, uint8_t const *data, uint32_t totalLen);
+  /**
+   * \brief Write the next packet to the file
+   *
+   * \param interfaceId interface id returned by AddInterface
+   * \param tsNs packet timestamp, in nanoseconds
+   * \param p packet to write
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, Ptr<const Packet> p);
+  /**
+   * \brief Write the next packet to the file
+   *
+   * \param interfaceId interface id returned by AddInterface
+   * \param tsNs packet timestamp, in nanoseconds
+   * \param header header to write, in front of packet
+   * \param p packet to write
+   */
+  void Write (uint32_t interfaceId, uint64_t tsNs, const Header &header, Ptr<const Packet> p);
+
+private:
+  /**
+   * \brief Start an enhanced packet block and reserve room for its data
+   * \param interfaceId interface id
+   * \param tsNs timestamp, in nanoseconds
+   * \param totalLen original packet length
+   * \param inclLen [out] number of packet bytes to copy
+   * \returns where the packet data must be copied
+   */
+  uint8_t * BeginPacketBlock (uint32_t interfaceId, uint64_t tsNs, uint32_t totalLen, uint32_t &inclLen);
+  /**
+   * \brief Append raw bytes to the current buffer
+   * \param data bytes to append
+   * \param len number of bytes
+   */
+  void Append (void const *data, uint32_t len);
+  /**
+   * \brief Append a 32 bit word to the current buffer
+   * \param v the value
+   */
+  void Append32 (uint32_t v);
+  /**
+   * \brief Append a 16 bit word to the current buffer
+   * \param v the value
+   */
+  void Append16 (uint16_t v);
+  /**
+   * \brief Hand the current buffer over to the writer if it is full.
+   */
+  void MaybeSubmit (void);
+  /**
+   * \brief Hand the current buffer over to the writer.
+   */
+  void Submit (void);
+  /**
+   * \brief Write one buffer to the file.  Called by the writer thread.
+   * \param buffer the bytes to write
+   */
+  void WriteBuffer (std::vector<uint8_t> const &buffer);
+  /**
+   * \brief Body of the writer thread.
+   */
+  void WriterLoop (void);
+
+  std::fstream m_file;                 //!< Uncompressed output stream
+  void *m_gzFile;                      //!< zlib stream (gzFile), when compressing
+  bool m_open;                         //!< True between Open and Close
+  bool m_fail;                         //!< True if an I/O error occurred, protected by m_mutex
+  uint32_t m_bufferSize;               //!< Size at which a buffer is submitted
+  uint32_t m_maxPending;               //!< Maximum number of buffers queued
+  std::vector<uint8_t> m_buffer;       //!< Buffer being filled by the simulation
+  std::vector<uint32_t> m_snapLen;     //!< Snap length of each interface
+#ifdef HAVE_PTHREAD_H
+  Ptr<SystemThread> m_writer;          //!< Background writer thread
+  mutable SystemMutex m_mutex;         //!< Protects m_fail and the members below
+  SystemCondition m_wakeWriter;        //!< Signalled when a buffer is queued
+  SystemCondition m_wakeProducer;      //!< Signalled when a buffer is written
+  std::list<std::vector<uint8_t> > m_pending; //!< Buffers waiting to be written
+  uint32_t m_inFlight;                 //!< Buffers queued or being written
+  bool m_stop;                         //!< Asks the writer thread to exit
+#endif
+};
+
+} // namespace ns3
+
+#endif /* PCAPNG_FILE_H */
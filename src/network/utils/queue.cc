@@ -22,6 +22,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/trace-source-accessor.h"
 #include "queue.h"
+#include <algorithm>
 
 namespace ns3 {
 
@@ -118,8 +119,11 @@ Queue::Enqueue (Ptr<QueueItem> item)
   bool retval = DoEnqueue (item);
   if (retval)
     {
-      NS_LOG_LOGIC ("m_traceEnqueue (p)");
-      m_traceEnqueue (item->GetPacket ());
+      if (!m_traceEnqueue.IsEmpty ())
+        {
+          NS_LOG_LOGIC ("m_traceEnqueue (p)");
+          m_traceEnqueue (item->GetPacket ());
+        }
 
       uint32_t size = item->GetPacketSize ();
       m_nBytes += size;
@@ -152,12 +156,130 @@ Queue::Dequeue (void)
       m_nBytes -= item->GetPacketSize ();
       m_nPackets--;
 
-      NS_LOG_LOGIC ("m_traceDequeue (packet)");
-      m_traceDequeue (item->GetPacket ());
+      if (!m_traceDequeue.IsEmpty ())
+        {
+          NS_LOG_LOGIC ("m_traceDequeue (packet)");
+          m_traceDequeue (item->GetPacket ());
+        }
     }
   return item;
 }
 
+uint32_t
+Queue::EnqueueBatch (std::vector<Ptr<QueueItem> > const &items)
+{
+  NS_LOG_FUNCTION (this << items.size ());
+
+  uint32_t enqueued = 0;
+  uint32_t i = 0;
+  while (i < items.size ())
+    {
+      //
+      // Find the run of items from i on which fit in the queue
+      //
+      uint32_t n = 0;
+      uint32_t bytes = 0;
+      while (i + n < items.size ())
+        {
+          uint32_t size = items[i + n]->GetPacketSize ();
+          if ((m_mode == QUEUE_MODE_PACKETS && m_nPackets.Get () + n >= m_maxPackets)
+              || (m_mode == QUEUE_MODE_BYTES && m_nBytes.Get () + bytes + size > m_maxBytes))
+            {
+              break;
+            }
+          bytes += size;
+          n++;
+        }
+      if (n == 0)
+        {
+          NS_LOG_LOGIC ("Queue full -- dropping pkt");
+          Drop (items[i]);
+          i++;
+          continue;
+        }
+      if (!DoEnqueueBatch (items, i, n))
+        {
+          for (; i < items.size (); i++)
+            {
+              enqueued += Enqueue (items[i]) ? 1 : 0;
+            }
+          return enqueued;
+        }
+      if (!m_traceEnqueue.IsEmpty ())
+        {
+          for (uint32_t j = i; j < i + n; j++)
+            {
+              m_traceEnqueue (items[j]->GetPacket ());
+            }
+        }
+      m_nBytes += bytes;
+      m_nTotalReceivedBytes += bytes;
+      m_nPackets += n;
+      m_nTotalReceivedPackets += n;
+      enqueued += n;
+      i += n;
+    }
+  return enqueued;
+}
+
+uint32_t
+Queue::DequeueBatch (std::vector<Ptr<QueueItem> > &items, uint32_t max)
+{
+  NS_LOG_FUNCTION (this << max);
+
+  uint32_t n = std::min (max, m_nPackets.Get ());
+  uint32_t first = items.size ();
+  if (n == 0)
+    {
+      return 0;
+    }
+  if (!DoDequeueBatch (items, n))
+    {
+      items.reserve (first + n);
+      for (uint32_t i = 0; i < n; ++i)
+        {
+          Ptr<QueueItem> item = Dequeue ();
+          if (item == 0)
+            {
+              return i;
+            }
+          items.push_back (item);
+        }
+      return n;
+    }
+
+  NS_ASSERT (items.size () == first + n);
+  uint32_t bytes = 0;
+  for (uint32_t i = first; i < items.size (); i++)
+    {
+      bytes += items[i]->GetPacketSize ();
+    }
+  NS_ASSERT (m_nBytes.Get () >= bytes);
+  m_nBytes -= bytes;
+  m_nPackets -= n;
+
+  if (!m_traceDequeue.IsEmpty ())
+    {
+      for (uint32_t i = first; i < items.size (); i++)
+        {
+          m_traceDequeue (items[i]->GetPacket ());
+        }
+    }
+  return n;
+}
+
+bool
+Queue::DoEnqueueBatch (std::vector<Ptr<QueueItem> > const &items, uint32_t first, uint32_t n)
+{
+  return false;
+}
+
+bool
+Queue::DoDequeueBatch (std::vector<Ptr<QueueItem> > &items, uint32_t n)
+{
+  return false;
+}
+
 Ptr<QueueItem>
 Queue::Remove (void)
 {
@@ -368,8 +490,11 @@ Queue::Drop (Ptr<QueueItem> item)
   m_nTotalDroppedPackets++;
   m_nTotalDroppedBytes += item->GetPacketSize ();
 
-  NS_LOG_LOGIC ("m_traceDrop (p)");
-  m_traceDrop (item->GetPacket ());
+  if (!m_traceDrop.IsEmpty ())
+    {
+      NS_LOG_LOGIC ("m_traceDrop (p)");
+      m_traceDrop (item->GetPacket ());
+    }
   NotifyDrop (item);
 }
 
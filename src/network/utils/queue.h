@@ -28,6 +28,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/net-device.h"
 #include "ns3/traced-value.h"
+#include <vector>
 
 namespace ns3 {
 
@@ -78,6 +79,32 @@ public:
    * \return 0 if the operation was not successful; the item otherwise.
    */
   Ptr<const QueueItem> Peek (void) const;
+  /**
+   * Place a batch of queue items into the rear of the Queue
+   *
+   * Each item is admitted, or dropped, as by Enqueue, and the Enqueue and
+   * Drop traces fire for each of them.  The runs of items which fit in
+   * the queue are stored at once by the subclasses which support it, such
+   * as DropTailQueue, and the counters, including the PacketsInQueue and
+   * BytesInQueue traced values, are then updated once per run.
+   *
+   * \param items items to enqueue, in order
+   * \return the number of items which were enqueued
+   */
+  uint32_t EnqueueBatch (std::vector<Ptr<QueueItem> > const &items);
+  /**
+   * Remove up to a given number of items from the front of the Queue,
+   * counting them as dequeued
+   *
+   * The Dequeue trace fires for each item.  The subclasses which support
+   * it, such as DropTailQueue, remove the items at once, and the counters
+   * are then updated once per batch.
+   *
+   * \param items vector the dequeued items are appended to
+   * \param max the maximum number of items to dequeue
+   * \return the number of items which were dequeued
+   */
+  uint32_t DequeueBatch (std::vector<Ptr<QueueItem> > &items, uint32_t max);
 
   /**
    * Flush the queue.
@@ -240,6 +267,27 @@ private:
    * \return the item.
    */
   virtual Ptr<const QueueItem> DoPeek (void) const = 0;
+  /**
+   * Push a run of items, which all fit in the queue, at once.
+   *
+   * Subclasses which store their items one at a time do not override it.
+   *
+   * \param items the items
+   * \param first the index of the first item of the run
+   * \param n the number of items of the run
+   * \return false if the items are to be enqueued one at a time instead
+   */
+  virtual bool DoEnqueueBatch (std::vector<Ptr<QueueItem> > const &items, uint32_t first, uint32_t n);
+  /**
+   * Pull items from the head of the queue at once.
+   *
+   * Subclasses which store their items one at a time do not override it.
+   *
+   * \param items the vector the items are appended to
+   * \param n the number of items, at most the number of packets in the queue
+   * \return false if the items are to be dequeued one at a time instead
+   */
+  virtual bool DoDequeueBatch (std::vector<Ptr<QueueItem> > &items, uint32_t n);
 
   /**
    *  \brief Notification of a packet drop
@@ -57,6 +57,10 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
                      Ptr<SimpleNetDevice> sender)
 {
   NS_LOG_FUNCTION (this << p << protocol << to << from << sender);
+  // several receivers share a copy of the packet, which the sender may
+  // still modify, and copy it again when they forward it
+  Ptr<SimpleNetDevice> first;
+  Ptr<const Packet> shared;
   for (std::vector<Ptr<SimpleNetDevice> >::const_iterator i = m_devices.begin (); i != m_devices.end (); ++i)
     {
       Ptr<SimpleNetDevice> tmp = *i;
@@ -72,8 +76,25 @@ SimpleChannel::Send (Ptr<Packet> p, uint16_t protocol,
               continue;
             }
         }
+      if (first == 0)
+        {
+          first = tmp;
+          continue;
+        }
+      if (shared == 0)
+        {
+          shared = p->Copy ();
+          Simulator::ScheduleWithContext (first->GetNode ()->GetId (), m_delay,
+                                          &SimpleNetDevice::ReceiveShared, first, shared, protocol, to, from);
+        }
       Simulator::ScheduleWithContext (tmp->GetNode ()->GetId (), m_delay,
-                                      &SimpleNetDevice::Receive, tmp, p->Copy (), protocol, to, from);
+                                      &SimpleNetDevice::ReceiveShared, tmp, shared, protocol, to, from);
+    }
+  if (first != 0 && shared == 0)
+    {
+      // a single receiver gets its own copy
+      Simulator::ScheduleWithContext (first->GetNode ()->GetId (), m_delay,
+                                      &SimpleNetDevice::Receive, first, p->Copy (), protocol, to, from);
     }
 }
 
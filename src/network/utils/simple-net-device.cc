@@ -270,6 +270,21 @@ SimpleNetDevice::Receive (Ptr<Packet> packet, uint16_t protocol,
     }
 }
 
+void
+SimpleNetDevice::ReceiveShared (Ptr<const Packet> packet, uint16_t protocol,
+                                Mac48Address to, Mac48Address from)
+{
+  NS_LOG_FUNCTION (this << packet << protocol << to << from);
+
+  // without an error model, a packet for another host is only used if it is sniffed
+  if (!m_receiveErrorModel && m_promiscCallback.IsNull ()
+      && to != m_address && !to.IsBroadcast () && !to.IsGroup ())
+    {
+      return;
+    }
+  Receive (packet->Copy (), protocol, to, from);
+}
+
 void 
 SimpleNetDevice::SetChannel (Ptr<SimpleChannel> channel)
 {
@@ -73,6 +73,18 @@ public:
    * \param from address packet was sent from
    */
   void Receive (Ptr<Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from);
+
+  /**
+   * Receive a packet from a connected SimpleChannel, shared with the other
+   * devices of the channel.  The packet is copied, then received as by
+   * Receive, unless it would be discarded anyway.
+   *
+   * \param packet Packet received on the channel
+   * \param protocol protocol number
+   * \param to address packet should be sent to
+   * \param from address packet was sent from
+   */
+  void ReceiveShared (Ptr<const Packet> packet, uint16_t protocol, Mac48Address to, Mac48Address from);
   
   /**
    * Attach a channel to this net device.  This will be the 
@@ -18,12 +18,14 @@
  * Authors: Josh Pelkey <jpelkey@gatech.edu>
  */
 
-#include <queue>
+#include <algorithm>
 #include <iomanip>
 
 #include "ns3/log.h"
 #include "ns3/abort.h"
 #include "ns3/names.h"
+#include "ns3/global-value.h"
+#include "ns3/uinteger.h"
 #include "ns3/ipv4-list-routing.h"
 
 #include "ipv4-nix-vector-routing.h"
@@ -34,7 +36,30 @@ NS_LOG_COMPONENT_DEFINE ("Ipv4NixVectorRouting");
 
 NS_OBJECT_ENSURE_REGISTERED (Ipv4NixVectorRouting);
 
+/**
+ * \ingroup nix-vector-routing
+ * \brief Maximum number of nix-vectors in the cache shared by all the nodes.
+ */
+static GlobalValue g_nixVectorCacheSize =
+  GlobalValue ("NixVectorCacheSize",
+               "The maximum number of nix-vectors cached for all the nodes "
+               "using ns3::Ipv4NixVectorRouting; the least recently used ones "
+               "are evicted beyond. 0 disables the cache.",
+               UintegerValue (100000),
+               MakeUintegerChecker<uint32_t> ());
+
+/// Marks a node not reached by a search
+static const uint32_t UNREACHED = 0xffffffff;
+
 bool Ipv4NixVectorRouting::g_isCacheDirty = false;
+std::map<Ipv4NixVectorRouting::NixCacheKey_t, Ipv4NixVectorRouting::NixCacheEntry> Ipv4NixVectorRouting::g_nixCache;
+std::list<Ipv4NixVectorRouting::NixCacheKey_t> Ipv4NixVectorRouting::g_nixCacheLru;
+std::vector<Ipv4NixVectorRouting::Adjacency> Ipv4NixVectorRouting::g_adjacency;
+std::map<Ipv4Address, uint32_t> Ipv4NixVectorRouting::g_nodeByAddress;
+bool Ipv4NixVectorRouting::g_isIndexValid = false;
+std::vector<Ipv4NixVectorRouting::SearchMark> Ipv4NixVectorRouting::g_searchMarks;
+uint32_t Ipv4NixVectorRouting::g_searchId = 0;
+uint32_t Ipv4NixVectorRouting::g_epoch = 0;
 
 TypeId 
 Ipv4NixVectorRouting::GetTypeId (void)
@@ -48,7 +73,8 @@ Ipv4NixVectorRouting::GetTypeId (void)
 }
 
 Ipv4NixVectorRouting::Ipv4NixVectorRouting ()
-  : m_totalNeighbors (0)
+  : m_epoch (g_epoch),
+    m_totalNeighbors (0)
 {
   NS_LOG_FUNCTION_NOARGS ();
 }
@@ -76,6 +102,9 @@ Ipv4NixVectorRouting::DoDispose ()
   m_node = 0;
   m_ipv4 = 0;
 
+  // node ids are reused by the next simulation
+  FlushGlobalNixRoutingCache ();
+
   Ipv4RoutingProtocol::DoDispose ();
 }
 
@@ -86,32 +115,24 @@ Ipv4NixVectorRouting::SetNode (Ptr<Node> node)
   NS_LOG_FUNCTION_NOARGS ();
 
   m_node = node;
-}
 
-void
-Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
-{
-  NS_LOG_FUNCTION_NOARGS ();
-  NodeList::Iterator listEnd = NodeList::End ();
-  for (NodeList::Iterator i = NodeList::Begin (); i != listEnd; i++)
-    {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4NixVectorRouting> rp = node->GetObject<Ipv4NixVectorRouting> ();
-      if (!rp)
-        {
-          continue;
-        }
-      NS_LOG_LOGIC ("Flushing Nix caches.");
-      rp->FlushNixCache ();
-      rp->FlushIpv4RouteCache ();
-    }
+  // the topology index does not know this node yet
+  g_isCacheDirty = true;
 }
 
 void
-Ipv4NixVectorRouting::FlushNixCache (void) const
+Ipv4NixVectorRouting::FlushGlobalNixRoutingCache (void) const
 {
   NS_LOG_FUNCTION_NOARGS ();
-  m_nixCache.clear ();
+  NS_LOG_LOGIC ("Flushing Nix caches.");
+  g_nixCache.clear ();
+  g_nixCacheLru.clear ();
+  g_adjacency.clear ();
+  g_nodeByAddress.clear ();
+  g_searchMarks.clear ();
+  g_isIndexValid = false;
+  // the Ipv4Route cache of each node is flushed on its next use
+  g_epoch++;
 }
 
 void
@@ -150,12 +171,11 @@ Ipv4NixVectorRouting::GetNixVector (Ptr<Node> source, Ipv4Address dest, Ptr<NetD
     {
       // otherwise proceed as normal 
       // and build the nix vector
-      std::vector< Ptr<Node> > parentVector;
+      std::vector<uint32_t> path;
 
-      BFS (NodeList::GetNNodes (), source, destNode, parentVector, oif);
-
-      if (BuildNixVector (parentVector, source->GetId (), destNode->GetId (), nixVector))
+      if (BFS (source, destNode, path, oif))
         {
+          BuildNixVector (path, nixVector);
           return nixVector;
         }
       else
@@ -173,17 +193,52 @@ Ipv4NixVectorRouting::GetNixVectorInCache (Ipv4Address address)
 
   CheckCacheStateAndFlush ();
 
-  NixMap_t::iterator iter = m_nixCache.find (address);
-  if (iter != m_nixCache.end ())
+  std::map<NixCacheKey_t, NixCacheEntry>::iterator iter = g_nixCache.find (NixCacheKey_t (m_node->GetId (), address));
+  if (iter != g_nixCache.end ())
     {
       NS_LOG_LOGIC ("Found Nix-vector in cache.");
-      return iter->second;
+      // move to the front of the LRU list
+      g_nixCacheLru.splice (g_nixCacheLru.begin (), g_nixCacheLru, iter->second.lru);
+      return iter->second.nixVector;
     }
 
   // not in cache
   return 0;
 }
 
+void
+Ipv4NixVectorRouting::AddNixVectorToCache (Ipv4Address address, Ptr<NixVector> nixVector)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+
+  UintegerValue cacheSize;
+  g_nixVectorCacheSize.GetValue (cacheSize);
+  if (cacheSize.Get () == 0)
+    {
+      return;
+    }
+
+  NixCacheKey_t key (m_node->GetId (), address);
+  std::map<NixCacheKey_t, NixCacheEntry>::iterator iter = g_nixCache.find (key);
+  if (iter != g_nixCache.end ())
+    {
+      iter->second.nixVector = nixVector;
+      g_nixCacheLru.splice (g_nixCacheLru.begin (), g_nixCacheLru, iter->second.lru);
+      return;
+    }
+  while (g_nixCache.size () >= cacheSize.Get ())
+    {
+      NS_LOG_LOGIC ("Evicting Nix-vector from cache.");
+      g_nixCache.erase (g_nixCacheLru.back ());
+      g_nixCacheLru.pop_back ();
+    }
+  g_nixCacheLru.push_front (key);
+  NixCacheEntry entry;
+  entry.nixVector = nixVector;
+  entry.lru = g_nixCacheLru.begin ();
+  g_nixCache.insert (std::make_pair (key, entry));
+}
+
 Ptr<Ipv4Route>
 Ipv4NixVectorRouting::GetIpv4RouteInCache (Ipv4Address address)
 {
@@ -229,77 +284,34 @@ Ipv4NixVectorRouting::BuildNixVectorLocal (Ptr<NixVector> nixVector)
   return false;
 }
 
-bool
-Ipv4NixVectorRouting::BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector)
+void
+Ipv4NixVectorRouting::BuildNixVector (const std::vector<uint32_t> & path, Ptr<NixVector> nixVector)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
-  if (source == dest)
-    {
-      return true;
-    }
-
-  if (parentVector.at (dest) == 0)
+  // walk the path backwards, from the last hop, adding the
+  // index of each node among the neighbors of its parent
+  for (uint32_t i = path.size (); i > 1; i--)
     {
-      return false;
-    }
-
-  Ptr<Node> parentNode = parentVector.at (dest);
-
-  uint32_t numberOfDevices = parentNode->GetNDevices ();
-  uint32_t destId = 0;
-  uint32_t totalNeighbors = 0;
-
-  // scan through the net devices on the parent node
-  // and then look at the nodes adjacent to them
-  for (uint32_t i = 0; i < numberOfDevices; i++)
-    {
-      // Get a net device from the node
-      // as well as the channel, and figure
-      // out the adjacent net devices
-      Ptr<NetDevice> localNetDevice = parentNode->GetDevice (i);
-      if (localNetDevice->IsBridge ())
+      uint32_t parent = path[i - 2];
+      uint32_t dest = path[i - 1];
+      std::vector<uint32_t> const &neighbors = g_adjacency[parent].neighbors;
+
+      // if the parent has several links to dest, the
+      // last one is used
+      uint32_t destId = 0;
+      for (uint32_t j = neighbors.size (); j > 0; j--)
         {
-          continue;
-        }
-      Ptr<Channel> channel = localNetDevice->GetChannel ();
-      if (channel == 0)
-        {
-          continue;
-        }
-
-      // this function takes in the local net dev, and channnel, and
-      // writes to the netDeviceContainer the adjacent net devs
-      NetDeviceContainer netDeviceContainer;
-      GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-      // Finally we can get the adjacent nodes
-      // and scan through them.  If we find the 
-      // node that matches "dest" then we can add 
-      // the index  to the nix vector.
-      // the index corresponds to the neighbor index
-      uint32_t offset = 0;
-      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-        {
-          Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-          if (remoteNode->GetId () == dest)
+          if (neighbors[j - 1] == dest)
             {
-              destId = totalNeighbors + offset;
+              destId = j - 1;
+              break;
             }
-          offset += 1;
         }
-
-      totalNeighbors += netDeviceContainer.GetN ();
+      NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
+                                   << nixVector->BitCount (neighbors.size ()) << " bits, for node " << parent);
+      nixVector->AddNeighborIndex (destId, nixVector->BitCount (neighbors.size ()));
     }
-  NS_LOG_LOGIC ("Adding Nix: " << destId << " with " 
-                               << nixVector->BitCount (totalNeighbors) << " bits, for node " << parentNode->GetId ());
-  nixVector->AddNeighborIndex (destId, nixVector->BitCount (totalNeighbors));
-
-  // recurse through parent vector, grabbing the path 
-  // and building the nix vector
-  BuildNixVector (parentVector, source, (parentVector.at (dest))->GetId (), nixVector);
-  return true;
 }
 
 void
@@ -347,27 +359,98 @@ Ipv4NixVectorRouting::GetNodeByIp (Ipv4Address dest)
 { 
   NS_LOG_FUNCTION_NOARGS ();
 
-  NodeContainer allNodes = NodeContainer::GetGlobal ();
-  Ptr<Node> destNode;
+  UpdateTopologyIndex ();
 
-  for (NodeContainer::Iterator i = allNodes.Begin (); i != allNodes.End (); ++i)
+  std::map<Ipv4Address, uint32_t>::const_iterator iter = g_nodeByAddress.find (dest);
+  if (iter == g_nodeByAddress.end ())
     {
-      Ptr<Node> node = *i;
-      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
-      if (ipv4->GetInterfaceForAddress (dest) != -1)
-        {
-          destNode = node;
-          break;
-        }
+      NS_LOG_ERROR ("Couldn't find dest node given the IP" << dest);
+      return 0;
     }
 
-  if (!destNode)
+  return NodeList::GetNode (iter->second);
+}
+
+void
+Ipv4NixVectorRouting::UpdateTopologyIndex (void)
+{
+  if (g_isIndexValid && g_adjacency.size () == NodeList::GetNNodes ())
     {
-      NS_LOG_ERROR ("Couldn't find dest node given the IP" << dest);
-      return 0;
+      return;
     }
+  NS_LOG_FUNCTION_NOARGS ();
+
+  uint32_t numberOfNodes = NodeList::GetNNodes ();
+  g_adjacency.assign (numberOfNodes, Adjacency ());
+  g_nodeByAddress.clear ();
+  SearchMark mark = { 0, 0, 0, 0, 0, 0 };
+  g_searchMarks.assign (numberOfNodes, mark);
+  g_searchId = 0;
+
+  for (uint32_t nodeId = 0; nodeId < numberOfNodes; nodeId++)
+    {
+      Ptr<Node> node = NodeList::GetNode (nodeId);
+      Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+
+      // the first node holding an address is its node
+      if (ipv4)
+        {
+          for (uint32_t i = 0; i < ipv4->GetNInterfaces (); i++)
+            {
+              for (uint32_t j = 0; j < ipv4->GetNAddresses (i); j++)
+                {
+                  g_nodeByAddress.insert (std::make_pair (ipv4->GetAddress (i, j).GetLocal (), nodeId));
+                }
+            }
+        }
 
-  return destNode;
+      for (uint32_t i = 0; i < node->GetNDevices (); i++)
+        {
+          // Get a net device from the node
+          // as well as the channel, and figure
+          // out the adjacent net devices
+          Ptr<NetDevice> localNetDevice = node->GetDevice (i);
+          Ptr<Channel> channel = localNetDevice->GetChannel ();
+          if (channel == 0)
+            {
+              continue;
+            }
+          NetDeviceContainer netDeviceContainer;
+          GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
+
+          // the neighbors, as numbered by the nix-vectors
+          if (!localNetDevice->IsBridge ())
+            {
+              for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+                {
+                  g_adjacency[nodeId].neighbors.push_back ((*iter)->GetNode ()->GetId ());
+                }
+            }
+
+          // the nodes BFS may go to, if we can go this way
+          if (ipv4)
+            {
+              int32_t interfaceIndex = ipv4->GetInterfaceForDevice (localNetDevice);
+              if (interfaceIndex >= 0 && !(ipv4->IsUp (interfaceIndex)))
+                {
+                  NS_LOG_LOGIC ("Ipv4Interface is down");
+                  continue;
+                }
+            }
+          if (!(localNetDevice->IsLinkUp ()))
+            {
+              NS_LOG_LOGIC ("Link is down.");
+              continue;
+            }
+          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+            {
+              uint32_t remoteId = (*iter)->GetNode ()->GetId ();
+              g_adjacency[nodeId].next.push_back (remoteId);
+              g_adjacency[remoteId].previous.push_back (nodeId);
+            }
+        }
+    }
+  g_isIndexValid = true;
 }
 
 uint32_t
@@ -510,7 +593,7 @@ Ipv4NixVectorRouting::RouteOutput (Ptr<Packet> p, const Ipv4Header &header, Ptr<
       nixVectorInCache = GetNixVector (m_node, header.GetDestination (), oif);
 
       // cache it
-      m_nixCache.insert (NixMap_t::value_type (header.GetDestination (), nixVectorInCache));
+      AddNixVectorToCache (header.GetDestination (), nixVectorInCache);
     }
 
   // path exists
@@ -709,15 +792,21 @@ Ipv4NixVectorRouting::PrintRoutingTable (Ptr<OutputStreamWrapper> stream) const
       << ", Nix Routing" << std::endl;
 
   *os << "NixCache:" << std::endl;
-  if (m_nixCache.size () > 0)
+  uint32_t nodeId = m_ipv4->GetObject<Node> ()->GetId ();
+  std::map<NixCacheKey_t, NixCacheEntry>::const_iterator first = g_nixCache.lower_bound (NixCacheKey_t (nodeId, Ipv4Address::GetZero ()));
+  if (first != g_nixCache.end () && first->first.first == nodeId)
     {
       *os << "Destination     NixVector" << std::endl;
-      for (NixMap_t::const_iterator it = m_nixCache.begin (); it != m_nixCache.end (); it++)
+      for (std::map<NixCacheKey_t, NixCacheEntry>::const_iterator it = first; it != g_nixCache.end () && it->first.first == nodeId; it++)
         {
           std::ostringstream dest;
-          dest << it->first;
+          dest << it->first.second;
           *os << std::setiosflags (std::ios::left) << std::setw (16) << dest.str ();
-          *os << *(it->second) << std::endl;
+          if (it->second.nixVector)
+            {
+              *os << *(it->second.nixVector);
+            }
+          *os << std::endl;
         }
     }
   *os << "Ipv4RouteCache:" << std::endl;
@@ -771,151 +860,160 @@ Ipv4NixVectorRouting::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddr
 }
 
 bool
-Ipv4NixVectorRouting::BFS (uint32_t numberOfNodes, Ptr<Node> source, 
-                           Ptr<Node> dest, std::vector< Ptr<Node> > & parentVector,
+Ipv4NixVectorRouting::BFS (Ptr<Node> source, Ptr<Node> dest,
+                           std::vector<uint32_t> & path,
                            Ptr<NetDevice> oif)
 {
   NS_LOG_FUNCTION_NOARGS ();
 
   NS_LOG_LOGIC ("Going from Node " << source->GetId () << " to Node " << dest->GetId ());
-  std::queue< Ptr<Node> > greyNodeList;  // discovered nodes with unexplored children
-
-  // reset the parent vector
-  parentVector.clear ();
-  parentVector.reserve (sizeof (Ptr<Node>)*numberOfNodes);
-  parentVector.insert (parentVector.begin (), sizeof (Ptr<Node>)*numberOfNodes, 0); // initialize to 0
-
-  // Add the source node to the queue, set its parent to itself 
-  greyNodeList.push (source);
-  parentVector.at (source->GetId ()) = source;
-
-  // BFS loop
-  while (greyNodeList.size () != 0)
+  UpdateTopologyIndex ();
+  path.clear ();
+  uint32_t sourceId = source->GetId ();
+  uint32_t destId = dest->GetId ();
+
+  // if a specific output interface was given, make
+  // sure we go this way from the source
+  std::vector<uint32_t> oifNeighbors;
+  if (oif)
     {
-      Ptr<Node> currNode = greyNodeList.front ();
-      Ptr<Ipv4> ipv4 = currNode->GetObject<Ipv4> ();
- 
-      if (currNode == dest) 
-        {
-          NS_LOG_LOGIC ("Made it to Node " << currNode->GetId ());
-          return true;
-        }
-
-      // if this is the first iteration of the loop and a 
-      // specific output interface was given, make sure 
-      // we go this way
-      if (currNode == source && oif)
+      // make sure that we can go this way
+      Ptr<Ipv4> ipv4 = source->GetObject<Ipv4> ();
+      if (ipv4)
         {
-          // make sure that we can go this way
-          if (ipv4)
-            {
-              uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (oif);
-              if (!(ipv4->IsUp (interfaceIndex)))
-                {
-                  NS_LOG_LOGIC ("Ipv4Interface is down");
-                  return false;
-                }
-            }
-          if (!(oif->IsLinkUp ()))
+          uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (oif);
+          if (!(ipv4->IsUp (interfaceIndex)))
             {
-              NS_LOG_LOGIC ("Link is down.");
-              return false;
-            }
-          Ptr<Channel> channel = oif->GetChannel ();
-          if (channel == 0)
-            { 
+              NS_LOG_LOGIC ("Ipv4Interface is down");
               return false;
             }
+        }
+      if (!(oif->IsLinkUp ()))
+        {
+          NS_LOG_LOGIC ("Link is down.");
+          return false;
+        }
+      Ptr<Channel> channel = oif->GetChannel ();
+      if (channel == 0)
+        { 
+          return false;
+        }
 
-          // this function takes in the local net dev, and channnel, and
-          // writes to the netDeviceContainer the adjacent net devs
-          NetDeviceContainer netDeviceContainer;
-          GetAdjacentNetDevices (oif, channel, netDeviceContainer);
+      NetDeviceContainer netDeviceContainer;
+      GetAdjacentNetDevices (oif, channel, netDeviceContainer);
+      for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
+        {
+          oifNeighbors.push_back ((*iter)->GetNode ()->GetId ());
+        }
+    }
 
-          // Finally we can get the adjacent nodes
-          // and scan through them.  We push them
-          // to the greyNode queue, if they aren't 
-          // already there.
-          for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-            {
-              Ptr<Node> remoteNode = (*iter)->GetNode ();
+  if (sourceId == destId)
+    {
+      path.push_back (sourceId);
+      return true;
+    }
 
-              // check to see if this node has been pushed before
-              // by checking to see if it has a parent
-              // if it doesn't (null or 0), then set its parent and 
-              // push to the queue
-              if (parentVector.at (remoteNode->GetId ()) == 0)
+  // start a new search; marks of older searches are ignored
+  if (++g_searchId == 0)
+    {
+      SearchMark mark = { 0, 0, 0, 0, 0, 0 };
+      g_searchMarks.assign (g_searchMarks.size (), mark);
+      g_searchId = 1;
+    }
+  g_searchMarks[sourceId].forwardSearch = g_searchId;
+  g_searchMarks[sourceId].forwardParent = sourceId;
+  g_searchMarks[sourceId].forwardDepth = 0;
+  g_searchMarks[destId].backwardSearch = g_searchId;
+  g_searchMarks[destId].backwardNext = destId;
+  g_searchMarks[destId].backwardDepth = 0;
+
+  // Grow the smaller frontier by one hop at a time, until
+  // both searches meet.  The shortest path goes through the
+  // node of the last frontier closest to the other end.
+  std::vector<uint32_t> forwardFrontier (1, sourceId);
+  std::vector<uint32_t> backwardFrontier (1, destId);
+  std::vector<uint32_t> frontier;
+  uint32_t meet = UNREACHED;
+  uint32_t shortest = UNREACHED;
+  while (meet == UNREACHED && !forwardFrontier.empty () && !backwardFrontier.empty ())
+    {
+      frontier.clear ();
+      if (forwardFrontier.size () <= backwardFrontier.size ())
+        {
+          for (std::vector<uint32_t>::const_iterator i = forwardFrontier.begin (); i != forwardFrontier.end (); i++)
+            {
+              std::vector<uint32_t> const &next = (*i == sourceId && oif) ? oifNeighbors : g_adjacency[*i].next;
+              for (std::vector<uint32_t>::const_iterator j = next.begin (); j != next.end (); j++)
                 {
-                  parentVector.at (remoteNode->GetId ()) = currNode;
-                  greyNodeList.push (remoteNode);
+                  SearchMark &mark = g_searchMarks[*j];
+                  if (mark.forwardSearch == g_searchId)
+                    {
+                      continue;
+                    }
+                  mark.forwardSearch = g_searchId;
+                  mark.forwardParent = *i;
+                  mark.forwardDepth = g_searchMarks[*i].forwardDepth + 1;
+                  frontier.push_back (*j);
+                  if (mark.backwardSearch == g_searchId && mark.forwardDepth + mark.backwardDepth < shortest)
+                    {
+                      shortest = mark.forwardDepth + mark.backwardDepth;
+                      meet = *j;
+                    }
                 }
             }
+          forwardFrontier.swap (frontier);
         }
       else
         {
-          // Iterate over the current node's adjacent vertices
-          // and push them into the queue
-          for (uint32_t i = 0; i < (currNode->GetNDevices ()); i++)
+          for (std::vector<uint32_t>::const_iterator i = backwardFrontier.begin (); i != backwardFrontier.end (); i++)
             {
-              // Get a net device from the node
-              // as well as the channel, and figure
-              // out the adjacent net device
-              Ptr<NetDevice> localNetDevice = currNode->GetDevice (i);
-
-              // make sure that we can go this way
-              if (ipv4)
+              std::vector<uint32_t> const &previous = g_adjacency[*i].previous;
+              for (std::vector<uint32_t>::const_iterator j = previous.begin (); j != previous.end (); j++)
                 {
-                  uint32_t interfaceIndex = (ipv4)->GetInterfaceForDevice (currNode->GetDevice (i));
-                  if (!(ipv4->IsUp (interfaceIndex)))
+                  if (*j == sourceId && oif
+                      && std::find (oifNeighbors.begin (), oifNeighbors.end (), *i) == oifNeighbors.end ())
                     {
-                      NS_LOG_LOGIC ("Ipv4Interface is down");
                       continue;
                     }
-                }
-              if (!(localNetDevice->IsLinkUp ()))
-                {
-                  NS_LOG_LOGIC ("Link is down.");
-                  continue;
-                }
-              Ptr<Channel> channel = localNetDevice->GetChannel ();
-              if (channel == 0)
-                { 
-                  continue;
-                }
-
-              // this function takes in the local net dev, and channnel, and
-              // writes to the netDeviceContainer the adjacent net devs
-              NetDeviceContainer netDeviceContainer;
-              GetAdjacentNetDevices (localNetDevice, channel, netDeviceContainer);
-
-              // Finally we can get the adjacent nodes
-              // and scan through them.  We push them
-              // to the greyNode queue, if they aren't 
-              // already there.
-              for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin (); iter != netDeviceContainer.End (); iter++)
-                {
-                  Ptr<Node> remoteNode = (*iter)->GetNode ();
-
-                  // check to see if this node has been pushed before
-                  // by checking to see if it has a parent
-                  // if it doesn't (null or 0), then set its parent and 
-                  // push to the queue
-                  if (parentVector.at (remoteNode->GetId ()) == 0)
+                  SearchMark &mark = g_searchMarks[*j];
+                  if (mark.backwardSearch == g_searchId)
+                    {
+                      continue;
+                    }
+                  mark.backwardSearch = g_searchId;
+                  mark.backwardNext = *i;
+                  mark.backwardDepth = g_searchMarks[*i].backwardDepth + 1;
+                  frontier.push_back (*j);
+                  if (mark.forwardSearch == g_searchId && mark.forwardDepth + mark.backwardDepth < shortest)
                     {
-                      parentVector.at (remoteNode->GetId ()) = currNode;
-                      greyNodeList.push (remoteNode);
+                      shortest = mark.forwardDepth + mark.backwardDepth;
+                      meet = *j;
                     }
                 }
             }
+          backwardFrontier.swap (frontier);
         }
+    }
 
-      // Pop off the head grey node.  We have all its children.
-      // It is now black.
-      greyNodeList.pop ();
+  if (meet == UNREACHED)
+    {
+      // Didn't find the dest...
+      return false;
     }
+  NS_LOG_LOGIC ("Made it to Node " << destId << " through Node " << meet);
 
-  // Didn't find the dest...
-  return false;
+  for (uint32_t node = meet; node != sourceId; node = g_searchMarks[node].forwardParent)
+    {
+      path.push_back (node);
+    }
+  path.push_back (sourceId);
+  std::reverse (path.begin (), path.end ());
+  for (uint32_t node = meet; node != destId; )
+    {
+      node = g_searchMarks[node].backwardNext;
+      path.push_back (node);
+    }
+  return true;
 }
 
 void 
@@ -926,6 +1024,11 @@ Ipv4NixVectorRouting::CheckCacheStateAndFlush (void) const
       FlushGlobalNixRoutingCache ();
       g_isCacheDirty = false;
     }
+  if (m_epoch != g_epoch)
+    {
+      FlushIpv4RouteCache ();
+      m_epoch = g_epoch;
+    }
 }
 
 } // namespace ns3
@@ -22,6 +22,8 @@
 #define IPV4_NIX_VECTOR_ROUTING_H
 
 #include <map>
+#include <list>
+#include <vector>
 
 #include "ns3/channel.h"
 #include "ns3/node-container.h"
@@ -48,6 +50,15 @@ typedef std::map<Ipv4Address, Ptr<Ipv4Route> > Ipv4RouteMap_t;
 /**
  * \ingroup nix-vector-routing
  * Nix-vector routing protocol
+ *
+ * Nix-vectors are computed on demand, by a bidirectional breadth-first
+ * search over an index of the adjacencies of all the nodes, which is built
+ * once per topology.  They are kept in a cache shared by all the nodes,
+ * bounded by the "NixVectorCacheSize" global value, which evicts the
+ * least recently used nix-vectors.  The cache and the index are dropped
+ * whenever an interface goes up or down or an address is added or
+ * removed on a node which uses nix-vector routing, or when
+ * FlushGlobalNixRoutingCache is called.
  */
 class Ipv4NixVectorRouting : public Ipv4RoutingProtocol
 {
@@ -70,8 +81,8 @@ public:
 
   /**
    * @brief Called when run-time link topology change occurs
-   * which iterates through the node list and flushes any
-   * nix vector caches
+   * which flushes the shared nix vector cache and the topology
+   * index, and the Ipv4Route caches of all the nodes
    *
    * \internal
    * \c const is used here due to need to potentially flush the cache
@@ -82,10 +93,6 @@ public:
 
 private:
 
-  /* flushes the cache which stores nix-vector based on
-   * destination IP */
-  void FlushNixCache (void) const;
-
   /* flushes the cache which stores the Ipv4 route
    * based on the destination IP */
   void FlushIpv4RouteCache (void) const;
@@ -100,9 +107,15 @@ private:
    *  BuildNixVector to return the built nix-vector */
   Ptr<NixVector> GetNixVector (Ptr<Node>, Ipv4Address, Ptr<NetDevice>);
 
-  /* checks the cache based on dest IP for the nix-vector */
+  /* checks the shared cache based on this node and dest IP
+   * for the nix-vector */
   Ptr<NixVector> GetNixVectorInCache (Ipv4Address);
 
+  /* adds the nix-vector from this node to dest IP to the
+   * shared cache, evicting the least recently used ones
+   * beyond the NixVectorCacheSize global value */
+  void AddNixVectorToCache (Ipv4Address, Ptr<NixVector>);
+
   /* checks the cache based on dest IP for the Ipv4Route */
   Ptr<Ipv4Route> GetIpv4RouteInCache (Ipv4Address);
 
@@ -110,12 +123,16 @@ private:
    * essentially getting the neighbors on that channel */
   void GetAdjacentNetDevices (Ptr<NetDevice>, Ptr<Channel>, NetDeviceContainer &);
 
-  /* iterates through the node list and finds the one
-   * corresponding to the given Ipv4Address */
+  /* finds the node corresponding to the given Ipv4Address
+   * in the topology index */
   Ptr<Node> GetNodeByIp (Ipv4Address);
 
-  /* Recurses the parent vector, created by BFS and actually builds the nixvector */
-  bool BuildNixVector (const std::vector< Ptr<Node> > & parentVector, uint32_t source, uint32_t dest, Ptr<NixVector> nixVector);
+  /* builds the topology index if it is out of date: the
+   * adjacencies of all the nodes and the node of each address */
+  void UpdateTopologyIndex (void);
+
+  /* Walks the path, created by BFS, and actually builds the nixvector */
+  void BuildNixVector (const std::vector<uint32_t> & path, Ptr<NixVector> nixVector);
 
   /* special variation of BuildNixVector for when a node is sending to itself */
   bool BuildNixVectorLocal (Ptr<NixVector> nixVector);
@@ -132,18 +149,17 @@ private:
    * derived from this */
   uint32_t FindNetDeviceForNixIndex (uint32_t nodeIndex, Ipv4Address & gatewayIp);
 
-  /* Breadth first search algorithm
-   * Param1: total number of nodes
-   * Param2: Source Node
-   * Param3: Dest Node
-   * Param4: (returned) Parent vector for retracing routes
-   * Param5: specific output interface to use from source node, if not null
+  /* Bidirectional breadth first search algorithm, over
+   * the topology index
+   * Param1: Source Node
+   * Param2: Dest Node
+   * Param3: (returned) Ids of the nodes of a shortest path
+   * Param4: specific output interface to use from source node, if not null
    * Returns: false if dest not found, true o.w.
    */
-  bool BFS (uint32_t numberOfNodes,
-            Ptr<Node> source,
+  bool BFS (Ptr<Node> source,
             Ptr<Node> dest,
-            std::vector< Ptr<Node> > & parentVector,
+            std::vector<uint32_t> & path,
             Ptr<NetDevice> oif);
 
   void DoDispose (void);
@@ -171,8 +187,67 @@ private:
    */
   static bool g_isCacheDirty;
 
-  /* Cache stores nix-vectors based on destination ip */
-  mutable NixMap_t m_nixCache;
+  /* Neighbors of a node, in the topology index */
+  struct Adjacency
+  {
+    /* neighbor node ids, in the order of their nix index */
+    std::vector<uint32_t> neighbors;
+    /* nodes reached through an interface which is up */
+    std::vector<uint32_t> next;
+    /* nodes which reach this node through an interface which is up */
+    std::vector<uint32_t> previous;
+  };
+
+  /* State of a node in the current BFS; fields are valid when
+   * the search id matches g_searchId */
+  struct SearchMark
+  {
+    uint32_t forwardSearch;   /* search which reached the node from the source */
+    uint32_t forwardParent;   /* previous node on the path from the source */
+    uint32_t forwardDepth;    /* hops from the source */
+    uint32_t backwardSearch;  /* search which reached the node from the dest */
+    uint32_t backwardNext;    /* next node on the path to the dest */
+    uint32_t backwardDepth;   /* hops to the dest */
+  };
+
+  /* Key of the shared cache: source node id and dest ip */
+  typedef std::pair<uint32_t, Ipv4Address> NixCacheKey_t;
+
+  /* Entry of the shared cache */
+  struct NixCacheEntry
+  {
+    Ptr<NixVector> nixVector;                    /* 0 if there is no path */
+    std::list<NixCacheKey_t>::iterator lru;      /* position in g_nixCacheLru */
+  };
+
+  /* Shared cache stores nix-vectors based on source node and
+   * destination ip */
+  static std::map<NixCacheKey_t, NixCacheEntry> g_nixCache;
+
+  /* Keys of the shared cache, most recently used first */
+  static std::list<NixCacheKey_t> g_nixCacheLru;
+
+  /* Topology index: adjacencies, by node id */
+  static std::vector<Adjacency> g_adjacency;
+
+  /* Topology index: node id, by ip */
+  static std::map<Ipv4Address, uint32_t> g_nodeByAddress;
+
+  /* Whether the topology index is up to date */
+  static bool g_isIndexValid;
+
+  /* BFS state, by node id */
+  static std::vector<SearchMark> g_searchMarks;
+
+  /* Id of the current BFS */
+  static uint32_t g_searchId;
+
+  /* Incremented by each flush; the Ipv4Route caches of
+   * older epochs are out of date */
+  static uint32_t g_epoch;
+
+  /* Epoch of the Ipv4Route cache */
+  mutable uint32_t m_epoch;
 
   /* Cache stores Ipv4Routes based on destination ip */
   mutable Ipv4RouteMap_t m_ipv4RouteCache;
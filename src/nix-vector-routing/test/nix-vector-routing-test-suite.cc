@@ -0,0 +1,204 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/uinteger.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-interface-container.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/udp-socket-factory.h"
+#include "ns3/socket.h"
+#include "ns3/packet.h"
+#include "ns3/ipv4-nix-vector-helper.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Send packets across a grid routed by nix-vectors, and check
+ * that they follow shortest paths, also when the nix-vector cache is
+ * smaller than the number of destinations, and that they go around an
+ * interface which was brought down.
+ */
+class NixVectorRoutingGridTestCase : public TestCase
+{
+public:
+  NixVectorRoutingGridTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * \brief Send a packet from the first node to every other node.
+   */
+  void SendToAll (void);
+
+  /**
+   * \brief Receive the packets of a node.
+   * \param socket the receiving socket
+   */
+  void Receive (Ptr<Socket> socket);
+
+  static const uint32_t SIZE = 4;          //!< the grid has SIZE x SIZE nodes
+  NodeContainer m_nodes;                   //!< the nodes
+  std::vector<Ipv4Address> m_addresses;    //!< an address of each node
+  Ptr<Socket> m_sender;                    //!< the socket of the first node
+  std::vector<uint32_t> m_received;        //!< packets received, by node
+  std::vector<uint32_t> m_ttl;             //!< TTL of the last packet, by node
+};
+
+NixVectorRoutingGridTestCase::NixVectorRoutingGridTestCase ()
+  : TestCase ("Nix-vector routing on a grid")
+{
+}
+
+void
+NixVectorRoutingGridTestCase::SendToAll (void)
+{
+  for (uint32_t i = 1; i < m_nodes.GetN (); i++)
+    {
+      m_sender->SendTo (Create<Packet> (100), 0, InetSocketAddress (m_addresses[i], 1234));
+    }
+}
+
+void
+NixVectorRoutingGridTestCase::Receive (Ptr<Socket> socket)
+{
+  uint32_t node = socket->GetNode ()->GetId () - m_nodes.Get (0)->GetId ();
+  Ptr<Packet> packet;
+  while ((packet = socket->Recv ()))
+    {
+      m_received[node]++;
+      SocketIpTtlTag tag;
+      if (packet->RemovePacketTag (tag))
+        {
+          m_ttl[node] = tag.GetTtl ();
+        }
+    }
+}
+
+void
+NixVectorRoutingGridTestCase::DoRun (void)
+{
+  // fewer cache entries than destinations
+  Config::SetGlobal ("NixVectorCacheSize", UintegerValue (3));
+
+  m_nodes.Create (SIZE * SIZE);
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (nixRouting);
+  stack.Install (m_nodes);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+  m_addresses.resize (m_nodes.GetN ());
+  Ipv4InterfaceContainer down;
+  for (uint32_t row = 0; row < SIZE; row++)
+    {
+      for (uint32_t column = 0; column < SIZE; column++)
+        {
+          uint32_t node = row * SIZE + column;
+          for (uint32_t direction = 0; direction < 2; direction++)
+            {
+              uint32_t neighbor = direction ? node + SIZE : node + 1;
+              if ((direction && row == SIZE - 1) || (!direction && column == SIZE - 1))
+                {
+                  continue;
+                }
+              NetDeviceContainer devices = simple.Install (NodeContainer (m_nodes.Get (node), m_nodes.Get (neighbor)));
+              Ipv4InterfaceContainer interfaces = address.Assign (devices);
+              address.NewNetwork ();
+              m_addresses[node] = interfaces.GetAddress (0);
+              m_addresses[neighbor] = interfaces.GetAddress (1);
+              if (node == 0 && direction == 0)
+                {
+                  down = interfaces;
+                }
+            }
+        }
+    }
+
+  m_received.assign (m_nodes.GetN (), 0);
+  m_ttl.assign (m_nodes.GetN (), 0);
+  for (uint32_t i = 1; i < m_nodes.GetN (); i++)
+    {
+      Ptr<Socket> socket = Socket::CreateSocket (m_nodes.Get (i), UdpSocketFactory::GetTypeId ());
+      socket->Bind (InetSocketAddress (Ipv4Address::GetAny (), 1234));
+      socket->SetIpRecvTtl (true);
+      socket->SetRecvCallback (MakeCallback (&NixVectorRoutingGridTestCase::Receive, this));
+    }
+  m_sender = Socket::CreateSocket (m_nodes.Get (0), UdpSocketFactory::GetTypeId ());
+  m_sender->SetIpTtl (64);
+
+  Simulator::Schedule (Seconds (1), &NixVectorRoutingGridTestCase::SendToAll, this);
+  Simulator::Schedule (Seconds (2), &NixVectorRoutingGridTestCase::SendToAll, this);
+  Simulator::Stop (Seconds (3));
+  Simulator::Run ();
+
+  for (uint32_t i = 1; i < m_nodes.GetN (); i++)
+    {
+      uint32_t hops = i / SIZE + i % SIZE;
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], 2, "Packets lost on the way to node " << i);
+      NS_TEST_ASSERT_MSG_EQ (m_ttl[i], 64 - (hops - 1), "Path to node " << i << " is not a shortest path");
+    }
+
+  // bring the link from the first node to its right neighbor down: the
+  // packets now leave through the other link of the first node
+  down.Get (0).first->SetDown (down.Get (0).second);
+  down.Get (1).first->SetDown (down.Get (1).second);
+  m_received.assign (m_nodes.GetN (), 0);
+  Simulator::Schedule (Seconds (1), &NixVectorRoutingGridTestCase::SendToAll, this);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+
+  for (uint32_t i = 1; i < m_nodes.GetN (); i++)
+    {
+      // the nodes of the first row are now reached through the second row
+      uint32_t hops = i < SIZE ? i + 2 : i / SIZE + i % SIZE;
+      NS_TEST_ASSERT_MSG_EQ (m_received[i], 1, "Packet lost on the way to node " << i);
+      NS_TEST_ASSERT_MSG_EQ (m_ttl[i], 64 - (hops - 1), "Path to node " << i << " is not a shortest path");
+    }
+
+  Simulator::Destroy ();
+  Config::SetGlobal ("NixVectorCacheSize", UintegerValue (100000));
+}
+
+/**
+ * \ingroup nix-vector-routing
+ * \ingroup tests
+ *
+ * \brief Nix-vector routing TestSuite
+ */
+class NixVectorRoutingTestSuite : public TestSuite
+{
+public:
+  NixVectorRoutingTestSuite ()
+    : TestSuite ("nix-vector-routing", UNIT)
+  {
+    AddTestCase (new NixVectorRoutingGridTestCase, TestCase::QUICK);
+  }
+};
+
+static NixVectorRoutingTestSuite g_nixVectorRoutingTestSuite;
@@ -179,6 +179,21 @@ RoutingProtocol::GetTypeId (void)
                                     OLSR_WILL_DEFAULT, "default",
                                     OLSR_WILL_HIGH, "high",
                                     OLSR_WILL_ALWAYS, "always"))
+    .AddAttribute ("TimerTick",
+                   "If not zero, the periodic message timers and the tuple "
+                   "expiration timers of all the OLSR instances are run by "
+                   "a shared timer wheel, in batches of this duration. "
+                   "A timer may then expire up to one tick late.",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&RoutingProtocol::m_timerTick),
+                   MakeTimeChecker (Seconds (0)))
+    .AddAttribute ("VerifyComputations",
+                   "If true, each MPR set or routing table computation skipped "
+                   "because its inputs did not change is also run from scratch, "
+                   "and the simulation aborts if the results differ. For testing.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RoutingProtocol::m_verifyComputations),
+                   MakeBooleanChecker ())
     .AddTraceSource ("Rx", "Receive OLSR packet.",
                      MakeTraceSourceAccessor (&RoutingProtocol::m_rxPacketTrace),
                      "ns3::olsr::RoutingProtocol::PacketTxRxTracedCallback")
@@ -195,6 +210,10 @@ RoutingProtocol::GetTypeId (void)
 
 RoutingProtocol::RoutingProtocol ()
   : m_routingTableAssociation (0),
+  m_timerWheelClient (0),
+  m_verifyComputations (false),
+  m_mprInputsValid (false),
+  m_routingInputsValid (false),
   m_ipv4 (0),
   m_helloTimer (Timer::CANCEL_ON_DESTROY),
   m_tcTimer (Timer::CANCEL_ON_DESTROY),
@@ -239,6 +258,11 @@ void RoutingProtocol::DoDispose ()
   m_ipv4 = 0;
   m_hnaRoutingTable = 0;
   m_routingTableAssociation = 0;
+  if (m_timerWheel != 0)
+    {
+      m_timerWheel->RemoveClient (m_timerWheelClient);
+      m_timerWheel = 0;
+    }
 
   for (std::map< Ptr<Socket>, Ipv4InterfaceAddress >::iterator iter = m_socketAddresses.begin ();
        iter != m_socketAddresses.end (); iter++)
@@ -358,6 +382,11 @@ void RoutingProtocol::DoInitialize ()
 
   if (canRunOlsr)
     {
+      if (!m_timerTick.IsZero ())
+        {
+          m_timerWheel = TimerWheel::GetShared ("ns3::olsr::RoutingProtocol", m_timerTick);
+          m_timerWheelClient = m_timerWheel->AddClient ();
+        }
       HelloTimerExpire ();
       TcTimerExpire ();
       MidTimerExpire ();
@@ -596,6 +625,30 @@ RoutingProtocol::MprComputation ()
 {
   NS_LOG_FUNCTION (this);
 
+  // The MPR set only depends on the neighbor and 2-hop neighbor sets,
+  // which HELLO messages mostly refresh without changing them.
+  if (m_mprInputsValid
+      && m_mprNeighbors == m_state.GetNeighbors ()
+      && m_mprTwoHopNeighbors == m_state.GetTwoHopNeighbors ())
+    {
+      NS_LOG_LOGIC ("Neighbor sets unchanged, MPR set kept");
+      if (m_verifyComputations && ComputeMprSet () != m_state.GetMprSet ())
+        {
+          NS_FATAL_ERROR ("Node " << m_mainAddress << ": the kept MPR set differs from a new one");
+        }
+      return;
+    }
+  m_state.SetMprSet (ComputeMprSet ());
+  m_mprNeighbors = m_state.GetNeighbors ();
+  m_mprTwoHopNeighbors = m_state.GetTwoHopNeighbors ();
+  m_mprInputsValid = true;
+}
+
+MprSet
+RoutingProtocol::ComputeMprSet ()
+{
+  NS_LOG_FUNCTION (this);
+
   // MPR computation should be done for each interface. See section 8.3.1
   // (RFC 3626) for details.
   MprSet mprSet;
@@ -883,7 +936,7 @@ RoutingProtocol::MprComputation ()
   }
 #endif  //NS3_LOG_ENABLE
 
-  m_state.SetMprSet (mprSet);
+  return mprSet;
 }
 
 Ipv4Address
@@ -904,6 +957,110 @@ RoutingProtocol::GetMainAddress (Ipv4Address iface_addr) const
 
 void
 RoutingProtocol::RoutingTableComputation ()
+{
+  // The routing table is computed after every OLSR packet, most of which
+  // only refresh the tuples.
+  if (!RoutingTableInputsChanged ())
+    {
+      NS_LOG_LOGIC ("Node " << m_mainAddress << ": routing tuples unchanged, routing table kept");
+      if (m_verifyComputations)
+        {
+          VerifyRoutingTable ();
+        }
+      return;
+    }
+  SaveRoutingTableInputs ();
+  ComputeRoutingTable ();
+  m_routingTableChanged (GetSize ());
+}
+
+bool
+RoutingProtocol::RoutingTableInputsChanged () const
+{
+  if (!m_routingInputsValid)
+    {
+      return true;
+    }
+  const LinkSet &linkSet = m_state.GetLinks ();
+  if (!(m_routingLinks == linkSet))
+    {
+      return true;
+    }
+  for (uint32_t i = 0; i < linkSet.size (); i++)
+    {
+      if (m_routingLinksValid[i] != (linkSet[i].time >= Simulator::Now ()))
+        {
+          return true;
+        }
+    }
+  return !(m_routingNeighbors == m_state.GetNeighbors ()
+           && m_routingTwoHopNeighbors == m_state.GetTwoHopNeighbors ()
+           && m_routingTopology == m_state.GetTopologySet ()
+           && m_routingIfaceAssoc == m_state.GetIfaceAssocSet ()
+           && m_routingAssociationSet == m_state.GetAssociationSet ()
+           && m_routingAssociations == m_state.GetAssociations ());
+}
+
+void
+RoutingProtocol::SaveRoutingTableInputs ()
+{
+  m_routingLinks = m_state.GetLinks ();
+  m_routingLinksValid.resize (m_routingLinks.size ());
+  for (uint32_t i = 0; i < m_routingLinks.size (); i++)
+    {
+      m_routingLinksValid[i] = m_routingLinks[i].time >= Simulator::Now ();
+    }
+  m_routingNeighbors = m_state.GetNeighbors ();
+  m_routingTwoHopNeighbors = m_state.GetTwoHopNeighbors ();
+  m_routingTopology = m_state.GetTopologySet ();
+  m_routingIfaceAssoc = m_state.GetIfaceAssocSet ();
+  m_routingAssociationSet = m_state.GetAssociationSet ();
+  m_routingAssociations = m_state.GetAssociations ();
+  m_routingInputsValid = true;
+}
+
+void
+RoutingProtocol::VerifyRoutingTable ()
+{
+  std::map<Ipv4Address, RoutingTableEntry> table = m_table;
+  std::vector<Ipv4RoutingTableEntry> hnaRoutes;
+  std::vector<uint32_t> hnaMetrics;
+  for (uint32_t i = 0; i < m_hnaRoutingTable->GetNRoutes (); i++)
+    {
+      hnaRoutes.push_back (m_hnaRoutingTable->GetRoute (i));
+      hnaMetrics.push_back (m_hnaRoutingTable->GetMetric (i));
+    }
+
+  ComputeRoutingTable ();
+
+  bool same = table.size () == m_table.size ()
+    && hnaRoutes.size () == m_hnaRoutingTable->GetNRoutes ();
+  for (std::map<Ipv4Address, RoutingTableEntry>::const_iterator i = table.begin (), j = m_table.begin ();
+       same && i != table.end (); i++, j++)
+    {
+      same = i->first == j->first
+        && i->second.destAddr == j->second.destAddr
+        && i->second.nextAddr == j->second.nextAddr
+        && i->second.interface == j->second.interface
+        && i->second.distance == j->second.distance;
+    }
+  for (uint32_t i = 0; same && i < hnaRoutes.size (); i++)
+    {
+      Ipv4RoutingTableEntry route = m_hnaRoutingTable->GetRoute (i);
+      same = route.GetDest () == hnaRoutes[i].GetDest ()
+        && route.GetDestNetworkMask () == hnaRoutes[i].GetDestNetworkMask ()
+        && route.GetGateway () == hnaRoutes[i].GetGateway ()
+        && route.GetInterface () == hnaRoutes[i].GetInterface ()
+        && m_hnaRoutingTable->GetMetric (i) == hnaMetrics[i];
+    }
+  if (!same)
+    {
+      NS_FATAL_ERROR ("Node " << m_mainAddress << ": the kept routing table differs from a new one");
+    }
+}
+
+void
+RoutingProtocol::ComputeRoutingTable ()
 {
   NS_LOG_DEBUG (Simulator::Now ().GetSeconds () << " s: Node " << m_mainAddress
                                                 << ": RoutingTableComputation begin...");
@@ -1215,7 +1372,6 @@ RoutingProtocol::RoutingTableComputation ()
     }
 
   NS_LOG_DEBUG ("Node " << m_mainAddress << ": RoutingTableComputation end.");
-  m_routingTableChanged (GetSize ());
 }
 
 
@@ -1340,11 +1496,11 @@ RoutingProtocol::ProcessTc (const olsr::MessageHeader &msg,
           AddTopologyTuple (topologyTuple);
 
           // Schedules topology tuple deletion
-          m_events.Track (Simulator::Schedule (DELAY (topologyTuple.expirationTime),
-                                               &RoutingProtocol::TopologyTupleTimerExpire,
-                                               this,
-                                               topologyTuple.destAddr,
-                                               topologyTuple.lastAddr));
+          ScheduleExpiration (DELAY (topologyTuple.expirationTime),
+                              MakeEvent (&RoutingProtocol::TopologyTupleTimerExpire,
+                                         this,
+                                         topologyTuple.destAddr,
+                                         topologyTuple.lastAddr));
         }
     }
 
@@ -1409,8 +1565,8 @@ RoutingProtocol::ProcessMid (const olsr::MessageHeader &msg,
           AddIfaceAssocTuple (tuple);
           NS_LOG_LOGIC ("New IfaceAssoc added: " << tuple);
           // Schedules iface association tuple deletion
-          Simulator::Schedule (DELAY (tuple.time),
-                               &RoutingProtocol::IfaceAssocTupleTimerExpire, this, tuple.ifaceAddr);
+          ScheduleExpiration (DELAY (tuple.time),
+                              MakeEvent (&RoutingProtocol::IfaceAssocTupleTimerExpire, this, tuple.ifaceAddr));
         }
     }
 
@@ -1484,9 +1640,9 @@ RoutingProtocol::ProcessHna (const olsr::MessageHeader &msg,
           AddAssociationTuple (assocTuple);
 
           //Schedule Association Tuple deletion
-          Simulator::Schedule (DELAY (assocTuple.expirationTime),
-                               &RoutingProtocol::AssociationTupleTimerExpire, this,
-                               assocTuple.gatewayAddr,assocTuple.networkAddr,assocTuple.netmask);
+          ScheduleExpiration (DELAY (assocTuple.expirationTime),
+                              MakeEvent (&RoutingProtocol::AssociationTupleTimerExpire, this,
+                                         assocTuple.gatewayAddr,assocTuple.networkAddr,assocTuple.netmask));
         }
 
     }
@@ -1554,9 +1710,9 @@ RoutingProtocol::ForwardDefault (olsr::MessageHeader olsrMessage,
       newDup.ifaceList.push_back (localIface);
       AddDuplicateTuple (newDup);
       // Schedule dup tuple deletion
-      Simulator::Schedule (OLSR_DUP_HOLD_TIME,
-                           &RoutingProtocol::DupTupleTimerExpire, this,
-                           newDup.address, newDup.sequenceNumber);
+      ScheduleExpiration (OLSR_DUP_HOLD_TIME,
+                          MakeEvent (&RoutingProtocol::DupTupleTimerExpire, this,
+                                     newDup.address, newDup.sequenceNumber));
     }
 }
 
@@ -2064,9 +2220,9 @@ RoutingProtocol::LinkSensing (const olsr::MessageHeader &msg,
   if (created)
     {
       LinkTupleAdded (*link_tuple, hello.willingness);
-      m_events.Track (Simulator::Schedule (DELAY (std::min (link_tuple->time, link_tuple->symTime)),
-                                           &RoutingProtocol::LinkTupleTimerExpire, this,
-                                           link_tuple->neighborIfaceAddr));
+      ScheduleExpiration (DELAY (std::min (link_tuple->time, link_tuple->symTime)),
+                          MakeEvent (&RoutingProtocol::LinkTupleTimerExpire, this,
+                                     link_tuple->neighborIfaceAddr));
     }
   NS_LOG_DEBUG ("@" << now.GetSeconds () << ": Olsr node " << m_mainAddress
                     << ": LinkSensing END");
@@ -2158,10 +2314,10 @@ RoutingProtocol::PopulateTwoHopNeighborSet (const olsr::MessageHeader &msg,
                       new_nb2hop_tuple.expirationTime = now + msg.GetVTime ();
                       AddTwoHopNeighborTuple (new_nb2hop_tuple);
                       // Schedules nb2hop tuple deletion
-                      m_events.Track (Simulator::Schedule (DELAY (new_nb2hop_tuple.expirationTime),
-                                                           &RoutingProtocol::Nb2hopTupleTimerExpire, this,
-                                                           new_nb2hop_tuple.neighborMainAddr,
-                                                           new_nb2hop_tuple.twoHopNeighborAddr));
+                      ScheduleExpiration (DELAY (new_nb2hop_tuple.expirationTime),
+                                          MakeEvent (&RoutingProtocol::Nb2hopTupleTimerExpire, this,
+                                                     new_nb2hop_tuple.neighborMainAddr,
+                                                     new_nb2hop_tuple.twoHopNeighborAddr));
                     }
                   else
                     {
@@ -2229,10 +2385,9 @@ RoutingProtocol::PopulateMprSelectorSet (const olsr::MessageHeader &msg,
                       AddMprSelectorTuple (mprsel_tuple);
 
                       // Schedules mpr selector tuple deletion
-                      m_events.Track (Simulator::Schedule
-                                        (DELAY (mprsel_tuple.expirationTime),
-                                        &RoutingProtocol::MprSelTupleTimerExpire, this,
-                                        mprsel_tuple.mainAddr));
+                      ScheduleExpiration (DELAY (mprsel_tuple.expirationTime),
+                                          MakeEvent (&RoutingProtocol::MprSelTupleTimerExpire, this,
+                                                     mprsel_tuple.mainAddr));
                     }
                   else
                     {
@@ -2563,11 +2718,37 @@ uint16_t RoutingProtocol::GetMessageSequenceNumber ()
   return m_messageSequenceNumber;
 }
 
+void
+RoutingProtocol::ScheduleExpiration (Time delay, EventImpl *event)
+{
+  if (m_timerWheel != 0)
+    {
+      m_timerWheel->Schedule (m_timerWheelClient, delay, Ptr<EventImpl> (event, false));
+    }
+  else
+    {
+      m_events.Track (Simulator::Schedule (delay, Ptr<EventImpl> (event, false)));
+    }
+}
+
+void
+RoutingProtocol::ScheduleTimer (Timer &timer, Time delay, void (RoutingProtocol::*expire)(void))
+{
+  if (m_timerWheel != 0)
+    {
+      m_timerWheel->Schedule (m_timerWheelClient, delay, expire, this);
+    }
+  else
+    {
+      timer.Schedule (delay);
+    }
+}
+
 void
 RoutingProtocol::HelloTimerExpire ()
 {
   SendHello ();
-  m_helloTimer.Schedule (m_helloInterval);
+  ScheduleTimer (m_helloTimer, m_helloInterval, &RoutingProtocol::HelloTimerExpire);
 }
 
 void
@@ -2581,14 +2762,14 @@ RoutingProtocol::TcTimerExpire ()
     {
       NS_LOG_DEBUG ("Not sending any TC, no one selected me as MPR.");
     }
-  m_tcTimer.Schedule (m_tcInterval);
+  ScheduleTimer (m_tcTimer, m_tcInterval, &RoutingProtocol::TcTimerExpire);
 }
 
 void
 RoutingProtocol::MidTimerExpire ()
 {
   SendMid ();
-  m_midTimer.Schedule (m_midInterval);
+  ScheduleTimer (m_midTimer, m_midInterval, &RoutingProtocol::MidTimerExpire);
 }
 
 void
@@ -2602,7 +2783,7 @@ RoutingProtocol::HnaTimerExpire ()
     {
       NS_LOG_DEBUG ("Not sending any HNA, no associations to advertise.");
     }
-  m_hnaTimer.Schedule (m_hnaInterval);
+  ScheduleTimer (m_hnaTimer, m_hnaInterval, &RoutingProtocol::HnaTimerExpire);
 }
 
 void
@@ -2620,9 +2801,9 @@ RoutingProtocol::DupTupleTimerExpire (Ipv4Address address, uint16_t sequenceNumb
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::DupTupleTimerExpire, this,
-                                           address, sequenceNumber));
+      ScheduleExpiration (DELAY (tuple->expirationTime),
+                          MakeEvent (&RoutingProtocol::DupTupleTimerExpire, this,
+                                     address, sequenceNumber));
     }
 }
 
@@ -2652,15 +2833,15 @@ RoutingProtocol::LinkTupleTimerExpire (Ipv4Address neighborIfaceAddr)
           NeighborLoss (*tuple);
         }
 
-      m_events.Track (Simulator::Schedule (DELAY (tuple->time),
-                                           &RoutingProtocol::LinkTupleTimerExpire, this,
-                                           neighborIfaceAddr));
+      ScheduleExpiration (DELAY (tuple->time),
+                          MakeEvent (&RoutingProtocol::LinkTupleTimerExpire, this,
+                                     neighborIfaceAddr));
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (std::min (tuple->time, tuple->symTime)),
-                                           &RoutingProtocol::LinkTupleTimerExpire, this,
-                                           neighborIfaceAddr));
+      ScheduleExpiration (DELAY (std::min (tuple->time, tuple->symTime)),
+                          MakeEvent (&RoutingProtocol::LinkTupleTimerExpire, this,
+                                     neighborIfaceAddr));
     }
 }
 
@@ -2679,9 +2860,9 @@ RoutingProtocol::Nb2hopTupleTimerExpire (Ipv4Address neighborMainAddr, Ipv4Addre
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::Nb2hopTupleTimerExpire,
-                                           this, neighborMainAddr, twoHopNeighborAddr));
+      ScheduleExpiration (DELAY (tuple->expirationTime),
+                          MakeEvent (&RoutingProtocol::Nb2hopTupleTimerExpire,
+                                     this, neighborMainAddr, twoHopNeighborAddr));
     }
 }
 
@@ -2699,9 +2880,9 @@ RoutingProtocol::MprSelTupleTimerExpire (Ipv4Address mainAddr)
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::MprSelTupleTimerExpire,
-                                           this, mainAddr));
+      ScheduleExpiration (DELAY (tuple->expirationTime),
+                          MakeEvent (&RoutingProtocol::MprSelTupleTimerExpire,
+                                     this, mainAddr));
     }
 }
 
@@ -2719,9 +2900,9 @@ RoutingProtocol::TopologyTupleTimerExpire (Ipv4Address destAddr, Ipv4Address las
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::TopologyTupleTimerExpire,
-                                           this, tuple->destAddr, tuple->lastAddr));
+      ScheduleExpiration (DELAY (tuple->expirationTime),
+                          MakeEvent (&RoutingProtocol::TopologyTupleTimerExpire,
+                                     this, tuple->destAddr, tuple->lastAddr));
     }
 }
 
@@ -2739,9 +2920,9 @@ RoutingProtocol::IfaceAssocTupleTimerExpire (Ipv4Address ifaceAddr)
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->time),
-                                           &RoutingProtocol::IfaceAssocTupleTimerExpire,
-                                           this, ifaceAddr));
+      ScheduleExpiration (DELAY (tuple->time),
+                          MakeEvent (&RoutingProtocol::IfaceAssocTupleTimerExpire,
+                                     this, ifaceAddr));
     }
 }
 
@@ -2759,9 +2940,9 @@ RoutingProtocol::AssociationTupleTimerExpire (Ipv4Address gatewayAddr, Ipv4Addre
     }
   else
     {
-      m_events.Track (Simulator::Schedule (DELAY (tuple->expirationTime),
-                                           &RoutingProtocol::AssociationTupleTimerExpire,
-                                           this, gatewayAddr, networkAddr, netmask));
+      ScheduleExpiration (DELAY (tuple->expirationTime),
+                          MakeEvent (&RoutingProtocol::AssociationTupleTimerExpire,
+                                     this, gatewayAddr, networkAddr, netmask));
     }
 }
 
@@ -2998,18 +3179,22 @@ bool RoutingProtocol::RouteInput  (Ptr<const Packet> p,
 void
 RoutingProtocol::NotifyInterfaceUp (uint32_t i)
 {
+  m_routingInputsValid = false;
 }
 void
 RoutingProtocol::NotifyInterfaceDown (uint32_t i)
 {
+  m_routingInputsValid = false;
 }
 void
 RoutingProtocol::NotifyAddAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
+  m_routingInputsValid = false;
 }
 void
 RoutingProtocol::NotifyRemoveAddress (uint32_t interface, Ipv4InterfaceAddress address)
 {
+  m_routingInputsValid = false;
 }
 
 
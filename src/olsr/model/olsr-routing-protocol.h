@@ -35,6 +35,7 @@
 #include "ns3/event-garbage-collector.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/timer.h"
+#include "ns3/timer-wheel.h"
 #include "ns3/traced-callback.h"
 #include "ns3/ipv4.h"
 #include "ns3/ipv4-routing-protocol.h"
@@ -202,6 +203,24 @@ private:
 
   EventGarbageCollector m_events; //!< Running events.
 
+  Time m_timerTick;                  //!< The tick of the shared timer wheel, or zero to use one event per timer.
+  Ptr<TimerWheel> m_timerWheel;      //!< The timer wheel shared by the OLSR instances, if any.
+  uint32_t m_timerWheelClient;       //!< The identifier of this instance in m_timerWheel.
+
+  bool m_verifyComputations;         //!< Check the skipped computations against full ones.
+  bool m_mprInputsValid;             //!< Whether the inputs of the last MPR computation are saved.
+  NeighborSet m_mprNeighbors;        //!< The neighbor set of the last MPR computation.
+  TwoHopNeighborSet m_mprTwoHopNeighbors; //!< The 2-hop neighbor set of the last MPR computation.
+  bool m_routingInputsValid;         //!< Whether the inputs of the last routing table computation are saved.
+  LinkSet m_routingLinks;            //!< The link set of the last routing table computation.
+  std::vector<bool> m_routingLinksValid; //!< Whether each link of m_routingLinks had not expired.
+  NeighborSet m_routingNeighbors;    //!< The neighbor set of the last routing table computation.
+  TwoHopNeighborSet m_routingTwoHopNeighbors; //!< The 2-hop neighbor set of the last routing table computation.
+  TopologySet m_routingTopology;     //!< The topology set of the last routing table computation.
+  IfaceAssocSet m_routingIfaceAssoc; //!< The interface association set of the last routing table computation.
+  AssociationSet m_routingAssociationSet; //!< The association set of the last routing table computation.
+  Associations m_routingAssociations; //!< The local associations of the last routing table computation.
+
   uint16_t m_packetSequenceNumber;    //!< Packets sequence number counter.
   uint16_t m_messageSequenceNumber;   //!< Messages sequence number counter.
   uint16_t m_ansn;  //!< Advertised Neighbor Set sequence number.
@@ -341,14 +360,49 @@ private:
 
   /**
    * \brief Computates MPR set of a node following \RFC{3626} hints.
+   *
+   * The computation is skipped when the neighbor and 2-hop neighbor sets
+   * did not change since the last one.
    */
   void MprComputation ();
 
+  /**
+   * \brief Computes the MPR set of a node from scratch.
+   * \return The MPR set.
+   */
+  MprSet ComputeMprSet ();
+
   /**
    * \brief Creates the routing table of the node following \RFC{3626} hints.
+   *
+   * The computation is skipped when none of the tuples it uses changed
+   * since the last one, and no link used by it expired.
    */
   void RoutingTableComputation ();
 
+  /**
+   * \brief Creates the routing table and the HNA routing table from scratch.
+   */
+  void ComputeRoutingTable ();
+
+  /**
+   * \brief Checks whether the inputs of the routing table computation
+   * changed since the last one.
+   * \return true if they changed, or if the last ones were not saved.
+   */
+  bool RoutingTableInputsChanged () const;
+
+  /**
+   * \brief Saves the inputs of the routing table computation.
+   */
+  void SaveRoutingTableInputs ();
+
+  /**
+   * \brief Recomputes the routing tables from scratch, and aborts the
+   * simulation if they differ from the current ones.
+   */
+  void VerifyRoutingTable ();
+
   /**
    * \brief Gets the main address associated with a given interface address.
    * \param iface_addr the interface address.
@@ -363,6 +417,25 @@ private:
    */
   bool UsesNonOlsrOutgoingInterface (const Ipv4RoutingTableEntry &route);
 
+  /**
+   * \brief Schedule the expiration of a tuple, with the shared timer wheel
+   * if there is one.
+   *
+   * \param delay The delay before the expiration.
+   * \param event The expiration handler.
+   */
+  void ScheduleExpiration (Time delay, EventImpl *event);
+
+  /**
+   * \brief Schedule a periodic timer, with the shared timer wheel if
+   * there is one.
+   *
+   * \param timer The timer.
+   * \param delay The delay before the timer expires.
+   * \param expire The handler of the timer.
+   */
+  void ScheduleTimer (Timer &timer, Time delay, void (RoutingProtocol::*expire)(void));
+
   // Timer handlers
   Timer m_helloTimer; //!< Timer for the HELLO message.
   /**
@@ -23,6 +23,15 @@
 #include "ns3/test.h"
 #include "ns3/olsr-routing-protocol.h"
 #include "ns3/ipv4-header.h"
+#include "ns3/olsr-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/error-model.h"
+#include "ns3/simulator.h"
+#include "ns3/boolean.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
 
 /********** Willingness **********/
 
@@ -167,6 +176,121 @@ OlsrMprTestCase::DoRun ()
   NS_TEST_EXPECT_MSG_EQ ((mpr.find ("10.0.0.9") == mpr.end ()), true, "Node 1 must NOT select node 8 as MPR");
 }
 
+/// Testcase for skipping the computations whose inputs did not change
+class OlsrComputationTestCase : public TestCase
+{
+public:
+  OlsrComputationTestCase ();
+  /// \brief Run test case
+  virtual void DoRun (void);
+  /**
+   * \brief Count the received packets.
+   * \param header the packet header
+   * \param messages the messages
+   */
+  void Rx (const PacketHeader &header, const MessageList &messages);
+  /**
+   * \brief Count the routing table computations.
+   * \param size the size of the routing table
+   */
+  void RoutingTableChanged (uint32_t size);
+
+  uint32_t m_rx;            //!< The packets received
+  uint32_t m_computations;  //!< The routing table computations
+};
+
+OlsrComputationTestCase::OlsrComputationTestCase ()
+  : TestCase ("Check that OLSR skips the computations whose inputs did not change"),
+    m_rx (0),
+    m_computations (0)
+{
+}
+
+void
+OlsrComputationTestCase::Rx (const PacketHeader &header, const MessageList &messages)
+{
+  m_rx++;
+}
+
+void
+OlsrComputationTestCase::RoutingTableChanged (uint32_t size)
+{
+  m_computations++;
+}
+
+void
+OlsrComputationTestCase::DoRun ()
+{
+  /*
+   * 0 -- 1 -- 2 -- 3 -- 4 -- 0
+   *
+   * Node 1 loses the packets of node 0 between 20 and 40 s: node 0 first
+   * sees an asymmetric link, then routes through node 4.  Each skipped
+   * computation is checked against a full one.
+   */
+  NodeContainer nodes;
+  nodes.Create (5);
+  OlsrHelper olsr;
+  olsr.Set ("VerifyComputations", BooleanValue (true));
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (olsr);
+  stack.Install (nodes);
+  SimpleNetDeviceHelper simple;
+  simple.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  Ipv4AddressHelper address ("10.1.0.0", "255.255.255.0");
+  Ptr<NetDevice> lossy;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      NetDeviceContainer devices = simple.Install (NodeContainer (nodes.Get (i), nodes.Get ((i + 1) % nodes.GetN ())));
+      address.Assign (devices);
+      address.NewNetwork ();
+      if (i == 0)
+        {
+          lossy = devices.Get (1);
+        }
+    }
+  Ptr<RateErrorModel> errorModel = CreateObject<RateErrorModel> ();
+  errorModel->SetRate (1);
+  errorModel->SetUnit (RateErrorModel::ERROR_UNIT_PACKET);
+  errorModel->Disable ();
+  lossy->SetAttribute ("ReceiveErrorModel", PointerValue (errorModel));
+  Simulator::Schedule (Seconds (20), &ErrorModel::Enable, errorModel);
+  Simulator::Schedule (Seconds (40), &ErrorModel::Disable, errorModel);
+
+  Ptr<RoutingProtocol> protocol = DynamicCast<RoutingProtocol> (nodes.Get (0)->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  protocol->TraceConnectWithoutContext ("Rx", MakeCallback (&OlsrComputationTestCase::Rx, this));
+  protocol->TraceConnectWithoutContext ("RoutingTableChanged",
+                                        MakeCallback (&OlsrComputationTestCase::RoutingTableChanged, this));
+
+  Simulator::Stop (Seconds (30));
+  Simulator::Run ();
+  std::vector<RoutingTableEntry> entries = protocol->GetRoutingTableEntries ();
+  uint32_t distance = 0;
+  for (std::vector<RoutingTableEntry>::const_iterator i = entries.begin (); i != entries.end (); i++)
+    {
+      if (i->destAddr == Ipv4Address ("10.1.0.2"))
+        {
+          distance = i->distance;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (distance, 4, "Node 1 must be reached through node 4 while the link is lossy");
+
+  Simulator::Stop (Seconds (30));
+  Simulator::Run ();
+  entries = protocol->GetRoutingTableEntries ();
+  for (std::vector<RoutingTableEntry>::const_iterator i = entries.begin (); i != entries.end (); i++)
+    {
+      if (i->destAddr == Ipv4Address ("10.1.0.2"))
+        {
+          distance = i->distance;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (distance, 1, "Node 1 must be a neighbor again");
+  NS_TEST_EXPECT_MSG_GT (m_computations, 0, "No routing table computed");
+  NS_TEST_EXPECT_MSG_LT (m_computations * 2, m_rx, "Routing table computed for most packets");
+  Simulator::Destroy ();
+}
+
 static class OlsrProtocolTestSuite : public TestSuite
 {
 public:
@@ -177,4 +301,5 @@ OlsrProtocolTestSuite::OlsrProtocolTestSuite ()
   : TestSuite ("routing-olsr", UNIT)
 {
   AddTestCase (new OlsrMprTestCase (), TestCase::QUICK);
+  AddTestCase (new OlsrComputationTestCase (), TestCase::QUICK);
 }
@@ -20,6 +20,7 @@
 #include "point-to-point-net-device.h"
 #include "ns3/trace-source-accessor.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 
@@ -106,6 +107,38 @@ PointToPointChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointChannel::TransmitStartBurst (
+  Ptr<PacketBurst> burst,
+  Ptr<PointToPointNetDevice> src,
+  std::vector<Time> const &offsets)
+{
+  NS_LOG_FUNCTION (this << burst << src);
+  NS_ASSERT (burst->GetNPackets () == offsets.size ());
+  NS_ASSERT (!offsets.empty ());
+
+  NS_ASSERT (m_link[0].m_state != INITIALIZING);
+  NS_ASSERT (m_link[1].m_state != INITIALIZING);
+
+  uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+
+  Simulator::ScheduleWithContext (m_link[wire].m_dst->GetNode ()->GetId (),
+                                  offsets.back () + m_delay, &PointToPointNetDevice::ReceiveBurst,
+                                  m_link[wire].m_dst, burst);
+
+  if (!m_txrxPointToPoint.IsEmpty ())
+    {
+      // every packet of the burst is received with the last one
+      Time rxTime = offsets.back () + m_delay;
+      std::vector<Time>::const_iterator offset = offsets.begin ();
+      for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i, ++offset)
+        {
+          m_txrxPointToPoint (*i, src, m_link[wire].m_dst, *offset, rxTime);
+        }
+    }
+  return true;
+}
+
 uint32_t 
 PointToPointChannel::GetNDevices (void) const
 {
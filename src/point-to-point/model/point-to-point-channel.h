@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_CHANNEL_H
 
 #include <list>
+#include <vector>
 #include "ns3/channel.h"
 #include "ns3/ptr.h"
 #include "ns3/nstime.h"
@@ -30,6 +31,7 @@ namespace ns3 {
 
 class PointToPointNetDevice;
 class Packet;
+class PacketBurst;
 
 /**
  * \ingroup point-to-point
@@ -80,6 +82,22 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src, Time txTime);
 
+  /**
+   * \brief Transmit a burst of back to back packets over this channel
+   *
+   * The whole burst is delivered to the peer device with a single event,
+   * scheduled when the last bit of the last packet arrives, which is the
+   * receive time the TxRxPointToPoint trace reports for every packet.
+   *
+   * \param burst Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param offsets For each packet, the time from now at which its last
+   * bit is transmitted
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitStartBurst (Ptr<PacketBurst> burst, Ptr<PointToPointNetDevice> src,
+                                   std::vector<Time> const &offsets);
+
   /**
    * \brief Get number of devices on this channel
    * \returns number of devices on this channel
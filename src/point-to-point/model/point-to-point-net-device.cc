@@ -25,6 +25,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 #include "ns3/pointer.h"
+#include "ns3/packet-burst.h"
 #include "point-to-point-net-device.h"
 #include "point-to-point-channel.h"
 #include "ppp-header.h"
@@ -67,6 +68,25 @@ PointToPointNetDevice::GetTypeId (void)
                    TimeValue (Seconds (0.0)),
                    MakeTimeAccessor (&PointToPointNetDevice::m_tInterframeGap),
                    MakeTimeChecker ())
+    .AddAttribute ("MaxBurstSize",
+                   "The maximum number of queued packets sent back to back "
+                   "as a single burst, with a single transmit complete event "
+                   "and a single receive event.  Values larger than 1 trade "
+                   "timing accuracy for fewer events: all the packets of a "
+                   "burst are dequeued at once when it starts, so the queue "
+                   "Dequeue trace, the Sniffer and PromiscSniffer traces, the "
+                   "PhyTxBegin trace and the bytes reported to BQL are all "
+                   "stamped at the start of the burst, and the queue, or the "
+                   "queue disc above it, drains by up to MaxBurstSize packets "
+                   "at a time; the PhyTxEnd trace fires for every packet at "
+                   "the end of the burst; and the whole burst is delivered to "
+                   "the peer when its last packet has been received, which "
+                   "delays the reception of the other packets, the receive "
+                   "traces of the peer, and the receive time the "
+                   "TxRxPointToPoint trace of the channel reports for them.",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&PointToPointNetDevice::m_maxBurstSize),
+                   MakeUintegerChecker<uint32_t> (1))
 
     //
     // Transmit queueing discipline for the device which includes its own set
@@ -177,7 +197,8 @@ PointToPointNetDevice::PointToPointNetDevice ()
     m_txMachineState (READY),
     m_channel (0),
     m_linkUp (false),
-    m_currentPkt (0)
+    m_currentPkt (0),
+    m_maxBurstSize (1)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -231,6 +252,7 @@ PointToPointNetDevice::DoDispose ()
   m_channel = 0;
   m_receiveErrorModel = 0;
   m_currentPkt = 0;
+  m_currentBurst = 0;
   m_queue = 0;
   m_queueInterface = 0;
   NetDevice::DoDispose ();
@@ -280,6 +302,47 @@ PointToPointNetDevice::TransmitStart (Ptr<Packet> p)
   return result;
 }
 
+bool
+PointToPointNetDevice::TransmitStartBurst (Ptr<PacketBurst> burst)
+{
+  NS_LOG_FUNCTION (this << burst);
+  NS_LOG_LOGIC ("Burst of " << burst->GetNPackets () << " packets");
+
+  //
+  // The packets go out back to back, so the last bit of packet i leaves the
+  // device at the sum of the transmission times of packets 0 to i, plus the
+  // interframe gaps in between.  The channel gets these offsets so that it
+  // can deliver the burst with a single event.
+  //
+  NS_ASSERT_MSG (m_txMachineState == READY, "Must be READY to transmit");
+  m_txMachineState = BUSY;
+  m_currentBurst = burst;
+
+  std::vector<Time> offsets;
+  offsets.reserve (burst->GetNPackets ());
+  Time offset = Seconds (0);
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+    {
+      m_phyTxBeginTrace (*i);
+      offset += m_bps.CalculateBytesTxTime ((*i)->GetSize ());
+      offsets.push_back (offset);
+      offset += m_tInterframeGap;
+    }
+
+  NS_LOG_LOGIC ("Schedule TransmitCompleteEvent in " << offset.GetSeconds () << "sec");
+  Simulator::Schedule (offset, &PointToPointNetDevice::TransmitComplete, this);
+
+  bool result = m_channel->TransmitStartBurst (burst, this, offsets);
+  if (result == false)
+    {
+      for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+        {
+          m_phyTxDropTrace (*i);
+        }
+    }
+  return result;
+}
+
 void
 PointToPointNetDevice::TransmitComplete (void)
 {
@@ -294,10 +357,21 @@ PointToPointNetDevice::TransmitComplete (void)
   NS_ASSERT_MSG (m_txMachineState == BUSY, "Must be BUSY if transmitting");
   m_txMachineState = READY;
 
-  NS_ASSERT_MSG (m_currentPkt != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
+  NS_ASSERT_MSG (m_currentPkt != 0 || m_currentBurst != 0, "PointToPointNetDevice::TransmitComplete(): m_currentPkt zero");
 
-  m_phyTxEndTrace (m_currentPkt);
-  m_currentPkt = 0;
+  if (m_currentBurst != 0)
+    {
+      for (std::list<Ptr<Packet> >::const_iterator i = m_currentBurst->Begin (); i != m_currentBurst->End (); ++i)
+        {
+          m_phyTxEndTrace (*i);
+        }
+      m_currentBurst = 0;
+    }
+  else
+    {
+      m_phyTxEndTrace (m_currentPkt);
+      m_currentPkt = 0;
+    }
 
   Ptr<NetDeviceQueue> txq;
   if (m_queueInterface)
@@ -318,6 +392,15 @@ PointToPointNetDevice::TransmitComplete (void)
       return;
     }
 
+  //
+  // If bursts are enabled, take the packets following this one as well.
+  //
+  std::vector<Ptr<QueueItem> > items;
+  if (m_maxBurstSize > 1 && !m_queue->IsEmpty ())
+    {
+      m_queue->DequeueBatch (items, m_maxBurstSize - 1);
+    }
+
   //
   // Got another packet off of the queue, so start the transmit process again.
   // If the queue was stopped, start it again if there is room for another packet.
@@ -340,11 +423,31 @@ PointToPointNetDevice::TransmitComplete (void)
   Ptr<Packet> p = item->GetPacket ();
   m_snifferTrace (p);
   m_promiscSnifferTrace (p);
-  TransmitStart (p);
+  if (items.empty ())
+    {
+      TransmitStart (p);
+      if (txq)
+        {
+          // Inform BQL
+          txq->NotifyTransmittedBytes (m_currentPkt->GetSize ());
+        }
+      return;
+    }
+
+  Ptr<PacketBurst> burst = Create<PacketBurst> ();
+  burst->AddPacket (p);
+  for (std::vector<Ptr<QueueItem> >::const_iterator i = items.begin (); i != items.end (); ++i)
+    {
+      p = (*i)->GetPacket ();
+      m_snifferTrace (p);
+      m_promiscSnifferTrace (p);
+      burst->AddPacket (p);
+    }
+  TransmitStartBurst (burst);
   if (txq)
     {
       // Inform BQL
-      txq->NotifyTransmittedBytes (m_currentPkt->GetSize ());
+      txq->NotifyTransmittedBytes (burst->GetSize ());
     }
 }
 
@@ -430,6 +533,16 @@ PointToPointNetDevice::Receive (Ptr<Packet> packet)
     }
 }
 
+void
+PointToPointNetDevice::ReceiveBurst (Ptr<PacketBurst> burst)
+{
+  NS_LOG_FUNCTION (this << burst);
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i)
+    {
+      Receive (*i);
+    }
+}
+
 Ptr<Queue>
 PointToPointNetDevice::GetQueue (void) const
 { 
@@ -20,6 +20,7 @@
 #define POINT_TO_POINT_NET_DEVICE_H
 
 #include <cstring>
+#include <vector>
 #include "ns3/address.h"
 #include "ns3/node.h"
 #include "ns3/net-device.h"
@@ -36,6 +37,7 @@ namespace ns3 {
 class Queue;
 class PointToPointChannel;
 class ErrorModel;
+class PacketBurst;
 
 /**
  * \defgroup point-to-point Point-To-Point Network Device
@@ -149,6 +151,17 @@ public:
    */
   void Receive (Ptr<Packet> p);
 
+  /**
+   * Receive a burst of packets from a connected PointToPointChannel.
+   *
+   * This is called by the channel once the last bit of the last packet of
+   * a burst has arrived at the device; each packet is then received in
+   * order, as if Receive had been called for it.
+   *
+   * \param burst the received packets
+   */
+  void ReceiveBurst (Ptr<PacketBurst> burst);
+
   // The remaining methods are documented in ns3::NetDevice*
 
   virtual void SetIfIndex (const uint32_t index);
@@ -269,6 +282,22 @@ private:
    */
   bool TransmitStart (Ptr<Packet> p);
 
+  /**
+   * Start Sending a Burst of Packets Down the Wire.
+   *
+   * The packets are sent back to back, separated by the interframe gap,
+   * and take as long as if TransmitStart had been called for each of
+   * them, but a single TransmitComplete event is scheduled at the end of
+   * the burst and the channel delivers the whole burst with a single
+   * event.  The PhyTxBegin trace thus fires for every packet now, and the
+   * PhyTxEnd trace for every packet at the end of the burst.
+   *
+   * \see PointToPointChannel::TransmitStartBurst ()
+   * \param burst the packets to send
+   * \returns true if success, false on failure
+   */
+  bool TransmitStartBurst (Ptr<PacketBurst> burst);
+
   /**
    * Stop Sending a Packet Down the Wire and Begin the Interframe Gap.
    *
@@ -459,6 +488,13 @@ private:
   uint32_t m_mtu;
 
   Ptr<Packet> m_currentPkt; //!< Current packet processed
+  Ptr<PacketBurst> m_currentBurst; //!< Current burst processed
+
+  /**
+   * Maximum number of packets pulled from the queue and sent as a single
+   * burst when the transmitter becomes ready.
+   */
+  uint32_t m_maxBurstSize;
 
   /**
    * \brief PPP to Ethernet protocol number mapping
@@ -23,6 +23,7 @@
 #include "point-to-point-remote-channel.h"
 #include "point-to-point-net-device.h"
 #include "ns3/packet.h"
+#include "ns3/packet-burst.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include "ns3/mpi-interface.h"
@@ -77,4 +78,22 @@ PointToPointRemoteChannel::TransmitStart (
   return true;
 }
 
+bool
+PointToPointRemoteChannel::TransmitStartBurst (
+  Ptr<PacketBurst> burst,
+  Ptr<PointToPointNetDevice> src,
+  std::vector<Time> const &offsets)
+{
+  NS_LOG_FUNCTION (this << burst << src);
+  NS_ASSERT (burst->GetNPackets () == offsets.size ());
+
+  // The remote simulator receives packets one by one.
+  std::vector<Time>::const_iterator offset = offsets.begin ();
+  for (std::list<Ptr<Packet> >::const_iterator i = burst->Begin (); i != burst->End (); ++i, ++offset)
+    {
+      TransmitStart (*i, src, *offset);
+    }
+  return true;
+}
+
 } // namespace ns3
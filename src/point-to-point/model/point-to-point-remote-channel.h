@@ -68,6 +68,18 @@ public:
    */
   virtual bool TransmitStart (Ptr<Packet> p, Ptr<PointToPointNetDevice> src,
                               Time txTime);
+
+  /**
+   * \brief Transmit a burst of packets, one MPI message per packet
+   *
+   * \param burst Packets to transmit
+   * \param src Source PointToPointNetDevice
+   * \param offsets Time from now at which the last bit of each packet
+   * is transmitted
+   * \returns true if successful (currently always true)
+   */
+  virtual bool TransmitStartBurst (Ptr<PacketBurst> burst, Ptr<PointToPointNetDevice> src,
+                                   std::vector<Time> const &offsets);
 };
 
 } // namespace ns3
@@ -23,6 +23,8 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/uinteger.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -100,6 +102,122 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test class for the burst mode of the PointToPoint model
+ *
+ * It queues several packets at once on a device allowing bursts, and
+ * checks when and in which order they reach the peer device.
+ */
+class PointToPointBurstTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointBurstTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /**
+   * \brief Send packets of increasing size to the device specified
+   *
+   * \param device NetDevice to send to
+   * \param n number of packets
+   */
+  void SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n);
+
+  /**
+   * \brief Record a received packet
+   *
+   * \param device the receiving device
+   * \param p the packet
+   * \param protocol the protocol number
+   * \param from the sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from);
+
+  std::vector<uint32_t> m_sizes; //!< sizes of the received packets
+  std::vector<Time> m_times;     //!< reception times
+};
+
+PointToPointBurstTest::PointToPointBurstTest ()
+  : TestCase ("PointToPoint bursts")
+{
+}
+
+void
+PointToPointBurstTest::SendPackets (Ptr<PointToPointNetDevice> device, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      device->Send (Create<Packet> (100 + i), device->GetBroadcast (), 0x800);
+    }
+}
+
+bool
+PointToPointBurstTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> p, uint16_t protocol, const Address &from)
+{
+  m_sizes.push_back (p->GetSize ());
+  m_times.push_back (Simulator::Now ());
+  return true;
+}
+
+void
+PointToPointBurstTest::DoRun (void)
+{
+  Ptr<Node> a = CreateObject<Node> ();
+  Ptr<Node> b = CreateObject<Node> ();
+  Ptr<PointToPointNetDevice> devA = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointNetDevice> devB = CreateObject<PointToPointNetDevice> ();
+  Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+  channel->SetAttribute ("Delay", TimeValue (MilliSeconds (2)));
+
+  DataRate rate ("8Mbps");
+  devA->Attach (channel);
+  devA->SetAddress (Mac48Address::Allocate ());
+  devA->SetQueue (CreateObject<DropTailQueue> ());
+  devA->SetDataRate (rate);
+  devA->SetAttribute ("MaxBurstSize", UintegerValue (4));
+  devB->Attach (channel);
+  devB->SetAddress (Mac48Address::Allocate ());
+  devB->SetQueue (CreateObject<DropTailQueue> ());
+
+  // Node::AddDevice sets the receive callback of the device
+  a->AddDevice (devA);
+  b->AddDevice (devB);
+  devB->SetReceiveCallback (MakeCallback (&PointToPointBurstTest::Receive, this));
+
+  const uint32_t n = 10;
+  Simulator::Schedule (Seconds (1.0), &PointToPointBurstTest::SendPackets, this, devA, n);
+
+  Simulator::Run ();
+
+  Simulator::Destroy ();
+
+  // The first packet is sent alone, the next eight in two bursts of four,
+  // and the last one alone again.  A burst is received when its last
+  // packet is.
+  NS_TEST_ASSERT_MSG_EQ (m_sizes.size (), n, "Wrong number of packets received");
+  Time lastBit = Seconds (1.0);
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      NS_TEST_ASSERT_MSG_EQ (m_sizes[i], 100 + i, "Packets received out of order");
+      lastBit += rate.CalculateBytesTxTime (100 + i + 2);
+      if (i == 0 || i == 4 || i == 8 || i == 9)
+        {
+          for (uint32_t j = (i == 0 || i == 9) ? i : i - 3; j <= i; ++j)
+            {
+              NS_TEST_ASSERT_MSG_EQ (m_times[j], lastBit + MilliSeconds (2), "Packet " << j << " received at the wrong time");
+            }
+        }
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -116,6 +234,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointBurstTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -180,4 +180,10 @@ Cost231PropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+Cost231PropagationLossModel::DoIsLossCacheable (void) const
+{
+  return true;
+}
+
 }
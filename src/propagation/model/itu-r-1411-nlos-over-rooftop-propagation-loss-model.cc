@@ -226,5 +226,11 @@ ItuR1411NlosOverRooftopPropagationLossModel::DoAssignStreams (int64_t stream)
   return 0;
 }
 
+bool
+ItuR1411NlosOverRooftopPropagationLossModel::DoIsLossCacheable (void) const
+{
+  return true;
+}
+
 
 } // namespace ns3
@@ -20,6 +20,8 @@
 
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 
 namespace ns3
@@ -47,6 +49,20 @@ JakesPropagationLossModel::GetTypeId ()
     .SetParent<PropagationLossModel> ()
     .SetGroupName ("Propagation")
     .AddConstructor<JakesPropagationLossModel> ()
+    .AddAttribute ("CacheSize",
+                   "The maximum number of paths whose fading process is kept; the least recently "
+                   "used paths are forgotten beyond it, and get a new process if used again. "
+                   "Zero keeps the process of every path.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&JakesPropagationLossModel::SetCacheSize,
+                                         &JakesPropagationLossModel::GetCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
+    .AddAttribute ("SymmetricPaths",
+                   "Whether the paths a-->b and b-->a share the same fading process.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&JakesPropagationLossModel::SetSymmetricPaths,
+                                        &JakesPropagationLossModel::GetSymmetricPaths),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -66,6 +82,36 @@ JakesPropagationLossModel::DoCalcRxPower (double txPowerDbm,
   return txPowerDbm + pathData->GetChannelGainDb ();
 }
 
+void
+JakesPropagationLossModel::SetCacheSize (uint32_t cacheSize)
+{
+  m_propagationCache.SetMaxSize (cacheSize);
+}
+
+uint32_t
+JakesPropagationLossModel::GetCacheSize (void) const
+{
+  return m_propagationCache.GetMaxSize ();
+}
+
+void
+JakesPropagationLossModel::SetSymmetricPaths (bool symmetric)
+{
+  m_propagationCache.SetSymmetric (symmetric);
+}
+
+bool
+JakesPropagationLossModel::GetSymmetricPaths (void) const
+{
+  return m_propagationCache.IsSymmetric ();
+}
+
+uint32_t
+JakesPropagationLossModel::GetNPaths (void) const
+{
+  return m_propagationCache.GetSize ();
+}
+
 Ptr<UniformRandomVariable>
 JakesPropagationLossModel::GetUniformRandomVariable () const
 {
@@ -30,7 +30,8 @@ namespace ns3
  * \ingroup propagation
  *
  * \brief a  Jakes narrowband propagation model.
- * Symmetrical cache for JakesProcess
+ * Symmetrical cache for JakesProcess, unless the SymmetricPaths attribute
+ * is false, bounded by the CacheSize attribute.
  */
 
 class JakesPropagationLossModel : public PropagationLossModel
@@ -43,6 +44,11 @@ public:
   static TypeId GetTypeId ();
   JakesPropagationLossModel ();
   virtual ~JakesPropagationLossModel ();
+
+  /**
+   * \return the number of paths whose fading process is kept
+   */
+  uint32_t GetNPaths (void) const;
   
 private:
   friend class JakesProcess;
@@ -65,6 +71,25 @@ private:
                         Ptr<MobilityModel> b) const;
   virtual int64_t DoAssignStreams (int64_t stream);
 
+  /**
+   * Set the maximum number of paths whose fading process is kept.
+   * \param cacheSize the maximum number of paths, or zero
+   */
+  void SetCacheSize (uint32_t cacheSize);
+  /**
+   * \return the maximum number of paths whose fading process is kept, or zero
+   */
+  uint32_t GetCacheSize (void) const;
+  /**
+   * Set whether the paths a-->b and b-->a share the same fading process.
+   * \param symmetric true if they share it
+   */
+  void SetSymmetricPaths (bool symmetric);
+  /**
+   * \return true if the paths a-->b and b-->a share the same fading process
+   */
+  bool GetSymmetricPaths (void) const;
+
   /**
    * Get the underlying RNG stream
    * \return the RNG stream
@@ -21,21 +21,27 @@
 #define PROPAGATION_CACHE_H_
 
 #include "ns3/mobility-model.h"
-#include <map>
+#include <unordered_map>
+#include <list>
 
 namespace ns3
 {
 /**
  * \ingroup propagation
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation path loss calculations.
- * Propagation path a-->b and b-->a is the same thing. Propagation path is identified by
- * a couple of MobilityModels and a spectrum model UID
+ * Propagation path is identified by a couple of MobilityModels and a spectrum model UID,
+ * hashed to find its object.  By default, propagation path a-->b and b-->a is the same
+ * thing, and the cache is unbounded.  A cache with a maximum size evicts the least
+ * recently used paths.  The cache keeps the MobilityModels of its paths alive.
  */
 template<class T>
 class PropagationCache
 {
 public:
-  PropagationCache () {};
+  PropagationCache ()
+    : m_maxSize (0),
+      m_symmetric (true)
+  {};
   ~PropagationCache () {};
 
   /**
@@ -47,17 +53,22 @@ public:
    */
   Ptr<T> GetPathData (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    PropagationPathIdentifier key = PropagationPathIdentifier (PeekPointer (a), PeekPointer (b), modelUid, m_symmetric);
     typename PathCache::iterator it = m_pathCache.find (key);
     if (it == m_pathCache.end ())
       {
         return 0;
       }
-    return it->second;
+    if (m_maxSize > 0)
+      {
+        m_lru.splice (m_lru.begin (), m_lru, it->second.lru);
+      }
+    return it->second.data;
   };
 
   /**
-   * Add a model to the path
+   * Add a model to the path, evicting the least recently used path
+   * if the cache is full
    * \param data the model to associate to the path
    * \param a 1st node mobility model
    * \param b 2nd node mobility model
@@ -65,10 +76,81 @@ public:
    */
   void AddPathData (Ptr<T> data, Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid)
   {
-    PropagationPathIdentifier key = PropagationPathIdentifier (a, b, modelUid);
+    PropagationPathIdentifier key = PropagationPathIdentifier (PeekPointer (a), PeekPointer (b), modelUid, m_symmetric);
     NS_ASSERT (m_pathCache.find (key) == m_pathCache.end ());
-    m_pathCache.insert (std::make_pair (key, data)); 
+    PathData pathData;
+    pathData.data = data;
+    pathData.a = a;
+    pathData.b = b;
+    if (m_maxSize > 0)
+      {
+        if (m_pathCache.size () >= m_maxSize)
+          {
+            m_pathCache.erase (m_lru.back ());
+            m_lru.pop_back ();
+          }
+        m_lru.push_front (key);
+        pathData.lru = m_lru.begin ();
+      }
+    m_pathCache.insert (std::make_pair (key, pathData));
+  };
+
+  /**
+   * Set the maximum number of paths of the cache.  The least recently
+   * used paths are evicted when it is full.  Changing the maximum size
+   * clears the cache.
+   * \param maxSize the maximum number of paths, or zero for an unbounded cache
+   */
+  void SetMaxSize (uint32_t maxSize)
+  {
+    Clear ();
+    m_maxSize = maxSize;
+  };
+
+  /**
+   * \return the maximum number of paths of the cache, or zero if it is unbounded
+   */
+  uint32_t GetMaxSize (void) const
+  {
+    return m_maxSize;
+  };
+
+  /**
+   * Set whether the paths a-->b and b-->a are the same.  Changing it
+   * clears the cache.
+   * \param symmetric true if the paths a-->b and b-->a are the same
+   */
+  void SetSymmetric (bool symmetric)
+  {
+    Clear ();
+    m_symmetric = symmetric;
+  };
+
+  /**
+   * \return true if the paths a-->b and b-->a are the same
+   */
+  bool IsSymmetric (void) const
+  {
+    return m_symmetric;
+  };
+
+  /**
+   * \return the number of paths in the cache
+   */
+  uint32_t GetSize (void) const
+  {
+    return m_pathCache.size ();
   };
+
+  /**
+   * Remove all the paths from the cache.
+   */
+  void Clear (void)
+  {
+    m_pathCache.clear ();
+    m_lru.clear ();
+  };
+
 private:
   /// Each path is identified by
   struct PropagationPathIdentifier
@@ -78,49 +160,66 @@ private:
      * @param a 1st node mobility model
      * @param b 2nd node mobility model
      * @param modelUid model UID
+     * @param symmetric whether the paths a-->b and b-->a are the same
      */
-    PropagationPathIdentifier (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b, uint32_t modelUid) :
+    PropagationPathIdentifier (const MobilityModel *a, const MobilityModel *b, uint32_t modelUid, bool symmetric) :
       m_srcMobility (a), m_dstMobility (b), m_spectrumModelUid (modelUid)
-    {};
-    Ptr<const MobilityModel> m_srcMobility; //!< 1st node mobility model
-    Ptr<const MobilityModel> m_dstMobility; //!< 2nd node mobility model
+    {
+      // the links are supposed to be symmetrical: order the models
+      if (symmetric && m_dstMobility < m_srcMobility)
+        {
+          std::swap (m_srcMobility, m_dstMobility);
+        }
+    };
+    const MobilityModel *m_srcMobility; //!< 1st node mobility model
+    const MobilityModel *m_dstMobility; //!< 2nd node mobility model
     uint32_t m_spectrumModelUid; //!< model UID
 
     /**
-     * Less-than operator.
-     *
-     * The goal of this operator is just to provide a stable comparison
-     * to be used in containers requiring a order (of any kind).
-     *
-     * If the models are different, the comparison is based on their Uid.
-     * Otherwise, the comparison is based on the pointers of the Mobility models.
+     * Equality operator.
      *
      * \param other Right value of the operator.
-     * \returns True if the Left value is less than the Right value.
+     * \returns True if both values identify the same path.
      */
-    bool operator < (const PropagationPathIdentifier & other) const
+    bool operator == (const PropagationPathIdentifier & other) const
     {
-      if (m_spectrumModelUid != other.m_spectrumModelUid)
-        {
-          return m_spectrumModelUid < other.m_spectrumModelUid;
-        }
-      /// Links are supposed to be symmetrical!
-      if (std::min (m_dstMobility, m_srcMobility) != std::min (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::min (m_dstMobility, m_srcMobility) < std::min (other.m_dstMobility, other.m_srcMobility);
-        }
-      if (std::max (m_dstMobility, m_srcMobility) != std::max (other.m_dstMobility, other.m_srcMobility))
-        {
-          return std::max (m_dstMobility, m_srcMobility) < std::max (other.m_dstMobility, other.m_srcMobility);
-        }
-      return false;
+      return m_srcMobility == other.m_srcMobility
+             && m_dstMobility == other.m_dstMobility
+             && m_spectrumModelUid == other.m_spectrumModelUid;
+    }
+  };
+
+  /// Hash of a PropagationPathIdentifier
+  struct PropagationPathHash
+  {
+    /**
+     * \param path the path
+     * \return the hash of the path
+     */
+    std::size_t operator () (const PropagationPathIdentifier & path) const
+    {
+      std::size_t hash = reinterpret_cast<std::size_t> (path.m_srcMobility);
+      hash = hash * 31 + reinterpret_cast<std::size_t> (path.m_dstMobility);
+      return hash * 31 + path.m_spectrumModelUid;
     }
   };
 
-  /// Typedef: PropagationPathIdentifier, Ptr<T>
-  typedef std::map<PropagationPathIdentifier, Ptr<T> > PathCache;
+  /// The data of a path, and its position in the LRU list of a bounded cache
+  struct PathData
+  {
+    Ptr<T> data; //!< the model of the path
+    Ptr<const MobilityModel> a; //!< 1st node mobility model, kept alive while the path is cached
+    Ptr<const MobilityModel> b; //!< 2nd node mobility model, kept alive while the path is cached
+    typename std::list<PropagationPathIdentifier>::iterator lru; //!< the position of the path in m_lru
+  };
+
+  /// Typedef: PropagationPathIdentifier, PathData
+  typedef std::unordered_map<PropagationPathIdentifier, PathData, PropagationPathHash> PathCache;
 private:
   PathCache m_pathCache; //!< Path cache
+  std::list<PropagationPathIdentifier> m_lru; //!< the paths of a bounded cache, most recently used first
+  uint32_t m_maxSize; //!< the maximum number of paths, or zero
+  bool m_symmetric; //!< whether the paths a-->b and b-->a are the same
 };
 } // namespace ns3
 
@@ -26,6 +26,7 @@
 #include "ns3/mobility-model.h"
 #include "ns3/boolean.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
 #include "ns3/string.h"
 #include "ns3/pointer.h"
 #include <cmath>
@@ -44,6 +45,14 @@ PropagationLossModel::GetTypeId (void)
   static TypeId tid = TypeId ("ns3::PropagationLossModel")
     .SetParent<Object> ()
     .SetGroupName ("Propagation")
+    .AddAttribute ("LossCacheSize",
+                   "The maximum number of paths whose loss is cached, for the models whose loss "
+                   "only depends on the positions; the least recently used paths are evicted "
+                   "beyond it. Zero disables the cache.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&PropagationLossModel::SetLossCacheSize,
+                                         &PropagationLossModel::GetLossCacheSize),
+                   MakeUintegerChecker<uint32_t> ())
   ;
   return tid;
 }
@@ -51,6 +60,8 @@ PropagationLossModel::GetTypeId (void)
 PropagationLossModel::PropagationLossModel ()
   : m_next (0)
 {
+  // the losses of a-->b and b-->a may differ, with the heights for example
+  m_lossCache.SetSymmetric (false);
 }
 
 PropagationLossModel::~PropagationLossModel ()
@@ -74,7 +85,15 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
                                    Ptr<MobilityModel> a,
                                    Ptr<MobilityModel> b) const
 {
-  double self = DoCalcRxPower (txPowerDbm, a, b);
+  double self;
+  if (m_lossCache.GetMaxSize () > 0 && DoIsLossCacheable ())
+    {
+      self = txPowerDbm + GetCachedGain (a, b);
+    }
+  else
+    {
+      self = DoCalcRxPower (txPowerDbm, a, b);
+    }
   if (m_next != 0)
     {
       self = m_next->CalcRxPower (self, a, b);
@@ -82,6 +101,54 @@ PropagationLossModel::CalcRxPower (double txPowerDbm,
   return self;
 }
 
+double
+PropagationLossModel::GetCachedGain (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const
+{
+  Vector aPosition = a->GetPosition ();
+  Vector bPosition = b->GetPosition ();
+  Ptr<CachedGain> gain = m_lossCache.GetPathData (a, b, 0);
+  if (gain == 0)
+    {
+      gain = Create<CachedGain> ();
+      m_lossCache.AddPathData (gain, a, b, 0);
+    }
+  else if (gain->aPosition.x == aPosition.x && gain->aPosition.y == aPosition.y && gain->aPosition.z == aPosition.z
+           && gain->bPosition.x == bPosition.x && gain->bPosition.y == bPosition.y && gain->bPosition.z == bPosition.z)
+    {
+      return gain->gainDb;
+    }
+  gain->aPosition = aPosition;
+  gain->bPosition = bPosition;
+  // the losses are independent of the transmission power: adding the
+  // gain to it gives the same result as DoCalcRxPower
+  gain->gainDb = DoCalcRxPower (0, a, b);
+  return gain->gainDb;
+}
+
+bool
+PropagationLossModel::DoIsLossCacheable (void) const
+{
+  return false;
+}
+
+void
+PropagationLossModel::SetLossCacheSize (uint32_t cacheSize)
+{
+  m_lossCache.SetMaxSize (cacheSize);
+}
+
+uint32_t
+PropagationLossModel::GetLossCacheSize (void) const
+{
+  return m_lossCache.GetMaxSize ();
+}
+
+uint32_t
+PropagationLossModel::GetNCachedLosses (void) const
+{
+  return m_lossCache.GetSize ();
+}
+
 int64_t
 PropagationLossModel::AssignStreams (int64_t stream)
 {
@@ -27,6 +27,8 @@
 
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/propagation-cache.h"
+#include "ns3/vector.h"
 #include <map>
 
 namespace ns3 {
@@ -45,6 +47,13 @@ class MobilityModel;
  *
  * Calculate the receive power (dbm) from a transmit power (dbm)
  * and a mobility model for the source and destination positions.
+ *
+ * The models whose loss only depends on the positions of the source and
+ * destination, and is more expensive to calculate than to look up, can
+ * keep the loss of each path in a cache, bounded by the
+ * LossCacheSize attribute, and only calculate it again when one of the
+ * positions changed.  The other attributes of a model must not change
+ * while its cache is enabled.
  */
 class PropagationLossModel : public Object
 {
@@ -106,6 +115,11 @@ public:
    */
   int64_t AssignStreams (int64_t stream);
 
+  /**
+   * \return the number of paths whose loss is kept in the cache
+   */
+  uint32_t GetNCachedLosses (void) const;
+
 private:
   /**
    * \brief Copy constructor
@@ -140,7 +154,48 @@ private:
    */
   virtual int64_t DoAssignStreams (int64_t stream) = 0;
 
+  /**
+   * Subclasses whose loss only depends on the positions of the source
+   * and destination, and not on the transmission power, on random
+   * variables or on time, can return true to have it cached.  The
+   * models which calculate it faster than it is looked up, such as the
+   * Friis and LogDistance ones, should not.
+   *
+   * \return true if the loss calculated by DoCalcRxPower can be cached
+   */
+  virtual bool DoIsLossCacheable (void) const;
+
+  /**
+   * Returns the gain of the path (the opposite of its loss) from the
+   * cache, calculating it if the path is not in the cache or if one of
+   * the positions changed since it was calculated.
+   *
+   * \param a the mobility model of the source
+   * \param b the mobility model of the destination
+   * \returns the gain of the path (in dB)
+   */
+  double GetCachedGain (Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
+
+  /**
+   * Set the maximum number of paths whose loss is cached.
+   * \param cacheSize the maximum number of paths, or zero to disable the cache
+   */
+  void SetLossCacheSize (uint32_t cacheSize);
+  /**
+   * \return the maximum number of paths whose loss is cached, or zero
+   */
+  uint32_t GetLossCacheSize (void) const;
+
+  /// The gain of a path, and the positions it was calculated for
+  struct CachedGain : public SimpleRefCount<CachedGain>
+  {
+    Vector aPosition; //!< the position of the source
+    Vector bPosition; //!< the position of the destination
+    double gainDb;    //!< the gain of the path (in dB)
+  };
+
   Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
+  mutable PropagationCache<CachedGain> m_lossCache; //!< the gains of the paths
 };
 
 /**
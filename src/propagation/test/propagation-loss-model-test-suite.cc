@@ -21,7 +21,12 @@
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/okumura-hata-propagation-loss-model.h"
+#include "ns3/kun-2600-mhz-propagation-loss-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +441,96 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class PropagationLossCacheTestCase : public TestCase
+{
+public:
+  PropagationLossCacheTestCase ();
+  virtual ~PropagationLossCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+PropagationLossCacheTestCase::PropagationLossCacheTestCase ()
+  : TestCase ("Test the cache of the propagation losses and of the Jakes processes")
+{
+}
+
+PropagationLossCacheTestCase::~PropagationLossCacheTestCase ()
+{
+}
+
+void
+PropagationLossCacheTestCase::DoRun (void)
+{
+  Ptr<MobilityModel> m[3];
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      m[i] = CreateObject<ConstantPositionMobilityModel> ();
+      m[i]->SetPosition (Vector (100.0 * i, 0, 1.5 + 30 * i));
+    }
+
+  // a chain of cached models gives the same results as the same chain without cache
+  Ptr<PropagationLossModel> cached = CreateObject<OkumuraHataPropagationLossModel> ();
+  cached->SetAttribute ("LossCacheSize", UintegerValue (2));
+  Ptr<PropagationLossModel> cachedNext = CreateObject<Kun2600MhzPropagationLossModel> ();
+  cachedNext->SetAttribute ("LossCacheSize", UintegerValue (2));
+  cached->SetNext (cachedNext);
+  Ptr<PropagationLossModel> reference = CreateObject<OkumuraHataPropagationLossModel> ();
+  reference->SetNext (CreateObject<Kun2600MhzPropagationLossModel> ());
+
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          for (uint32_t j = 0; j < 3; j++)
+            {
+              if (i == j)
+                {
+                  continue;
+                }
+              double expected = reference->CalcRxPower (10, m[i], m[j]);
+              NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (10, m[i], m[j]), expected, "Loss " << i << " -> " << j << " incorrect");
+              NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (10, m[i], m[j]), expected, "Cached loss " << i << " -> " << j << " incorrect");
+              NS_TEST_EXPECT_MSG_EQ (cached->CalcRxPower (-20, m[i], m[j]), expected - 30, "Cached loss " << i << " -> " << j << " depends on the power");
+            }
+        }
+      NS_TEST_EXPECT_MSG_EQ (cached->GetNCachedLosses (), 2, "Cache not bounded");
+      NS_TEST_EXPECT_MSG_EQ (cachedNext->GetNCachedLosses (), 2, "Cache of the next model not bounded");
+      // the cached losses must follow the moves
+      Vector position = m[k % 3]->GetPosition ();
+      m[k % 3]->SetPosition (Vector (position.x + 50, position.y + 20, position.z));
+    }
+
+  // the models which are not cacheable, or cheaper to calculate than to
+  // look up, ignore the cache size
+  Ptr<PropagationLossModel> range = CreateObject<RangePropagationLossModel> ();
+  range->SetAttribute ("LossCacheSize", UintegerValue (10));
+  NS_TEST_EXPECT_MSG_EQ (range->CalcRxPower (10, m[0], m[1]), 10, "Loss incorrect");
+  NS_TEST_EXPECT_MSG_EQ (range->GetNCachedLosses (), 0, "Loss of a model which is not cacheable cached");
+  Ptr<PropagationLossModel> logDistance = CreateObject<LogDistancePropagationLossModel> ();
+  logDistance->SetAttribute ("LossCacheSize", UintegerValue (10));
+  logDistance->CalcRxPower (10, m[0], m[1]);
+  NS_TEST_EXPECT_MSG_EQ (logDistance->GetNCachedLosses (), 0, "Loss of a cheap model cached");
+
+  // a path and its reverse share a Jakes process, unless SymmetricPaths is false
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  jakes->SetAttribute ("CacheSize", UintegerValue (2));
+  jakes->CalcRxPower (0, m[0], m[1]);
+  jakes->CalcRxPower (0, m[1], m[0]);
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetNPaths (), 1, "Symmetric paths not shared");
+  jakes->CalcRxPower (0, m[0], m[2]);
+  jakes->CalcRxPower (0, m[1], m[2]);
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetNPaths (), 2, "Jakes cache not bounded");
+  jakes->SetAttribute ("SymmetricPaths", BooleanValue (false));
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetNPaths (), 0, "Jakes cache not cleared");
+  jakes->CalcRxPower (0, m[0], m[1]);
+  jakes->CalcRxPower (0, m[1], m[0]);
+  NS_TEST_EXPECT_MSG_EQ (jakes->GetNPaths (), 2, "Asymmetric paths shared");
+
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +545,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new PropagationLossCacheTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
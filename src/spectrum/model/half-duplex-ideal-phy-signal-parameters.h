@@ -50,9 +50,10 @@ struct HalfDuplexIdealPhySignalParameters : public SpectrumSignalParameters
   HalfDuplexIdealPhySignalParameters (const HalfDuplexIdealPhySignalParameters& p);
 
   /**
-   * The data packet being transmitted with this signal
+   * The data packet being transmitted with this signal, shared by all
+   * the copies of the parameters delivered to the receivers
    */
-  Ptr<Packet> data;
+  Ptr<const Packet> data;
 };
 
 }  // namespace ns3
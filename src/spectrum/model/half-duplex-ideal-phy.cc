@@ -371,7 +371,7 @@ HalfDuplexIdealPhy::StartRx (Ptr<SpectrumSignalParameters> spectrumParams)
         case IDLE:
           // preamble detection and synchronization is supposed to be always successful.
 
-          Ptr<Packet> p = rxParams->data;
+          Ptr<const Packet> p = rxParams->data;
           m_phyRxStartTrace (p);
           m_rxPacket = p;
           m_rxPsd = rxParams->psd;
@@ -433,7 +433,8 @@ HalfDuplexIdealPhy::EndRx ()
       if (!m_phyMacRxEndOkCallback.IsNull ())
         {
           NS_LOG_LOGIC (this << " calling m_phyMacRxEndOkCallback");
-          m_phyMacRxEndOkCallback (m_rxPacket);
+          // the packet is shared with the other receivers of the signal
+          m_phyMacRxEndOkCallback (m_rxPacket->Copy ());
         }
       else
         {
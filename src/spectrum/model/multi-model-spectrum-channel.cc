@@ -34,6 +34,8 @@
 #include <ns3/propagation-delay-model.h>
 #include <ns3/antenna-model.h>
 #include <ns3/angles.h>
+#include <ns3/position-grid.h>
+#include <algorithm>
 #include <iostream>
 #include <utility>
 #include "multi-model-spectrum-channel.h"
@@ -82,6 +84,7 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
+  : m_numDevices (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -95,6 +98,10 @@ MultiModelSpectrumChannel::DoDispose ()
   m_spectrumPropagationLoss = 0;
   m_txSpectrumModelInfoMap.clear ();
   m_rxSpectrumModelInfoMap.clear ();
+  m_grid = 0;
+  m_gridPhys.clear ();
+  m_indexedPhys.clear ();
+  m_unindexedPhys.clear ();
   SpectrumChannel::DoDispose ();
 }
 
@@ -119,6 +126,17 @@ MultiModelSpectrumChannel::GetTypeId (void)
                    DoubleValue (1.0e9),
                    MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxLossDb),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("MaxRange",
+                   "The maximum distance in meters between the transmitter "
+                   "and the receivers of a signal, or 0 for no limit.  "
+                   "The receivers farther away get no event and their path "
+                   "loss is not calculated, as if it exceeded MaxLossDb; "
+                   "they are found without visiting every receiver, which "
+                   "reduces the computational load of the channels with "
+                   "many receivers spread over a large area.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
     .AddTraceSource ("PathLoss",
                      "This trace is fired whenever a new path loss value "
                      "is calculated. The first and second parameters "
@@ -204,6 +222,12 @@ MultiModelSpectrumChannel::AddRx (Ptr<SpectrumPhy> phy)
       NS_ASSERT (ret2.second);
     }
 
+  // the PHYs usually get their mobility model after they are added to
+  // the channel: index them in the grid at the next transmission
+  if (m_indexedPhys.find (phy) == m_indexedPhys.end ())
+    {
+      m_unindexedPhys.insert (phy);
+    }
 }
 
 
@@ -272,6 +296,34 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
   NS_LOG_LOGIC ("converter map size: " << txInfoIteratorerator->second.m_spectrumConverterMap.size ());
   NS_LOG_LOGIC ("converter map first element: " << txInfoIteratorerator->second.m_spectrumConverterMap.begin ()->first);
 
+  // with a maximum range, only the receivers near the transmitter are
+  // considered, grouped by the SpectrumModel they currently use
+  bool culling = (m_maxRange > 0 && txMobility != 0);
+  std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > > receiversInRange;
+  if (culling)
+    {
+      UpdateGrid ();
+      std::vector<uint32_t> items;
+      Vector txPosition = txMobility->GetPosition ();
+      m_grid->GetItemsNear (txPosition, m_maxRange, items);
+      for (std::vector<uint32_t>::const_iterator item = items.begin (); item != items.end (); ++item)
+        {
+          Ptr<SpectrumPhy> phy = m_gridPhys[*item];
+          if (phy != txParams->txPhy
+              && m_grid->IsWithin (*item, txPosition, m_maxRange))
+            {
+              receiversInRange[phy->GetRxSpectrumModel ()->GetUid ()].push_back (phy);
+            }
+        }
+      for (std::set<Ptr<SpectrumPhy> >::const_iterator phy = m_unindexedPhys.begin (); phy != m_unindexedPhys.end (); ++phy)
+        {
+          if (*phy != txParams->txPhy)
+            {
+              receiversInRange[(*phy)->GetRxSpectrumModel ()->GetUid ()].push_back (*phy);
+            }
+        }
+    }
+
   for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin ();
        rxInfoIterator != m_rxSpectrumModelInfoMap.end ();
        ++rxInfoIterator)
@@ -279,6 +331,20 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
       SpectrumModelUid_t rxSpectrumModelUid = rxInfoIterator->second.m_rxSpectrumModel->GetUid ();
       NS_LOG_LOGIC (" rxSpectrumModelUids " << rxSpectrumModelUid);
 
+      std::vector<Ptr<SpectrumPhy> > *receivers = 0;
+      if (culling)
+        {
+          std::map<SpectrumModelUid_t, std::vector<Ptr<SpectrumPhy> > >::iterator it = receiversInRange.find (rxSpectrumModelUid);
+          if (it == receiversInRange.end ())
+            {
+              NS_LOG_LOGIC ("no receiver in range, not converting the signal");
+              continue;
+            }
+          receivers = &it->second;
+          // deliver in the same order as without a maximum range
+          std::sort (receivers->begin (), receivers->end ());
+        }
+
       Ptr <SpectrumValue> convertedTxPowerSpectrum;
       if (txSpectrumModelUid == rxSpectrumModelUid)
         {
@@ -293,6 +359,19 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
           convertedTxPowerSpectrum = rxConverterIterator->second.Convert (txParams->psd);
         }
 
+      if (culling)
+        {
+          for (std::vector<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = receivers->begin ();
+               rxPhyIterator != receivers->end ();
+               ++rxPhyIterator)
+            {
+              NS_ASSERT_MSG (rxInfoIterator->second.m_rxPhySet.find (*rxPhyIterator) != rxInfoIterator->second.m_rxPhySet.end (),
+                             "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
+              Deliver (txParams, convertedTxPowerSpectrum, *rxPhyIterator);
+            }
+          receiversInRange.erase (rxSpectrumModelUid);
+          continue;
+        }
 
       for (std::set<Ptr<SpectrumPhy> >::const_iterator rxPhyIterator = rxInfoIterator->second.m_rxPhySet.begin ();
            rxPhyIterator != rxInfoIterator->second.m_rxPhySet.end ();
@@ -303,79 +382,125 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
 
           if ((*rxPhyIterator) != txParams->txPhy)
             {
-              NS_LOG_LOGIC (" copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
-              Time delay = MicroSeconds (0);
-
-              Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
-
-              if (txMobility && receiverMobility)
-                {
-                  double pathLossDb = 0;
-                  if (rxParams->txAntenna != 0)
-                    {
-                      Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      double txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
-                      NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
-                      pathLossDb -= txAntennaGain;
-                    }
-                  Ptr<AntennaModel> rxAntenna = (*rxPhyIterator)->GetRxAntenna ();
-                  if (rxAntenna != 0)
-                    {
-                      Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
-                      double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
-                      NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
-                      pathLossDb -= rxAntennaGain;
-                    }
-                  if (m_propagationLoss)
-                    {
-                      double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
-                      NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
-                      pathLossDb -= propagationGainDb;
-                    }                    
-                  NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");    
-                  m_pathLossTrace (txParams->txPhy, *rxPhyIterator, pathLossDb);
-                  if ( pathLossDb > m_maxLossDb)
-                    {
-                      // beyond range
-                      continue;
-                    }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;              
-
-                  if (m_spectrumPropagationLoss)
-                    {
-                      rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
-                    }
-
-                  if (m_propagationDelay)
-                    {
-                      delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
-                    }
-                }
-
-              Ptr<NetDevice> netDev = (*rxPhyIterator)->GetDevice ();
-              if (netDev)
-                {
-                  // the receiver has a NetDevice, so we expect that it is attached to a Node
-                  uint32_t dstNode =  netDev->GetNode ()->GetId ();
-                  Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
-                                                  rxParams, *rxPhyIterator);
-                }
-              else
-                {
-                  // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
-                  Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
-                                       rxParams, *rxPhyIterator);
-                }
+              Deliver (txParams, convertedTxPowerSpectrum, *rxPhyIterator);
             }
         }
 
     }
+  NS_ASSERT_MSG (receiversInRange.empty (),
+                 "SpectrumModel change was not notified to MultiModelSpectrumChannel (i.e., AddRx should be called again after model is changed)");
 
 }
 
+void
+MultiModelSpectrumChannel::Deliver (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumValue> psd, Ptr<SpectrumPhy> receiver)
+{
+  NS_LOG_FUNCTION (this << txParams << receiver);
+  Ptr<MobilityModel> txMobility = txParams->txPhy->GetMobility ();
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ();
+  Time delay = MicroSeconds (0);
+  double pathGainLinear = 1;
+
+  // the loss is calculated before copying the signal, which is not
+  // copied at all if the receiver is beyond range
+  if (txMobility && receiverMobility)
+    {
+      double pathLossDb = 0;
+      if (txParams->txAntenna != 0)
+        {
+          Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
+          double txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
+          NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
+          pathLossDb -= txAntennaGain;
+        }
+      Ptr<AntennaModel> rxAntenna = receiver->GetRxAntenna ();
+      if (rxAntenna != 0)
+        {
+          Angles rxAngles (txMobility->GetPosition (), receiverMobility->GetPosition ());
+          double rxAntennaGain = rxAntenna->GetGainDb (rxAngles);
+          NS_LOG_LOGIC ("rxAntennaGain = " << rxAntennaGain << " dB");
+          pathLossDb -= rxAntennaGain;
+        }
+      if (m_propagationLoss)
+        {
+          double propagationGainDb = m_propagationLoss->CalcRxPower (0, txMobility, receiverMobility);
+          NS_LOG_LOGIC ("propagationGainDb = " << propagationGainDb << " dB");
+          pathLossDb -= propagationGainDb;
+        }
+      NS_LOG_LOGIC ("total pathLoss = " << pathLossDb << " dB");
+      m_pathLossTrace (txParams->txPhy, receiver, pathLossDb);
+      if ( pathLossDb > m_maxLossDb)
+        {
+          // beyond range
+          return;
+        }
+      pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+    }
+
+  NS_LOG_LOGIC (" copying signal parameters " << txParams);
+  Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+  rxParams->psd = Copy<SpectrumValue> (psd);
+
+  if (txMobility && receiverMobility)
+    {
+      *(rxParams->psd) *= pathGainLinear;
+
+      if (m_spectrumPropagationLoss)
+        {
+          rxParams->psd = m_spectrumPropagationLoss->CalcRxPowerSpectralDensity (rxParams->psd, txMobility, receiverMobility);
+        }
+
+      if (m_propagationDelay)
+        {
+          delay = m_propagationDelay->GetDelay (txMobility, receiverMobility);
+        }
+    }
+
+  Ptr<NetDevice> netDev = receiver->GetDevice ();
+  if (netDev)
+    {
+      // the receiver has a NetDevice, so we expect that it is attached to a Node
+      uint32_t dstNode =  netDev->GetNode ()->GetId ();
+      Simulator::ScheduleWithContext (dstNode, delay, &MultiModelSpectrumChannel::StartRx, this,
+                                      rxParams, receiver);
+    }
+  else
+    {
+      // the receiver is not attached to a NetDevice, so we cannot assume that it is attached to a node
+      Simulator::Schedule (delay, &MultiModelSpectrumChannel::StartRx, this,
+                           rxParams, receiver);
+    }
+}
+
+void
+MultiModelSpectrumChannel::UpdateGrid (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_grid == 0 || m_grid->GetCellSize () != m_maxRange)
+    {
+      m_grid = Create<PositionGrid> (m_maxRange);
+      for (std::vector<Ptr<SpectrumPhy> >::const_iterator phy = m_gridPhys.begin (); phy != m_gridPhys.end (); ++phy)
+        {
+          m_grid->Add ((*phy)->GetMobility ());
+        }
+    }
+  std::set<Ptr<SpectrumPhy> >::iterator phy = m_unindexedPhys.begin ();
+  while (phy != m_unindexedPhys.end ())
+    {
+      Ptr<MobilityModel> mobility = (*phy)->GetMobility ();
+      if (mobility == 0)
+        {
+          ++phy;
+          continue;
+        }
+      NS_ASSERT (m_grid->GetNItems () == m_gridPhys.size ());
+      m_grid->Add (mobility);
+      m_gridPhys.push_back (*phy);
+      m_indexedPhys.insert (*phy);
+      m_unindexedPhys.erase (phy++);
+    }
+}
+
 void
 MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver)
 {
@@ -29,9 +29,12 @@
 #include <ns3/propagation-delay-model.h>
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ns3 {
 
+class PositionGrid;
+
 
 /**
  * \ingroup spectrum
@@ -102,6 +105,15 @@ typedef std::map<SpectrumModelUid_t, RxSpectrumModelInfo> RxSpectrumModelInfoMap
  * for this to work is that, after the SpectrumPhy switched its
  * SpectrumModel,  MultiModelSpectrumChannel::AddRx () is
  * called again passing the pointer to that SpectrumPhy.
+ *
+ * The signals are delivered to every SpectrumPhy by default.  The
+ * "MaxRange" attribute restricts them to the receivers within a
+ * distance of the transmitter, which are found with a
+ * ns3::PositionGrid rather than by visiting every receiver, and are
+ * grouped by SpectrumModel so that the signal is only converted to the
+ * SpectrumModels of the receivers in range.  The receivers without a
+ * mobility model are always considered in range, as the receivers of
+ * a transmitter without a mobility model.
  */
 class MultiModelSpectrumChannel : public SpectrumChannel
 {
@@ -158,6 +170,23 @@ private:
    */
   virtual void StartRx (Ptr<SpectrumSignalParameters> params, Ptr<SpectrumPhy> receiver);
 
+  /**
+   * Compute the loss of a signal towards a receiver, and schedule its
+   * reception unless the loss exceeds MaxLossDb.
+   *
+   * @param txParams The signal parameters of the transmitter.
+   * @param psd The power spectral density of the signal, converted to
+   *        the SpectrumModel of the receiver.
+   * @param receiver A pointer to the receiver SpectrumPhy.
+   */
+  void Deliver (Ptr<SpectrumSignalParameters> txParams, Ptr<SpectrumValue> psd, Ptr<SpectrumPhy> receiver);
+
+  /**
+   * Index in m_grid the receivers which got a mobility model since the
+   * last transmission, creating the grid first if needed.
+   */
+  void UpdateGrid (void);
+
   /**
    * Propagation delay model to be used with this channel.
    */
@@ -201,6 +230,12 @@ private:
    */
   double m_maxLossDb;
 
+  double m_maxRange;                                //!< The maximum distance of the receivers, or 0 for no limit
+  Ptr<PositionGrid> m_grid;                         //!< The positions of the indexed receivers
+  std::vector<Ptr<SpectrumPhy> > m_gridPhys;        //!< The indexed receivers, by item of m_grid
+  std::set<Ptr<SpectrumPhy> > m_indexedPhys;        //!< The indexed receivers
+  std::set<Ptr<SpectrumPhy> > m_unindexedPhys;      //!< The receivers not indexed yet, or without mobility model
+
   /**
    * \deprecated The non-const \c Ptr<SpectrumPhy> argument
    * is deprecated and will be changed to \c Ptr<const SpectrumPhy>
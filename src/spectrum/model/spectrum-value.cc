@@ -22,6 +22,8 @@
 #include <ns3/spectrum-value.h>
 #include <ns3/math.h>
 #include <ns3/log.h>
+#include <algorithm>
+#include <utility>
 
 namespace ns3 {
 
@@ -41,13 +43,15 @@ SpectrumValue::SpectrumValue (Ptr<const SpectrumModel> sof)
 double&
 SpectrumValue::operator[] (size_t index)
 {
-  return m_values.at (index);
+  NS_ASSERT (index < m_values.size ());
+  return m_values[index];
 }
 
 const double&
 SpectrumValue::operator[] (size_t index) const
 {
-  return m_values.at (index);
+  NS_ASSERT (index < m_values.size ());
+  return m_values[index];
 }
 
 
@@ -106,17 +110,15 @@ SpectrumValue::ConstBandsEnd () const
 void
 SpectrumValue::Add (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 += *it2;
-      ++it1;
-      ++it2;
+      v[i] += xv[i];
     }
 }
 
@@ -124,12 +126,11 @@ SpectrumValue::Add (const SpectrumValue& x)
 void
 SpectrumValue::Add (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 += s;
-      ++it1;
+      v[i] += s;
     }
 }
 
@@ -138,17 +139,15 @@ SpectrumValue::Add (double s)
 void
 SpectrumValue::Subtract (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 -= *it2;
-      ++it1;
-      ++it2;
+      v[i] -= xv[i];
     }
 }
 
@@ -164,17 +163,15 @@ SpectrumValue::Subtract (double s)
 void
 SpectrumValue::Multiply (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 *= *it2;
-      ++it1;
-      ++it2;
+      v[i] *= xv[i];
     }
 }
 
@@ -182,12 +179,11 @@ SpectrumValue::Multiply (const SpectrumValue& x)
 void
 SpectrumValue::Multiply (double s)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 *= s;
-      ++it1;
+      v[i] *= s;
     }
 }
 
@@ -197,17 +193,15 @@ SpectrumValue::Multiply (double s)
 void
 SpectrumValue::Divide (const SpectrumValue& x)
 {
-  Values::iterator it1 = m_values.begin ();
-  Values::const_iterator it2 = x.m_values.begin ();
-
   NS_ASSERT (m_spectrumModel == x.m_spectrumModel);
+  NS_ASSERT (m_values.size () == x.m_values.size ());
 
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  const double *xv = x.m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      NS_ASSERT ( it2 != x.m_values.end ());
-      *it1 /= *it2;
-      ++it1;
-      ++it2;
+      v[i] /= xv[i];
     }
 }
 
@@ -216,12 +210,11 @@ void
 SpectrumValue::Divide (double s)
 {
   NS_LOG_FUNCTION (this << s);
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 /= s;
-      ++it1;
+      v[i] /= s;
     }
 }
 
@@ -231,12 +224,11 @@ SpectrumValue::Divide (double s)
 void
 SpectrumValue::ChangeSign ()
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
+  double *v = m_values.data ();
+  size_t n = m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      *it1 = -(*it1);
-      ++it1;
+      v[i] = -v[i];
     }
 }
 
@@ -348,11 +340,11 @@ double
 Norm (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  const double *v = x.m_values.data ();
+  size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      s += (*it1) * (*it1);
-      ++it1;
+      s += v[i] * v[i];
     }
   return std::sqrt (s);
 }
@@ -362,11 +354,11 @@ double
 Sum (const SpectrumValue& x)
 {
   double s = 0;
-  Values::const_iterator it1 = x.ConstValuesBegin ();
-  while (it1 != x.ConstValuesEnd ())
+  const double *v = x.m_values.data ();
+  size_t n = x.m_values.size ();
+  for (size_t i = 0; i < n; i++)
     {
-      s += (*it1);
-      ++it1;
+      s += v[i];
     }
   return s;
 }
@@ -390,16 +382,14 @@ double
 Integral (const SpectrumValue& arg)
 {
   double i = 0;
-  Values::const_iterator vit = arg.ConstValuesBegin ();
+  const double *v = arg.m_values.data ();
+  size_t n = arg.m_values.size ();
   Bands::const_iterator bit = arg.ConstBandsBegin ();
-  while (vit != arg.ConstValuesEnd ())
+  NS_ASSERT (static_cast<size_t> (arg.ConstBandsEnd () - bit) == n);
+  for (size_t k = 0; k < n; k++, ++bit)
     {
-      NS_ASSERT (bit != arg.ConstBandsEnd ());
-      i += (*vit) * (bit->fh - bit->fl);
-      ++vit;
-      ++bit;
+      i += v[k] * (bit->fh - bit->fl);
     }
-  NS_ASSERT (bit == arg.ConstBandsEnd ());
   return i;
 }
 
@@ -408,11 +398,7 @@ Integral (const SpectrumValue& arg)
 Ptr<SpectrumValue>
 SpectrumValue::Copy () const
 {
-  Ptr<SpectrumValue> p = Create<SpectrumValue> (m_spectrumModel);
-  *p = *this;
-  return p;
-
-  //  return Copy<SpectrumValue> (*this)
+  return Ptr<SpectrumValue> (new SpectrumValue (*this), false);
 }
 
 
@@ -603,6 +589,189 @@ Log (const SpectrumValue& arg)
   return res;
 }
 
+// The overloads taking a temporary operand compute the result in its
+// values, which saves the allocation of a new SpectrumValue for each
+// operator of an expression.  They compute the same values, in the same
+// way, as the overloads above.
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.Add (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Add (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator+ (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Add (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.ChangeSign ();
+  rhs.Add (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Subtract (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  rhs.Multiply (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Multiply (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator* (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Multiply (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, const SpectrumValue& rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator/ (const SpectrumValue& lhs, SpectrumValue&& rhs)
+{
+  NS_ASSERT (lhs.m_spectrumModel == rhs.m_spectrumModel);
+  NS_ASSERT (lhs.m_values.size () == rhs.m_values.size ());
+
+  const double *lv = lhs.m_values.data ();
+  double *v = rhs.m_values.data ();
+  size_t n = rhs.m_values.size ();
+  for (size_t i = 0; i < n; i++)
+    {
+      v[i] = lv[i] / v[i];
+    }
+  return std::move (rhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, SpectrumValue&& rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator/ (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Divide (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+operator- (SpectrumValue&& rhs)
+{
+  rhs.ChangeSign ();
+  return std::move (rhs);
+}
+
+SpectrumValue
+Pow (double lhs, SpectrumValue&& rhs)
+{
+  rhs.Exp (lhs);
+  return std::move (rhs);
+}
+
+SpectrumValue
+Pow (SpectrumValue&& lhs, double rhs)
+{
+  lhs.Pow (rhs);
+  return std::move (lhs);
+}
+
+SpectrumValue
+Log10 (SpectrumValue&& arg)
+{
+  arg.Log10 ();
+  return std::move (arg);
+}
+
+SpectrumValue
+Log2 (SpectrumValue&& arg)
+{
+  arg.Log2 ();
+  return std::move (arg);
+}
+
+SpectrumValue
+Log (SpectrumValue&& arg)
+{
+  arg.Log ();
+  return std::move (arg);
+}
+
 SpectrumValue&
 SpectrumValue::operator+= (const SpectrumValue& rhs)
 {
@@ -664,13 +833,7 @@ SpectrumValue::operator/= (double rhs)
 SpectrumValue&
 SpectrumValue::operator= (double rhs)
 {
-  Values::iterator it1 = m_values.begin ();
-
-  while (it1 != m_values.end ())
-    {
-      *it1 = rhs;
-      ++it1;
-    }
+  std::fill (m_values.begin (), m_values.end (), rhs);
   return *this;
 }
 
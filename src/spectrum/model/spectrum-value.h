@@ -297,6 +297,42 @@ public:
    */
   friend SpectrumValue operator- (const SpectrumValue& rhs);
 
+  /**
+   * \name Operators on temporary values
+   *
+   * These overloads return the same values as the ones above, but
+   * compute them in place of a temporary operand, such as the result of
+   * another operator, rather than in a new SpectrumValue: an expression
+   * like (a - b + c) / d allocates a single SpectrumValue.  A scalar
+   * minus or divided by a temporary still uses the overloads above.
+   * @{
+   */
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator+ (const SpectrumValue& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator+ (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator+ (double lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator- (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator- (const SpectrumValue& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator- (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator- (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator* (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator* (const SpectrumValue& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator* (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator* (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator* (double lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, const SpectrumValue& rhs);
+  friend SpectrumValue operator/ (const SpectrumValue& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, SpectrumValue&& rhs);
+  friend SpectrumValue operator/ (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue operator- (SpectrumValue&& rhs);
+  friend SpectrumValue Pow (SpectrumValue&& lhs, double rhs);
+  friend SpectrumValue Pow (double lhs, SpectrumValue&& rhs);
+  friend SpectrumValue Log10 (SpectrumValue&& arg);
+  friend SpectrumValue Log2 (SpectrumValue&& arg);
+  friend SpectrumValue Log (SpectrumValue&& arg);
+  /**@}*/
+
 
   /**
    * left shift operator
@@ -618,6 +654,11 @@ SpectrumValue Pow (double lhs, const SpectrumValue& rhs);
 SpectrumValue Log10 (const SpectrumValue& arg);
 SpectrumValue Log2 (const SpectrumValue& arg);
 SpectrumValue Log (const SpectrumValue& arg);
+SpectrumValue Pow (SpectrumValue&& lhs, double rhs);
+SpectrumValue Pow (double lhs, SpectrumValue&& rhs);
+SpectrumValue Log10 (SpectrumValue&& arg);
+SpectrumValue Log2 (SpectrumValue&& arg);
+SpectrumValue Log (SpectrumValue&& arg);
 double Integral (const SpectrumValue& arg);
 
 
@@ -0,0 +1,281 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/net-device.h>
+#include <ns3/antenna-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/test.h>
+
+using namespace ns3;
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief A SpectrumPhy which counts the signals it receives.
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  CountingSpectrumPhy ();
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d);
+  virtual Ptr<NetDevice> GetDevice () const;
+  virtual void SetMobility (Ptr<MobilityModel> m);
+  virtual Ptr<MobilityModel> GetMobility ();
+  virtual void SetChannel (Ptr<SpectrumChannel> c);
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const;
+  virtual Ptr<AntennaModel> GetRxAntenna ();
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params);
+
+  /**
+   * Set the SpectrumModel of the signals received.
+   * \param model the SpectrumModel
+   */
+  void SetRxSpectrumModel (Ptr<const SpectrumModel> model);
+
+  uint32_t m_received;                    //!< the signals received
+  SpectrumModelUid_t m_lastModelUid;      //!< the SpectrumModel of the last signal received
+
+private:
+  Ptr<MobilityModel> m_mobility;          //!< the mobility model
+  Ptr<const SpectrumModel> m_model;       //!< the SpectrumModel of the signals received
+};
+
+CountingSpectrumPhy::CountingSpectrumPhy ()
+  : m_received (0),
+    m_lastModelUid (0)
+{
+}
+
+void
+CountingSpectrumPhy::SetDevice (Ptr<NetDevice> d)
+{
+}
+
+Ptr<NetDevice>
+CountingSpectrumPhy::GetDevice () const
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::SetMobility (Ptr<MobilityModel> m)
+{
+  m_mobility = m;
+}
+
+Ptr<MobilityModel>
+CountingSpectrumPhy::GetMobility ()
+{
+  return m_mobility;
+}
+
+void
+CountingSpectrumPhy::SetChannel (Ptr<SpectrumChannel> c)
+{
+}
+
+Ptr<const SpectrumModel>
+CountingSpectrumPhy::GetRxSpectrumModel () const
+{
+  return m_model;
+}
+
+Ptr<AntennaModel>
+CountingSpectrumPhy::GetRxAntenna ()
+{
+  return 0;
+}
+
+void
+CountingSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
+{
+  m_received++;
+  m_lastModelUid = params->psd->GetSpectrumModelUid ();
+}
+
+void
+CountingSpectrumPhy::SetRxSpectrumModel (Ptr<const SpectrumModel> model)
+{
+  m_model = model;
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Check that a MultiModelSpectrumChannel with a MaxRange delivers
+ * the signals to the receivers within range only, converted to their
+ * SpectrumModel, while the receivers move and change SpectrumModel.
+ */
+class MultiModelSpectrumChannelMaxRangeTestCase : public TestCase
+{
+public:
+  MultiModelSpectrumChannelMaxRangeTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Count a path loss calculated.
+   * \param txPhy the transmitter
+   * \param rxPhy the receiver
+   * \param lossDb the loss
+   */
+  void PathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb);
+  /**
+   * Transmit a signal from a PHY.
+   * \param tx the transmitter
+   */
+  void Transmit (Ptr<CountingSpectrumPhy> tx);
+
+  Ptr<MultiModelSpectrumChannel> m_channel;            //!< the channel
+  std::vector<Ptr<CountingSpectrumPhy> > m_phys;       //!< the PHYs
+  Ptr<const SpectrumModel> m_txModel;                  //!< the SpectrumModel of the signals
+  uint32_t m_pathLosses;                               //!< the path losses calculated
+};
+
+MultiModelSpectrumChannelMaxRangeTestCase::MultiModelSpectrumChannelMaxRangeTestCase ()
+  : TestCase ("Check the receivers of a MultiModelSpectrumChannel with a MaxRange"),
+    m_pathLosses (0)
+{
+}
+
+void
+MultiModelSpectrumChannelMaxRangeTestCase::PathLoss (Ptr<SpectrumPhy> txPhy, Ptr<SpectrumPhy> rxPhy, double lossDb)
+{
+  m_pathLosses++;
+}
+
+void
+MultiModelSpectrumChannelMaxRangeTestCase::Transmit (Ptr<CountingSpectrumPhy> tx)
+{
+  Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+  params->txPhy = tx;
+  params->psd = Create<SpectrumValue> (m_txModel);
+  *params->psd = 1e-10;
+  params->duration = MicroSeconds (100);
+  m_channel->StartTx (params);
+}
+
+void
+MultiModelSpectrumChannelMaxRangeTestCase::DoRun (void)
+{
+  std::vector<double> freqs;
+  for (double f = 2.400e9; f < 2.420e9; f += 1e6)
+    {
+      freqs.push_back (f);
+    }
+  m_txModel = Create<SpectrumModel> (freqs);
+  std::vector<double> otherFreqs;
+  for (double f = 2.400e9; f < 2.420e9; f += 5e6)
+    {
+      otherFreqs.push_back (f);
+    }
+  Ptr<const SpectrumModel> otherModel = Create<SpectrumModel> (otherFreqs);
+
+  m_channel = CreateObject<MultiModelSpectrumChannel> ();
+  m_channel->SetAttribute ("MaxRange", DoubleValue (100));
+  m_channel->TraceConnectWithoutContext ("PathLoss", MakeCallback (&MultiModelSpectrumChannelMaxRangeTestCase::PathLoss, this));
+
+  // the transmitter at the origin, then receivers at 50, 99, 101 and
+  // 300 m alternating between the two SpectrumModels, then a receiver
+  // without mobility model
+  double xs[] = { 0, 50, 99, 101, 300 };
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      Ptr<CountingSpectrumPhy> phy = CreateObject<CountingSpectrumPhy> ();
+      phy->SetRxSpectrumModel (i % 2 ? otherModel : m_txModel);
+      m_channel->AddRx (phy);
+      m_phys.push_back (phy);
+    }
+  // the mobility models are set after the PHYs are added to the channel
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+      mobility->SetPosition (Vector (xs[i], 0, 0));
+      m_phys[i]->SetMobility (mobility);
+    }
+  Ptr<CountingSpectrumPhy> tx = m_phys[0];
+
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannelMaxRangeTestCase::Transmit, this, tx);
+  Simulator::Stop (Seconds (1.5));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (tx->m_received, 0, "The transmitter received its own signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[1]->m_received, 1, "Receiver at 50 m missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[1]->m_lastModelUid, otherModel->GetUid (), "Signal not converted");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[2]->m_received, 1, "Receiver at 99 m missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[2]->m_lastModelUid, m_txModel->GetUid (), "Signal converted needlessly");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[3]->m_received, 0, "Receiver at 101 m got the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[4]->m_received, 0, "Receiver at 300 m got the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[5]->m_received, 1, "Receiver without mobility model missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_pathLosses, 2, "Path loss calculated for receivers out of range");
+
+  // move the receiver at 300 m within range, and switch the one at 99 m
+  // to the other SpectrumModel
+  m_phys[4]->GetMobility ()->SetPosition (Vector (-80, 0, 0));
+  m_phys[2]->SetRxSpectrumModel (otherModel);
+  m_channel->AddRx (m_phys[2]);
+  NS_TEST_EXPECT_MSG_EQ (m_channel->GetNDevices (), 6, "Receiver added twice");
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannelMaxRangeTestCase::Transmit, this, tx);
+  Simulator::Stop (Seconds (1.5));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_phys[1]->m_received, 2, "Receiver at 50 m missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[2]->m_received, 2, "Receiver at 99 m missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[2]->m_lastModelUid, otherModel->GetUid (), "SpectrumModel change not accounted for");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[3]->m_received, 0, "Receiver at 101 m got the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[4]->m_received, 1, "Receiver moved at 80 m missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[5]->m_received, 2, "Receiver without mobility model missed the signal");
+
+  // without MaxRange, every receiver gets the signal
+  m_channel->SetAttribute ("MaxRange", DoubleValue (0));
+  Simulator::Schedule (Seconds (1), &MultiModelSpectrumChannelMaxRangeTestCase::Transmit, this, tx);
+  Simulator::Stop (Seconds (1.5));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_phys[3]->m_received, 1, "Receiver at 101 m missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[4]->m_received, 2, "Receiver at 80 m missed the signal");
+  NS_TEST_EXPECT_MSG_EQ (m_phys[5]->m_received, 3, "Receiver without mobility model missed the signal");
+
+  m_channel->Dispose ();
+  m_channel = 0;
+  m_phys.clear ();
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief MultiModelSpectrumChannel TestSuite
+ */
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ()
+    : TestSuite ("multi-model-spectrum-channel", UNIT)
+  {
+    AddTestCase (new MultiModelSpectrumChannelMaxRangeTestCase, TestCase::QUICK);
+  }
+};
+
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite;
@@ -227,6 +227,32 @@ SpectrumValueTestSuite::SpectrumValueTestSuite ()
 
 
 
+  // the same operations on temporary operands
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) + v2, v3, "tv3 = temp + v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (v1 + SpectrumValue (v2), v3, "tv3 = v1 + temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) - v2, v4, "tv4 = temp - v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (v1 - SpectrumValue (v2), v4, "tv4 = v1 - temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) - SpectrumValue (v2), v4, "tv4 = temp - temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) * v2, v5, "tv5 = temp * v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (v1 * SpectrumValue (v2), v5, "tv5 = v1 * temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) / v2, v6, "tv6 = temp div v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (v1 / SpectrumValue (v2), v6, "tv6 = v1 div temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) / SpectrumValue (v2), v6, "tv6 = temp div temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) + doubleValue, v7, "tv7 = temp + doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (doubleValue + SpectrumValue (v1), v7, "tv7 = doubleValue + temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) - doubleValue, v8, "tv8 = temp - doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (doubleValue - SpectrumValue (v1), tv8b, "tv8 = doubleValue - temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) * doubleValue, v9, "tv9 = temp * doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (doubleValue * SpectrumValue (v1), v9, "tv9 = doubleValue * temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (SpectrumValue (v1) / doubleValue, v10, "tv10 = temp div doubleValue"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (doubleValue / SpectrumValue (v1), tv10b, "tv10 = doubleValue div temp"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (v1 - v2 + v2, v1, "v1 = v1 - v2 + v2"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (-(v1 + v2), -v3, "-v3 = -(v1 + v2)"), TestCase::QUICK);
+  SpectrumValue v1squared = v1 * v1;
+  AddTestCase (new SpectrumValueTestCase (Log10 (v1 * v1), Log10 (v1squared), "Log10 (v1 * v1)"), TestCase::QUICK);
+  AddTestCase (new SpectrumValueTestCase (Pow (v1 * 1.0, 2), v1 * v1, "Pow (v1, 2)"), TestCase::QUICK);
+
+
   SpectrumValue v1ls3 (f), v1rs3 (f);
   SpectrumValue tv1ls3 (f), tv1rs3 (f);
 
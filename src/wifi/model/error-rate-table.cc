@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "error-rate-table.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ErrorRateTable");
+
+/// The lowest SNR sampled, in dB
+static const double MIN_SNR_DB = -200;
+/// The highest SNR sampled, in dB
+static const double MAX_SNR_DB = 100;
+/// The largest number of steps of a segment
+static const uint32_t MAX_STEPS = 1 << 16;
+
+/**
+ * \param ber the bit error rate
+ * \param snrDb the SNR, in dB
+ *
+ * \return the bit error rate at the SNR
+ */
+static double
+GetBer (Callback<double, double> ber, double snrDb)
+{
+  return ber (std::pow (10.0, snrDb / 10.0));
+}
+
+ErrorRateTable::ErrorRateTable (Callback<double, double> ber, double maxError)
+{
+  NS_LOG_FUNCTION (this << maxError);
+  NS_ASSERT (maxError > 0 && maxError < 1);
+  // beyond this bit error rate, even the largest chunks are received
+  // with a success rate within the maximum error of 1
+  double minBer = maxError / std::numeric_limits<uint32_t>::max ();
+  NS_ASSERT_MSG (GetBer (ber, MAX_SNR_DB) <= minBer, "Bit error rate too high at " << MAX_SNR_DB << " dB");
+
+  // sample from the SNR at which the bit error rate falls below its value
+  // at a zero SNR, within the maximum error, to the SNR at which it falls
+  // below minBer
+  m_zeroSnrBer = ber (0);
+  double maxBer = m_zeroSnrBer * (1 - maxError);
+  NS_ASSERT_MSG (GetBer (ber, MIN_SNR_DB) >= maxBer, "Bit error rate too low at " << MIN_SNR_DB << " dB");
+  double low = MIN_SNR_DB;
+  double high = MAX_SNR_DB;
+  while (high - low > 1e-9)
+    {
+      double middle = (low + high) / 2;
+      (GetBer (ber, middle) >= maxBer ? low : high) = middle;
+    }
+  m_minDb = low;
+  high = MAX_SNR_DB;
+  while (high - low > 1e-9)
+    {
+      double middle = (low + high) / 2;
+      (GetBer (ber, middle) > minBer ? low : high) = middle;
+    }
+
+  for (double startDb = m_minDb; startDb < high; startDb += 1)
+    {
+      Segment segment;
+      segment.first = m_logBer.size ();
+      segment.nSteps = 1;
+      while (!Sample (ber, maxError, startDb, segment.nSteps))
+        {
+          m_logBer.resize (segment.first);
+          segment.nSteps *= 2;
+          NS_ASSERT_MSG (segment.nSteps <= MAX_STEPS, "Bit error rate not interpolated within " << maxError);
+        }
+      m_segments.push_back (segment);
+    }
+
+  // the samples are only checked against the bit error rates between
+  // them: check the ones beyond the ends of the table, which are not
+  // interpolated, at the sampled extremes and every dB past them
+  double endDb = m_minDb + m_segments.size ();
+  for (double snrDb = m_minDb; snrDb > MIN_SNR_DB; snrDb -= 1)
+    {
+      NS_ABORT_MSG_IF (std::fabs (GetBer (ber, snrDb) - m_zeroSnrBer) > maxError * m_zeroSnrBer,
+                       "Bit error rate not within " << maxError << " of its value at a zero SNR at " << snrDb << " dB");
+    }
+  for (double snrDb = endDb; snrDb < MAX_SNR_DB; snrDb += 1)
+    {
+      NS_ABORT_MSG_IF (GetBer (ber, snrDb) > minBer, "Bit error rate too high at " << snrDb << " dB");
+    }
+  NS_LOG_DEBUG ("bit error rate sampled from " << m_minDb << " dB to " << high
+                << " dB with " << m_logBer.size () << " samples");
+}
+
+bool
+ErrorRateTable::Sample (Callback<double, double> ber, double maxError, double startDb, uint32_t nSteps)
+{
+  NS_LOG_FUNCTION (this << maxError << startDb << nSteps);
+  uint32_t first = m_logBer.size ();
+  double step = 1.0 / nSteps;
+  for (uint32_t i = 0; i <= nSteps; i++)
+    {
+      m_logBer.push_back (std::log (std::max (GetBer (ber, startDb + i * step), std::numeric_limits<double>::min ())));
+    }
+  // the error is largest within the steps, where the bit error rate is
+  // furthest from its chord: check it at the quarters of each step
+  for (uint32_t i = 0; i < nSteps; i++)
+    {
+      for (uint32_t quarter = 1; quarter < 4; quarter++)
+        {
+          double fraction = quarter / 4.0;
+          double exact = GetBer (ber, startDb + (i + fraction) * step);
+          double interpolated = std::exp (m_logBer[first + i] + fraction * (m_logBer[first + i + 1] - m_logBer[first + i]));
+          if (std::fabs (interpolated - exact) > maxError * exact)
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+double
+ErrorRateTable::GetChunkSuccessRate (double snr, uint32_t nbits) const
+{
+  double position = 10 * std::log10 (snr) - m_minDb;
+  if (position >= m_segments.size ())
+    {
+      return 1.0;
+    }
+  double ber = m_zeroSnrBer;
+  if (position > 0)
+    {
+      uint32_t s = static_cast<uint32_t> (position);
+      const Segment &segment = m_segments[s];
+      position = (position - s) * segment.nSteps;
+      uint32_t i = std::min (static_cast<uint32_t> (position), segment.nSteps - 1);
+      const double *logBer = &m_logBer[segment.first + i];
+      ber = std::exp (logBer[0] + (position - i) * (logBer[1] - logBer[0]));
+    }
+  return std::pow (1 - ber, static_cast<double> (nbits));
+}
+
+} //namespace ns3
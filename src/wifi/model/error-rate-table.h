@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ERROR_RATE_TABLE_H
+#define ERROR_RATE_TABLE_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/callback.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief A table of the bit error rate of a coded modulation against the
+ * SNR, from which the success rate of the chunks is interpolated.
+ *
+ * The success rate of a chunk of n bits received with a bit error rate
+ * p after decoding is (1 - p)^n, so that a single table of p serves the
+ * chunks of every size.  The logarithm of p is sampled over segments of
+ * 1 dB, each with the largest step, halved from 1 dB, with which the bit
+ * error rates interpolated between the samples are within a relative
+ * error of the maximum error of the chunk success rates; since
+ * n p (1 - p)^(n - 1) is at most 1, this bounds the error of the chunk
+ * success rates as well.  Below the first segment, the bit error rate is
+ * within the maximum error of its value at a zero SNR, and beyond the
+ * last one, the chunks of up to 2^32 bits are received with a success
+ * rate within the maximum error of 1; both are checked every dB from the
+ * ends of the table.
+ *
+ * The table does not keep the bit error rate function, so that a table
+ * may be shared by all the instances of an error rate model.
+ */
+class ErrorRateTable
+{
+public:
+  /**
+   * Sample the bit error rate of a coded modulation.
+   *
+   * \param ber the bit error rate after decoding, at most 1, as a
+   *        function of the SNR (linear), which must not increase with the SNR
+   * \param maxError the maximum error of the chunk success rates
+   */
+  ErrorRateTable (Callback<double, double> ber, double maxError);
+
+  /**
+   * \param snr the SNR of the chunk (linear)
+   * \param nbits the number of bits in the chunk
+   *
+   * \return the probability of successfully receiving the chunk
+   */
+  double GetChunkSuccessRate (double snr, uint32_t nbits) const;
+
+
+private:
+  /**
+   * Sample the bit error rate over a segment.
+   *
+   * \param ber the bit error rate
+   * \param maxError the maximum error of the chunk success rates
+   * \param startDb the start of the segment, in dB
+   * \param nSteps the number of steps of the segment
+   *
+   * \return true if the bit error rates interpolated at the quarters of
+   *         the steps between the samples are within the maximum error
+   */
+  bool Sample (Callback<double, double> ber, double maxError, double startDb, uint32_t nSteps);
+
+  /// A segment of 1 dB of the table
+  struct Segment
+  {
+    uint32_t first;  //!< the index of the first sample of the segment
+    uint32_t nSteps; //!< the number of steps between the samples of the segment
+  };
+
+  double m_zeroSnrBer;            //!< the bit error rate at a zero SNR
+  double m_minDb;                 //!< the start of the first segment, in dB
+  std::vector<Segment> m_segments; //!< the segments
+  std::vector<double> m_logBer;   //!< the logarithms of the sampled bit error rates
+};
+
+} //namespace ns3
+
+#endif /* ERROR_RATE_TABLE_H */
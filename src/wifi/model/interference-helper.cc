@@ -104,28 +104,28 @@ InterferenceHelper::Event::GetPreambleType (void) const
  *       short period of time.
  ****************************************************************/
 
-InterferenceHelper::NiChange::NiChange (Time time, double delta)
-  : m_time (time),
-    m_delta (delta)
+InterferenceHelper::NiChange::NiChange (double power, Ptr<InterferenceHelper::Event> event)
+  : m_power (power),
+    m_event (event)
 {
 }
 
-Time
-InterferenceHelper::NiChange::GetTime (void) const
+double
+InterferenceHelper::NiChange::GetPower (void) const
 {
-  return m_time;
+  return m_power;
 }
 
-double
-InterferenceHelper::NiChange::GetDelta (void) const
+void
+InterferenceHelper::NiChange::AddPower (double power)
 {
-  return m_delta;
+  m_power += power;
 }
 
-bool
-InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o) const
+Ptr<InterferenceHelper::Event>
+InterferenceHelper::NiChange::GetEvent (void) const
 {
-  return (m_time < o.m_time);
+  return m_event;
 }
 
 
@@ -135,9 +135,10 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
 
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
-    m_firstPower (0.0),
     m_rxing (false)
 {
+  // the medium is idle until the first signal starts
+  m_niChanges.insert (std::make_pair (Time (0), NiChange (0.0, 0)));
 }
 
 InterferenceHelper::~InterferenceHelper ()
@@ -199,18 +200,11 @@ Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
-  double noiseInterferenceW = 0.0;
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  for (NiChanges::const_iterator i = m_niChanges.lower_bound (now); i != m_niChanges.end (); i++)
     {
-      noiseInterferenceW += i->GetDelta ();
-      end = i->GetTime ();
-      if (end < now)
-        {
-          continue;
-        }
-      if (noiseInterferenceW < energyW)
+      end = i->first;
+      if (i->second.GetPower () < energyW)
         {
           break;
         }
@@ -221,23 +215,20 @@ InterferenceHelper::GetEnergyDuration (double energyW)
 void
 InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
 {
-  Time now = Simulator::Now ();
+  double previousPowerStart = GetPreviousPosition (event->GetStartTime ())->second.GetPower ();
+  double previousPowerEnd = GetPreviousPosition (event->GetEndTime ())->second.GetPower ();
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
-        {
-          m_firstPower += i->GetDelta ();
-        }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      // forget the changes up to now, but the power they add up to
+      m_niChanges.erase (m_niChanges.begin (), GetNextPosition (event->GetStartTime ()));
+      m_niChanges.insert (std::make_pair (event->GetStartTime (), NiChange (previousPowerStart, 0)));
     }
-  else
+  NiChanges::iterator first = AddNiChangeEvent (event->GetStartTime (), NiChange (previousPowerStart, event));
+  NiChanges::iterator last = AddNiChangeEvent (event->GetEndTime (), NiChange (previousPowerEnd, event));
+  for (NiChanges::iterator i = first; i != last; i++)
     {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRxPowerW ()));
+      i->second.AddPower (event->GetRxPowerW ());
     }
-  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRxPowerW ()));
-
 }
 
 
@@ -259,18 +250,27 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, uint3
 double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
 {
-  double noiseInterference = m_firstPower;
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  NiChanges::const_iterator i = m_niChanges.lower_bound (event->GetStartTime ());
+  while (i->second.GetEvent () != event)
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
+      i++;
+      NS_ASSERT (i != m_niChanges.end ());
     }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
+  // the changes at the same time which were added before the event are
+  // part of the interference at its start; the first change is never
+  // the start of an event
+  NS_ASSERT (i != m_niChanges.begin ());
+  NiChanges::const_iterator previous = i;
+  previous--;
+  double noiseInterference = previous->second.GetPower ();
+  ni->insert (ni->end (), std::make_pair (event->GetStartTime (), NiChange (noiseInterference, event)));
+  for (i++; i->second.GetEvent () != event; i++)
+    {
+      NS_ASSERT (i != m_niChanges.end ());
+      ni->insert (ni->end (), std::make_pair (i->first, NiChange (i->second.GetPower () - event->GetRxPowerW (), i->second.GetEvent ())));
+    }
+  ni->insert (ni->end (), std::make_pair (event->GetEndTime (), NiChange (0, event)));
   return noiseInterference;
 }
 
@@ -293,19 +293,19 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
   NS_LOG_FUNCTION (this);
   double psr = 1.0; /* Packet Success Rate */
   NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  Time previous = j->first;
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
-  Time plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector (), preamble); //packet start time + preamble
+  Time plcpHeaderStart = j->first + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector (), preamble); //packet start time + preamble
   Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (event->GetTxVector (), preamble); //packet start time + preamble + L-SIG
   Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble) + WifiPhy::GetPlcpVhtSigA1Duration (preamble) + WifiPhy::GetPlcpVhtSigA2Duration (preamble); //packet start time + preamble + L-SIG + HT-SIG or VHT-SIG-A (A1 + A2)
   Time plcpPayloadStart = plcpHtTrainingSymbolsStart + WifiPhy::GetPlcpHtTrainingSymbolDuration (preamble, event->GetTxVector ()) + WifiPhy::GetPlcpVhtSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or VHT-SIG-A (A1 + A2) + (V)HT Training + VHT-SIG-B
-  double noiseInterferenceW = (*j).GetDelta ();
+  double noiseInterferenceW = j->second.GetPower ();
   double powerW = event->GetRxPowerW ();
   j++;
   while (ni->end () != j)
     {
-      Time current = (*j).GetTime ();
+      Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
       //Case 1: Both previous and current point to the payload
@@ -330,8 +330,8 @@ InterferenceHelper::CalculatePlcpPayloadPer (Ptr<const InterferenceHelper::Event
           NS_LOG_DEBUG ("previous is before payload and current is in the payload: mode=" << payloadMode << ", psr=" << psr);
         }
 
-      noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
+      noiseInterferenceW = j->second.GetPower ();
+      previous = j->first;
       j++;
     }
 
@@ -345,7 +345,7 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
   NS_LOG_FUNCTION (this);
   double psr = 1.0; /* Packet Success Rate */
   NiChanges::iterator j = ni->begin ();
-  Time previous = (*j).GetTime ();
+  Time previous = j->first;
   WifiMode payloadMode = event->GetPayloadMode ();
   WifiPreamble preamble = event->GetPreambleType ();
   WifiMode htHeaderMode;
@@ -360,16 +360,16 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
       htHeaderMode = WifiPhy::GetVhtPlcpHeaderMode (payloadMode);
     }
   WifiMode headerMode = WifiPhy::GetPlcpHeaderMode (payloadMode, preamble, event->GetTxVector ());
-  Time plcpHeaderStart = (*j).GetTime () + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector (), preamble); //packet start time + preamble
+  Time plcpHeaderStart = j->first + WifiPhy::GetPlcpPreambleDuration (event->GetTxVector (), preamble); //packet start time + preamble
   Time plcpHsigHeaderStart = plcpHeaderStart + WifiPhy::GetPlcpHeaderDuration (event->GetTxVector (), preamble); //packet start time + preamble + L-SIG
   Time plcpHtTrainingSymbolsStart = plcpHsigHeaderStart + WifiPhy::GetPlcpHtSigHeaderDuration (preamble) + WifiPhy::GetPlcpVhtSigA1Duration (preamble) + WifiPhy::GetPlcpVhtSigA2Duration (preamble); //packet start time + preamble + L-SIG + HT-SIG or VHT-SIG-A (A1 + A2)
   Time plcpPayloadStart = plcpHtTrainingSymbolsStart + WifiPhy::GetPlcpHtTrainingSymbolDuration (preamble, event->GetTxVector ()) + WifiPhy::GetPlcpVhtSigBDuration (preamble); //packet start time + preamble + L-SIG + HT-SIG or VHT-SIG-A (A1 + A2) + (V)HT Training + VHT-SIG-B
-  double noiseInterferenceW = (*j).GetDelta ();
+  double noiseInterferenceW = j->second.GetPower ();
   double powerW = event->GetRxPowerW ();
   j++;
   while (ni->end () != j)
     {
-      Time current = (*j).GetTime ();
+      Time current = j->first;
       NS_LOG_DEBUG ("previous= " << previous << ", current=" << current);
       NS_ASSERT (current >= previous);
       //Case 1: previous and current after playload start: nothing to do
@@ -784,8 +784,8 @@ InterferenceHelper::CalculatePlcpHeaderPer (Ptr<const InterferenceHelper::Event>
             }
         }
 
-      noiseInterferenceW += (*j).GetDelta ();
-      previous = (*j).GetTime ();
+      noiseInterferenceW = j->second.GetPower ();
+      previous = j->first;
       j++;
     }
 
@@ -837,20 +837,28 @@ void
 InterferenceHelper::EraseEvents (void)
 {
   m_niChanges.clear ();
+  m_niChanges.insert (std::make_pair (Time (0), NiChange (0.0, 0)));
   m_rxing = false;
-  m_firstPower = 0.0;
 }
 
 InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPosition (Time moment)
+InterferenceHelper::GetNextPosition (Time moment)
 {
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
+  return m_niChanges.upper_bound (moment);
 }
 
-void
-InterferenceHelper::AddNiChangeEvent (NiChange change)
+InterferenceHelper::NiChanges::iterator
+InterferenceHelper::GetPreviousPosition (Time moment)
+{
+  NiChanges::iterator it = GetNextPosition (moment);
+  NS_ASSERT (it != m_niChanges.begin ());
+  return --it;
+}
+
+InterferenceHelper::NiChanges::iterator
+InterferenceHelper::AddNiChangeEvent (Time moment, NiChange change)
 {
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
+  return m_niChanges.insert (GetNextPosition (moment), std::make_pair (moment, change));
 }
 
 void
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <map>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -223,47 +224,52 @@ private:
 
 private:
   /**
-   * Noise and Interference (thus Ni) event.
+   * Noise and Interference (thus Ni) event: a signal starts or ends, and
+   * the total power on the medium changes.
    */
   class NiChange
   {
 public:
     /**
-     * Create a NiChange at the given time and the amount of NI change.
+     * Create a NiChange with the power on the medium after the change.
      *
-     * \param time time of the event
-     * \param delta the power
+     * \param power the power (W)
+     * \param event the signal which starts or ends, or 0
      */
-    NiChange (Time time, double delta);
+    NiChange (double power, Ptr<Event> event);
     /**
-     * Return the event time.
+     * Return the power on the medium after the change.
      *
-     * \return the event time.
+     * \return the power (W)
      */
-    Time GetTime (void) const;
+    double GetPower (void) const;
     /**
-     * Return the power
+     * Add a power to the power on the medium after the change.
      *
-     * \return the power
+     * \param power the power (W)
      */
-    double GetDelta (void) const;
+    void AddPower (double power);
     /**
-     * Compare the event time of two NiChange objects (a < o).
+     * Return the signal which starts or ends.
      *
-     * \param o
-     * \return true if a < o.time, false otherwise
+     * \return the event
      */
-    bool operator < (const NiChange& o) const;
+    Ptr<Event> GetEvent (void) const;
 
 
 private:
-    Time m_time;
-    double m_delta;
+    double m_power;
+    Ptr<Event> m_event;
   };
   /**
-   * typedef for a vector of NiChanges
+   * The changes of the power on the medium, indexed by time.  The
+   * changes at the same time are kept in the order they were added.
+   * Each change records the total power from its time to the time of
+   * the next change, i.e. the sum of the power of all the signals
+   * started so far, so that the power at any time is found without
+   * adding up the changes which precede it.
    */
-  typedef std::vector <NiChange> NiChanges;
+  typedef std::multimap<Time, NiChange> NiChanges;
   /**
    * typedef for a list of Events
    */
@@ -279,7 +285,8 @@ private:
    * Calculate noise and interference power in W.
    *
    * \param event
-   * \param ni
+   * \param ni the changes of the noise and interference power during the event,
+   *        recording the power excluding the event
    *
    * \return noise and interference power
    */
@@ -332,16 +339,21 @@ private:
   Ptr<ErrorRateModel> m_errorRateModel;
   /// Experimental: needed for energy duration calculation
   NiChanges m_niChanges;
-  double m_firstPower;
   bool m_rxing;
   /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
+  NiChanges::iterator GetNextPosition (Time moment);
+  /// Returns an iterator to the last nichange, which is not later than moment
+  NiChanges::iterator GetPreviousPosition (Time moment);
   /**
-   * Add NiChange to the list at the appropriate position.
+   * Add NiChange to the list at the appropriate position, after the
+   * changes at the same time.
    *
+   * \param moment the time of the change
    * \param change
+   *
+   * \return an iterator to the change
    */
-  void AddNiChangeEvent (NiChange change);
+  NiChanges::iterator AddNiChangeEvent (Time moment, NiChange change);
 };
 
 } //namespace ns3
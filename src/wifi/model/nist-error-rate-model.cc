@@ -20,9 +20,12 @@
  */
 
 #include <cmath>
+#include <map>
 #include "nist-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -37,11 +40,19 @@ NistErrorRateModel::GetTypeId (void)
     .SetParent<ErrorRateModel> ()
     .SetGroupName ("Wifi")
     .AddConstructor<NistErrorRateModel> ()
+    .AddAttribute ("MaxTableError",
+                   "The maximum error of the chunk success rates of the OFDM modulations "
+                   "interpolated from tables of the bit error rates, or zero to calculate "
+                   "them exactly.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&NistErrorRateModel::m_maxTableError),
+                   MakeDoubleChecker<double> (0, 0.1))
   ;
   return tid;
 }
 
 NistErrorRateModel::NistErrorRateModel ()
+  : m_maxTableError (0)
 {
 }
 
@@ -94,38 +105,6 @@ NistErrorRateModel::Get256QamBer (double snr) const
   return ber;
 }
 
-double
-NistErrorRateModel::GetFecBpskBer (double snr, uint32_t nbits,
-                                   uint32_t bValue) const
-{
-  NS_LOG_FUNCTION (this << snr << nbits << bValue);
-  double ber = GetBpskBer (snr);
-  if (ber == 0.0)
-    {
-      return 1.0;
-    }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, (double)nbits);
-  return pms;
-}
-
-double
-NistErrorRateModel::GetFecQpskBer (double snr, uint32_t nbits,
-                                   uint32_t bValue) const
-{
-  NS_LOG_FUNCTION (this << snr << nbits << bValue);
-  double ber = GetQpskBer (snr);
-  if (ber == 0.0)
-    {
-      return 1.0;
-    }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, (double)nbits);
-  return pms;
-}
-
 double
 NistErrorRateModel::CalculatePe (double p, uint32_t bValue) const
 {
@@ -199,51 +178,68 @@ NistErrorRateModel::CalculatePe (double p, uint32_t bValue) const
 }
 
 double
-NistErrorRateModel::GetFec16QamBer (double snr, uint32_t nbits,
-                                    uint32_t bValue) const
+NistErrorRateModel::GetFecBer (uint32_t constellationSize, uint32_t bValue, double snr) const
 {
-  NS_LOG_FUNCTION (this << snr << nbits << bValue);
-  double ber = Get16QamBer (snr);
+  NS_LOG_FUNCTION (this << constellationSize << bValue << snr);
+  double ber;
+  switch (constellationSize)
+    {
+    case 2:
+      ber = GetBpskBer (snr);
+      break;
+    case 4:
+      ber = GetQpskBer (snr);
+      break;
+    case 16:
+      ber = Get16QamBer (snr);
+      break;
+    case 64:
+      ber = Get64QamBer (snr);
+      break;
+    case 256:
+      ber = Get256QamBer (snr);
+      break;
+    default:
+      NS_FATAL_ERROR ("Unsupported constellation size " << constellationSize);
+    }
   if (ber == 0.0)
     {
-      return 1.0;
+      return 0.0;
     }
   double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, static_cast<double> (nbits));
-  return pms;
+  return std::min (pe, 1.0);
 }
 
-double
-NistErrorRateModel::GetFec64QamBer (double snr, uint32_t nbits,
-                                    uint32_t bValue) const
+NistErrorRateModel::Tables &
+NistErrorRateModel::GetTables (void)
 {
-  NS_LOG_FUNCTION (this << snr << nbits << bValue);
-  double ber = Get64QamBer (snr);
-  if (ber == 0.0)
-    {
-      return 1.0;
-    }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, static_cast<double> (nbits));
-  return pms;
+  static Tables tables;
+  return tables;
 }
 
-double
-NistErrorRateModel::GetFec256QamBer (double snr, uint32_t nbits,
-                                     uint32_t bValue) const
+void
+NistErrorRateModel::ClearTables (void)
 {
-  NS_LOG_FUNCTION (this << snr << nbits << bValue);
-  double ber = Get256QamBer (snr);
-  if (ber == 0.0)
+  GetTables ().clear ();
+}
+
+const ErrorRateTable &
+NistErrorRateModel::GetTable (uint32_t constellationSize, uint32_t bValue) const
+{
+  Tables &tables = GetTables ();
+  Tables::key_type key (m_maxTableError, std::make_pair (constellationSize, bValue));
+  Tables::const_iterator i = tables.find (key);
+  if (i == tables.end ())
     {
-      return 1.0;
+      if (tables.empty ())
+        {
+          Simulator::ScheduleDestroy (&ClearTables);
+        }
+      NS_LOG_DEBUG ("build the table of constellation size " << constellationSize << " and b value " << bValue);
+      Callback<double, double> ber = MakeCallback (&NistErrorRateModel::GetFecBer, this).TwoBind (constellationSize, bValue);
+      i = tables.insert (std::make_pair (key, ErrorRateTable (ber, m_maxTableError))).first;
     }
-  double pe = CalculatePe (ber, bValue);
-  pe = std::min (pe, 1.0);
-  double pms = std::pow (1 - pe, static_cast<double> (nbits));
-  return pms;
+  return i->second;
 }
 
 double
@@ -255,89 +251,30 @@ NistErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, d
       || mode.GetModulationClass () == WIFI_MOD_CLASS_HT
       || mode.GetModulationClass () == WIFI_MOD_CLASS_VHT)
     {
-      if (mode.GetConstellationSize () == 2)
+      uint32_t bValue;
+      switch (mode.GetCodeRate ())
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    1); //b value
-            }
-          else
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    3); //b value
-            }
-        }
-      else if (mode.GetConstellationSize () == 4)
-        {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQpskBer (snr,
-                                    nbits,
-                                    1); //b value
-            }
-          else
-            {
-              return GetFecQpskBer (snr,
-                                    nbits,
-                                    3); //b value
-            }
-        }
-      else if (mode.GetConstellationSize () == 16)
-        {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFec16QamBer (snr,
-                                     nbits,
-                                     1); //b value
-            }
-          else
-            {
-              return GetFec16QamBer (snr,
-                                     nbits,
-                                     3); //b value
-            }
-        }
-      else if (mode.GetConstellationSize () == 64)
-        {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_2_3)
-            {
-              return GetFec64QamBer (snr,
-                                     nbits,
-                                     2); //b value
-            }
-          else if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-            {
-              return GetFec64QamBer (snr,
-                                     nbits,
-                                     5); //b value
-            }
-          else
-            {
-              return GetFec64QamBer (snr,
-                                     nbits,
-                                     3); //b value
-            }
+        case WIFI_CODE_RATE_1_2:
+          bValue = 1;
+          break;
+        case WIFI_CODE_RATE_2_3:
+          bValue = 2;
+          break;
+        case WIFI_CODE_RATE_3_4:
+          bValue = 3;
+          break;
+        case WIFI_CODE_RATE_5_6:
+          bValue = 5;
+          break;
+        default:
+          NS_FATAL_ERROR ("Unsupported code rate of mode " << mode);
         }
-      else if (mode.GetConstellationSize () == 256)
+      if (m_maxTableError > 0)
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-            {
-              return GetFec256QamBer (snr,
-                                      nbits,
-                                      5     // b value
-                                      );
-            }
-          else
-            {
-              return GetFec256QamBer (snr,
-                                      nbits,
-                                      3     // b value
-                                      );
-            }
+          return GetTable (mode.GetConstellationSize (), bValue).GetChunkSuccessRate (snr, nbits);
         }
+      double pe = GetFecBer (mode.GetConstellationSize (), bValue, snr);
+      return std::pow (1 - pe, static_cast<double> (nbits));
     }
   else if (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS || mode.GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS)
     {
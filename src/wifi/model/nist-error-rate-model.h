@@ -22,8 +22,10 @@
 #define NIST_ERROR_RATE_MODEL_H
 
 #include <stdint.h>
+#include <map>
 #include "wifi-mode.h"
 #include "error-rate-model.h"
+#include "error-rate-table.h"
 #include "dsss-error-rate-model.h"
 
 namespace ns3 {
@@ -35,6 +37,11 @@ namespace ns3 {
  * the model description and validation can be found in
  * http://www.nsnam.org/~pei/80211ofdm.pdf.  For DSSS modulations (802.11b),
  * the model uses the DsssErrorRateModel.
+ *
+ * When the MaxTableError attribute is not zero, the chunk success rates of
+ * the OFDM modulations are interpolated from an ErrorRateTable of each
+ * constellation and code rate, built the first time it is needed and
+ * shared by all the instances until the simulator is destroyed.
  */
 class NistErrorRateModel : public ErrorRateModel
 {
@@ -96,59 +103,39 @@ private:
    */
   double Get256QamBer (double snr) const;
   /**
-   * Return BER of BPSK at the given SNR after applying FEC.
+   * Return the BER of a modulation at the given SNR after applying FEC.
    *
-   * \param snr snr ratio (not dB)
-   * \param nbits the number of bits in the chunk
+   * \param constellationSize the size of the constellation
    * \param bValue
-   *
-   * \return BER of BPSK at the given SNR after applying FEC
-   */
-  double GetFecBpskBer (double snr, uint32_t nbits,
-                        uint32_t bValue) const;
-  /**
-   * Return BER of QPSK at the given SNR after applying FEC.
-   *
    * \param snr snr ratio (not dB)
-   * \param nbits the number of bits in the chunk
-   * \param bValue
    *
-   * \return BER of QPSK at the given SNR after applying FEC
+   * \return the BER after applying FEC, at most 1
    */
-  double GetFecQpskBer (double snr, uint32_t nbits,
-                        uint32_t bValue) const;
+  double GetFecBer (uint32_t constellationSize, uint32_t bValue, double snr) const;
+  /// The tables of the BER, by maximum error and modulation
+  typedef std::map<std::pair<double, std::pair<uint32_t, uint32_t> >, ErrorRateTable> Tables;
+
   /**
-   * Return BER of QAM16 at the given SNR after applying FEC.
-   *
-   * \param snr snr ratio (not dB)
-   * \param nbits the number of bits in the chunk
-   * \param bValue
-   *
-   * \return BER of QAM16 at the given SNR after applying FEC
+   * \return the tables of the BER shared by all the instances
    */
-  double GetFec16QamBer (double snr, uint32_t nbits,
-                         uint32_t bValue) const;
+  static Tables & GetTables (void);
   /**
-   * Return BER of QAM64 at the given SNR after applying FEC.
-   *
-   * \param snr snr ratio (not dB)
-   * \param nbits the number of bits in the chunk
-   * \param bValue
-   *
-   * \return BER of QAM64 at the given SNR after applying FEC
+   * Release the tables of the BER, when the simulator is destroyed.
    */
-  double GetFec64QamBer (double snr, uint32_t nbits,
-                         uint32_t bValue) const;
+  static void ClearTables (void);
   /**
-   * Return BER of QAM256 at the given SNR after applying FEC.
+   * Return the table of the BER of a modulation after applying FEC,
+   * and build it if needed; the tables are shared by all the instances,
+   * until the simulator is destroyed.
    *
-   * \param snr snr ratio (not dB)
-   * \param nbits the number of bits in the chunk
+   * \param constellationSize the size of the constellation
    * \param bValue
-   * \return BER of QAM256 at the given SNR after applying FEC
+   *
+   * \return the table of the BER after applying FEC
    */
-  double GetFec256QamBer (double snr, uint32_t nbits,
-                          uint32_t bValue) const;
+  const ErrorRateTable & GetTable (uint32_t constellationSize, uint32_t bValue) const;
+
+  double m_maxTableError; //!< the maximum error of the chunk success rates interpolated from the tables
 };
 
 } //namespace ns3
@@ -407,7 +407,7 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
     }
 
   NS_LOG_INFO ("Received Wi-Fi signal");
-  Ptr<Packet> packet = wifiRxParams->packet->Copy ();
+  Ptr<const Packet> packet = wifiRxParams->packet;
   WifiPhyTag tag;
   bool found = packet->PeekPacketTag (tag);
   if (!found)
@@ -571,7 +571,7 @@ SpectrumWifiPhy::StartRx (Ptr<SpectrumSignalParameters> rxParams)
 }
 
 void
-SpectrumWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+SpectrumWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                                      WifiTxVector txVector,
                                      enum WifiPreamble preamble,
                                      enum mpduType mpdutype,
@@ -761,7 +761,7 @@ SpectrumWifiPhy::UnregisterListener (WifiPhyListener *listener)
 }
 
 void
-SpectrumWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, enum mpduType mpdutype, Ptr<InterferenceHelper::Event> event)
+SpectrumWifiPhy::EndReceive (Ptr<const Packet> packet, enum WifiPreamble preamble, enum mpduType mpdutype, Ptr<InterferenceHelper::Event> event)
 {
   NS_LOG_FUNCTION (this << packet << event);
   NS_ASSERT (IsStateRx ());
@@ -796,14 +796,14 @@ SpectrumWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, enu
           aMpdu.type = mpdutype;
           aMpdu.mpduRefNumber = m_rxMpduReferenceNumber;
           NotifyMonitorSniffRx (packet, (uint16_t) GetFrequency (), GetChannelNumber (), dataRate500KbpsUnits, event->GetPreambleType (), event->GetTxVector (), aMpdu, signalNoise);
-          m_state->SwitchFromRxEndOk (packet, snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
+          m_state->SwitchFromRxEndOk (packet->Copy (), snrPer.snr, event->GetTxVector (), event->GetPreambleType ());
           rxSucceeded = true;
         }
       else
         {
           /* failure. */
           NotifyRxDrop (packet);
-          m_state->SwitchFromRxEndError (packet, snrPer.snr);
+          m_state->SwitchFromRxEndError (packet->Copy (), snrPer.snr);
           rxSucceeded = false;
         }
       if (!m_rxCallback.IsNull ())
@@ -813,7 +813,7 @@ SpectrumWifiPhy::EndReceive (Ptr<Packet> packet, enum WifiPreamble preamble, enu
     }
   else
     {
-      m_state->SwitchFromRxEndError (packet, snrPer.snr);
+      m_state->SwitchFromRxEndError (packet->Copy (), snrPer.snr);
       if (!m_rxCallback.IsNull ())
         {
           m_rxCallback (false);
@@ -22,6 +22,8 @@
 #define WIFI_REMOTE_STATION_MANAGER_H
 
 #include <vector>
+#include <deque>
+#include <unordered_map>
 #include <utility>
 #include "ns3/mac48-address.h"
 #include "ns3/traced-callback.h"
@@ -36,7 +38,6 @@
 namespace ns3 {
 
 struct WifiRemoteStation;
-struct WifiRemoteStationState;
 class WifiPhy;
 class WifiMac;
 class WifiMacHeader;
@@ -79,6 +80,49 @@ private:
   double m_failAvg;
 };
 
+/**
+ * A struct that holds information about each remote station.
+ */
+struct WifiRemoteStationState
+{
+  /**
+   * State of the station
+   */
+  enum
+  {
+    BRAND_NEW,
+    DISASSOC,
+    WAIT_ASSOC_TX_OK,
+    GOT_ASSOC_TX_OK
+  } m_state;
+
+  /**
+   * This member is the list of WifiMode objects that comprise the
+   * OperationalRateSet parameter for this remote station. This list
+   * is constructed through calls to
+   * WifiRemoteStationManager::AddSupportedMode(), and an API that
+   * allows external access to it is available through
+   * WifiRemoteStationManager::GetNSupported() and
+   * WifiRemoteStationManager::GetSupported().
+   */
+  WifiModeList m_operationalRateSet;
+  WifiModeList m_operationalMcsSet;
+  Mac48Address m_address;  //!< Mac48Address of the remote station
+  WifiRemoteStationInfo m_info;
+
+  uint32_t m_channelWidth;    //!< Channel width (in MHz) supported by the remote station
+  bool m_shortGuardInterval;  //!< Flag if short guard interval is supported by the remote station
+  uint8_t m_rx;               //!< Number of supported RX streams by the remote station
+  uint32_t m_ness;            //!< Number of streams in beamforming of the remote station
+  bool m_stbc;                //!< Flag if STBC is supported by the remote station
+  bool m_aggregation;         //!< Flag if MPDU aggregation is used by the remote station
+  bool m_greenfield;          //!< Flag if greenfield is supported by the remote station
+  bool m_shortPreamble;       //!< Flag if short PLCP preamble is supported by the remote station
+  bool m_shortSlotTime;       //!< Flag if short ERP slot time is supported by the remote station
+  bool m_htSupported;         //!< Flag if HT is supported by the station
+  bool m_vhtSupported;        //!< Flag if VHT is supported by the station
+};
+
 /**
  * \ingroup wifi
  * \brief hold a list of per-remote-station state.
@@ -1178,13 +1222,28 @@ private:
   uint32_t GetNFragments (const WifiMacHeader *header, Ptr<const Packet> packet);
 
   /**
-   * A vector of WifiRemoteStations
+   * Return the key of the station associated with the given address and TID.
+   *
+   * \param address the address of the station
+   * \param tid the TID
+   *
+   * \return the 48 bits of the address followed by the 8 bits of the TID
    */
-  typedef std::vector <WifiRemoteStation *> Stations;
+  static uint64_t GetStationKey (Mac48Address address, uint8_t tid);
+
   /**
-   * A vector of WifiRemoteStationStates
+   * The WifiRemoteStations, indexed by the key of their address and TID
    */
-  typedef std::vector <WifiRemoteStationState *> StationStates;
+  typedef std::unordered_map<uint64_t, WifiRemoteStation *> Stations;
+  /**
+   * The WifiRemoteStationStates, stored contiguously in chunks which do
+   * not move when states are added
+   */
+  typedef std::deque<WifiRemoteStationState> StationStates;
+  /**
+   * The WifiRemoteStationStates, indexed by the key of their address
+   */
+  typedef std::unordered_map<uint64_t, WifiRemoteStationState *> StationStateIndex;
 
   /**
    * This is a pointer to the WifiPhy associated with this
@@ -1215,8 +1274,9 @@ private:
   WifiModeList m_bssBasicRateSet;
   WifiModeList m_bssBasicMcsSet;
 
-  StationStates m_states;  //!< States of known stations
-  Stations m_stations;     //!< Information for each known stations
+  StationStates m_states;           //!< States of known stations
+  StationStateIndex m_stateIndex;   //!< States of known stations, by address
+  Stations m_stations;              //!< Information for each known stations, by address and TID
 
   WifiMode m_defaultTxMode; //!< The default transmission mode
   WifiMode m_defaultTxMcs;   //!< The default transmission modulation-coding scheme (MCS)
@@ -1255,49 +1315,6 @@ private:
   TracedCallback<Mac48Address> m_macTxFinalDataFailed;
 };
 
-/**
- * A struct that holds information about each remote station.
- */
-struct WifiRemoteStationState
-{
-  /**
-   * State of the station
-   */
-  enum
-  {
-    BRAND_NEW,
-    DISASSOC,
-    WAIT_ASSOC_TX_OK,
-    GOT_ASSOC_TX_OK
-  } m_state;
-
-  /**
-   * This member is the list of WifiMode objects that comprise the
-   * OperationalRateSet parameter for this remote station. This list
-   * is constructed through calls to
-   * WifiRemoteStationManager::AddSupportedMode(), and an API that
-   * allows external access to it is available through
-   * WifiRemoteStationManager::GetNSupported() and
-   * WifiRemoteStationManager::GetSupported().
-   */
-  WifiModeList m_operationalRateSet;
-  WifiModeList m_operationalMcsSet;
-  Mac48Address m_address;  //!< Mac48Address of the remote station
-  WifiRemoteStationInfo m_info;
-
-  uint32_t m_channelWidth;    //!< Channel width (in MHz) supported by the remote station
-  bool m_shortGuardInterval;  //!< Flag if short guard interval is supported by the remote station
-  uint8_t m_rx;               //!< Number of supported RX streams by the remote station
-  uint32_t m_ness;            //!< Number of streams in beamforming of the remote station
-  bool m_stbc;                //!< Flag if STBC is supported by the remote station
-  bool m_aggregation;         //!< Flag if MPDU aggregation is used by the remote station
-  bool m_greenfield;          //!< Flag if greenfield is supported by the remote station
-  bool m_shortPreamble;       //!< Flag if short PLCP preamble is supported by the remote station
-  bool m_shortSlotTime;       //!< Flag if short ERP slot time is supported by the remote station
-  bool m_htSupported;         //!< Flag if HT is supported by the station
-  bool m_vhtSupported;        //!< Flag if VHT is supported by the station
-};
-
 /**
  * \brief hold per-remote-station state.
  *
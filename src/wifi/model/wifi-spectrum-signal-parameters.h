@@ -50,9 +50,10 @@ struct WifiSpectrumSignalParameters : public SpectrumSignalParameters
   WifiSpectrumSignalParameters (const WifiSpectrumSignalParameters& p);
 
   /**
-   * The packet being transmitted with this signal
+   * The packet being transmitted with this signal, shared by all the
+   * copies of the parameters delivered to the receivers
    */
-  Ptr<Packet> packet;
+  Ptr<const Packet> packet;
 };
 
 }  // namespace ns3
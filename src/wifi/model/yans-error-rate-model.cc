@@ -20,9 +20,12 @@
  */
 
 #include <cmath>
+#include <map>
 #include "yans-error-rate-model.h"
 #include "wifi-phy.h"
 #include "ns3/log.h"
+#include "ns3/double.h"
+#include "ns3/simulator.h"
 
 namespace ns3 {
 
@@ -37,11 +40,51 @@ YansErrorRateModel::GetTypeId (void)
     .SetParent<ErrorRateModel> ()
     .SetGroupName ("Wifi")
     .AddConstructor<YansErrorRateModel> ()
+    .AddAttribute ("MaxTableError",
+                   "The maximum error of the chunk success rates of the OFDM modulations "
+                   "interpolated from tables of the bit error rates, or zero to calculate "
+                   "them exactly.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansErrorRateModel::m_maxTableError),
+                   MakeDoubleChecker<double> (0, 0.1))
   ;
   return tid;
 }
 
+YansErrorRateModel::FecParameters::FecParameters (uint32_t m, uint32_t dFree, uint32_t adFree, uint32_t adFreePlusOne)
+  : m (m),
+    dFree (dFree),
+    adFree (adFree),
+    adFreePlusOne (adFreePlusOne)
+{
+}
+
+bool
+YansErrorRateModel::FecParameters::operator < (const FecParameters &o) const
+{
+  if (m != o.m)
+    {
+      return m < o.m;
+    }
+  if (dFree != o.dFree)
+    {
+      return dFree < o.dFree;
+    }
+  if (adFree != o.adFree)
+    {
+      return adFree < o.adFree;
+    }
+  return adFreePlusOne < o.adFreePlusOne;
+}
+
+bool
+YansErrorRateModel::FecParameters::operator != (const FecParameters &o) const
+{
+  return m != o.m || dFree != o.dFree || adFree != o.adFree || adFreePlusOne != o.adFreePlusOne;
+}
+
 YansErrorRateModel::YansErrorRateModel ()
+  : m_maxTableError (0)
 {
 }
 
@@ -52,26 +95,24 @@ YansErrorRateModel::Log2 (double val) const
 }
 
 double
-YansErrorRateModel::GetBpskBer (double snr, uint32_t signalSpread, uint32_t phyRate) const
+YansErrorRateModel::GetBpskBer (double ebNo) const
 {
-  NS_LOG_FUNCTION (this << snr << signalSpread << phyRate);
-  double EbNo = snr * signalSpread / phyRate;
-  double z = std::sqrt (EbNo);
+  NS_LOG_FUNCTION (this << ebNo);
+  double z = std::sqrt (ebNo);
   double ber = 0.5 * erfc (z);
-  NS_LOG_INFO ("bpsk snr=" << snr << " ber=" << ber);
+  NS_LOG_INFO ("bpsk ebNo=" << ebNo << " ber=" << ber);
   return ber;
 }
 
 double
-YansErrorRateModel::GetQamBer (double snr, unsigned int m, uint32_t signalSpread, uint32_t phyRate) const
+YansErrorRateModel::GetQamBer (double ebNo, unsigned int m) const
 {
-  NS_LOG_FUNCTION (this << snr << m << signalSpread << phyRate);
-  double EbNo = snr * signalSpread / phyRate;
-  double z = std::sqrt ((1.5 * Log2 (m) * EbNo) / (m - 1.0));
+  NS_LOG_FUNCTION (this << ebNo << m);
+  double z = std::sqrt ((1.5 * Log2 (m) * ebNo) / (m - 1.0));
   double z1 = ((1.0 - 1.0 / std::sqrt (m)) * erfc (z));
   double z2 = 1 - std::pow ((1 - z1), 2);
   double ber = z2 / Log2 (m);
-  NS_LOG_INFO ("Qam m=" << m << " rate=" << phyRate << " snr=" << snr << " ber=" << ber);
+  NS_LOG_INFO ("Qam m=" << m << " ebNo=" << ebNo << " ber=" << ber);
   return ber;
 }
 
@@ -143,191 +184,133 @@ YansErrorRateModel::CalculatePd (double ber, unsigned int d) const
 }
 
 double
-YansErrorRateModel::GetFecBpskBer (double snr, double nbits,
-                                   uint32_t signalSpread, uint32_t phyRate,
-                                   uint32_t dFree, uint32_t adFree) const
+YansErrorRateModel::GetFecBer (FecParameters fec, double ebNo) const
 {
-  NS_LOG_FUNCTION (this << snr << nbits << signalSpread << phyRate << dFree << adFree);
-  double ber = GetBpskBer (snr, signalSpread, phyRate);
+  NS_LOG_FUNCTION (this << fec.m << fec.dFree << fec.adFree << fec.adFreePlusOne << ebNo);
+  double ber = fec.m == 2 ? GetBpskBer (ebNo) : GetQamBer (ebNo, fec.m);
   if (ber == 0.0)
     {
-      return 1.0;
+      return 0.0;
     }
-  double pd = CalculatePd (ber, dFree);
-  double pmu = adFree * pd;
-  pmu = std::min (pmu, 1.0);
-  double pms = std::pow (1 - pmu, nbits);
-  return pms;
+  /* first term */
+  double pd = CalculatePd (ber, fec.dFree);
+  double pmu = fec.adFree * pd;
+  /* second term */
+  if (fec.adFreePlusOne > 0)
+    {
+      pd = CalculatePd (ber, fec.dFree + 1);
+      pmu += fec.adFreePlusOne * pd;
+    }
+  return std::min (pmu, 1.0);
 }
 
-double
-YansErrorRateModel::GetFecQamBer (double snr, uint32_t nbits,
-                                  uint32_t signalSpread,
-                                  uint32_t phyRate,
-                                  uint32_t m, uint32_t dFree,
-                                  uint32_t adFree, uint32_t adFreePlusOne) const
+YansErrorRateModel::Tables &
+YansErrorRateModel::GetTables (void)
 {
-  NS_LOG_FUNCTION (this << snr << nbits << signalSpread << phyRate << m << dFree << adFree << adFreePlusOne);
-  double ber = GetQamBer (snr, m, signalSpread, phyRate);
-  if (ber == 0.0)
+  static Tables tables;
+  return tables;
+}
+
+void
+YansErrorRateModel::ClearTables (void)
+{
+  GetTables ().clear ();
+}
+
+const ErrorRateTable &
+YansErrorRateModel::GetTable (FecParameters fec) const
+{
+  Tables &tables = GetTables ();
+  Tables::key_type key (m_maxTableError, fec);
+  Tables::const_iterator i = tables.find (key);
+  if (i == tables.end ())
     {
-      return 1.0;
+      if (tables.empty ())
+        {
+          Simulator::ScheduleDestroy (&ClearTables);
+        }
+      NS_LOG_DEBUG ("build the table of m=" << fec.m << " dFree=" << fec.dFree);
+      Callback<double, double> ber = MakeCallback (&YansErrorRateModel::GetFecBer, this).Bind (fec);
+      i = tables.insert (std::make_pair (key, ErrorRateTable (ber, m_maxTableError))).first;
     }
-  /* first term */
-  double pd = CalculatePd (ber, dFree);
-  double pmu = adFree * pd;
-  /* second term */
-  pd = CalculatePd (ber, dFree + 1);
-  pmu += adFreePlusOne * pd;
-  pmu = std::min (pmu, 1.0);
-  double pms = std::pow (1 - pmu, static_cast<double> (nbits));
-  return pms;
+  return i->second;
 }
 
-double
-YansErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const
+YansErrorRateModel::FecParameters
+YansErrorRateModel::GetFecParameters (WifiMode mode) const
 {
-  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
-  if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
-      || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
-      || mode.GetModulationClass () == WIFI_MOD_CLASS_HT
-      || mode.GetModulationClass () == WIFI_MOD_CLASS_VHT)
+  if (mode.GetConstellationSize () == 2)
     {
-      if (mode.GetConstellationSize () == 2)
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    txVector.GetChannelWidth () * 1000000, //signal spread
-                                    mode.GetPhyRate (txVector), //phy rate
-                                    10, //dFree
-                                    11); //adFree
-            }
-          else
-            {
-              return GetFecBpskBer (snr,
-                                    nbits,
-                                    txVector.GetChannelWidth () * 1000000, //signal spread
-                                    mode.GetPhyRate (txVector), //phy rate
-                                    5, //dFree
-                                    8); //adFree
-            }
+          return FecParameters (2, 10, 11, 0);
         }
-      else if (mode.GetConstellationSize () == 4)
+      else
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, //signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   4, //m
-                                   10, //dFree
-                                   11, //adFree
-                                   0); //adFreePlusOne
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, //signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   4, //m
-                                   5, //dFree
-                                   8, //adFree
-                                   31); //adFreePlusOne
-            }
+          return FecParameters (2, 5, 8, 0);
         }
-      else if (mode.GetConstellationSize () == 16)
+    }
+  else if (mode.GetConstellationSize () == 4 || mode.GetConstellationSize () == 16)
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_1_2)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, //signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   16, //m
-                                   10, //dFree
-                                   11, //adFree
-                                   0); //adFreePlusOne
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, //signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   16, //m
-                                   5, //dFree
-                                   8, //adFree
-                                   31); //adFreePlusOne
-            }
+          return FecParameters (mode.GetConstellationSize (), 10, 11, 0);
         }
-      else if (mode.GetConstellationSize () == 64)
+      else
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_2_3)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, //signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   64, //m
-                                   6, //dFree
-                                   1, //adFree
-                                   16); //adFreePlusOne
-            }
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-            {
-              //Table B.32  in Pâl Frenger et al., "Multi-rate Convolutional Codes".
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, //signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   64, //m
-                                   4, //dFree
-                                   14, //adFree
-                                   69); //adFreePlusOne
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, //signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   64, //m
-                                   5, //dFree
-                                   8, //adFree
-                                   31); //adFreePlusOne
-            }
+          return FecParameters (mode.GetConstellationSize (), 5, 8, 31);
         }
-      else if (mode.GetConstellationSize () == 256)
+    }
+  else if (mode.GetConstellationSize () == 64)
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_2_3)
+        {
+          return FecParameters (64, 6, 1, 16);
+        }
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+        {
+          //Table B.32  in Pâl Frenger et al., "Multi-rate Convolutional Codes".
+          return FecParameters (64, 4, 14, 69);
+        }
+      else
+        {
+          return FecParameters (64, 5, 8, 31);
+        }
+    }
+  else if (mode.GetConstellationSize () == 256)
+    {
+      if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
+        {
+          return FecParameters (256, 4, 14, 69);
+        }
+      else
+        {
+          return FecParameters (256, 5, 8, 31);
+        }
+    }
+  NS_FATAL_ERROR ("Unsupported constellation size of mode " << mode);
+  return FecParameters (0, 0, 0, 0);
+}
+
+double
+YansErrorRateModel::GetChunkSuccessRate (WifiMode mode, WifiTxVector txVector, double snr, uint32_t nbits) const
+{
+  NS_LOG_FUNCTION (this << mode << txVector.GetMode () << snr << nbits);
+  if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM
+      || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
+      || mode.GetModulationClass () == WIFI_MOD_CLASS_HT
+      || mode.GetModulationClass () == WIFI_MOD_CLASS_VHT)
+    {
+      FecParameters fec = GetFecParameters (mode);
+      uint32_t signalSpread = txVector.GetChannelWidth () * 1000000;
+      uint32_t phyRate = mode.GetPhyRate (txVector);
+      double ebNo = snr * signalSpread / phyRate;
+      if (m_maxTableError > 0)
         {
-          if (mode.GetCodeRate () == WIFI_CODE_RATE_5_6)
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, // signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   256, // m
-                                   4,  // dFree
-                                   14,  // adFree
-                                   69  // adFreePlusOne
-                                   );
-            }
-          else
-            {
-              return GetFecQamBer (snr,
-                                   nbits,
-                                   txVector.GetChannelWidth () * 1000000, // signal spread
-                                   mode.GetPhyRate (txVector), //phy rate
-                                   256, // m
-                                   5,  // dFree
-                                   8,  // adFree
-                                   31  // adFreePlusOne
-                                   );
-            }
+          return GetTable (fec).GetChunkSuccessRate (ebNo, nbits);
         }
+      double pmu = GetFecBer (fec, ebNo);
+      return std::pow (1 - pmu, static_cast<double> (nbits));
     }
   else if (mode.GetModulationClass () == WIFI_MOD_CLASS_DSSS || mode.GetModulationClass () == WIFI_MOD_CLASS_HR_DSSS)
     {
@@ -22,8 +22,10 @@
 #define YANS_ERROR_RATE_MODEL_H
 
 #include <stdint.h>
+#include <map>
 #include "wifi-mode.h"
 #include "error-rate-model.h"
+#include "error-rate-table.h"
 #include "dsss-error-rate-model.h"
 
 namespace ns3 {
@@ -52,6 +54,12 @@ namespace ns3 {
  *      57(2):440-449, February 2009.
  *    - More detailed description and validation can be found in
  *      http://www.nsnam.org/~pei/80211b.pdf
+ *
+ * When the MaxTableError attribute is not zero, the chunk success rates of
+ * the OFDM modulations are interpolated from an ErrorRateTable of each
+ * constellation and convolutional code, against the Eb/No, built the
+ * first time it is needed and shared by all the instances until the
+ * simulator is destroyed.
  */
 class YansErrorRateModel : public ErrorRateModel
 {
@@ -64,6 +72,35 @@ public:
 
 
 private:
+  /**
+   * The constellation and the convolutional code of an OFDM modulation.
+   */
+  struct FecParameters
+  {
+    /**
+     * \param m the size of the constellation
+     * \param dFree the free distance of the code
+     * \param adFree the number of paths at the free distance
+     * \param adFreePlusOne the number of paths at the free distance plus one
+     */
+    FecParameters (uint32_t m, uint32_t dFree, uint32_t adFree, uint32_t adFreePlusOne);
+    /**
+     * \param o the other parameters
+     * \return true if these parameters sort before the other ones
+     */
+    bool operator < (const FecParameters &o) const;
+    /**
+     * \param o the other parameters
+     * \return true if these parameters differ from the other ones
+     */
+    bool operator != (const FecParameters &o) const;
+
+    uint32_t m;             //!< the size of the constellation
+    uint32_t dFree;         //!< the free distance of the code
+    uint32_t adFree;        //!< the number of paths at the free distance
+    uint32_t adFreePlusOne; //!< the number of paths at the free distance plus one
+  };
+
   /**
    * Return the logarithm of the given value to base 2.
    *
@@ -75,24 +112,20 @@ private:
   /**
    * Return BER of BPSK with the given parameters.
    *
-   * \param snr SNR ratio (not dB)
-   * \param signalSpread
-   * \param phyRate
+   * \param ebNo the energy per bit to noise ratio (not dB)
    *
-   * \return BER of BPSK at the given SNR
+   * \return BER of BPSK at the given Eb/No
    */
-  double GetBpskBer (double snr, uint32_t signalSpread, uint32_t phyRate) const;
+  double GetBpskBer (double ebNo) const;
   /**
    * Return BER of QAM-m with the given parameters.
    *
-   * \param snr SNR ratio (not dB)
+   * \param ebNo the energy per bit to noise ratio (not dB)
    * \param m
-   * \param signalSpread
-   * \param phyRate
    *
-   * \return BER of BPSK at the given SNR
+   * \return BER of QAM-m at the given Eb/No
    */
-  double GetQamBer (double snr, unsigned int m, uint32_t signalSpread, uint32_t phyRate) const;
+  double GetQamBer (double ebNo, unsigned int m) const;
   /**
    * Return k!
    *
@@ -133,35 +166,43 @@ private:
    */
   double CalculatePd (double ber, unsigned int d) const;
   /**
-   * \param snr SNR ratio (not dB)
-   * \param nbits
-   * \param signalSpread
-   * \param phyRate
-   * \param dFree
-   * \param adFree
+   * \param mode the OFDM mode
    *
-   * \return double
+   * \return the constellation and the convolutional code of the mode
    */
-  double GetFecBpskBer (double snr, double nbits,
-                        uint32_t signalSpread, uint32_t phyRate,
-                        uint32_t dFree, uint32_t adFree) const;
+  FecParameters GetFecParameters (WifiMode mode) const;
   /**
-   * \param snr SNR ratio (not dB)
-   * \param nbits
-   * \param signalSpread
-   * \param phyRate
-   * \param m
-   * \param dfree
-   * \param adFree
-   * \param adFreePlusOne
+   * Return the BER of a modulation after applying FEC.
    *
-   * \return double
+   * \param fec the constellation and the convolutional code
+   * \param ebNo the energy per bit to noise ratio (not dB)
+   *
+   * \return the BER after applying FEC, at most 1
    */
-  double GetFecQamBer (double snr, uint32_t nbits,
-                       uint32_t signalSpread,
-                       uint32_t phyRate,
-                       uint32_t m, uint32_t dfree,
-                       uint32_t adFree, uint32_t adFreePlusOne) const;
+  double GetFecBer (FecParameters fec, double ebNo) const;
+  /// The tables of the BER, by maximum error and modulation
+  typedef std::map<std::pair<double, FecParameters>, ErrorRateTable> Tables;
+
+  /**
+   * \return the tables of the BER shared by all the instances
+   */
+  static Tables & GetTables (void);
+  /**
+   * Release the tables of the BER, when the simulator is destroyed.
+   */
+  static void ClearTables (void);
+  /**
+   * Return the table of the BER of a modulation after applying FEC,
+   * against the Eb/No, and build it if needed; the tables are shared by
+   * all the instances, until the simulator is destroyed.
+   *
+   * \param fec the constellation and the convolutional code
+   *
+   * \return the table of the BER after applying FEC
+   */
+  const ErrorRateTable & GetTable (FecParameters fec) const;
+
+  double m_maxTableError; //!< the maximum error of the chunk success rates interpolated from the tables
 };
 
 } //namespace ns3
@@ -18,6 +18,7 @@
  * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
  */
 
+#include <limits>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
@@ -25,10 +26,12 @@
 #include "ns3/node.h"
 #include "ns3/log.h"
 #include "ns3/pointer.h"
+#include "ns3/double.h"
 #include "ns3/object-factory.h"
 #include "yans-wifi-channel.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
+#include "ns3/position-grid.h"
 
 namespace ns3 {
 
@@ -51,11 +54,24 @@ YansWifiChannel::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&YansWifiChannel::m_delay),
                    MakePointerChecker<PropagationDelayModel> ())
+    .AddAttribute ("MaxRange",
+                   "The maximum distance, in meters, between the sender and the receivers of a frame; "
+                   "0 delivers the frames to the PHYs at any distance.",
+                   DoubleValue (0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0))
+    .AddAttribute ("ReceptionThreshold",
+                   "The minimum power, in dBm, with which a PHY must receive a frame for the frame to be delivered to it.",
+                   DoubleValue (-std::numeric_limits<double>::max ()),
+                   MakeDoubleAccessor (&YansWifiChannel::m_receptionThreshold),
+                   MakeDoubleChecker<double> ())
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_maxRange (0),
+    m_receptionThreshold (-std::numeric_limits<double>::max ())
 {
 }
 
@@ -63,6 +79,7 @@ YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_phyList.clear ();
+  m_grid = 0;
 }
 
 void
@@ -83,23 +100,54 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 {
   Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
   NS_ASSERT (senderMobility != 0);
-  uint32_t j = 0;
-  for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  // a single copy of the packet is shared by all the receivers, which
+  // copy it again only when they hand it to their MAC
+  Ptr<const Packet> copy;
+  Vector senderPosition;
+  if (m_maxRange > 0)
     {
-      if (sender != (*i))
+      UpdateGrid ();
+      senderPosition = senderMobility->GetPosition ();
+      m_grid->GetItemsNear (senderPosition, m_maxRange, m_receivers);
+    }
+  else
+    {
+      m_receivers.resize (m_phyList.size ());
+      for (uint32_t j = 0; j < m_phyList.size (); j++)
+        {
+          m_receivers[j] = j;
+        }
+    }
+  for (std::vector<uint32_t>::const_iterator k = m_receivers.begin (); k != m_receivers.end (); k++)
+    {
+      uint32_t j = *k;
+      Ptr<YansWifiPhy> phy = m_phyList[j];
+      if (sender != phy)
         {
           //For now don't account for inter channel interference
-          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
+          if (phy->GetChannelNumber () != sender->GetChannelNumber ())
             {
               continue;
             }
 
-          Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
+          if (m_maxRange > 0 && !m_grid->IsWithin (j, senderPosition, m_maxRange))
+            {
+              continue;
+            }
+          Ptr<MobilityModel> receiverMobility = phy->GetMobility ()->GetObject<MobilityModel> ();
           Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
           double rxPowerDbm = m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
           NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
                         "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-          Ptr<Packet> copy = packet->Copy ();
+          if (rxPowerDbm < m_receptionThreshold)
+            {
+              NS_LOG_DEBUG ("received power below the reception threshold, not delivering to " << j);
+              continue;
+            }
+          if (copy == 0)
+            {
+              copy = packet->Copy ();
+            }
           Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
           uint32_t dstNode;
           if (dstNetDevice == 0)
@@ -126,7 +174,24 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const
+YansWifiChannel::UpdateGrid (void) const
+{
+  if (m_grid == 0 || m_grid->GetCellSize () != m_maxRange)
+    {
+      m_grid = Create<PositionGrid> (m_maxRange);
+    }
+  // the PHYs get their mobility model when their node is set up, after
+  // they are added to the channel: index them when they first transmit
+  for (uint32_t j = m_grid->GetNItems (); j < m_phyList.size (); j++)
+    {
+      Ptr<MobilityModel> mobility = m_phyList[j]->GetMobility ()->GetObject<MobilityModel> ();
+      NS_ASSERT_MSG (mobility != 0, "The PHYs of a channel with a maximum range need a mobility model");
+      m_grid->Add (mobility);
+    }
+}
+
+void
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, struct Parameters parameters) const
 {
   m_phyList[i]->StartReceivePreambleAndHeader (packet, parameters.rxPowerDbm, parameters.txVector, parameters.preamble, parameters.type, parameters.duration);
 }
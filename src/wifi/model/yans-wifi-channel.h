@@ -36,6 +36,7 @@ namespace ns3 {
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class PositionGrid;
 
 struct Parameters
 {
@@ -57,6 +58,13 @@ struct Parameters
  * class and contains a ns3::PropagationLossModel and a ns3::PropagationDelayModel.
  * By default, no propagation models are set so, it is the caller's responsability
  * to set them before using the channel.
+ *
+ * The frames are delivered to every PHY of the channel by default.  The
+ * "MaxRange" attribute restricts them to the PHYs within a distance of
+ * the sender, which are found with a ns3::PositionGrid rather than by
+ * visiting every PHY, and the "ReceptionThreshold" attribute to the PHYs
+ * receiving them with a minimum power.  The PHYs left out do not get any
+ * event, and do not see the frames as interference either.
  */
 class YansWifiChannel : public WifiChannel
 {
@@ -127,16 +135,26 @@ private:
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
+   * \param packet the packet being sent, shared by all the receivers
    * \param atts a vector containing the received power in dBm and the packet type
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, struct Parameters parameters) const;
+  void Receive (uint32_t i, Ptr<const Packet> packet, struct Parameters parameters) const;
+
+  /**
+   * Index the PHYs added since the last transmission in the position
+   * grid, creating it if needed.
+   */
+  void UpdateGrid (void) const;
 
   PhyList m_phyList;                   //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss;    //!< Propagation loss model
   Ptr<PropagationDelayModel> m_delay;  //!< Propagation delay model
+  double m_maxRange;                   //!< The maximum distance of the receivers, or 0 for no limit
+  double m_receptionThreshold;         //!< The minimum received power of the receivers, in dBm
+  mutable Ptr<PositionGrid> m_grid;    //!< The positions of the PHYs, indexed by their number
+  mutable std::vector<uint32_t> m_receivers;  //!< The candidate receivers of a transmission
 };
 
 } //namespace ns3
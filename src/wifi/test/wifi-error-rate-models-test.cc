@@ -23,6 +23,10 @@
 #include "ns3/dsss-error-rate-model.h"
 #include "ns3/yans-error-rate-model.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/double.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
 
 using namespace ns3;
 
@@ -279,6 +283,80 @@ WifiErrorRateModelsTestCaseNist::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (ps, 0.999, 0.001, "Not equal within tolerance");
 }
 
+class WifiErrorRateModelsTestCaseTable : public TestCase
+{
+public:
+  WifiErrorRateModelsTestCaseTable ();
+  virtual ~WifiErrorRateModelsTestCaseTable ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check the chunk success rates interpolated from the tables of an
+   * error rate model against the exact ones.
+   *
+   * \param type the type of the error rate model
+   */
+  void CheckTables (std::string type);
+};
+
+WifiErrorRateModelsTestCaseTable::WifiErrorRateModelsTestCaseTable ()
+  : TestCase ("WifiErrorRateModel test case of the tables of the bit error rates")
+{
+}
+
+WifiErrorRateModelsTestCaseTable::~WifiErrorRateModelsTestCaseTable ()
+{
+}
+
+void
+WifiErrorRateModelsTestCaseTable::CheckTables (std::string type)
+{
+  double maxError = 1e-6;
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  Ptr<ErrorRateModel> exact = factory.Create<ErrorRateModel> ();
+  DoubleValue defaultError;
+  exact->GetAttribute ("MaxTableError", defaultError);
+  NS_TEST_ASSERT_MSG_EQ (defaultError.Get (), 0, type << " not exact by default");
+  factory.Set ("MaxTableError", DoubleValue (maxError));
+  Ptr<ErrorRateModel> table = factory.Create<ErrorRateModel> ();
+
+  WifiMode modes[] = { WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate9Mbps (), WifiPhy::GetOfdmRate54Mbps (),
+                       WifiPhy::GetHtMcs0 (), WifiPhy::GetHtMcs1 (), WifiPhy::GetHtMcs2 (), WifiPhy::GetHtMcs3 (),
+                       WifiPhy::GetHtMcs4 (), WifiPhy::GetHtMcs5 (), WifiPhy::GetHtMcs6 (), WifiPhy::GetHtMcs7 (),
+                       WifiPhy::GetVhtMcs8 (), WifiPhy::GetVhtMcs9 () };
+  uint32_t sizes[] = { 1, 100, 16000, 1000000 };
+  for (uint32_t i = 0; i < sizeof (modes) / sizeof (modes[0]); i++)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (modes[i]);
+      txVector.SetChannelWidth (modes[i].GetModulationClass () == WIFI_MOD_CLASS_VHT ? 80 : 20);
+      txVector.SetNss (1);
+      // beyond both ends of the tables
+      for (double snrDb = -80.0; snrDb < 80.0; snrDb += 0.173)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (uint32_t j = 0; j < sizeof (sizes) / sizeof (sizes[0]); j++)
+            {
+              double expected = exact->GetChunkSuccessRate (modes[i], txVector, snr, sizes[j]);
+              double actual = table->GetChunkSuccessRate (modes[i], txVector, snr, sizes[j]);
+              NS_TEST_ASSERT_MSG_EQ_TOL (actual, expected, maxError,
+                                         type << " " << modes[i] << " at " << snrDb << " dB for " << sizes[j] << " bits");
+            }
+        }
+    }
+}
+
+void
+WifiErrorRateModelsTestCaseTable::DoRun (void)
+{
+  CheckTables ("ns3::NistErrorRateModel");
+  CheckTables ("ns3::YansErrorRateModel");
+  // release the tables
+  Simulator::Destroy ();
+}
+
 class WifiErrorRateModelsTestSuite : public TestSuite
 {
 public:
@@ -290,6 +368,7 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite ()
 {
   AddTestCase (new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
   AddTestCase (new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
+  AddTestCase (new WifiErrorRateModelsTestCaseTable, TestCase::QUICK);
 }
 
 static WifiErrorRateModelsTestSuite wifiErrorRateModelsTestSuite;
@@ -28,6 +28,8 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/yans-error-rate-model.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/interference-helper.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/test.h"
 #include "ns3/pointer.h"
@@ -39,6 +41,8 @@
 #include "ns3/packet-socket-server.h"
 #include "ns3/packet-socket-client.h"
 #include "ns3/packet-socket-helper.h"
+#include "ns3/aarf-wifi-manager.h"
+#include "ns3/wifi-mac-header.h"
 
 using namespace ns3;
 
@@ -1092,6 +1096,289 @@ Bug2222TestCase::DoRun (void)
 
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the frames are only delivered to the PHYs within the
+ * maximum range of a YansWifiChannel, including PHYs which moved since
+ * they were indexed, and to the PHYs receiving them above the reception
+ * threshold.
+ */
+class YansWifiChannelCullingTest : public TestCase
+{
+public:
+  YansWifiChannelCullingTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  Ptr<Node> CreateOne (Vector pos, Ptr<YansWifiChannel> channel);
+  void SendOnePacket (Ptr<WifiNetDevice> dev);
+  static void Receive (uint32_t *count, Ptr<const Packet> packet);
+
+  ObjectFactory m_manager;
+  ObjectFactory m_mac;
+  uint32_t m_received[4];
+};
+
+YansWifiChannelCullingTest::YansWifiChannelCullingTest ()
+  : TestCase ("YansWifiChannel maximum range and reception threshold")
+{
+}
+
+void
+YansWifiChannelCullingTest::SendOnePacket (Ptr<WifiNetDevice> dev)
+{
+  Ptr<Packet> p = Create<Packet> (1000);
+  dev->Send (p, dev->GetBroadcast (), 1);
+}
+
+void
+YansWifiChannelCullingTest::Receive (uint32_t *count, Ptr<const Packet> packet)
+{
+  (*count)++;
+}
+
+Ptr<Node>
+YansWifiChannelCullingTest::CreateOne (Vector pos, Ptr<YansWifiChannel> channel)
+{
+  Ptr<Node> node = CreateObject<Node> ();
+  Ptr<WifiNetDevice> dev = CreateObject<WifiNetDevice> ();
+
+  Ptr<WifiMac> mac = m_mac.Create<WifiMac> ();
+  mac->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<ConstantPositionMobilityModel> mobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  Ptr<ErrorRateModel> error = CreateObject<YansErrorRateModel> ();
+  phy->SetErrorRateModel (error);
+  phy->SetChannel (channel);
+  phy->SetDevice (dev);
+  phy->SetMobility (mobility);
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = m_manager.Create<WifiRemoteStationManager> ();
+
+  mobility->SetPosition (pos);
+  node->AggregateObject (mobility);
+  mac->SetAddress (Mac48Address::Allocate ());
+  dev->SetMac (mac);
+  dev->SetPhy (phy);
+  dev->SetRemoteStationManager (manager);
+  node->AddDevice (dev);
+
+  return node;
+}
+
+void
+YansWifiChannelCullingTest::DoRun (void)
+{
+  m_mac.SetTypeId ("ns3::AdhocWifiMac");
+  m_manager.SetTypeId ("ns3::ConstantRateWifiManager");
+
+  Ptr<YansWifiChannel> channel = CreateObject<YansWifiChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (100));
+  Ptr<PropagationDelayModel> propDelay = CreateObject<ConstantSpeedPropagationDelayModel> ();
+  Ptr<MatrixPropagationLossModel> propLoss = CreateObject<MatrixPropagationLossModel> ();
+  propLoss->SetDefaultLoss (50);
+  channel->SetPropagationDelayModel (propDelay);
+  channel->SetPropagationLossModel (propLoss);
+
+  Ptr<Node> sender = CreateOne (Vector (0.0, 0.0, 0.0), channel);
+  Ptr<Node> near = CreateOne (Vector (50.0, 0.0, 0.0), channel);
+  Ptr<Node> far = CreateOne (Vector (0.0, 150.0, 0.0), channel);
+  Ptr<Node> moving = CreateOne (Vector (500.0, 500.0, 0.0), channel);
+  Ptr<Node> nodes[] = { sender, near, far, moving };
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_received[i] = 0;
+      DynamicCast<WifiNetDevice> (nodes[i]->GetDevice (0))->GetPhy ()->TraceConnectWithoutContext
+        ("PhyRxEnd", MakeBoundCallback (&YansWifiChannelCullingTest::Receive, &m_received[i]));
+    }
+  Ptr<WifiNetDevice> senderDevice = DynamicCast<WifiNetDevice> (sender->GetDevice (0));
+
+  Simulator::Schedule (Seconds (1.0), &YansWifiChannelCullingTest::SendOnePacket, this, senderDevice);
+  Simulator::Schedule (Seconds (2.0), &MobilityModel::SetPosition, moving->GetObject<MobilityModel> (), Vector (0.0, -80.0, 0.0));
+  Simulator::Schedule (Seconds (3.0), &YansWifiChannelCullingTest::SendOnePacket, this, senderDevice);
+  Simulator::Stop (Seconds (4.0));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], 2, "Frames not received within range");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 0, "Frames received out of range");
+  NS_TEST_EXPECT_MSG_EQ (m_received[3], 1, "Frame not received after moving within range");
+
+  // a 16 dBm transmission with a 1 dB antenna gain is received below -80 dBm with a 100 dB loss
+  channel->SetAttribute ("MaxRange", DoubleValue (0));
+  channel->SetAttribute ("ReceptionThreshold", DoubleValue (-80));
+  propLoss->SetLoss (sender->GetObject<MobilityModel> (), near->GetObject<MobilityModel> (), 100);
+  Simulator::Schedule (Seconds (5.0), &YansWifiChannelCullingTest::SendOnePacket, this, senderDevice);
+  Simulator::Stop (Seconds (6.0));
+  Simulator::Run ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received[1], 2, "Frame received below the reception threshold");
+  NS_TEST_EXPECT_MSG_EQ (m_received[2], 1, "Frame not received without maximum range");
+  NS_TEST_EXPECT_MSG_EQ (m_received[3], 2, "Frame not received above the reception threshold");
+
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the InterferenceHelper adds up the power of overlapping
+ * signals, including signals starting and ending at the same time, both
+ * for the energy duration and for the interference of a frame.
+ */
+class InterferenceHelperPowerTest : public TestCase
+{
+public:
+  InterferenceHelperPowerTest ();
+
+  virtual void DoRun (void);
+
+
+private:
+  void AddSignal (Time duration, double rxPower);
+  void CheckEnergyDuration (double energyW, Time expected);
+  void CheckSnr (double expected);
+
+  InterferenceHelper m_interference;
+  Ptr<InterferenceHelper::Event> m_event;
+};
+
+InterferenceHelperPowerTest::InterferenceHelperPowerTest ()
+  : TestCase ("InterferenceHelper power of overlapping signals")
+{
+}
+
+void
+InterferenceHelperPowerTest::AddSignal (Time duration, double rxPower)
+{
+  m_interference.AddForeignSignal (duration, rxPower);
+}
+
+void
+InterferenceHelperPowerTest::CheckEnergyDuration (double energyW, Time expected)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_interference.GetEnergyDuration (energyW), expected,
+                         "Wrong energy duration above " << energyW << " W at " << Simulator::Now ());
+}
+
+void
+InterferenceHelperPowerTest::CheckSnr (double expected)
+{
+  double snr = m_interference.CalculatePlcpPayloadSnrPer (m_event).snr;
+  NS_TEST_EXPECT_MSG_EQ_TOL (snr, expected, expected * 1e-9, "Wrong SNR of the frame");
+}
+
+void
+InterferenceHelperPowerTest::DoRun (void)
+{
+  m_interference.SetNoiseFigure (1);
+  m_interference.SetErrorRateModel (CreateObject<NistErrorRateModel> ());
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetOfdmRate6Mbps ());
+  txVector.SetChannelWidth (20);
+  double noiseW = 1.3803e-23 * 290.0 * 20e6;
+
+  // 1 nW over [0, 10) us, 2 nW over [5, 25) us and 3 nW over [5, 10) us,
+  // around a 4 nW frame over [0, 100) us:
+  // 5 nW until 5 us, 10 nW until 10 us, 6 nW until 25 us, 4 nW until 100 us
+  AddSignal (MicroSeconds (10), 1e-9);
+  m_event = m_interference.Add (1000, txVector, WIFI_PREAMBLE_LONG, MicroSeconds (100), 4e-9);
+  m_interference.NotifyRxStart ();
+  Simulator::Schedule (MicroSeconds (5), &InterferenceHelperPowerTest::AddSignal, this, MicroSeconds (20), 2e-9);
+  Simulator::Schedule (MicroSeconds (5), &InterferenceHelperPowerTest::AddSignal, this, MicroSeconds (5), 3e-9);
+  Simulator::Schedule (MicroSeconds (6), &InterferenceHelperPowerTest::CheckEnergyDuration, this, 9.5e-9, MicroSeconds (4));
+  Simulator::Schedule (MicroSeconds (6), &InterferenceHelperPowerTest::CheckEnergyDuration, this, 5.5e-9, MicroSeconds (19));
+  Simulator::Schedule (MicroSeconds (6), &InterferenceHelperPowerTest::CheckEnergyDuration, this, 1e-9, MicroSeconds (94));
+  // the interference of the frame is the one at its start
+  Simulator::Schedule (MicroSeconds (50), &InterferenceHelperPowerTest::CheckSnr, this, 4e-9 / (noiseW + 1e-9));
+  Simulator::Run ();
+
+  m_interference.NotifyRxEnd ();
+  m_interference.EraseEvents ();
+  CheckEnergyDuration (1e-12, MicroSeconds (0));
+
+  m_event = 0;
+  Simulator::Destroy ();
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Make sure that the WifiRemoteStationManager keeps one state per remote
+ * address and one station per remote address and TID, with many remote
+ * stations, and that Reset forgets the stations but not the states.
+ */
+class WifiRemoteStationLookupTest : public TestCase
+{
+public:
+  WifiRemoteStationLookupTest ();
+
+  virtual void DoRun (void);
+};
+
+WifiRemoteStationLookupTest::WifiRemoteStationLookupTest ()
+  : TestCase ("WifiRemoteStationManager lookup of many remote stations")
+{
+}
+
+void
+WifiRemoteStationLookupTest::DoRun (void)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  Ptr<WifiRemoteStationManager> manager = CreateObject<AarfWifiManager> ();
+  manager->SetupPhy (phy);
+  manager->SetMaxSlrc (3);
+
+  WifiMacHeader tid1;
+  tid1.SetType (WIFI_MAC_QOSDATA);
+  tid1.SetQosTid (1);
+  WifiMacHeader tid2;
+  tid2.SetType (WIFI_MAC_QOSDATA);
+  tid2.SetQosTid (2);
+  Ptr<Packet> packet = Create<Packet> (1000);
+
+  uint32_t nStations = 300;
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+    }
+  // the even stations wait for their association, and i % 4 frames of
+  // TID 1 to the i-th station failed
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      if (i % 2 == 0)
+        {
+          manager->RecordWaitAssocTxOk (addresses[i]);
+        }
+      for (uint32_t j = 0; j < i % 4; j++)
+        {
+          manager->ReportDataFailed (addresses[i], &tid1);
+        }
+    }
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (manager->IsWaitAssocTxOk (addresses[i]), (i % 2 == 0), "Wrong state of station " << i);
+      NS_TEST_EXPECT_MSG_EQ (manager->IsBrandNew (addresses[i]), (i % 2 == 1), "Wrong state of station " << i);
+      NS_TEST_EXPECT_MSG_EQ (manager->NeedDataRetransmission (addresses[i], &tid1, packet), (i % 4 < 3),
+                             "Wrong retry count of TID 1 of station " << i);
+      NS_TEST_EXPECT_MSG_EQ (manager->NeedDataRetransmission (addresses[i], &tid2, packet), true,
+                             "Wrong retry count of TID 2 of station " << i);
+    }
+
+  manager->Reset ();
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (manager->IsWaitAssocTxOk (addresses[i]), (i % 2 == 0), "Lost state of station " << i);
+      NS_TEST_EXPECT_MSG_EQ (manager->NeedDataRetransmission (addresses[i], &tid1, packet), true,
+                             "Kept retry count of TID 1 of station " << i);
+    }
+
+  manager->Dispose ();
+  phy->Dispose ();
+  Simulator::Destroy ();
+}
+
 class WifiTestSuite : public TestSuite
 {
 public:
@@ -1108,6 +1395,9 @@ WifiTestSuite::WifiTestSuite ()
   AddTestCase (new Bug730TestCase, TestCase::QUICK); //Bug 730
   AddTestCase (new SetChannelFrequencyTest, TestCase::QUICK);
   AddTestCase (new Bug2222TestCase, TestCase::QUICK); //Bug 2222
+  AddTestCase (new YansWifiChannelCullingTest, TestCase::QUICK);
+  AddTestCase (new InterferenceHelperPowerTest, TestCase::QUICK);
+  AddTestCase (new WifiRemoteStationLookupTest, TestCase::QUICK);
 }
 
 static WifiTestSuite g_wifiTestSuite;
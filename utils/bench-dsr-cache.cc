@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the DSR route caches and send buffer: a node
+// learns routes to many destinations, which expire over time, and looks
+// them up for every packet it forwards, buffering the packets without
+// a route.  Print the lookups which found a route, the packets left in
+// the send buffer and the wall clock time, for the path and link caches.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/dsr-rcache.h"
+#include "ns3/dsr-rsendbuff.h"
+#include <iostream>
+
+using namespace ns3;
+
+static uint32_t g_found = 0;    //!< the lookups which found a route
+
+/**
+ * Learn a route to a random destination, through random relays.
+ *
+ * \param rcache the route cache
+ * \param rng the random variable
+ * \param nDst the number of destinations
+ */
+static void
+Learn (Ptr<dsr::DsrRouteCache> rcache, Ptr<UniformRandomVariable> rng, uint32_t nDst)
+{
+  std::vector<Ipv4Address> route;
+  route.push_back (Ipv4Address ("10.0.0.1"));
+  uint32_t hops = rng->GetInteger (1, 5);
+  for (uint32_t i = 0; i < hops; i++)
+    {
+      route.push_back (Ipv4Address (0x0a000002 + rng->GetInteger (0, nDst - 1)));
+    }
+  Ipv4Address dst (0x0a000002 + rng->GetInteger (0, nDst - 1));
+  route.push_back (dst);
+  if (rcache->IsLinkCache ())
+    {
+      rcache->AddRoute_Link (route, route.front ());
+    }
+  else
+    {
+      dsr::DsrRouteCacheEntry entry (route, dst, Seconds (rng->GetValue (10, 60)));
+      rcache->AddRoute (entry);
+    }
+}
+
+/**
+ * Forward a packet to a random destination, buffering it if there is no route.
+ *
+ * \param rcache the route cache
+ * \param buffer the send buffer
+ * \param rng the random variable
+ * \param nDst the number of destinations
+ */
+static void
+Forward (Ptr<dsr::DsrRouteCache> rcache, dsr::DsrSendBuffer *buffer, Ptr<UniformRandomVariable> rng, uint32_t nDst)
+{
+  Ipv4Address dst (0x0a000002 + rng->GetInteger (0, nDst - 1));
+  dsr::DsrRouteCacheEntry entry;
+  if (rcache->LookupRoute (dst, entry))
+    {
+      g_found++;
+      if (rcache->IsLinkCache ())
+        {
+          rcache->UseExtends (entry.GetVector ());
+        }
+      dsr::DsrSendBuffEntry queued;
+      buffer->Dequeue (dst, queued);
+    }
+  else
+    {
+      dsr::DsrSendBuffEntry queued (Create<Packet> (100), dst, Seconds (0));
+      buffer->Enqueue (queued);
+    }
+}
+
+/**
+ * Run the simulation of the node.
+ *
+ * \param cacheType the type of route cache, LinkCache or PathCache
+ * \param nDst the number of destinations
+ * \param duration the simulated time
+ */
+static void
+Run (std::string cacheType, uint32_t nDst, Time duration)
+{
+  g_found = 0;
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  Ptr<dsr::DsrRouteCache> rcache = CreateObject<dsr::DsrRouteCache> ();
+  rcache->SetCacheType (cacheType);
+  rcache->SetMaxEntriesEachDst (3);
+  rcache->SetSubRoute (false);
+  rcache->SetInitStability (Seconds (25));
+  rcache->SetMinLifeTime (Seconds (1));
+  rcache->SetUseExtends (Seconds (120));
+  rcache->SetStabilityDecrFactor (2);
+  rcache->SetStabilityIncrFactor (4);
+  dsr::DsrSendBuffer buffer;
+  buffer.SetMaxQueueLen (64);
+  buffer.SetSendBufferTimeout (Seconds (30));
+
+  for (Time t = Seconds (0); t < duration; t += MilliSeconds (100))
+    {
+      Simulator::Schedule (t, &Learn, rcache, rng, nDst);
+    }
+  for (Time t = Seconds (0); t < duration; t += MilliSeconds (1))
+    {
+      Simulator::Schedule (t, &Forward, rcache, &buffer, rng, nDst);
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (duration);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+
+  std::cout << cacheType << ": " << g_found << " routes found, "
+            << buffer.GetSize () << " packets buffered, "
+            << runMs << " ms run" << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nDst = 500;
+  double duration = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the lookups and expiration of the DSR route caches and send buffer");
+  cmd.AddValue ("destinations", "number of destinations", nDst);
+  cmd.AddValue ("duration", "simulated time, in seconds", duration);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-dsr-cache with " << nDst << " destinations" << std::endl;
+  Run ("PathCache", nDst, Seconds (duration));
+  Run ("LinkCache", nDst, Seconds (duration));
+  return 0;
+}
@@ -0,0 +1,209 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Run bulk TCP transfers across a k-ary fat-tree routed by global routing,
+// with either a single path, random per-packet ECMP or per-flow ECMP, and
+// report the aggregate throughput, the fraction of data segments which
+// arrive out of order, and the simulation speed.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/applications-module.h"
+#include <iostream>
+#include <map>
+
+using namespace ns3;
+
+/// Highest sequence number received so far, by flow
+static std::map<std::pair<uint64_t, uint32_t>, SequenceNumber32> g_highest;
+static uint64_t g_segments = 0;    //!< data segments received
+static uint64_t g_reordered = 0;   //!< data segments received below the highest sequence number
+
+/**
+ * Check the order of the TCP data segments delivered to a node.
+ *
+ * \param header IP header
+ * \param packet the packet, starting with the TCP header
+ * \param interface receiving interface
+ */
+static void
+LocalDeliver (const Ipv4Header &header, Ptr<const Packet> packet, uint32_t interface)
+{
+  if (header.GetProtocol () != TcpL4Protocol::PROT_NUMBER)
+    {
+      return;
+    }
+  TcpHeader tcp;
+  packet->PeekHeader (tcp);
+  uint32_t size = packet->GetSize () - tcp.GetSerializedSize ();
+  if (size == 0)
+    {
+      return;
+    }
+  std::pair<uint64_t, uint32_t> flow ((uint64_t (header.GetSource ().Get ()) << 32) | header.GetDestination ().Get (),
+                                      (tcp.GetSourcePort () << 16) | tcp.GetDestinationPort ());
+  SequenceNumber32 end = tcp.GetSequenceNumber () + size;
+  std::map<std::pair<uint64_t, uint32_t>, SequenceNumber32>::iterator it = g_highest.find (flow);
+  g_segments++;
+  if (it == g_highest.end ())
+    {
+      g_highest[flow] = end;
+    }
+  else if (end < it->second)
+    {
+      g_reordered++;
+    }
+  else
+    {
+      it->second = end;
+    }
+}
+
+/**
+ * Connect two nodes with a point-to-point link on its own /30 subnet.
+ *
+ * \param a first node
+ * \param b second node
+ * \param p2p the link helper
+ * \param address the address helper, moved to the next subnet afterwards
+ * \returns the interfaces of the link
+ */
+static Ipv4InterfaceContainer
+Connect (Ptr<Node> a, Ptr<Node> b, PointToPointHelper &p2p, Ipv4AddressHelper &address)
+{
+  NetDeviceContainer devices = p2p.Install (a, b);
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  address.NewNetwork ();
+  return interfaces;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t k = 4;
+  std::string ecmp = "flow";
+  double duration = 1.0;
+  uint32_t cacheSize = 256;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark ECMP routing with bulk TCP transfers on a k-ary fat-tree");
+  cmd.AddValue ("k", "fat-tree arity (even), giving 5k^2/4 switches and k^3/4 hosts", k);
+  cmd.AddValue ("ecmp", "ECMP mode: none, random (per packet) or flow (per five-tuple)", ecmp);
+  cmd.AddValue ("duration", "simulated time, in seconds", duration);
+  cmd.AddValue ("cache", "size of the flow cache of each router, 0 to disable it", cacheSize);
+  cmd.Parse (argc, argv);
+  k = (k / 2) * 2;
+  if (k < 2)
+    {
+      k = 2;
+    }
+  uint32_t half = k / 2;
+
+  if (ecmp == "random")
+    {
+      Config::SetDefault ("ns3::Ipv4GlobalRouting::RandomEcmpRouting", BooleanValue (true));
+    }
+  else if (ecmp == "flow")
+    {
+      Config::SetDefault ("ns3::Ipv4GlobalRouting::FlowEcmpRouting", BooleanValue (true));
+    }
+  else if (ecmp != "none")
+    {
+      NS_FATAL_ERROR ("Unknown ECMP mode " << ecmp);
+    }
+  Config::SetDefault ("ns3::Ipv4GlobalRouting::FlowCacheSize", UintegerValue (cacheSize));
+
+  NodeContainer core;
+  core.Create (half * half);
+  NodeContainer aggregation;
+  aggregation.Create (k * half);
+  NodeContainer edge;
+  edge.Create (k * half);
+  NodeContainer hosts;
+  hosts.Create (k * half * half);
+
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("10us"));
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+
+  std::vector<Ipv4Address> hostAddresses;
+  for (uint32_t pod = 0; pod < k; ++pod)
+    {
+      for (uint32_t a = 0; a < half; ++a)
+        {
+          Ptr<Node> agg = aggregation.Get (pod * half + a);
+          for (uint32_t c = 0; c < half; ++c)
+            {
+              Connect (agg, core.Get (a * half + c), p2p, address);
+            }
+          for (uint32_t e = 0; e < half; ++e)
+            {
+              Connect (agg, edge.Get (pod * half + e), p2p, address);
+            }
+        }
+      for (uint32_t e = 0; e < half; ++e)
+        {
+          for (uint32_t h = 0; h < half; ++h)
+            {
+              Ipv4InterfaceContainer link = Connect (edge.Get (pod * half + e), hosts.Get ((pod * half + e) * half + h), p2p, address);
+              hostAddresses.push_back (link.GetAddress (1));
+            }
+        }
+    }
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+
+  // every host sends to the host half way around the fat-tree, through the core
+  uint32_t nHosts = hosts.GetN ();
+  uint16_t port = 5000;
+  ApplicationContainer sinks;
+  for (uint32_t i = 0; i < nHosts; ++i)
+    {
+      PacketSinkHelper sink ("ns3::TcpSocketFactory", InetSocketAddress (Ipv4Address::GetAny (), port));
+      sinks.Add (sink.Install (hosts.Get (i)));
+      BulkSendHelper source ("ns3::TcpSocketFactory", InetSocketAddress (hostAddresses[(i + nHosts / 2) % nHosts], port));
+      ApplicationContainer app = source.Install (hosts.Get (i));
+      app.Start (Seconds (0.001 * i / nHosts));
+    }
+  Config::ConnectWithoutContext ("/NodeList/*/$ns3::Ipv4L3Protocol/LocalDeliver", MakeCallback (&LocalDeliver));
+
+  std::cout << "Running bench-ecmp with k=" << k << ", ecmp=" << ecmp << std::endl;
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (Seconds (duration));
+  Simulator::Run ();
+  int64_t ms = timer.End ();
+
+  uint64_t bytes = 0;
+  for (uint32_t i = 0; i < sinks.GetN (); ++i)
+    {
+      bytes += DynamicCast<PacketSink> (sinks.Get (i))->GetTotalRx ();
+    }
+  std::cout << "throughput: " << bytes * 8 / duration / 1e6 << " Mbps ("
+            << nHosts << " flows)" << std::endl;
+  std::cout << "reordered: " << g_reordered << " of " << g_segments << " data segments ("
+            << (g_segments > 0 ? 100.0 * g_reordered / g_segments : 0) << "%)" << std::endl;
+  std::cout << "wall clock: " << ms << " ms" << std::endl;
+
+  Simulator::Destroy ();
+  return 0;
+}
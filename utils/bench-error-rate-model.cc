@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the chunk success rates of the NistErrorRateModel
+// and of the YansErrorRateModel, calculated exactly and interpolated from
+// the tables of the bit error rates: first over the 802.11n and 802.11ac
+// MCSs and a range of SNRs, then in a saturated 802.11n network, where
+// every node broadcasts frames back to back at HT MCS 7.  Print the wall
+// clock time of each, and the largest difference between the chunk
+// success rates.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+static uint32_t g_received = 0;   //!< the frames received
+
+/**
+ * Count a frame received.
+ *
+ * \param p the frame
+ */
+static void
+Received (Ptr<const Packet> p)
+{
+  g_received++;
+}
+
+/**
+ * Keep the queue of a device full.
+ *
+ * \param device the sending device
+ */
+static void
+Saturate (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (1500), device->GetBroadcast (), 1);
+  Simulator::Schedule (MicroSeconds (300), &Saturate, device);
+}
+
+/**
+ * Calculate the chunk success rates of the MCSs over a range of SNRs.
+ *
+ * \param type the type of the error rate model
+ * \param iterations the iterations over the MCSs and SNRs
+ */
+static void
+RunChunks (std::string type, uint32_t iterations)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (type);
+  factory.Set ("MaxTableError", DoubleValue (0));
+  Ptr<ErrorRateModel> exact = factory.Create<ErrorRateModel> ();
+  factory.Set ("MaxTableError", DoubleValue (1e-6));
+  Ptr<ErrorRateModel> table = factory.Create<ErrorRateModel> ();
+
+  // HT MCS 0 to 7 over 20 MHz, then VHT MCS 8 and 9 over 80 MHz
+  WifiMode mcs[] = { WifiPhy::GetHtMcs0 (), WifiPhy::GetHtMcs1 (), WifiPhy::GetHtMcs2 (), WifiPhy::GetHtMcs3 (),
+                     WifiPhy::GetHtMcs4 (), WifiPhy::GetHtMcs5 (), WifiPhy::GetHtMcs6 (), WifiPhy::GetHtMcs7 (),
+                     WifiPhy::GetVhtMcs8 (), WifiPhy::GetVhtMcs9 () };
+  std::vector<WifiMode> modes;
+  std::vector<WifiTxVector> txVectors;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      WifiTxVector txVector;
+      txVector.SetMode (mcs[i]);
+      txVector.SetChannelWidth (i < 8 ? 20 : 80);
+      txVector.SetNss (1);
+      modes.push_back (mcs[i]);
+      txVectors.push_back (txVector);
+    }
+  std::vector<double> snrs;
+  for (double snrDb = 0; snrDb < 40; snrDb += 0.1)
+    {
+      snrs.push_back (std::pow (10.0, snrDb / 10.0));
+    }
+
+  // build the tables first
+  for (uint32_t i = 0; i < modes.size (); i++)
+    {
+      table->GetChunkSuccessRate (modes[i], txVectors[i], 1, 1);
+    }
+
+  Ptr<ErrorRateModel> models[] = { exact, table };
+  double total[2] = { 0, 0 };
+  int64_t ms[2];
+  for (uint32_t k = 0; k < 2; k++)
+    {
+      SystemWallClockMs timer;
+      timer.Start ();
+      for (uint32_t iteration = 0; iteration < iterations; iteration++)
+        {
+          for (uint32_t i = 0; i < modes.size (); i++)
+            {
+              for (uint32_t j = 0; j < snrs.size (); j++)
+                {
+                  total[k] += models[k]->GetChunkSuccessRate (modes[i], txVectors[i], snrs[j], 12000);
+                }
+            }
+        }
+      ms[k] = timer.End ();
+    }
+  double maxDifference = 0;
+  for (uint32_t i = 0; i < modes.size (); i++)
+    {
+      for (uint32_t j = 0; j < snrs.size (); j++)
+        {
+          maxDifference = std::max (maxDifference, std::fabs (exact->GetChunkSuccessRate (modes[i], txVectors[i], snrs[j], 12000)
+                                                              - table->GetChunkSuccessRate (modes[i], txVectors[i], snrs[j], 12000)));
+        }
+    }
+  double calls = static_cast<double> (iterations) * modes.size () * snrs.size ();
+  std::cout << type << ": " << std::setprecision (3)
+            << ms[0] * 1e6 / calls << " ns exact, "
+            << ms[1] * 1e6 / calls << " ns from the tables, "
+            << maxDifference << " largest difference" << std::endl;
+}
+
+/**
+ * Run the saturated network.
+ *
+ * \param type the type of the error rate model
+ * \param maxTableError the MaxTableError of the error rate model
+ * \param nNodes the number of nodes
+ * \param stop the duration of the simulation
+ */
+static void
+RunNetwork (std::string type, double maxTableError, uint32_t nNodes, Time stop)
+{
+  g_received = 0;
+  RngSeedManager::SetRun (1);
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  MobilityHelper mobility;
+  mobility.SetPositionAllocator ("ns3::GridPositionAllocator",
+                                 "DeltaX", DoubleValue (10),
+                                 "DeltaY", DoubleValue (10),
+                                 "GridWidth", UintegerValue (10));
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+
+  YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channelHelper.Create ());
+  phy.SetErrorRateModel (type, "MaxTableError", DoubleValue (maxTableError));
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211n_5GHZ);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager",
+                                "DataMode", StringValue ("HtMcs7"),
+                                "NonUnicastMode", StringValue ("HtMcs7"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 1);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&Received));
+      Simulator::Schedule (MicroSeconds (i), &Saturate, devices.Get (i));
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+
+  std::cout << type << " with MaxTableError " << maxTableError << ": "
+            << g_received << " frames received, "
+            << runMs << " ms run" << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t iterations = 20;
+  uint32_t nNodes = 30;
+  double stop = 2;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the chunk success rates of the OFDM error rate models, exact and interpolated from tables");
+  cmd.AddValue ("iterations", "iterations over the MCSs and SNRs", iterations);
+  cmd.AddValue ("nodes", "number of nodes of the saturated network", nNodes);
+  cmd.AddValue ("stop", "duration of the simulation of the saturated network, in seconds", stop);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-error-rate-model" << std::endl;
+  RunChunks ("ns3::NistErrorRateModel", iterations);
+  RunChunks ("ns3::YansErrorRateModel", iterations);
+  RunNetwork ("ns3::NistErrorRateModel", 0, nNodes, Seconds (stop));
+  RunNetwork ("ns3::NistErrorRateModel", 1e-6, nNodes, Seconds (stop));
+  RunNetwork ("ns3::YansErrorRateModel", 0, nNodes, Seconds (stop));
+  RunNetwork ("ns3::YansErrorRateModel", 1e-6, nNodes, Seconds (stop));
+  return 0;
+}
@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure how long global routing takes to populate the routing tables of
+// a k-ary fat-tree built out of point-to-point links, then to recompute
+// them when nothing changed and after a link went down.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/point-to-point-helper.h"
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Connect two nodes with a point-to-point link on its own /30 subnet.
+ *
+ * \param a first node
+ * \param b second node
+ * \param p2p the link helper
+ * \param address the address helper, moved to the next subnet afterwards
+ * \returns the interfaces of the link
+ */
+static Ipv4InterfaceContainer
+Connect (Ptr<Node> a, Ptr<Node> b, PointToPointHelper &p2p, Ipv4AddressHelper &address)
+{
+  NetDeviceContainer devices = p2p.Install (a, b);
+  Ipv4InterfaceContainer interfaces = address.Assign (devices);
+  address.NewNetwork ();
+  return interfaces;
+}
+
+/**
+ * Print the time taken by a step.
+ *
+ * \param name the step
+ * \param ms the wall clock time, in milliseconds
+ * \param nNodes number of nodes
+ */
+static void
+Report (std::string name, int64_t ms, uint32_t nNodes)
+{
+  std::cout << name << ": " << ms << " ms (" << nNodes << " nodes)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t k = 8;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark global routing table computation on a k-ary fat-tree");
+  cmd.AddValue ("k", "fat-tree arity (even), giving 5k^2/4 switches and k^3/4 hosts", k);
+  cmd.Parse (argc, argv);
+  k = (k / 2) * 2;
+  if (k < 2)
+    {
+      k = 2;
+    }
+  uint32_t half = k / 2;
+
+  NodeContainer core;
+  core.Create (half * half);
+  NodeContainer aggregation;
+  aggregation.Create (k * half);
+  NodeContainer edge;
+  edge.Create (k * half);
+  NodeContainer hosts;
+  hosts.Create (k * half * half);
+
+  InternetStackHelper stack;
+  stack.InstallAll ();
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1us"));
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+
+  Ipv4InterfaceContainer coreLink;
+  for (uint32_t pod = 0; pod < k; ++pod)
+    {
+      for (uint32_t a = 0; a < half; ++a)
+        {
+          Ptr<Node> agg = aggregation.Get (pod * half + a);
+          for (uint32_t c = 0; c < half; ++c)
+            {
+              Ipv4InterfaceContainer link = Connect (agg, core.Get (a * half + c), p2p, address);
+              if (coreLink.GetN () == 0)
+                {
+                  coreLink = link;
+                }
+            }
+          for (uint32_t e = 0; e < half; ++e)
+            {
+              Connect (agg, edge.Get (pod * half + e), p2p, address);
+            }
+        }
+      for (uint32_t e = 0; e < half; ++e)
+        {
+          for (uint32_t h = 0; h < half; ++h)
+            {
+              Connect (edge.Get (pod * half + e), hosts.Get ((pod * half + e) * half + h), p2p, address);
+            }
+        }
+    }
+
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::cout << "Running bench-global-routing with k=" << k << std::endl;
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  Ipv4GlobalRoutingHelper::PopulateRoutingTables ();
+  Report ("populate", timer.End (), nNodes);
+
+  timer.Start ();
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  Report ("recompute, no change", timer.End (), nNodes);
+
+  std::pair<Ptr<Ipv4>, uint32_t> down = coreLink.Get (0);
+  down.first->SetDown (down.second);
+  timer.Start ();
+  Ipv4GlobalRoutingHelper::RecomputeRoutingTables ();
+  Report ("recompute, one link down", timer.End (), nNodes);
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,129 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the course changes of random mobility models
+// whose positions are seldom queried: Gauss-Markov nodes, which change
+// course at every time step, have the position of a few of them looked
+// up every second, with the course changes made in scheduled events,
+// then lazily.  Print the wall clock time of each simulation, and the
+// number of course changes made.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+static double g_total = 0;          //!< the sum of the abscissas, to keep the results alive
+static uint64_t g_courseChanges = 0; //!< the number of course changes
+
+/**
+ * Count a course change.
+ *
+ * \param model the mobility model
+ */
+static void
+CourseChange (Ptr<const MobilityModel> model)
+{
+  g_courseChanges++;
+}
+
+/**
+ * Look up the positions of some of the nodes, and schedule the next lookup.
+ *
+ * \param nodes the mobility models of the nodes
+ * \param lookups the number of nodes looked up
+ */
+static void
+LookUp (const std::vector<Ptr<MobilityModel> > *nodes, uint32_t lookups)
+{
+  for (uint32_t i = 0; i < lookups; i++)
+    {
+      g_total += (*nodes)[i % nodes->size ()]->GetPosition ().x;
+    }
+  Simulator::Schedule (Seconds (1), &LookUp, nodes, lookups);
+}
+
+/**
+ * Run the simulation.
+ *
+ * \param nNodes the number of nodes
+ * \param lookups the number of nodes looked up every second
+ * \param stop the duration of the simulation
+ * \param lazy whether the course changes are made lazily
+ * \returns the wall clock time of the simulation, in milliseconds
+ */
+static int64_t
+Run (uint32_t nNodes, uint32_t lookups, Time stop, bool lazy)
+{
+  std::vector<Ptr<MobilityModel> > nodes;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObjectWithAttributes<GaussMarkovMobilityModel>
+          ("Bounds", BoxValue (Box (0, 1000, 0, 1000, 0, 100)),
+           "TimeStep", TimeValue (Seconds (0.1)),
+           "Lazy", BooleanValue (lazy));
+      mobility->AssignStreams (1 + 6 * i);
+      mobility->SetPosition (Vector (i % 1000, i / 1000 % 1000, 50));
+      mobility->TraceConnectWithoutContext ("CourseChange", MakeCallback (&CourseChange));
+      mobility->Initialize ();
+      nodes.push_back (mobility);
+    }
+  Simulator::Schedule (Seconds (1), &LookUp, &nodes, lookups);
+
+  g_courseChanges = 0;
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+  Simulator::Destroy ();
+  return runMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 10000;
+  uint32_t lookups = 10;
+  double stop = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the course changes of random mobility models made in events and lazily");
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("lookups", "number of nodes looked up every second", lookups);
+  cmd.AddValue ("stop", "duration of the simulation, in seconds", stop);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-lazy-mobility with " << nNodes << " nodes, "
+            << lookups << " looked up every second, for " << stop << " s" << std::endl;
+  const char *names[] = { "scheduled", "lazy" };
+  for (uint32_t lazy = 0; lazy <= 1; lazy++)
+    {
+      int64_t runMs = Run (nNodes, lookups, Seconds (stop), lazy);
+      std::cout << "  " << std::left << std::setw (12) << names[lazy] << std::right
+                << std::setw (8) << runMs << " ms run, "
+                << std::setw (10) << g_courseChanges << " course changes" << std::endl;
+    }
+  // keep the results alive
+  if (g_total == 0)
+    {
+      std::cout << "unexpected result" << std::endl;
+    }
+  return 0;
+}
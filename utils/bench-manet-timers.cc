@@ -0,0 +1,138 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the timers of OLSR and AODV on a grid of nodes
+// linked to their neighbors, with one simulator event per timer and with
+// the timers batched in a shared timer wheel (the TimerTick attribute).
+// Print the number of events scheduled, the wall clock time of the
+// simulation and, for OLSR, the number of routes of the first node.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/olsr-module.h"
+#include "ns3/aodv-module.h"
+#include <iostream>
+
+using namespace ns3;
+
+/// Do nothing; used to get the identifier of the next event.
+static void
+Noop (void)
+{
+}
+
+/**
+ * Get the number of OLSR routes of a node.
+ *
+ * \param node the node
+ * \returns the number of routes, or 0 if OLSR is not the routing protocol of the node
+ */
+static uint32_t
+GetOlsrRoutes (Ptr<Node> node)
+{
+  Ptr<olsr::RoutingProtocol> olsr = DynamicCast<olsr::RoutingProtocol> (node->GetObject<Ipv4> ()->GetRoutingProtocol ());
+  return olsr != 0 ? olsr->GetRoutingTableEntries ().size () : 0;
+}
+
+/**
+ * Run the simulation of the grid.
+ *
+ * \param side the number of nodes on a side of the grid
+ * \param stop the duration of the simulation
+ * \param aodv whether AODV rather than OLSR runs on the nodes
+ * \param tick the tick of the timer wheel, or zero not to use one
+ */
+static void
+Run (uint32_t side, Time stop, bool aodv, Time tick)
+{
+  NodeContainer nodes;
+  nodes.Create (side * side);
+  InternetStackHelper stack;
+  if (aodv)
+    {
+      AodvHelper routing;
+      routing.Set ("TimerTick", TimeValue (tick));
+      stack.SetRoutingHelper (routing);
+    }
+  else
+    {
+      OlsrHelper routing;
+      routing.Set ("TimerTick", TimeValue (tick));
+      stack.SetRoutingHelper (routing);
+    }
+  stack.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetChannelAttribute ("Delay", StringValue ("1ms"));
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+  for (uint32_t i = 0; i < side * side; i++)
+    {
+      // link each node to its right and bottom neighbors
+      if (i % side + 1 < side)
+        {
+          address.Assign (simple.Install (NodeContainer (nodes.Get (i), nodes.Get (i + 1))));
+          address.NewNetwork ();
+        }
+      if (i + side < side * side)
+        {
+          address.Assign (simple.Install (NodeContainer (nodes.Get (i), nodes.Get (i + side))));
+          address.NewNetwork ();
+        }
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+
+  std::cout << (aodv ? "AODV" : "OLSR") << ", tick " << tick.GetMilliSeconds () << " ms: "
+            << Simulator::Schedule (Seconds (0), &Noop).GetUid () << " events, "
+            << runMs << " ms run";
+  if (!aodv)
+    {
+      std::cout << ", " << GetOlsrRoutes (nodes.Get (0)) << " routes on the first node";
+    }
+  std::cout << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t side = 10;
+  double stop = 60;
+  uint32_t tickMs = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the timers of OLSR and AODV, with and without a shared timer wheel");
+  cmd.AddValue ("side", "number of nodes on a side of the grid", side);
+  cmd.AddValue ("stop", "duration of the simulation, in seconds", stop);
+  cmd.AddValue ("tick", "tick of the timer wheel, in milliseconds", tickMs);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-manet-timers with " << side * side << " nodes for "
+            << stop << " s" << std::endl;
+  for (uint32_t aodv = 0; aodv < 2; aodv++)
+    {
+      Run (side, Seconds (stop), aodv, Seconds (0));
+      Run (side, Seconds (stop), aodv, MilliSeconds (tickMs));
+    }
+  return 0;
+}
@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the evaluation of the positions of moving nodes:
+// nodes following the random waypoint model are looked up every 10 ms,
+// first not at all, to measure the cost of the simulation of their
+// moves, then by asking their mobility models one at a time, then by
+// evaluating all their positions at once with the MobilityManager.
+// Print the wall clock time of each simulation, and the time of a
+// position evaluation, in nanoseconds.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/mobility-module.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+static double g_total = 0;   //!< the sum of the abscissas, to keep the results alive
+
+/**
+ * Look up the positions of all the nodes, and schedule the next lookup.
+ *
+ * \param nodes the mobility models of the nodes
+ * \param mode 0 not to look up the positions, 1 to ask the mobility
+ *        models, 2 to evaluate them with the MobilityManager
+ */
+static void
+LookUp (const std::vector<Ptr<MobilityModel> > *nodes, uint32_t mode)
+{
+  if (mode == 1)
+    {
+      for (uint32_t i = 0; i < nodes->size (); i++)
+        {
+          g_total += (*nodes)[i]->GetPosition ().x;
+        }
+    }
+  else if (mode == 2)
+    {
+      MobilityManager *manager = MobilityManager::Get ();
+      manager->EvaluatePositions ();
+      for (uint32_t i = 0; i < nodes->size (); i++)
+        {
+          g_total += manager->GetPosition (i).x;
+        }
+    }
+  Simulator::Schedule (MilliSeconds (10), &LookUp, nodes, mode);
+}
+
+/**
+ * Run the simulation.
+ *
+ * \param nNodes the number of nodes
+ * \param size the side of the square area, in meters
+ * \param stop the duration of the simulation
+ * \param mode how the positions are looked up, see LookUp
+ * \returns the wall clock time of the simulation, in milliseconds
+ */
+static int64_t
+Run (uint32_t nNodes, double size, Time stop, uint32_t mode)
+{
+  std::ostringstream bound;
+  bound << "ns3::UniformRandomVariable[Min=0.0|Max=" << size << "]";
+  Ptr<RandomRectanglePositionAllocator> waypoints = CreateObject<RandomRectanglePositionAllocator> ();
+  waypoints->SetAttribute ("X", StringValue (bound.str ()));
+  waypoints->SetAttribute ("Y", StringValue (bound.str ()));
+  waypoints->AssignStreams (0);
+  std::vector<Ptr<MobilityModel> > nodes;
+  MobilityManager *manager = MobilityManager::Get ();
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<MobilityModel> mobility = CreateObjectWithAttributes<RandomWaypointMobilityModel>
+          ("PositionAllocator", PointerValue (waypoints),
+           "Speed", StringValue ("ns3::UniformRandomVariable[Min=1.0|Max=20.0]"),
+           "Pause", StringValue ("ns3::ConstantRandomVariable[Constant=1.0]"));
+      mobility->AssignStreams (1 + 2 * i);
+      mobility->SetPosition (waypoints->GetNext ());
+      manager->Add (mobility);
+      mobility->Initialize ();
+      nodes.push_back (mobility);
+    }
+  Simulator::Schedule (MilliSeconds (10), &LookUp, &nodes, mode);
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+  Simulator::Destroy ();
+  return runMs;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 1000;
+  double size = 1000;
+  double stop = 100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the evaluation of the positions of moving nodes, with and without the MobilityManager");
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("size", "side of the square area, in meters", size);
+  cmd.AddValue ("stop", "duration of the simulation, in seconds", stop);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-mobility-manager with " << nNodes << " nodes on "
+            << size << " m x " << size << " m for " << stop << " s" << std::endl;
+  double lookups = nNodes * (stop * 100 - 1);
+  int64_t moves = Run (nNodes, size, Seconds (stop), 0);
+  std::cout << "  " << std::left << std::setw (24) << "no lookup" << std::right
+            << std::setw (8) << moves << " ms run" << std::endl;
+  const char *names[] = { "mobility models", "MobilityManager" };
+  for (uint32_t mode = 1; mode <= 2; mode++)
+    {
+      int64_t runMs = Run (nNodes, size, Seconds (stop), mode);
+      std::cout << "  " << std::left << std::setw (24) << names[mode - 1] << std::right
+                << std::setw (8) << runMs << " ms run, "
+                << std::setw (8) << (runMs - moves) * 1e6 / lookups << " ns per position" << std::endl;
+    }
+  // keep the results alive
+  if (g_total == 0)
+    {
+      std::cout << "unexpected result" << std::endl;
+    }
+  return 0;
+}
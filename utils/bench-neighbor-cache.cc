@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of address resolution on a CSMA LAN: every node sends
+// a UDP packet to the next one, first with ARP or NDISC resolving the
+// neighbors, then with neighbor caches populated by NeighborCacheHelper.
+// Print the frames sent on the LAN, the mean latency of the first packets
+// and the wall clock time of the simulation.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/csma-module.h"
+#include <iostream>
+
+using namespace ns3;
+
+static uint32_t g_frames = 0;   //!< the frames sent on the LAN
+static Time g_latency;          //!< the sum of the latencies of the packets
+static uint32_t g_received = 0; //!< the packets received
+
+/**
+ * Count a frame sent on the LAN.
+ *
+ * \param p the frame
+ */
+static void
+FrameSent (Ptr<const Packet> p)
+{
+  g_frames++;
+}
+
+/**
+ * Receive the packets of a node; all of them were sent at one second.
+ *
+ * \param socket the receiving socket
+ */
+static void
+Receive (Ptr<Socket> socket)
+{
+  while (socket->Recv ())
+    {
+      g_latency += Simulator::Now () - Seconds (1);
+      g_received++;
+    }
+}
+
+/**
+ * Send a packet.
+ *
+ * \param socket the sending socket
+ * \param to the destination
+ */
+static void
+Send (Ptr<Socket> socket, Address to)
+{
+  socket->SendTo (Create<Packet> (100), 0, to);
+}
+
+/**
+ * Run the simulation of the LAN.
+ *
+ * \param nNodes the number of nodes
+ * \param ipv6 whether the packets are sent with IPv6 rather than IPv4
+ * \param populate whether the neighbor caches are populated
+ */
+static void
+Run (uint32_t nNodes, bool ipv6, bool populate)
+{
+  g_frames = 0;
+  g_latency = Seconds (0);
+  g_received = 0;
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  InternetStackHelper stack;
+  stack.Install (nodes);
+  CsmaHelper csma;
+  csma.SetChannelAttribute ("DataRate", StringValue ("1Gbps"));
+  NetDeviceContainer devices = csma.Install (nodes);
+  Ipv4AddressHelper ipv4Address ("10.0.0.0", "255.0.0.0");
+  Ipv4InterfaceContainer ipv4Interfaces = ipv4Address.Assign (devices);
+  Ipv6AddressHelper ipv6Address (Ipv6Address ("2001:1::"), Ipv6Prefix (64));
+  Ipv6InterfaceContainer ipv6Interfaces = ipv6Address.Assign (devices);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      nodes.Get (i)->GetObject<Icmpv6L4Protocol> ()->SetAttribute ("DAD", BooleanValue (false));
+      devices.Get (i)->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&FrameSent));
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  if (populate)
+    {
+      NeighborCacheHelper neighbors;
+      neighbors.PopulateNeighborCache ();
+    }
+  int64_t populateMs = timer.End ();
+
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      Ptr<Socket> receiver = Socket::CreateSocket (nodes.Get (i), UdpSocketFactory::GetTypeId ());
+      Ptr<Socket> sender = Socket::CreateSocket (nodes.Get (i), UdpSocketFactory::GetTypeId ());
+      uint32_t next = (i + 1) % nNodes;
+      if (ipv6)
+        {
+          receiver->Bind (Inet6SocketAddress (Ipv6Address::GetAny (), 9));
+          sender->Bind6 ();
+          Simulator::Schedule (Seconds (1), &Send, sender, Inet6SocketAddress (ipv6Interfaces.GetAddress (next, 1), 9));
+        }
+      else
+        {
+          receiver->Bind (InetSocketAddress (Ipv4Address::GetAny (), 9));
+          sender->Bind ();
+          Simulator::Schedule (Seconds (1), &Send, sender, InetSocketAddress (ipv4Interfaces.GetAddress (next), 9));
+        }
+      receiver->SetRecvCallback (MakeCallback (&Receive));
+    }
+
+  timer.Start ();
+  Simulator::Stop (Seconds (10));
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+
+  std::cout << (ipv6 ? "IPv6" : "IPv4") << (populate ? ", populated caches: " : ", address resolution: ")
+            << g_frames << " frames, "
+            << (g_received > 0 ? (g_latency / g_received).GetMicroSeconds () : 0) << " us mean latency ("
+            << g_received << " of " << nNodes << " received), "
+            << populateMs << " ms populate, " << runMs << " ms run" << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 200;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark address resolution and populated neighbor caches on a CSMA LAN");
+  cmd.AddValue ("nodes", "number of nodes on the LAN", nNodes);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-neighbor-cache with " << nNodes << " nodes" << std::endl;
+  for (uint32_t ipv6 = 0; ipv6 < 2; ipv6++)
+    {
+      Run (nNodes, ipv6, false);
+      Run (nNodes, ipv6, true);
+    }
+  return 0;
+}
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure how fast nix-vector routing computes routes on a square grid of
+// point-to-point links: time RouteOutput between random pairs of nodes,
+// first with an empty nix-vector cache, then with the same pairs again.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/nix-vector-routing-module.h"
+#include <iostream>
+#include <cmath>
+
+using namespace ns3;
+
+/**
+ * Print the route computation rate.
+ *
+ * \param name the step
+ * \param ms the wall clock time, in milliseconds
+ * \param nRoutes the number of routes
+ * \param nFound the number of routes found
+ */
+static void
+Report (std::string name, int64_t ms, uint32_t nRoutes, uint32_t nFound)
+{
+  std::cout << name << ": " << ms << " ms, "
+            << (ms > 0 ? nRoutes * 1000.0 / ms : 0) << " routes/s ("
+            << nFound << " of " << nRoutes << " found)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 2500;
+  uint32_t nRoutes = 2000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark nix-vector route computation on a grid");
+  cmd.AddValue ("nodes", "number of nodes, rounded down to a square", nNodes);
+  cmd.AddValue ("routes", "number of routes computed", nRoutes);
+  cmd.Parse (argc, argv);
+  uint32_t side = std::max (2, static_cast<int> (std::sqrt (static_cast<double> (nNodes))));
+
+  NodeContainer nodes;
+  nodes.Create (side * side);
+  Ipv4NixVectorHelper nixRouting;
+  InternetStackHelper stack;
+  stack.SetRoutingHelper (nixRouting);
+  stack.Install (nodes);
+
+  SimpleNetDeviceHelper simple;
+  simple.SetNetDevicePointToPointMode (true);
+  Ipv4AddressHelper address ("10.0.0.0", "255.255.255.252");
+  std::vector<Ipv4Address> addresses (nodes.GetN ());
+  for (uint32_t node = 0; node < nodes.GetN (); node++)
+    {
+      if (node % side != side - 1)
+        {
+          Ipv4InterfaceContainer link = address.Assign (simple.Install (NodeContainer (nodes.Get (node), nodes.Get (node + 1))));
+          address.NewNetwork ();
+          addresses[node] = link.GetAddress (0);
+          addresses[node + 1] = link.GetAddress (1);
+        }
+      if (node + side < nodes.GetN ())
+        {
+          Ipv4InterfaceContainer link = address.Assign (simple.Install (NodeContainer (nodes.Get (node), nodes.Get (node + side))));
+          address.NewNetwork ();
+          addresses[node + side] = link.GetAddress (1);
+        }
+    }
+
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  std::vector<std::pair<uint32_t, uint32_t> > pairs;
+  for (uint32_t i = 0; i < nRoutes; ++i)
+    {
+      pairs.push_back (std::make_pair (rng->GetInteger (0, nodes.GetN () - 1), rng->GetInteger (0, nodes.GetN () - 1)));
+    }
+
+  std::cout << "Running bench-nix-vector with " << nodes.GetN () << " nodes" << std::endl;
+
+  Socket::SocketErrno sockerr;
+  Ipv4Header header;
+  SystemWallClockMs timer;
+  for (uint32_t pass = 0; pass < 2; ++pass)
+    {
+      uint32_t found = 0;
+      timer.Start ();
+      for (uint32_t i = 0; i < nRoutes; ++i)
+        {
+          Ptr<Ipv4RoutingProtocol> routing = nodes.Get (pairs[i].first)->GetObject<Ipv4> ()->GetRoutingProtocol ();
+          header.SetDestination (addresses[pairs[i].second]);
+          found += (routing->RouteOutput (Create<Packet> (), header, 0, sockerr) != 0);
+        }
+      Report (pass == 0 ? "first lookup" : "cached lookup", timer.End (), nRoutes, found);
+    }
+
+  Simulator::Destroy ();
+  return 0;
+}
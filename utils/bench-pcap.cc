@@ -0,0 +1,164 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Compare the cost of today's per-device pcap tracing (one PcapFileWrapper,
+// hence one std::fstream, per device) with a single buffered pcapng file
+// shared by all devices, optionally gzip-compressed.
+//
+// The trace sinks are driven directly, as PcapHelper::DefaultSink would, so
+// that only the cost of getting the records to disk is measured.
+//
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/packet.h"
+#include "ns3/trace-helper.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+
+using namespace ns3;
+
+/**
+ * Write packets round-robin over a set of per-device pcap files.
+ *
+ * \param files the per-device files
+ * \param p the packet to write
+ * \param n number of packets per device
+ */
+static void
+WriteAll (std::vector<Ptr<PcapFileWrapper> > &files, Ptr<const Packet> p, uint32_t n)
+{
+  for (uint32_t i = 0; i < n; ++i)
+    {
+      Time t = MicroSeconds (i);
+      for (std::vector<Ptr<PcapFileWrapper> >::iterator f = files.begin (); f != files.end (); ++f)
+        {
+          (*f)->Write (t, p);
+        }
+    }
+}
+
+/**
+ * Create one pcap file per device, as EnablePcapAll does.
+ *
+ * \param prefix file name prefix
+ * \param devices number of devices
+ * \returns the files
+ */
+static std::vector<Ptr<PcapFileWrapper> >
+CreateFiles (std::string prefix, uint32_t devices)
+{
+  PcapHelper helper;
+  std::vector<Ptr<PcapFileWrapper> > files;
+  for (uint32_t d = 0; d < devices; ++d)
+    {
+      std::ostringstream oss;
+      oss << prefix << "-" << d << "-0.pcap";
+      files.push_back (helper.CreateFile (oss.str (), std::ios::out, PcapHelper::DLT_PPP));
+    }
+  return files;
+}
+
+/**
+ * Remove the files created by CreateFiles.
+ *
+ * \param prefix file name prefix
+ * \param devices number of devices
+ */
+static void
+RemoveFiles (std::string prefix, uint32_t devices)
+{
+  for (uint32_t d = 0; d < devices; ++d)
+    {
+      std::ostringstream oss;
+      oss << prefix << "-" << d << "-0.pcap";
+      std::remove (oss.str ().c_str ());
+    }
+}
+
+/**
+ * Run one configuration and print its throughput.
+ *
+ * \param name configuration name
+ * \param prefix file name prefix, or a pcapng file name
+ * \param devices number of devices
+ * \param n number of packets per device
+ * \param size packet size
+ * \param ng use a shared pcapng file
+ */
+static void
+RunBench (std::string name, std::string prefix, uint32_t devices, uint32_t n, uint32_t size, bool ng)
+{
+  Ptr<const Packet> p = Create<Packet> (size);
+  SystemWallClockMs time;
+  time.Start ();
+  Ptr<PcapNgFileWrapper> ngFile;
+  if (ng)
+    {
+      PcapHelper helper;
+      ngFile = helper.CreateNgFile (prefix);
+      PcapHelper::SetPcapNgRedirect (ngFile);
+    }
+  std::vector<Ptr<PcapFileWrapper> > files = CreateFiles (prefix, devices);
+  PcapHelper::SetPcapNgRedirect (0);
+  WriteAll (files, p, n);
+  files.clear ();
+  if (ng)
+    {
+      ngFile->Close ();
+    }
+  uint64_t ms = time.End ();
+  double records = static_cast<double> (devices) * n;
+  std::cout << name << ": " << ms << " ms, "
+            << (ms > 0 ? records * 1000.0 / ms : 0) << " records/s" << std::endl;
+  if (ng)
+    {
+      std::remove (prefix.c_str ());
+    }
+  else
+    {
+      RemoveFiles (prefix, devices);
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t devices = 500;
+  uint32_t n = 1000;
+  uint32_t size = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark per-device pcap files against a shared, buffered pcapng file");
+  cmd.AddValue ("devices", "number of traced devices", devices);
+  cmd.AddValue ("n", "number of packets per device", n);
+  cmd.AddValue ("size", "packet size, in bytes", size);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-pcap with devices=" << devices << " n=" << n
+            << " size=" << size << std::endl;
+
+  RunBench ("per-device pcap", "bench-pcap", devices, n, size, false);
+  RunBench ("shared pcapng", "bench-pcap.pcapng", devices, n, size, true);
+  Config::SetDefault ("ns3::PcapNgFileWrapper::Compress", BooleanValue (true));
+  RunBench ("shared pcapng, gzip", "bench-pcap.pcapng.gz", devices, n, size, true);
+
+  return 0;
+}
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the forwarding rate of the static and global routing protocols:
+// fill a routing table with random prefixes, then time RouteOutput for
+// random destinations.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/internet-module.h"
+#include <iostream>
+
+using namespace ns3;
+
+/**
+ * Print the lookup rate of a routing protocol.
+ *
+ * \param name the routing protocol
+ * \param ms the wall clock time, in milliseconds
+ * \param nLookups the number of lookups
+ * \param nFound the number of lookups which found a route
+ */
+static void
+Report (std::string name, int64_t ms, uint32_t nLookups, uint32_t nFound)
+{
+  std::cout << name << ": " << ms << " ms, "
+            << (ms > 0 ? nLookups * 1000.0 / ms : 0) << " lookups/s ("
+            << nFound << " of " << nLookups << " routed)" << std::endl;
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nRoutes = 10000;
+  uint32_t nLookups = 1000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark route lookups in Ipv4StaticRouting, Ipv4GlobalRouting and Ipv6StaticRouting");
+  cmd.AddValue ("routes", "number of routes in each routing table", nRoutes);
+  cmd.AddValue ("lookups", "number of lookups per routing protocol", nLookups);
+  cmd.Parse (argc, argv);
+
+  Ptr<Node> node = CreateObject<Node> ();
+  InternetStackHelper stack;
+  stack.Install (node);
+  Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+  device->SetAddress (Mac48Address::Allocate ());
+  device->SetChannel (CreateObject<SimpleChannel> ());
+  node->AddDevice (device);
+
+  Ptr<Ipv4> ipv4 = node->GetObject<Ipv4> ();
+  uint32_t interface = ipv4->AddInterface (device);
+  ipv4->AddAddress (interface, Ipv4InterfaceAddress (Ipv4Address ("192.168.0.1"), Ipv4Mask ("255.255.255.0")));
+  ipv4->SetUp (interface);
+  Ptr<Ipv6> ipv6 = node->GetObject<Ipv6> ();
+  uint32_t interface6 = ipv6->AddInterface (device);
+  ipv6->AddAddress (interface6, Ipv6InterfaceAddress (Ipv6Address ("2001:db8::1"), Ipv6Prefix (64)));
+  ipv6->SetUp (interface6);
+
+  Ptr<Ipv4StaticRouting> staticRouting = CreateObject<Ipv4StaticRouting> ();
+  staticRouting->SetIpv4 (ipv4);
+  Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting> ();
+  globalRouting->SetIpv4 (ipv4);
+  Ptr<Ipv6StaticRouting> staticRouting6 = CreateObject<Ipv6StaticRouting> ();
+  staticRouting6->SetIpv6 (ipv6);
+
+  // Prefixes from /8 to /32, most of them in 10.0.0.0/8 so that they nest
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  Ipv4Address gateway ("192.168.0.2");
+  Ipv6Address gateway6 ("2001:db8::2");
+  for (uint32_t i = 0; i < nRoutes; ++i)
+    {
+      uint32_t length = rng->GetInteger (8, 32);
+      uint32_t address = (10 << 24) | rng->GetInteger (0, 0xffffff);
+      Ipv4Mask mask (length == 32 ? 0xffffffff : ~(0xffffffff >> length));
+      Ipv4Address network = Ipv4Address (address).CombineMask (mask);
+      staticRouting->AddNetworkRouteTo (network, mask, gateway, interface, rng->GetInteger (0, 3));
+      globalRouting->AddNetworkRouteTo (network, mask, gateway, interface);
+
+      uint8_t bytes[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+      for (uint32_t j = 4; j < 16; ++j)
+        {
+          bytes[j] = rng->GetInteger (0, 255);
+        }
+      uint8_t length6 = rng->GetInteger (32, 128);
+      staticRouting6->AddNetworkRouteTo (Ipv6Address (bytes).CombinePrefix (Ipv6Prefix (length6)),
+                                         Ipv6Prefix (length6), gateway6, interface6, rng->GetInteger (0, 3));
+    }
+
+  std::vector<Ipv4Address> destinations;
+  std::vector<Ipv6Address> destinations6;
+  for (uint32_t i = 0; i < 1024; ++i)
+    {
+      destinations.push_back (Ipv4Address ((10 << 24) | rng->GetInteger (0, 0xffffff)));
+      uint8_t bytes[16] = { 0x20, 0x01, 0x0d, 0xb8 };
+      for (uint32_t j = 4; j < 16; ++j)
+        {
+          bytes[j] = rng->GetInteger (0, 255);
+        }
+      destinations6.push_back (Ipv6Address (bytes));
+    }
+
+  std::cout << "Running bench-routing-lookup with " << nRoutes << " routes" << std::endl;
+
+  Socket::SocketErrno sockerr;
+  Ipv4Header header;
+  SystemWallClockMs timer;
+  uint32_t found = 0;
+  timer.Start ();
+  for (uint32_t i = 0; i < nLookups; ++i)
+    {
+      header.SetDestination (destinations[i % destinations.size ()]);
+      found += (staticRouting->RouteOutput (0, header, 0, sockerr) != 0);
+    }
+  Report ("Ipv4StaticRouting", timer.End (), nLookups, found);
+
+  found = 0;
+  timer.Start ();
+  for (uint32_t i = 0; i < nLookups; ++i)
+    {
+      header.SetDestination (destinations[i % destinations.size ()]);
+      found += (globalRouting->RouteOutput (0, header, 0, sockerr) != 0);
+    }
+  Report ("Ipv4GlobalRouting", timer.End (), nLookups, found);
+
+  Ipv6Header header6;
+  found = 0;
+  timer.Start ();
+  for (uint32_t i = 0; i < nLookups; ++i)
+    {
+      header6.SetDestinationAddress (destinations6[i % destinations6.size ()]);
+      found += (staticRouting6->RouteOutput (0, header6, 0, sockerr) != 0);
+    }
+  Report ("Ipv6StaticRouting", timer.End (), nLookups, found);
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,171 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the deliveries of a MultiModelSpectrumChannel:
+// nodes spread over a large area broadcast a packet every 100 ms, half
+// of them with a 5 MHz resolution SpectrumModel and the other half with
+// a 20 MHz OFDM SpectrumModel, so that the signals are converted
+// between the two.  The signals are first delivered to every PHY, then
+// only to the PHYs with a loss below the MaxLossDb of the channel, then
+// only to the PHYs within the MaxRange of the channel, which has the
+// same loss; beyond it, they are received well below the noise floor.
+// Print the events, the packets received and the wall clock time of the
+// simulation.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/propagation-module.h"
+#include "ns3/spectrum-module.h"
+#include <iostream>
+
+using namespace ns3;
+
+static uint32_t g_received = 0;   //!< the packets received
+
+/// Do nothing; used to get the identifier of the next event.
+static void
+Noop (void)
+{
+}
+
+/**
+ * Count a packet received.
+ *
+ * \param p the packet
+ */
+static void
+Received (Ptr<const Packet> p)
+{
+  g_received++;
+}
+
+/**
+ * Broadcast a packet, and schedule the next one.
+ *
+ * \param device the sending device
+ */
+static void
+Broadcast (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (125), device->GetBroadcast (), 1);
+  Simulator::Schedule (MilliSeconds (100), &Broadcast, device);
+}
+
+/**
+ * Run the simulation of the area.
+ *
+ * \param nNodes the number of nodes
+ * \param size the side of the square area, in meters
+ * \param stop the duration of the simulation
+ * \param maxLossDb the MaxLossDb of the channel
+ * \param maxRange the MaxRange of the channel, or zero to deliver the signals to every PHY
+ */
+static void
+Run (uint32_t nNodes, double size, Time stop, double maxLossDb, double maxRange)
+{
+  g_received = 0;
+  RngSeedManager::SetRun (1);
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  // fixed streams, for all the runs to draw the same random values
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (0);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      nodes.Get (i)->GetObject<MobilityModel> ()->SetPosition (Vector (rng->GetValue (0, size), rng->GetValue (0, size), 0));
+    }
+
+  SpectrumChannelHelper channelHelper;
+  channelHelper.SetChannel ("ns3::MultiModelSpectrumChannel",
+                            "MaxLossDb", DoubleValue (maxLossDb),
+                            "MaxRange", DoubleValue (maxRange));
+  channelHelper.AddPropagationLoss ("ns3::LogDistancePropagationLossModel", "Exponent", DoubleValue (3.5));
+  channelHelper.SetPropagationDelay ("ns3::ConstantSpeedPropagationDelayModel");
+  Ptr<SpectrumChannel> channel = channelHelper.Create ();
+
+  WifiSpectrumValue5MhzFactory sf;
+  NodeContainer narrow;
+  NodeContainer wide;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      (i % 2 ? wide : narrow).Add (nodes.Get (i));
+    }
+  AdhocAlohaNoackIdealPhyHelper deviceHelper;
+  deviceHelper.SetChannel (channel);
+  deviceHelper.SetPhyAttribute ("Rate", DataRateValue (DataRate ("1Mbps")));
+  deviceHelper.SetTxPowerSpectralDensity (sf.CreateTxPowerSpectralDensity (0.1, 1));
+  deviceHelper.SetNoisePowerSpectralDensity (sf.CreateConstant (1.381e-23 * 290));
+  NetDeviceContainer devices = deviceHelper.Install (narrow);
+  deviceHelper.SetTxPowerSpectralDensity (WifiSpectrumValueHelper::CreateOfdmTxPowerSpectralDensity (2412, 20, 0.1));
+  deviceHelper.SetNoisePowerSpectralDensity (WifiSpectrumValueHelper::CreateNoisePowerSpectralDensity (2412, 20, 7));
+  devices.Add (deviceHelper.Install (wide));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/$ns3::AlohaNoackNetDevice/Phy/RxEndOk", MakeCallback (&Received));
+  for (uint32_t i = 0; i < devices.GetN (); i++)
+    {
+      Simulator::Schedule (MilliSeconds (rng->GetInteger (0, 99)), &Broadcast, devices.Get (i));
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+
+  std::cout << "MaxLossDb " << maxLossDb << " dB, MaxRange " << maxRange << " m: "
+            << Simulator::Schedule (Seconds (0), &Noop).GetUid () << " events, "
+            << g_received << " packets received, "
+            << runMs << " ms run" << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 500;
+  double size = 10000;
+  double stop = 2;
+  double maxRange = 1000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the deliveries of a MultiModelSpectrumChannel, with and without a maximum range");
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("size", "side of the square area, in meters", size);
+  cmd.AddValue ("stop", "duration of the simulation, in seconds", stop);
+  cmd.AddValue ("maxRange", "maximum range of the channel, in meters", maxRange);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-spectrum-channel with " << nNodes << " nodes on "
+            << size << " m x " << size << " m for " << stop << " s" << std::endl;
+  // the loss at the maximum range
+  Ptr<LogDistancePropagationLossModel> loss = CreateObject<LogDistancePropagationLossModel> ();
+  loss->SetAttribute ("Exponent", DoubleValue (3.5));
+  Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  b->SetPosition (Vector (maxRange, 0, 0));
+  double maxLossDb = -loss->CalcRxPower (0, a, b);
+
+  Run (nNodes, size, Seconds (stop), 1.0e9, 0);
+  Run (nNodes, size, Seconds (stop), maxLossDb, 0);
+  Run (nNodes, size, Seconds (stop), 1.0e9, maxRange);
+  return 0;
+}
@@ -0,0 +1,134 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the SpectrumValue operations used by the
+// interference and SINR computations: the SINR of a signal over the
+// noise and the other signals, the accumulation of the SINR chunks, and
+// the reductions of the SINR, for SpectrumModels of 100 and 1000 bands.
+// Print the wall clock time of each operation, in nanoseconds.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/spectrum-value.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+/**
+ * Print the time of an operation.
+ *
+ * \param name the name of the operation
+ * \param ms the time of all the iterations, in milliseconds
+ * \param iterations the iterations
+ */
+static void
+Report (std::string name, int64_t ms, uint32_t iterations)
+{
+  std::cout << "  " << std::left << std::setw (32) << name
+            << std::right << std::setw (10) << ms * 1e6 / iterations << " ns" << std::endl;
+}
+
+/**
+ * Run the operations over a SpectrumModel.
+ *
+ * \param nBands the number of bands of the SpectrumModel
+ * \param iterations the iterations of each operation
+ */
+static void
+Run (uint32_t nBands, uint32_t iterations)
+{
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i <= nBands; i++)
+    {
+      freqs.push_back (2.0e9 + i * 180e3);
+    }
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (freqs);
+  SpectrumValue rxSignal (model);
+  SpectrumValue allSignals (model);
+  SpectrumValue noise (model);
+  for (uint32_t i = 0; i < nBands; i++)
+    {
+      rxSignal[i] = 1e-12 * (1 + i % 7);
+      allSignals[i] = rxSignal[i] + 1e-13 * (1 + i % 5);
+      noise[i] = 4e-21;
+    }
+  SpectrumValue sum (model);
+  double total = 0;
+  SystemWallClockMs timer;
+
+  std::cout << nBands << " bands:" << std::endl;
+
+  timer.Start ();
+  for (uint32_t k = 0; k < iterations; k++)
+    {
+      SpectrumValue sinr = rxSignal / (allSignals - rxSignal + noise);
+      total += sinr[k % nBands];
+    }
+  Report ("sinr = s / (all - s + noise)", timer.End (), iterations);
+
+  timer.Start ();
+  for (uint32_t k = 0; k < iterations; k++)
+    {
+      sum += rxSignal * 1e-3;
+    }
+  Report ("sum += sinr * duration", timer.End (), iterations);
+
+  timer.Start ();
+  for (uint32_t k = 0; k < iterations; k++)
+    {
+      allSignals += rxSignal;
+      allSignals -= rxSignal;
+    }
+  Report ("all += s; all -= s", timer.End (), iterations);
+
+  timer.Start ();
+  for (uint32_t k = 0; k < iterations; k++)
+    {
+      SpectrumValue db = 10 * Log10 (rxSignal);
+      total += db[k % nBands];
+    }
+  Report ("10 * Log10 (s)", timer.End (), iterations);
+
+  timer.Start ();
+  for (uint32_t k = 0; k < iterations; k++)
+    {
+      total += Sum (rxSignal) + Integral (rxSignal);
+    }
+  Report ("Sum (s) + Integral (s)", timer.End (), iterations);
+
+  // keep the results alive
+  if (total + sum[0] == 0)
+    {
+      std::cout << "unexpected result" << std::endl;
+    }
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t iterations = 1000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the SpectrumValue operations of the interference and SINR computations");
+  cmd.AddValue ("iterations", "iterations of each operation", iterations);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-spectrum-value with " << iterations << " iterations" << std::endl;
+  Run (100, iterations);
+  Run (1000, iterations / 10);
+  return 0;
+}
@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the memory allocations of the deliveries of the wifi channels:
+// nodes within range of each other broadcast a frame every 100 ms, over a
+// YansWifiChannel and then over a MultiModelSpectrumChannel, so that
+// every frame reaches every other PHY, most of which drop it because
+// they are already busy.  Print the events, the frames received, the
+// allocations made and the wall clock time of the simulation.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include "ns3/spectrum-module.h"
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+using namespace ns3;
+
+static uint64_t g_allocations = 0;   //!< the allocations made
+static uint32_t g_received = 0;      //!< the frames received
+
+/**
+ * Count an allocation.
+ *
+ * \param size the size of the allocation
+ * \return the memory allocated
+ */
+void *
+operator new (std::size_t size)
+{
+  g_allocations++;
+  void *p = std::malloc (size ? size : 1);
+  if (p == 0)
+    {
+      throw std::bad_alloc ();
+    }
+  return p;
+}
+
+/**
+ * Free the memory of an allocation.
+ *
+ * \param p the memory allocated
+ */
+void
+operator delete (void *p) throw ()
+{
+  std::free (p);
+}
+
+/// Do nothing; used to get the identifier of the next event.
+static void
+Noop (void)
+{
+}
+
+/**
+ * Count a frame received.
+ *
+ * \param p the frame
+ */
+static void
+Received (Ptr<const Packet> p)
+{
+  g_received++;
+}
+
+/**
+ * Broadcast a frame, and schedule the next one.
+ *
+ * \param device the sending device
+ */
+static void
+Broadcast (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (200), device->GetBroadcast (), 1);
+  Simulator::Schedule (MilliSeconds (100), &Broadcast, device);
+}
+
+/**
+ * Run the simulation.
+ *
+ * \param nNodes the number of nodes
+ * \param size the side of the square area, in meters
+ * \param stop the duration of the simulation
+ * \param spectrum whether to use a MultiModelSpectrumChannel rather than a YansWifiChannel
+ */
+static void
+Run (uint32_t nNodes, double size, Time stop, bool spectrum)
+{
+  g_received = 0;
+  RngSeedManager::SetRun (1);
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  // fixed streams, for both runs to draw the same random values
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (0);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.Install (nodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      nodes.Get (i)->GetObject<MobilityModel> ()->SetPosition (Vector (rng->GetValue (0, size), rng->GetValue (0, size), 0));
+    }
+
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices;
+  if (spectrum)
+    {
+      SpectrumChannelHelper channelHelper = SpectrumChannelHelper::Default ();
+      SpectrumWifiPhyHelper phy = SpectrumWifiPhyHelper::Default ();
+      phy.SetChannel (channelHelper.Create ());
+      devices = wifi.Install (phy, mac, nodes);
+    }
+  else
+    {
+      YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+      YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+      phy.SetChannel (channelHelper.Create ());
+      devices = wifi.Install (phy, mac, nodes);
+    }
+  wifi.AssignStreams (devices, 1);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&Received));
+      Simulator::Schedule (MilliSeconds (rng->GetInteger (0, 99)), &Broadcast, devices.Get (i));
+    }
+
+  uint64_t allocations = g_allocations;
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+  allocations = g_allocations - allocations;
+
+  std::cout << (spectrum ? "MultiModelSpectrumChannel: " : "YansWifiChannel: ")
+            << Simulator::Schedule (Seconds (0), &Noop).GetUid () << " events, "
+            << g_received << " frames received, "
+            << allocations << " allocations, "
+            << runMs << " ms run" << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 200;
+  double size = 100;
+  double stop = 2;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the memory allocations of the deliveries of the wifi channels");
+  cmd.AddValue ("nodes", "number of nodes", nNodes);
+  cmd.AddValue ("size", "side of the square area, in meters", size);
+  cmd.AddValue ("stop", "duration of the simulation, in seconds", stop);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-wifi-broadcast with " << nNodes << " nodes on "
+            << size << " m x " << size << " m for " << stop << " s" << std::endl;
+  Run (nNodes, size, Seconds (stop), false);
+  Run (nNodes, size, Seconds (stop), true);
+  return 0;
+}
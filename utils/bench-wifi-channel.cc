@@ -0,0 +1,148 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the deliveries of a YansWifiChannel: vehicles drive
+// along the lanes of a highway and broadcast a frame every second, first
+// with the frames delivered to every PHY, then only to the PHYs within
+// the MaxRange of the channel, beyond which they are received well below
+// the noise floor.  Print the events, the frames received and the wall
+// clock time of the simulation.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/wifi-module.h"
+#include <iostream>
+
+using namespace ns3;
+
+static uint32_t g_received = 0;   //!< the frames received
+
+/// Do nothing; used to get the identifier of the next event.
+static void
+Noop (void)
+{
+}
+
+/**
+ * Count a frame received.
+ *
+ * \param p the frame
+ */
+static void
+Received (Ptr<const Packet> p)
+{
+  g_received++;
+}
+
+/**
+ * Broadcast a frame, and schedule the next one.
+ *
+ * \param device the sending device
+ */
+static void
+Broadcast (Ptr<NetDevice> device)
+{
+  device->Send (Create<Packet> (200), device->GetBroadcast (), 1);
+  Simulator::Schedule (Seconds (1), &Broadcast, device);
+}
+
+/**
+ * Run the simulation of the highway.
+ *
+ * \param nNodes the number of vehicles
+ * \param length the length of the highway, in meters
+ * \param stop the duration of the simulation
+ * \param maxRange the MaxRange of the channel, or zero to deliver the frames to every PHY
+ */
+static void
+Run (uint32_t nNodes, double length, Time stop, double maxRange)
+{
+  g_received = 0;
+  RngSeedManager::SetRun (1);
+
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  // fixed streams, for both runs to draw the same random values
+  Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable> ();
+  rng->SetStream (0);
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantVelocityMobilityModel");
+  mobility.Install (nodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      // four lanes 5 m apart, two in each direction
+      uint32_t lane = i % 4;
+      Ptr<ConstantVelocityMobilityModel> model = nodes.Get (i)->GetObject<ConstantVelocityMobilityModel> ();
+      model->SetPosition (Vector (rng->GetValue (0, length), lane * 5.0, 0));
+      model->SetVelocity (Vector ((lane < 2 ? 1 : -1) * rng->GetValue (20, 35), 0, 0));
+    }
+
+  YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default ();
+  Ptr<YansWifiChannel> channel = channelHelper.Create ();
+  channel->SetAttribute ("MaxRange", DoubleValue (maxRange));
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel);
+  WifiHelper wifi;
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager ("ns3::ConstantRateWifiManager", "DataMode", StringValue ("OfdmRate6Mbps"));
+  WifiMacHelper mac;
+  mac.SetType ("ns3::AdhocWifiMac");
+  NetDeviceContainer devices = wifi.Install (phy, mac, nodes);
+  wifi.AssignStreams (devices, 1);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      DynamicCast<WifiNetDevice> (devices.Get (i))->GetPhy ()->TraceConnectWithoutContext ("PhyRxEnd", MakeCallback (&Received));
+      Simulator::Schedule (Seconds (rng->GetValue (0, 1)), &Broadcast, devices.Get (i));
+    }
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  Simulator::Stop (stop);
+  Simulator::Run ();
+  int64_t runMs = timer.End ();
+
+  std::cout << "MaxRange " << maxRange << " m: "
+            << Simulator::Schedule (Seconds (0), &Noop).GetUid () << " events, "
+            << g_received << " frames received, "
+            << runMs << " ms run" << std::endl;
+
+  Simulator::Destroy ();
+}
+
+int main (int argc, char *argv[])
+{
+  uint32_t nNodes = 500;
+  double length = 10000;
+  double stop = 10;
+  double maxRange = 600;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the deliveries of a YansWifiChannel, with and without a maximum range");
+  cmd.AddValue ("nodes", "number of vehicles", nNodes);
+  cmd.AddValue ("length", "length of the highway, in meters", length);
+  cmd.AddValue ("stop", "duration of the simulation, in seconds", stop);
+  cmd.AddValue ("maxRange", "maximum range of the channel, in meters", maxRange);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-wifi-channel with " << nNodes << " vehicles on "
+            << length << " m for " << stop << " s" << std::endl;
+  Run (nNodes, length, Seconds (stop), 0);
+  Run (nNodes, length, Seconds (stop), maxRange);
+  return 0;
+}
@@ -0,0 +1,105 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Measure the cost of the lookup of the remote stations by the
+// WifiRemoteStationManager, as seen by an access point with an
+// increasing number of associated stations: the access point sends
+// frames of two TIDs to its stations in turn, and reports their
+// acknowledgment, its reception of their answer, and the tx vector of the
+// next one.  Print the wall clock time of a frame, in nanoseconds.
+//
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+#include <iostream>
+#include <iomanip>
+
+using namespace ns3;
+
+/**
+ * Send frames to the remote stations in turn.
+ *
+ * \param managerType the type of the WifiRemoteStationManager
+ * \param nStations the number of remote stations
+ * \param nFrames the number of frames
+ * \returns the wall clock time of the frames, in milliseconds
+ */
+static int64_t
+Run (std::string managerType, uint32_t nStations, uint32_t nFrames)
+{
+  Ptr<YansWifiPhy> phy = CreateObject<YansWifiPhy> ();
+  phy->ConfigureStandard (WIFI_PHY_STANDARD_80211a);
+  ObjectFactory factory;
+  factory.SetTypeId (managerType);
+  Ptr<WifiRemoteStationManager> manager = factory.Create<WifiRemoteStationManager> ();
+  manager->SetupPhy (phy);
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      addresses.push_back (Mac48Address::Allocate ());
+      manager->RecordGotAssocTxOk (addresses.back ());
+    }
+  WifiMacHeader headers[2];
+  for (uint8_t tid = 0; tid < 2; tid++)
+    {
+      headers[tid].SetType (WIFI_MAC_QOSDATA);
+      headers[tid].SetQosTid (tid);
+    }
+  Ptr<Packet> packet = Create<Packet> (1000);
+  WifiMode ackMode = WifiPhy::GetOfdmRate6Mbps ();
+
+  SystemWallClockMs timer;
+  timer.Start ();
+  for (uint32_t i = 0; i < nFrames; i++)
+    {
+      Mac48Address address = addresses[i % nStations];
+      const WifiMacHeader *header = &headers[i / nStations % 2];
+      WifiTxVector txVector = manager->GetDataTxVector (address, header, packet);
+      manager->ReportDataOk (address, header, 100, ackMode, 100);
+      manager->ReportRxOk (address, header, 100, txVector.GetMode ());
+    }
+  int64_t runMs = timer.End ();
+  manager->Dispose ();
+  phy->Dispose ();
+  Simulator::Destroy ();
+  return runMs;
+}
+
+int main (int argc, char *argv[])
+{
+  std::string managerType = "ns3::AarfWifiManager";
+  uint32_t nFrames = 1000000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the lookup of the remote stations of a WifiRemoteStationManager");
+  cmd.AddValue ("manager", "type of the WifiRemoteStationManager", managerType);
+  cmd.AddValue ("frames", "number of frames", nFrames);
+  cmd.Parse (argc, argv);
+
+  std::cout << "Running bench-wifi-remote-station-manager with " << managerType
+            << ", " << nFrames << " frames" << std::endl;
+  uint32_t stations[] = { 1, 10, 100, 500 };
+  for (uint32_t i = 0; i < sizeof (stations) / sizeof (stations[0]); i++)
+    {
+      int64_t runMs = Run (managerType, stations[i], nFrames);
+      std::cout << "  " << std::setw (4) << stations[i] << " stations "
+                << std::setw (8) << runMs * 1e6 / nFrames << " ns per frame" << std::endl;
+    }
+  return 0;
+}
@@ -0,0 +1,62 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+//
+// Regenerate the ASCII trace from a file written by a stream created with
+// AsciiTraceHelper::CreateBinaryFileStream.
+//
+
+#include "ns3/command-line.h"
+#include "ns3/binary-trace-file.h"
+#include <iostream>
+#include <fstream>
+
+using namespace ns3;
+
+int main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.Usage ("Convert a binary trace file to the ASCII trace format");
+  cmd.AddValue ("input", "binary trace file", input);
+  cmd.AddValue ("output", "ASCII trace file, standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      std::cerr << "convert-binary-trace: --input is required" << std::endl;
+      return 1;
+    }
+
+  bool ok;
+  if (output.empty ())
+    {
+      ok = BinaryTraceFile::ConvertToAscii (input, std::cout);
+    }
+  else
+    {
+      std::ofstream os (output.c_str ());
+      ok = BinaryTraceFile::ConvertToAscii (input, os);
+    }
+  if (!ok)
+    {
+      std::cerr << "convert-binary-trace: " << input << " is not a complete binary trace file" << std::endl;
+      return 1;
+    }
+  return 0;
+}